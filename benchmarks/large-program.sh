@@ -0,0 +1,34 @@
+#!/bin/bash
+
+# Times how long the host takes to compile large generated programs to byte code, to check that this scales linearly with the
+# size of the program. Each program is N lines of straight line code of the form "a=a+k", by default for N of 25000, 50000
+# and 100000, and other sizes can be given as arguments. The host built standalone (make standalone) is used unless EPYTHON is set
+
+cd "$(dirname "$0")"
+
+EPYTHON=${EPYTHON:-../epython-host}
+SIZES=${@:-25000 50000 100000}
+
+if [ ! -x $EPYTHON ]
+then
+echo "ePython host '$EPYTHON' not found, build this first with make standalone"
+exit 1
+fi
+
+# The byte code cache is kept in a directory of its own, which starts empty, so that every program is compiled
+WORKDIR=$(mktemp -d)
+trap 'rm -rf "$WORKDIR"' EXIT
+export EPYTHONCACHE=$WORKDIR
+
+TIMEFORMAT=%R
+echo "lines     seconds"
+for N in $SIZES
+do
+echo "a=0" > $WORKDIR/large.py
+for ((i=1;i<N;i++))
+do
+echo "a=a+$((i % 100))"
+done >> $WORKDIR/large.py
+SECONDS_TAKEN=$( { time $EPYTHON -o $WORKDIR/large.epyb $WORKDIR/large.py > /dev/null 2>&1; } 2>&1 )
+printf "%-9s %s\n" $N $SECONDS_TAKEN
+done
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2016, Nick Brown
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Arena allocation for the data structures of the compiler. The many small pieces of memory that lexing, parsing and assembling
+ * the byte code creates are allocated from large blocks in the current arena, and the arena is released in one go once the
+ * byte code has been compiled. Unless another arena has been selected allocations are made from the program arena, which is
+ * held for the lifetime of the program. Whilst a scratch arena is entered allocations are made from this, apart from those of
+ * anything that outlives the scratch arena which are made from the arena that was current when it was entered (the retained arena)
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+
+// Size of the blocks that an arena is made up of, allocations larger than a quarter of this are given their own block
+#define ARENA_BLOCK_SIZE 65536
+// Allocations are aligned to this, which is also the size that the header of a block is rounded up to
+#define ARENA_ALIGNMENT 8
+#define ALIGN_ARENA_SIZE(size) (((size) + ARENA_ALIGNMENT - 1) & ~((size_t) ARENA_ALIGNMENT - 1))
+#define ARENA_BLOCK_DATA(block) ((char*) (block) + ALIGN_ARENA_SIZE(sizeof(struct memory_arena_block)))
+
+static struct memory_arena programArena={NULL};
+static struct memory_arena * currentArena=&programArena;
+static struct memory_arena * retainedArena=NULL;
+
+static struct memory_arena_block* createArenaBlock(size_t);
+
+/**
+ * Creates an empty arena, which blocks are added to as memory is allocated from it
+ */
+struct memory_arena* createArena(void) {
+	struct memory_arena * arena=(struct memory_arena*) malloc(sizeof(struct memory_arena));
+	arena->blocks=NULL;
+	return arena;
+}
+
+/**
+ * Frees an arena along with all the memory that has been allocated from it
+ */
+void freeArena(struct memory_arena * arena) {
+	struct memory_arena_block * block=arena->blocks, * next;
+	while (block != NULL) {
+		next=block->next;
+		free(block);
+		block=next;
+	}
+	if (currentArena == arena) currentArena=&programArena;
+	if (retainedArena == arena) retainedArena=NULL;
+	free(arena);
+}
+
+/**
+ * Releases all the memory that has been allocated from an arena so that this can be allocated from again. The most recent block
+ * is kept to be reused if it is of the usual size, the others are freed
+ */
+void resetArena(struct memory_arena * arena) {
+	struct memory_arena_block * block=arena->blocks, * next;
+	if (block != NULL && block->size == ARENA_BLOCK_SIZE) {
+		arena->blocks=block;
+		block->used=0;
+		next=block->next;
+		block->next=NULL;
+		block=next;
+	} else {
+		arena->blocks=NULL;
+	}
+	while (block != NULL) {
+		next=block->next;
+		free(block);
+		block=next;
+	}
+}
+
+/**
+ * Sets the arena that memory is allocated from, NULL selects the program arena. The previously selected arena is returned
+ */
+struct memory_arena* setCurrentArena(struct memory_arena * arena) {
+	struct memory_arena * previousArena=currentArena;
+	currentArena=arena != NULL ? arena : &programArena;
+	return previousArena;
+}
+
+/**
+ * Gets the arena that memory is currently allocated from
+ */
+struct memory_arena* getCurrentArena(void) {
+	return currentArena;
+}
+
+/**
+ * Enters a scratch arena, which memory is allocated from until it is left. The arena that was current becomes the retained arena,
+ * unless a scratch arena has already been entered in which case the retained arena is unchanged. The previous arena is returned,
+ * which is passed to leaveScratchArena
+ */
+struct memory_arena* enterScratchArena(struct memory_arena * arena) {
+	struct memory_arena * previousArena=currentArena;
+	if (retainedArena == NULL) retainedArena=currentArena;
+	currentArena=arena;
+	return previousArena;
+}
+
+/**
+ * Leaves a scratch arena, the arena which was current when this was entered becomes current again
+ */
+void leaveScratchArena(struct memory_arena * previousArena) {
+	currentArena=previousArena;
+	if (currentArena == retainedArena) retainedArena=NULL;
+}
+
+/**
+ * Sets the retained arena as the one that memory is allocated from, for anything which must outlive the scratch arena that has been
+ * entered. If no scratch arena has been entered the current arena is unchanged. The previously selected arena is returned
+ */
+struct memory_arena* setRetainedArena(void) {
+	struct memory_arena * previousArena=currentArena;
+	if (retainedArena != NULL) currentArena=retainedArena;
+	return previousArena;
+}
+
+/**
+ * Allocates memory from the current arena, this is released when the arena is freed
+ */
+void* arenaAllocate(size_t size) {
+	struct memory_arena_block * block=currentArena->blocks;
+	size=ALIGN_ARENA_SIZE(size);
+	if (block == NULL || block->used + size > block->size) {
+		if (size > ARENA_BLOCK_SIZE / 4) {
+			// Large allocations have their own block, which is placed after the current block so its free space is still used
+			struct memory_arena_block * largeBlock=createArenaBlock(size);
+			largeBlock->used=size;
+			if (block == NULL) {
+				currentArena->blocks=largeBlock;
+			} else {
+				largeBlock->next=block->next;
+				block->next=largeBlock;
+			}
+			return ARENA_BLOCK_DATA(largeBlock);
+		}
+		block=createArenaBlock(ARENA_BLOCK_SIZE);
+		block->next=currentArena->blocks;
+		currentArena->blocks=block;
+	}
+	void * memory=ARENA_BLOCK_DATA(block) + block->used;
+	block->used+=size;
+	return memory;
+}
+
+/**
+ * Changes the size of some memory allocated from the current arena. This is grown in place if it was the most recent allocation
+ * and there is room in the block, otherwise it is copied into newly allocated memory
+ */
+void* arenaReallocate(void * memory, size_t oldSize, size_t newSize) {
+	struct memory_arena_block * block=currentArena->blocks;
+	if (memory == NULL) return arenaAllocate(newSize);
+	if (block != NULL && (char*) memory + ALIGN_ARENA_SIZE(oldSize) == ARENA_BLOCK_DATA(block) + block->used &&
+			block->used - ALIGN_ARENA_SIZE(oldSize) + ALIGN_ARENA_SIZE(newSize) <= block->size) {
+		block->used=block->used - ALIGN_ARENA_SIZE(oldSize) + ALIGN_ARENA_SIZE(newSize);
+		return memory;
+	}
+	void * newMemory=arenaAllocate(newSize);
+	memcpy(newMemory, memory, oldSize < newSize ? oldSize : newSize);
+	return newMemory;
+}
+
+/**
+ * Copies a string into memory allocated from the current arena
+ */
+char* arenaDuplicateString(const char * string) {
+	size_t length=strlen(string) + 1;
+	char * copy=(char*) arenaAllocate(length);
+	memcpy(copy, string, length);
+	return copy;
+}
+
+/**
+ * Creates a block which can hold a specific number of bytes
+ */
+static struct memory_arena_block* createArenaBlock(size_t size) {
+	struct memory_arena_block * block=(struct memory_arena_block*) malloc(ALIGN_ARENA_SIZE(sizeof(struct memory_arena_block)) + size);
+	block->next=NULL;
+	block->size=size;
+	block->used=0;
+	return block;
+}
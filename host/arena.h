@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2016, Nick Brown
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <stddef.h>
+
+// A block of memory in an arena, allocations are made from the bytes which follow this header
+struct memory_arena_block {
+	struct memory_arena_block * next;
+	size_t size, used;
+};
+
+// Arena that memory is allocated from in turn and then released all at once, rather than each allocation being freed
+struct memory_arena {
+	struct memory_arena_block * blocks;
+};
+
+struct memory_arena* createArena(void);
+void freeArena(struct memory_arena*);
+void resetArena(struct memory_arena*);
+struct memory_arena* setCurrentArena(struct memory_arena*);
+struct memory_arena* getCurrentArena(void);
+struct memory_arena* enterScratchArena(struct memory_arena*);
+void leaveScratchArena(struct memory_arena*);
+struct memory_arena* setRetainedArena(void);
+void* arenaAllocate(size_t);
+void* arenaReallocate(void*, size_t, size_t);
+char* arenaDuplicateString(const char*);
+
+#endif /* ARENA_H_ */
@@ -33,119 +33,311 @@
 #include "basictokens.h"
 #include "byteassembler.h"
 #include "misc.h"
+#include "hashtable.h"
+#include "arena.h"
 
 #define RECURSION_VAR_DEPTH 10
+#define HOST_RECURSION_VAR_DEPTH 255
+// Largest body, in bytes, of a function which is substituted in place of calls to it
+#define MAX_INLINED_FUNCTION_SIZE 24
+// Types inferred for variables and expressions, from unassigned (no assignment seen yet) up to any (the type is not provable)
+#define INFERRED_UNASSIGNED 0
+#define INFERRED_INT 1
+#define INFERRED_REAL 2
+#define INFERRED_BOOLEAN 3
+#define INFERRED_STRING 4
+#define INFERRED_ANY 5
+// Source file of the util module, loops over whose range and xrange functions are run as counted loops, and the flags for where
+// these functions are defined
+#define UTIL_MODULE_FILENAME "util.py"
+#define UTIL_MODULE_SOURCE 1
+#define OTHER_SOURCE 2
 
 /*
  * Node for holding a specific scope information - the variables that belong to
  * this scope. These are arranged in a stack, and the stack searched downwards for
  * a variable. Therefore when we enter a scope block it is stack push and when we leave
- * stack pop
+ * stack pop. The variables of a scope are indexed by their case folded name, this
+ * table is created when the first variable is added to the scope. The variables are
+ * allocated from the arena that the scope was entered in, as they live as long as it
  */
 struct scope_info {
-	struct variable_node * variables;
+	struct hash_table * variableTable;
+	struct memory_arena * arena;
 	struct scope_info * next;
 };
 
 /*
- * Information about a specific variable, mapping it to a unique ID that will be
- * represented in the symbol table
+ * Information about a specific variable, mapping it to its slot in the symbol table. This is either
+ * a global slot or, for variables declared in a function, a slot relative to the function's frame
  */
 struct variable_node {
 	char * name;
 	unsigned short id;
-	struct variable_node * next;
+};
+
+/*
+ * State of the type inference pass over a region of the program (the main code or a function.) Variables are tracked
+ * by their slot, globals across the whole program and locals within the function. Once the types have settled the
+ * pass is run again to rewrite the operators whose operand types are proven
+ */
+struct type_inference_state {
+	unsigned char * globalTypes, * localTypes;
+	unsigned short numberGlobals, numberLocals;
+	char changed, rewrite, failed;
+};
+
+/*
+ * Register format code being assembled, this is grown as instructions are appended and the line definitions
+ * of any expressions copied in unchanged are moved across to it
+ */
+struct register_code {
+	char * data;
+	unsigned int length, capacity;
+	struct lineDefinition * lineDefns;
+};
+
+/*
+ * A growable list of positions or variable slots, used by the passes which scan and rewrite assembled code
+ */
+struct position_list {
+	unsigned int * entries;
+	int number, capacity;
+};
+
+/*
+ * An edit to assembled code, replacing the bytes at some position with others
+ */
+struct code_edit {
+	unsigned int position, length;
+	struct memorycontainer * replacement;
+};
+
+/*
+ * The values which are fixed for a run that byte code is specialised to, the core id and number of cores are negative if not known
+ */
+struct specialisation_values {
+	int isHost, coreId, numberCores;
+};
+
+/*
+ * State of a scan over the code of the main program or a function. For loop invariant code motion the statements of a loop are
+ * walked once to find the variables which it assigns to and whether it calls anything which might assign to others, and then
+ * again to find the invariant expressions. The length fields of conditionals and loops, and the skip fields of short circuiting
+ * operators, are recorded so these can be updated once the code is rewritten, along with the calls for the inlining pass and the
+ * branches and natives in expressions for specialisation
+ */
+struct code_scan_state {
+	char * data;
+	struct lineDefinition * lineDefns;
+	struct position_list assignedSlots, parameterSlots, lengthFields, skipFields, candidates, conditionals, callStatements, callExpressions;
+	struct position_list branches, natives;
+	unsigned int statementStart;
+	char inFunction, findCandidates, impureCall, assignsAliasable, failed;
 };
 
 // The current for line, this is is used in conjunction with GOTO to code for repetition
 int currentForLine=-1;
-int currentSymbolTableId, isFnRecursive;
+int isFnRecursive;
 char * currentFunctionName=NULL;
-
-static unsigned short current_var_id=1; // Current variable id (unique for each unique variable)
+int registerExpressions=0;
+// Number of bytes that folding constant conditions, algebraic simplification and dead block removal have taken out of the byte code
+unsigned int bytesOptimisedAway=0;
+// Whether any variable has been aliased, or had its reference or symbol taken, in which case an assignment might change others
+static int aliasingAssembled=0;
+static unsigned int functionStartBytesOptimisedAway=0;
+
+// Where range and xrange have been defined, either in the util module or elsewhere
+static unsigned char rangeFunctionSources[2]={0, 0};
+
+static unsigned short current_global_slot=0; // Next free global variable slot
+static unsigned short current_local_slot=0; // Next free slot in the frame of the function being assembled
 static struct scope_info * scope=NULL; // Scope stack
 struct function_call_tree_node *currentCall=NULL; // The current function call tree state
 
 static unsigned short addVariable(char*);
-static int doesVariableExist(char*);
-static unsigned short findVariable(struct variable_node*,  char*);
-static int areStringsEqualIgnoreCase(char*, char*);
+static int findVariable(struct scope_info*,  char*);
 static unsigned short getVariableId(char*, int);
+static unsigned int appendVariableSlot(struct memorycontainer*, unsigned short, unsigned int);
 static struct memorycontainer* createUnaryExpression(unsigned char token, struct memorycontainer*);
 static struct memorycontainer* createExpression(unsigned char, struct memorycontainer*, struct memorycontainer*);
+static struct memorycontainer* createShortCircuitExpression(unsigned char, struct memorycontainer*, struct memorycontainer*);
+static struct memorycontainer* simplifyAlgebraicIdentity(unsigned char, struct memorycontainer*, struct memorycontainer*);
+static int isLiteral(struct memorycontainer*, unsigned char);
+static int isIntegerLiteralOfValue(struct memorycontainer*, int);
+static int isNumericExpression(struct memorycontainer*);
+static int getConstantCondition(struct memorycontainer*);
+static void discardMemory(struct memorycontainer*);
 static struct memorycontainer* appendLetIfNoAliasStatement(struct memorycontainer*, struct memorycontainer*);
+static struct memorycontainer* appendExpressionLetStatement(struct memorycontainer*, struct memorycontainer*);
+static unsigned short getNumberEntriesForRecursionDepth(int);
+static struct memorycontainer* appendForRangeStatement(char*, struct memorycontainer**, int, struct memorycontainer*);
+static int extractRangeArguments(struct memorycontainer*, struct memorycontainer**);
+static int isCountedRangeFunction(char*);
+static int getRangeFunctionIndex(char*);
+static struct memorycontainer* extractExpression(struct memorycontainer*, unsigned int, unsigned int);
+static void moveLineDefinitions(struct lineDefinition**, unsigned int, unsigned int, struct lineDefinition**, unsigned int);
+static struct memorycontainer* compileExpression(struct memorycontainer*, char);
+static struct memorycontainer* compileArrayAccessIndexes(struct memorycontainer*);
+static unsigned int appendRegisterExpression(struct register_code*, struct memorycontainer*, unsigned int, char);
+static unsigned int compileRegisterInstructions(struct register_code*, struct memorycontainer*, unsigned int, unsigned char, char);
+static int isRegisterOperator(unsigned char);
+static unsigned int getExpressionLength(char*, unsigned int);
+static void emitRegisterCode(struct register_code*, void*, unsigned int);
+static void emitRegisterInstruction(struct register_code*, unsigned char, unsigned char);
+static void copyExpressionIntoRegisterCode(struct register_code*, struct memorycontainer*, unsigned int, unsigned int);
+static struct memorycontainer* appendLetSuperinstruction(struct memorycontainer*, struct memorycontainer*);
+static int isCompareAndBranchCondition(struct memorycontainer*);
+static unsigned int getSuperinstructionOperandLength(struct memorycontainer*, unsigned int);
+static int hasLocationLineDefinitions(struct memorycontainer*);
+static unsigned int inferStatementTypes(struct type_inference_state*, char*, unsigned int);
+static unsigned char inferExpressionType(struct type_inference_state*, char*, unsigned int*);
+static unsigned char inferLeafType(struct type_inference_state*, char*, unsigned int*);
+static void inferFunctionCallTypes(struct type_inference_state*, char*, unsigned int*);
+static unsigned char inferAssignmentTypes(struct type_inference_state*, char*, unsigned int*);
+static void rewriteTypedOperator(struct type_inference_state*, char*, unsigned int, unsigned char, unsigned char);
+static unsigned char getInferredArithmeticType(unsigned char, unsigned char);
+static unsigned char getInferredVariableType(struct type_inference_state*, unsigned short);
+static void assignInferredVariableType(struct type_inference_state*, unsigned short, unsigned char);
+static unsigned char* getInferredVariableTypeEntry(struct type_inference_state*, unsigned short);
+static struct memorycontainer* getInlineableBody(char*, unsigned int, unsigned short*, int);
+static int substituteInlinedArguments(char*, unsigned int, unsigned short*, unsigned short*, int);
+static void removeCalledFunction(char**, int*, char*);
+static void applyCodeEdits(struct memorycontainer*, struct code_scan_state*, struct code_edit*, int);
+static int getSpecialisedBranchEdits(struct memorycontainer*, unsigned int, struct specialisation_values*, struct code_edit*);
+static int evaluateSpecialisedExpression(char*, unsigned int, struct specialisation_values*, int*, int*);
+static int evaluateSpecialisedComparison(char*, unsigned char, unsigned int, struct specialisation_values*, int*);
+static int getSpecialisedNativeValue(char*, unsigned int, struct specialisation_values*, int*, int*);
+static struct code_edit* appendCodeEdit(struct code_edit*, int*, int*, unsigned int, unsigned int, struct memorycontainer*);
+static void keepCodeSize(struct code_edit*, int*);
+static int hoistLoopInvariantsOutOfLoop(struct memorycontainer*, unsigned int, unsigned int, int, struct position_list*, int);
+static unsigned int getLoopEnd(struct memorycontainer*, unsigned int, int*);
+static unsigned int scanStatement(struct code_scan_state*, unsigned int);
+static unsigned int scanAssignmentTarget(struct code_scan_state*, unsigned int);
+static unsigned int scanStatementExpression(struct code_scan_state*, unsigned int);
+static int scanExpression(struct code_scan_state*, unsigned int);
+static void scanOperand(struct code_scan_state*, unsigned int, int);
+static void scanOpaqueExpression(struct code_scan_state*, unsigned int);
+static int isLoopInvariantVariable(struct code_scan_state*, unsigned short);
+static int isWorthHoisting(unsigned char);
+static int isSideEffectFreeNative(unsigned char);
+static int isSideEffectFreeCall(struct code_scan_state*, unsigned int);
+static int areLoopExpressionsEqual(struct memorycontainer*, unsigned int, unsigned int, unsigned int);
+static struct lineDefinition* findLineDefinitionAt(struct lineDefinition*, unsigned int, char);
+static void appendPositionEntry(struct position_list*, unsigned int);
+static int containsPositionEntry(struct position_list*, unsigned int);
+static void appendCalledFunction(struct function_call_tree_node*, char*);
+static void initialiseCodeScanState(struct code_scan_state*, struct memorycontainer*, int);
+static void freeCodeScanState(struct code_scan_state*);
 
 /**
  * Function entry, used for tracking recursive functions and the call tree
  */
 void enterFunction(char* fn_name) {
-	currentSymbolTableId=current_var_id;
+	current_local_slot=0;
 	isFnRecursive=0;
-	currentFunctionName=(char*) malloc(strlen(fn_name) + 1);
-	strcpy(currentFunctionName, fn_name);
-	struct function_call_tree_node * newFunctionCallNode=(struct function_call_tree_node*) malloc(sizeof(struct function_call_tree_node));
+	functionStartBytesOptimisedAway=bytesOptimisedAway;
+	currentFunctionName=arenaDuplicateString(fn_name);
+	struct function_call_tree_node * newFunctionCallNode=(struct function_call_tree_node*) arenaAllocate(sizeof(struct function_call_tree_node));
 	newFunctionCallNode->number_of_calls=0;
 	currentCall=newFunctionCallNode;
 }
 
 /**
- * Gets the total number of entries in the symbol table
+ * Gets the total number of entries in the symbol table, this is the globals followed by space for the frames of called functions
  */
 unsigned short getNumberEntriesInSymbolTable() {
-	return (current_var_id - getNumberOfSymbolEntriesNotUsed()) + (getNumberSymbolTableEntriesForRecursion()*(RECURSION_VAR_DEPTH-1));
+	return getNumberEntriesForRecursionDepth(RECURSION_VAR_DEPTH);
+}
+
+/**
+ * Gets the total number of entries in the symbol table for host interpreters, memory is not constrained here so more frames
+ * are allowed for recursive functions
+ */
+unsigned short getNumberEntriesInHostSymbolTable() {
+	return getNumberEntriesForRecursionDepth(HOST_RECURSION_VAR_DEPTH);
+}
+
+static unsigned short getNumberEntriesForRecursionDepth(int recursionDepth) {
+	int entries=current_global_slot + getNumberSymbolTableEntriesForCalledFunctions() +
+			(getNumberSymbolTableEntriesForRecursion()*(recursionDepth-1));
+	return entries > 0xFFFF ? 0xFFFF : (unsigned short) entries;
+}
+
+/**
+ * Gets the number of global variable slots, these are at the start of the symbol table
+ */
+unsigned short getNumberGlobalSymbolTableEntries() {
+	return current_global_slot;
 }
 
 /**
  * Sets the total number of entries in the symbol table
  */
 void setNumberEntriesInSymbolTable(unsigned short e) {
-	current_var_id=e;
+	current_global_slot=e;
+}
+
+/**
+ * Appends the program header, which is the number of global variable slots and is placed at the very start of the byte code
+ */
+struct memorycontainer* appendProgramHeader(void) {
+	struct memorycontainer* memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
+	memoryContainer->length=sizeof(unsigned short);
+	memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
+	memoryContainer->lineDefns=NULL;
+
+	appendVariable(memoryContainer, current_global_slot, 0);
+	return memoryContainer;
 }
 
 struct memorycontainer* appendReferenceStatement(char* identifier) {
-	struct memorycontainer* memoryContainer = (struct memorycontainer*) malloc(sizeof(struct memorycontainer));
+	struct memorycontainer* memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
 	memoryContainer->length=sizeof(unsigned char) + sizeof(unsigned short);
-	memoryContainer->data=(char*) malloc(memoryContainer->length);
+	memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
 	memoryContainer->lineDefns=NULL;
 
 	unsigned int position=0;
 
+	aliasingAssembled=1;
 	position=appendStatement(memoryContainer, REFERENCE_TOKEN, position);
-	appendVariable(memoryContainer, getVariableId(identifier, 0), position);
+	appendVariableSlot(memoryContainer, getVariableId(identifier, 0), position);
 	return memoryContainer;
 };
 
 struct memorycontainer* appendSymbolStatement(char* identifier) {
-	struct memorycontainer* memoryContainer = (struct memorycontainer*) malloc(sizeof(struct memorycontainer));
+	struct memorycontainer* memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
 	memoryContainer->length=sizeof(unsigned char) + sizeof(unsigned short);
-	memoryContainer->data=(char*) malloc(memoryContainer->length);
+	memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
 	memoryContainer->lineDefns=NULL;
 
 	unsigned int position=0;
 
+	aliasingAssembled=1;
 	position=appendStatement(memoryContainer, SYMBOL_TOKEN, position);
-	appendVariable(memoryContainer, getVariableId(identifier, 0), position);
+	appendVariableSlot(memoryContainer, getVariableId(identifier, 0), position);
 	return memoryContainer;
 };
 
 struct memorycontainer* appendAliasStatement(char* tgtidentifier, struct memorycontainer* srcExpression) {
-	struct memorycontainer* memoryContainer = (struct memorycontainer*) malloc(sizeof(struct memorycontainer));
+	struct memorycontainer* memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
 	memoryContainer->length=sizeof(unsigned char) + sizeof(unsigned short);
-	memoryContainer->data=(char*) malloc(memoryContainer->length);
+	memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
 	memoryContainer->lineDefns=NULL;
 
 	unsigned int position=0;
 
+	aliasingAssembled=1;
 	position=appendStatement(memoryContainer, ALIAS_TOKEN, position);
-	position=appendVariable(memoryContainer, getVariableId(tgtidentifier, 0), position);
-	memoryContainer=concatenateMemory(memoryContainer, srcExpression);
+	position=appendVariableSlot(memoryContainer, getVariableId(tgtidentifier, 0), position);
+	memoryContainer=concatenateMemory(memoryContainer, compileExpression(srcExpression, 0));
 	return memoryContainer;
 };
 
 struct memorycontainer* appendNativeCallFunctionStatement(char* functionName, struct stack_t* args, struct memorycontainer* singleArg) {
-    struct memorycontainer* memoryContainer = (struct memorycontainer*) malloc(sizeof(struct memorycontainer));
+    struct memorycontainer* memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
 	memoryContainer->length=(sizeof(unsigned char)*2) + sizeof(unsigned short);
-	memoryContainer->data=(char*) malloc(memoryContainer->length);
+	memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
 	memoryContainer->lineDefns=NULL;
 
 	unsigned int position=0;
@@ -249,6 +441,10 @@ struct memorycontainer* appendNativeCallFunctionStatement(char* functionName, st
 				unsigned char command=NATIVE_FN_RTL_ARRAYCOPY;
 				unsigned char args=0b10100000;
 				position=appendStatement(memoryContainer, args | command, position);
+		} else if (strcmp(functionName, NATIVE_RTL_SIZE_STR)==0) {
+				unsigned char command=NATIVE_FN_RTL_SIZE;
+				unsigned char args=0b00100000;
+				position=appendStatement(memoryContainer, args | command, position);
     } else {
         fprintf(stderr, "Native function call of '%s' is not found\n", functionName);
         exit(EXIT_FAILURE);
@@ -260,10 +456,10 @@ struct memorycontainer* appendNativeCallFunctionStatement(char* functionName, st
         int i;
         for (i=0;i<numArgs;i++) {
             struct memorycontainer* expression=getExpressionAt(args, i);
-            memoryContainer=concatenateMemory(memoryContainer, expression);
+            memoryContainer=concatenateMemory(memoryContainer, compileExpression(expression, 0));
         }
     }
-    if (singleArg != NULL) memoryContainer=concatenateMemory(memoryContainer, singleArg);
+    if (singleArg != NULL) memoryContainer=concatenateMemory(memoryContainer, compileExpression(singleArg, 0));
 	return memoryContainer;
 }
 
@@ -272,6 +468,11 @@ struct memorycontainer* appendNativeCallFunctionStatement(char* functionName, st
  * which is needed as the function might appear at any point
  */
 struct memorycontainer* appendCallFunctionStatement(char* functionName, struct stack_t* args) {
+	struct memorycontainer* linkedModuleCode=getLinkedModuleImportCode(functionName);
+	if (linkedModuleCode != NULL) {
+		clearStack(args);
+		return linkedModuleCode;
+	}
 	char * last_dot=strrchr(functionName,'.');
 	if (last_dot != NULL) functionName=last_dot+1;
 	if (currentFunctionName != NULL && strcmp(currentFunctionName, functionName) == 0) isFnRecursive=1;
@@ -289,32 +490,30 @@ struct memorycontainer* appendCallFunctionStatement(char* functionName, struct s
 			isArgIdentifier[i]=0;
 			sprintf(varname,"%s#%d", functionName, i);
 			if (assignmentContainer == NULL) {
-				assignmentContainer=appendLetStatement(createIdentifierExpression(varname, 1), getExpressionAt(args, i));
+				assignmentContainer=appendExpressionLetStatement(createIdentifierExpression(varname, 1), getExpressionAt(args, i));
 			} else {
-				assignmentContainer=concatenateMemory(assignmentContainer, appendLetStatement(createIdentifierExpression(varname, 1), getExpressionAt(args, i)));
+				assignmentContainer=concatenateMemory(assignmentContainer, appendExpressionLetStatement(createIdentifierExpression(varname, 1), getExpressionAt(args, i)));
 			}
 		} else {
 			isArgIdentifier[i]=1;
 			varIds[i]=*((unsigned short*) (&((char*) expression->data)[1]));
-			free(expression->data);
 		}
 	}
-	struct memorycontainer* memoryContainer = (struct memorycontainer*) malloc(sizeof(struct memorycontainer));
+	struct memorycontainer* memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
 	memoryContainer->length=sizeof(unsigned short)*(2+numArgs)+sizeof(unsigned char);
-	memoryContainer->data=(char*) malloc(memoryContainer->length);
+	memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
     unsigned int position=0;
 
 	if (doesVariableExist(functionName)) {
         memoryContainer->lineDefns=NULL;
         position=appendStatement(memoryContainer, FNCALL_BY_VAR_TOKEN, position);
-        position=appendVariable(memoryContainer, getVariableId(functionName, 0), position);
+        position=appendVariableSlot(memoryContainer, getVariableId(functionName, 0), position);
 	} else {
-        struct lineDefinition * defn = (struct lineDefinition*) malloc(sizeof(struct lineDefinition));
+        struct lineDefinition * defn = (struct lineDefinition*) arenaAllocate(sizeof(struct lineDefinition));
         defn->next=NULL;
         defn->type=3;
         defn->linenumber=line_num;
-        defn->name=(char*) malloc(strlen(functionName)+1);
-        strcpy(defn->name, functionName);
+        defn->name=arenaDuplicateString(functionName);
         defn->currentpoint=sizeof(unsigned char);
 
         memoryContainer->lineDefns=defn;
@@ -326,23 +525,17 @@ struct memorycontainer* appendCallFunctionStatement(char* functionName, struct s
 
 	for (i=0;i<numArgs;i++) {
 		if (isArgIdentifier[i]) {
-			position=appendVariable(memoryContainer, varIds[i], position);
+			position=appendVariableSlot(memoryContainer, varIds[i], position);
 		} else {
 			sprintf(varname,"%s#%d", functionName, i);
-			position=appendVariable(memoryContainer, getVariableId(varname, 0), position);
+			position=appendVariableSlot(memoryContainer, getVariableId(varname, 0), position);
 		}
 	}
 	clearStack(args);
 	free(varname);
 	free(isArgIdentifier);
 	free(varIds);
-	if (currentCall==NULL) {
-		mainCodeCallTree.calledFunctions[mainCodeCallTree.number_of_calls]=(char*)malloc(strlen(functionName)+1);
-		strcpy(mainCodeCallTree.calledFunctions[mainCodeCallTree.number_of_calls++], functionName);
-	} else {
-		currentCall->calledFunctions[currentCall->number_of_calls]=(char*)malloc(strlen(functionName)+1);
-		strcpy(currentCall->calledFunctions[currentCall->number_of_calls++], functionName);
-	}
+	appendCalledFunction(currentCall == NULL ? &mainCodeCallTree : currentCall, functionName);
 	if (assignmentContainer != NULL) {
 		return concatenateMemory(assignmentContainer, memoryContainer);
 	} else {
@@ -356,10 +549,10 @@ struct memorycontainer* appendCallFunctionStatement(char* functionName, struct s
  * which is needed as we might be jumping forward and have not yet encountered the line label
  */
 struct memorycontainer* appendGotoStatement(int lineNumber) {
-	struct lineDefinition * defn = (struct lineDefinition*) malloc(sizeof(struct lineDefinition));
-	struct memorycontainer* memoryContainer = (struct memorycontainer*) malloc(sizeof(struct memorycontainer));
+	struct lineDefinition * defn = (struct lineDefinition*) arenaAllocate(sizeof(struct lineDefinition));
+	struct memorycontainer* memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
 	memoryContainer->length=sizeof(unsigned short)+sizeof(unsigned char);
-	memoryContainer->data=(char*) malloc(memoryContainer->length);
+	memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
 
 	defn->next=NULL;
 	defn->type=1;
@@ -376,39 +569,93 @@ struct memorycontainer* appendGotoStatement(int lineNumber) {
  * termination check at each iteration along with jumping to next iteration if applicable
  */
 struct memorycontainer* appendForStatement(char * identifier, struct memorycontainer* exp, struct memorycontainer* block) {
+	struct memorycontainer* rangeArguments[3];
+	int numberRangeArguments=extractRangeArguments(exp, rangeArguments);
+	if (numberRangeArguments > 0) return appendForRangeStatement(identifier, rangeArguments, numberRangeArguments, block);
+
+	// The array is evaluated once on entry and held, along with the trip count which is set on the first iteration
+	exp=compileExpression(exp, 0);
 	struct memorycontainer* initialLet=appendLetStatement(createIdentifierExpression("epy_i_ctr", 1), createIntegerExpression(0));
+	initialLet=concatenateMemory(initialLet, appendLetStatement(createIdentifierExpression("epy_i_arr", 1), exp));
 	struct memorycontainer* variantLet=appendLetStatement(createIdentifierExpression(identifier, 1), createIntegerExpression(0));
-	struct memorycontainer* incrementLet=appendLetStatement(createIdentifierExpression("epy_i_ctr", 1), createAddExpression(createIdentifierExpression("epy_i_ctr", 1), createIntegerExpression(1)));
 
-	struct memorycontainer* memoryContainer = (struct memorycontainer*) malloc(sizeof(struct memorycontainer));
-	memoryContainer->length=sizeof(unsigned char)*2+sizeof(unsigned short) * 4 + exp->length + (block != NULL ? block->length : 0) +
-			initialLet->length + variantLet->length + incrementLet->length;
-	memoryContainer->data=(char*) malloc(memoryContainer->length);
+	struct memorycontainer* memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
+	memoryContainer->length=sizeof(unsigned char)*2+sizeof(unsigned short) * 6 + (block != NULL ? block->length : 0) +
+			initialLet->length + variantLet->length;
+	memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
 	memoryContainer->lineDefns=NULL;
 
-	struct memorycontainer* combinedBlock=block != NULL ? concatenateMemory(block, incrementLet) : incrementLet;
-
 	unsigned int position=0;
 
-	struct lineDefinition * defn = (struct lineDefinition*) malloc(sizeof(struct lineDefinition));
+	struct lineDefinition * defn = (struct lineDefinition*) arenaAllocate(sizeof(struct lineDefinition));
 	defn->next=memoryContainer->lineDefns;
 	defn->type=0;
 	defn->linenumber=currentForLine;
-	defn->currentpoint=initialLet->length;
+	defn->currentpoint=initialLet->length + variantLet->length;
 	memoryContainer->lineDefns=defn;
 
 	position=appendMemory(memoryContainer, initialLet, position);
 	position=appendMemory(memoryContainer, variantLet, position);
 	position=appendStatement(memoryContainer, FOR_TOKEN, position);
-	position=appendVariable(memoryContainer, getVariableId("epy_i_ctr", 0), position);
-	position=appendVariable(memoryContainer, getVariableId(identifier, 0), position);
-	position=appendMemory(memoryContainer, exp, position);
-	unsigned short length=(unsigned short) combinedBlock->length;
+	position=appendVariableSlot(memoryContainer, getVariableId("epy_i_ctr", 0), position);
+	position=appendVariableSlot(memoryContainer, getVariableId(identifier, 0), position);
+	position=appendVariableSlot(memoryContainer, getVariableId("epy_i_arr", 0), position);
+	position=appendVariableSlot(memoryContainer, getVariableId("epy_i_len", 1), position);
+	unsigned short length=(unsigned short) (block != NULL ? block->length : 0);
+	memcpy(&memoryContainer->data[position], &length, sizeof(unsigned short));
+	position+=sizeof(unsigned short);
+	if (block != NULL) position=appendMemory(memoryContainer, block, position);
+	position=appendStatement(memoryContainer, GOTO_TOKEN, position);
+	defn = (struct lineDefinition*) arenaAllocate(sizeof(struct lineDefinition));
+	defn->next=memoryContainer->lineDefns;
+	defn->type=1;
+	defn->linenumber=currentForLine;
+	defn->currentpoint=position;
+	memoryContainer->lineDefns=defn;
+	currentForLine--;
+	return memoryContainer;
+}
+
+/**
+ * Appends a counted loop for iterating over range(stop), range(start, stop) or range(start, stop, step). As with the range function
+ * the stop value is inclusive, the current value, stop and step are held in loop state so no array is created
+ */
+static struct memorycontainer* appendForRangeStatement(char * identifier, struct memorycontainer** rangeArguments,
+		int numberRangeArguments, struct memorycontainer* block) {
+	struct memorycontainer* startExpression=numberRangeArguments == 1 ? createIntegerExpression(0) : rangeArguments[0];
+	struct memorycontainer* stopExpression=numberRangeArguments == 1 ? rangeArguments[0] : rangeArguments[1];
+	struct memorycontainer* stepExpression=numberRangeArguments == 3 ? rangeArguments[2] : createIntegerExpression(1);
+	struct memorycontainer* initialLet=appendLetStatement(createIdentifierExpression("epy_i_ctr", 1), startExpression);
+	initialLet=concatenateMemory(initialLet, appendLetStatement(createIdentifierExpression("epy_i_stop", 1), stopExpression));
+	initialLet=concatenateMemory(initialLet, appendLetStatement(createIdentifierExpression("epy_i_step", 1), stepExpression));
+	initialLet=concatenateMemory(initialLet, appendLetStatement(createIdentifierExpression(identifier, 1), createIntegerExpression(0)));
+
+	struct memorycontainer* memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
+	memoryContainer->length=sizeof(unsigned char)*2+sizeof(unsigned short) * 6 + (block != NULL ? block->length : 0) + initialLet->length;
+	memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
+	memoryContainer->lineDefns=NULL;
+
+	unsigned int position=0;
+
+	struct lineDefinition * defn = (struct lineDefinition*) arenaAllocate(sizeof(struct lineDefinition));
+	defn->next=memoryContainer->lineDefns;
+	defn->type=0;
+	defn->linenumber=currentForLine;
+	defn->currentpoint=initialLet->length;
+	memoryContainer->lineDefns=defn;
+
+	position=appendMemory(memoryContainer, initialLet, position);
+	position=appendStatement(memoryContainer, FOR_RANGE_TOKEN, position);
+	position=appendVariableSlot(memoryContainer, getVariableId("epy_i_ctr", 0), position);
+	position=appendVariableSlot(memoryContainer, getVariableId(identifier, 0), position);
+	position=appendVariableSlot(memoryContainer, getVariableId("epy_i_stop", 0), position);
+	position=appendVariableSlot(memoryContainer, getVariableId("epy_i_step", 0), position);
+	unsigned short length=(unsigned short) (block != NULL ? block->length : 0);
 	memcpy(&memoryContainer->data[position], &length, sizeof(unsigned short));
 	position+=sizeof(unsigned short);
-	position=appendMemory(memoryContainer, combinedBlock, position);
+	if (block != NULL) position=appendMemory(memoryContainer, block, position);
 	position=appendStatement(memoryContainer, GOTO_TOKEN, position);
-	defn = (struct lineDefinition*) malloc(sizeof(struct lineDefinition));
+	defn = (struct lineDefinition*) arenaAllocate(sizeof(struct lineDefinition));
 	defn->next=memoryContainer->lineDefns;
 	defn->type=1;
 	defn->linenumber=currentForLine;
@@ -418,39 +665,169 @@ struct memorycontainer* appendForStatement(char * identifier, struct memoryconta
 	return memoryContainer;
 }
 
+/**
+ * Determines whether the expression a loop iterates over is a call to range (or xrange) and if so extracts the argument
+ * expressions, returning the number of these. The call is made up of assignments of any arguments which are not plain variables to
+ * temporaries, followed by the call itself, and on success the call to range is dropped
+ */
+static int extractRangeArguments(struct memorycontainer* expression, struct memorycontainer** rangeArguments) {
+	struct lineDefinition * defn, *callDefn=NULL;
+	for (defn=expression->lineDefns;defn != NULL;defn=defn->next) {
+		if (defn->type == 3 && isCountedRangeFunction(defn->name)) {
+			if (callDefn == NULL || defn->currentpoint > callDefn->currentpoint) callDefn=defn;
+		}
+	}
+	if (callDefn == NULL) return 0;
+	unsigned int i, j, position=0, callPosition=callDefn->currentpoint-sizeof(unsigned char);
+	unsigned short numberArguments, argumentSlot;
+	if (((unsigned char*) expression->data)[callPosition] != FNCALL_TOKEN) return 0;
+	memcpy(&numberArguments, &expression->data[callPosition+sizeof(unsigned char)+sizeof(unsigned short)], sizeof(unsigned short));
+	if (numberArguments < 1 || numberArguments > 3 ||
+			callPosition + sizeof(unsigned char) + sizeof(unsigned short) * (2+numberArguments) != expression->length) return 0;
+
+	unsigned int temporaryStart[3], temporaryLength[3];
+	unsigned short temporarySlot[3];
+	int numberTemporaries=0;
+	while (position < callPosition) {
+		if (((unsigned char*) expression->data)[position] != LET_TOKEN || numberTemporaries == 3 ||
+				((unsigned char*) expression->data)[position+sizeof(unsigned char)] != IDENTIFIER_TOKEN) return 0;
+		memcpy(&temporarySlot[numberTemporaries], &expression->data[position+sizeof(unsigned char)*2], sizeof(unsigned short));
+		position+=sizeof(unsigned char)*2 + sizeof(unsigned short);
+		temporaryStart[numberTemporaries]=position;
+		temporaryLength[numberTemporaries]=getExpressionLength(expression->data, position);
+		position+=temporaryLength[numberTemporaries++];
+	}
+	if (position != callPosition) return 0;
+
+	for (i=0;i<numberArguments;i++) {
+		memcpy(&argumentSlot, &expression->data[callPosition+sizeof(unsigned char)+sizeof(unsigned short)*(2+i)], sizeof(unsigned short));
+		rangeArguments[i]=NULL;
+		for (j=0;j<(unsigned int) numberTemporaries;j++) {
+			if (temporarySlot[j] == argumentSlot) {
+				rangeArguments[i]=extractExpression(expression, temporaryStart[j], temporaryLength[j]);
+			}
+		}
+		if (rangeArguments[i] == NULL) {
+			rangeArguments[i] = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
+			rangeArguments[i]->length=sizeof(unsigned char)+sizeof(unsigned short);
+			rangeArguments[i]->data=(char*) arenaAllocate(rangeArguments[i]->length);
+			rangeArguments[i]->lineDefns=NULL;
+			appendVariableSlot(rangeArguments[i], argumentSlot, appendStatement(rangeArguments[i], IDENTIFIER_TOKEN, 0));
+		}
+	}
+	return numberArguments;
+}
+
+/**
+ * Records where a function is defined, this is called as each function is parsed or linked in from a module object. The source
+ * file is NULL if it is not known, such as when the source code is piped in
+ */
+void addFunctionSource(char * functionName, char * filename) {
+	int index=getRangeFunctionIndex(functionName);
+	if (index < 0) return;
+	char * basename=filename != NULL ? strrchr(filename, '/') : NULL;
+	basename=basename != NULL ? basename + 1 : filename;
+	rangeFunctionSources[index]|=basename != NULL && strcmp(basename, UTIL_MODULE_FILENAME) == 0 ? UTIL_MODULE_SOURCE : OTHER_SOURCE;
+}
+
+/**
+ * Determines whether a call is to the range or xrange function of the util module, which loops are run as counted loops in place
+ * of. This is not the case if the program defines a function of the same name itself, which the call might then resolve to
+ */
+static int isCountedRangeFunction(char * functionName) {
+	int index=getRangeFunctionIndex(functionName);
+	return index >= 0 && rangeFunctionSources[index] == UTIL_MODULE_SOURCE;
+}
+
+/**
+ * Gets the index of range (0) or xrange (1), or -1 if the function is neither of these
+ */
+static int getRangeFunctionIndex(char * functionName) {
+	if (strcmp(functionName, "range") == 0) return 0;
+	if (strcmp(functionName, "xrange") == 0) return 1;
+	return -1;
+}
+
+/**
+ * Extracts part of an expression into a new memory container, moving across any line definitions which fall within it
+ */
+static struct memorycontainer* extractExpression(struct memorycontainer* source, unsigned int position, unsigned int length) {
+	struct memorycontainer* memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
+	memoryContainer->length=length;
+	memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
+	memoryContainer->lineDefns=NULL;
+	memcpy(memoryContainer->data, &source->data[position], length);
+	moveLineDefinitions(&source->lineDefns, position, length, &memoryContainer->lineDefns, 0);
+	return memoryContainer;
+}
+
+/**
+ * Moves the line definitions which fall within some part of the source code across to the target list, for code which has been
+ * copied from this part to some position in the target
+ */
+static void moveLineDefinitions(struct lineDefinition** source, unsigned int position, unsigned int length,
+		struct lineDefinition** target, unsigned int targetPosition) {
+	struct lineDefinition * moved;
+	while (*source != NULL) {
+		if ((*source)->currentpoint >= (int) position && (*source)->currentpoint < (int) (position + length)) {
+			moved=*source;
+			*source=moved->next;
+			moved->currentpoint=(moved->currentpoint - position) + targetPosition;
+			moved->next=*target;
+			*target=moved;
+		} else {
+			source=&(*source)->next;
+		}
+	}
+}
+
 /**
  * Appends in a do while statement, which assembles down to an if statement with jump at the end of the block
  * to retest the condition and either do another iteration or not
  */
 struct memorycontainer* appendWhileStatement(struct memorycontainer* expression, struct memorycontainer* block) {
-	struct memorycontainer* memoryContainer = (struct memorycontainer*) malloc(sizeof(struct memorycontainer));
-	memoryContainer->length=sizeof(unsigned char)+sizeof(unsigned short) * 3 + expression->length + (block != NULL ? block->length : 0);
-	memoryContainer->data=(char*) malloc(memoryContainer->length);
+	int constantCondition=getConstantCondition(expression);
+	if (constantCondition == 0) {
+		// The loop is never entered so is removed
+		discardMemory(expression);
+		discardMemory(block);
+		bytesOptimisedAway+=sizeof(unsigned char)*2+sizeof(unsigned short)*2;
+		return NULL;
+	}
+	int compareAndBranch=constantCondition < 0 && isCompareAndBranchCondition(expression);
+	if (constantCondition > 0) {
+		// The loop never ends by its condition, so this is not tested and the block just jumps back to its start
+		discardMemory(expression);
+		bytesOptimisedAway+=sizeof(unsigned char)+sizeof(unsigned short);
+		expression=NULL;
+	} else if (!compareAndBranch) {
+		expression=compileExpression(expression, 1);
+	}
+	struct memorycontainer* memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
+	memoryContainer->length=sizeof(unsigned char)+sizeof(unsigned short) + (block != NULL ? block->length : 0) +
+			(expression != NULL ? sizeof(unsigned char)+sizeof(unsigned short) + expression->length : 0);
+	memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
 	memoryContainer->lineDefns=NULL;
 
 	unsigned int position=0;
-	position=appendStatement(memoryContainer, IF_TOKEN, position);
-	position=appendMemory(memoryContainer, expression, position);
-	if (block != NULL) {
-		unsigned short blockLen=(unsigned short) block->length + 4;
-		memcpy(&memoryContainer->data[position], &blockLen, sizeof(unsigned short));
-		position+=sizeof(unsigned short);
-		position=appendMemory(memoryContainer, block, position);
-	} else {
-		unsigned short blockLen=4;
+	if (expression != NULL) {
+		unsigned short blockLen=(unsigned short) (block != NULL ? block->length : 0) + 3;
+		position=appendStatement(memoryContainer, compareAndBranch ? IF_COMPARE_TOKEN : IF_TOKEN, position);
+		position=appendMemory(memoryContainer, expression, position);
 		memcpy(&memoryContainer->data[position], &blockLen, sizeof(unsigned short));
 		position+=sizeof(unsigned short);
 	}
+	if (block != NULL) position=appendMemory(memoryContainer, block, position);
 	position=appendStatement(memoryContainer, GOTO_TOKEN, position);
 
-	struct lineDefinition * defn = (struct lineDefinition*) malloc(sizeof(struct lineDefinition));
+	struct lineDefinition * defn = (struct lineDefinition*) arenaAllocate(sizeof(struct lineDefinition));
 	defn->next=memoryContainer->lineDefns;
 	defn->type=0;
 	defn->linenumber=currentForLine;
 	defn->currentpoint=0;
 	memoryContainer->lineDefns=defn;
 
-	defn = (struct lineDefinition*) malloc(sizeof(struct lineDefinition));
+	defn = (struct lineDefinition*) arenaAllocate(sizeof(struct lineDefinition));
 	defn->next=memoryContainer->lineDefns;
 	defn->type=1;
 	defn->linenumber=currentForLine;
@@ -465,14 +842,25 @@ struct memorycontainer* appendWhileStatement(struct memorycontainer* expression,
  * Appends and returns a conditional, this is without an else statement so sets that to be zero
  */
 struct memorycontainer* appendIfStatement(struct memorycontainer* expressionContainer, struct memorycontainer* thenBlock) {
-	struct memorycontainer* memoryContainer = (struct memorycontainer*) malloc(sizeof(struct memorycontainer));
+	int constantCondition=getConstantCondition(expressionContainer);
+	if (constantCondition >= 0) {
+		// The condition is known so the block is either always run, or is unreachable and removed
+		discardMemory(expressionContainer);
+		bytesOptimisedAway+=sizeof(unsigned char)+sizeof(unsigned short);
+		if (constantCondition) return thenBlock;
+		discardMemory(thenBlock);
+		return NULL;
+	}
+	int compareAndBranch=isCompareAndBranchCondition(expressionContainer);
+	if (!compareAndBranch) expressionContainer=compileExpression(expressionContainer, 1);
+	struct memorycontainer* memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
 	memoryContainer->length=sizeof(unsigned char)+sizeof(unsigned short) + expressionContainer->length +
 			(thenBlock != NULL ? thenBlock->length : 0);
-	memoryContainer->data=(char*) malloc(memoryContainer->length);
+	memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
 	memoryContainer->lineDefns=NULL;
 
 	unsigned int position=0;
-	position=appendStatement(memoryContainer, IF_TOKEN, position);
+	position=appendStatement(memoryContainer, compareAndBranch ? IF_COMPARE_TOKEN : IF_TOKEN, position);
 	position=appendMemory(memoryContainer, expressionContainer, position);
 	if (thenBlock != NULL) {
 		unsigned short len=(unsigned short) thenBlock->length;
@@ -492,14 +880,24 @@ struct memorycontainer* appendIfStatement(struct memorycontainer* expressionCont
  */
 struct memorycontainer* appendIfElseStatement(struct memorycontainer* expressionContainer, struct memorycontainer* thenBlock,
 		struct memorycontainer* elseBlock) {
-	struct memorycontainer* memoryContainer = (struct memorycontainer*) malloc(sizeof(struct memorycontainer));
+	int constantCondition=getConstantCondition(expressionContainer);
+	if (constantCondition >= 0) {
+		// The condition is known so only the block which is run is kept, along with none of the branching
+		discardMemory(expressionContainer);
+		discardMemory(constantCondition ? elseBlock : thenBlock);
+		bytesOptimisedAway+=sizeof(unsigned char)*2+sizeof(unsigned short)*2;
+		return constantCondition ? thenBlock : elseBlock;
+	}
+	int compareAndBranch=isCompareAndBranchCondition(expressionContainer);
+	if (!compareAndBranch) expressionContainer=compileExpression(expressionContainer, 1);
+	struct memorycontainer* memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
 	memoryContainer->length=sizeof(unsigned char)*2+sizeof(unsigned short)*2 + expressionContainer->length +
 			(thenBlock != NULL ? thenBlock->length : 0) + (elseBlock != NULL ? elseBlock->length : 0);
-	memoryContainer->data=(char*) malloc(memoryContainer->length);
+	memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
 	memoryContainer->lineDefns=NULL;
 
 	unsigned int position=0;
-	position=appendStatement(memoryContainer, IFELSE_TOKEN, position);
+	position=appendStatement(memoryContainer, compareAndBranch ? IF_COMPARE_TOKEN : IFELSE_TOKEN, position);
 	position=appendMemory(memoryContainer, expressionContainer, position);
 
 	unsigned short combinedThenGotoLength=(unsigned short) (thenBlock != NULL ? thenBlock->length : 0)+3;	// add for goto and line num
@@ -510,7 +908,7 @@ struct memorycontainer* appendIfElseStatement(struct memorycontainer* expression
 		position=appendMemory(memoryContainer, thenBlock, position);
 	}
 	position=appendStatement(memoryContainer, GOTO_TOKEN, position);
-	struct lineDefinition * defn = (struct lineDefinition*) malloc(sizeof(struct lineDefinition));
+	struct lineDefinition * defn = (struct lineDefinition*) arenaAllocate(sizeof(struct lineDefinition));
 	defn->next=memoryContainer->lineDefns;
 	defn->type=1;
 	defn->linenumber=currentForLine;
@@ -519,7 +917,7 @@ struct memorycontainer* appendIfElseStatement(struct memorycontainer* expression
 	position+=sizeof(unsigned short);
 	if (elseBlock != NULL) position=appendMemory(memoryContainer, elseBlock, position);
 
-	defn = (struct lineDefinition*) malloc(sizeof(struct lineDefinition));
+	defn = (struct lineDefinition*) arenaAllocate(sizeof(struct lineDefinition));
 	defn->next=memoryContainer->lineDefns;
 	defn->type=0;
 	defn->linenumber=currentForLine;
@@ -540,15 +938,13 @@ void appendArgument(char* argName) {
  * the current goto point as the function name
  */
 void appendNewFunctionStatement(char* functionName, struct stack_t * args, struct memorycontainer* functionContents) {
-	struct functionDefinition * fn=(struct functionDefinition*) malloc(sizeof(struct functionDefinition));
-	fn->name=(char*) malloc(strlen(functionName) + 1);
-	strcpy(fn->name, functionName);
-	fn->called=0;
+	struct memory_arena * previousArena;
 
+	// The function header is the number of arguments, size of the function's frame and then the argument slots
 	unsigned short numberArgs=(unsigned short) getStackSize(args);
-	struct memorycontainer* numberArgsContainer = (struct memorycontainer*) malloc(sizeof(struct memorycontainer));
-	numberArgsContainer->length=sizeof(unsigned short) * (numberArgs + 1);
-	numberArgsContainer->data=(char*) malloc(sizeof(unsigned short) * (numberArgs + 1));
+	struct memorycontainer* numberArgsContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
+	numberArgsContainer->length=sizeof(unsigned short) * (numberArgs + 2);
+	numberArgsContainer->data=(char*) arenaAllocate(sizeof(unsigned short) * (numberArgs + 2));
 	numberArgsContainer->lineDefns=NULL;
 
 	((unsigned short *) numberArgsContainer->data)[0]=numberArgs;
@@ -558,7 +954,7 @@ void appendNewFunctionStatement(char* functionName, struct stack_t * args, struc
 	int i;
 	for (i=0;i<numberArgs;i++) {
 		if (getTypeAt(args, i) == 2) {
-			((unsigned short *) numberArgsContainer->data)[i+1]=getVariableId(getIdentifierAt(args, i), 1);
+			((unsigned short *) numberArgsContainer->data)[i+2]=getVariableId(getIdentifierAt(args, i), 1);
 		} else {
 			struct identifier_exp * idexp=getExpressionIdentifierAt(args, i);
 			if (assignmentContainer == NULL) {
@@ -566,47 +962,75 @@ void appendNewFunctionStatement(char* functionName, struct stack_t * args, struc
 			} else {
 				assignmentContainer=concatenateMemory(assignmentContainer, appendLetIfNoAliasStatement(createIdentifierExpression(idexp->identifier,0), idexp->exp));
 			}
-			((unsigned short *) numberArgsContainer->data)[i+1]=getVariableId(idexp->identifier, 1);
+			((unsigned short *) numberArgsContainer->data)[i+2]=getVariableId(idexp->identifier, 1);
 		}
 	}
 
 	clearStack(args);
 
+	// All the function's variables have been encountered by now so the frame size is known
+	((unsigned short *) numberArgsContainer->data)[1]=current_local_slot;
+
 	if (assignmentContainer != NULL) numberArgsContainer=concatenateMemory(numberArgsContainer, assignmentContainer);
 
 	struct memorycontainer* completedFunction=concatenateMemory(concatenateMemory(numberArgsContainer, functionContents),
 			appendReturnStatement());
 
-	struct lineDefinition * defn = (struct lineDefinition*) malloc(sizeof(struct lineDefinition));
+	struct lineDefinition * defn = (struct lineDefinition*) arenaAllocate(sizeof(struct lineDefinition));
 	defn->next=completedFunction->lineDefns;
 	defn->type=2;
 	defn->currentpoint=0;
-	defn->name=(char*) malloc(strlen(functionName) + 1);
-	strcpy(defn->name, functionName);
+	defn->name=functionName;
 	completedFunction->lineDefns=defn;
 
-	fn->contents=completedFunction;
-	fn->numberEntriesInSymbolTable=current_var_id - currentSymbolTableId;
+	// The function outlives the scratch arena, if any, that its body was assembled in so is copied out into the retained arena
+	previousArena=setRetainedArena();
+	struct functionDefinition * fn=(struct functionDefinition*) arenaAllocate(sizeof(struct functionDefinition));
+	fn->name=arenaDuplicateString(functionName);
+	fn->called=0;
+	fn->contents=cloneMemoryWithLineDefinitions(completedFunction);
+
+	// A function which just returns the result of a side effect free native function, such as coreid(), can be hoisted out of loops
+	fn->sideEffectFree=numberArgs == 0 && functionContents != NULL &&
+			functionContents->length == sizeof(unsigned char)*3+sizeof(unsigned short) && functionContents->data[0] == RETURN_EXP_TOKEN &&
+			functionContents->data[1] == NATIVE_TOKEN && isSideEffectFreeNative(functionContents->data[2]) &&
+			functionContents->data[3] == 0 && functionContents->data[4] == 0;
+
+	// A small function which just runs a native function, or returns an expression of its arguments, is inlined at call sites
+	fn->inlineBody=NULL;
+	if (assignmentContainer == NULL && functionContents != NULL && !hasLocationLineDefinitions(functionContents)) {
+		fn->inlineBody=getInlineableBody(functionContents->data, functionContents->length,
+				(unsigned short*) &fn->contents->data[sizeof(unsigned short)*2], numberArgs);
+	}
+
+	fn->numberEntriesInSymbolTable=current_local_slot;
 	fn->recursive=isFnRecursive;
 	fn->number_of_fn_calls=currentCall->number_of_calls;
+	fn->bytesOptimisedAway=bytesOptimisedAway-functionStartBytesOptimisedAway;
 	if (fn_decorator != NULL) {
-		if (strcmp(fn_decorator, "exportable")==0) {
-			mainCodeCallTree.calledFunctions[mainCodeCallTree.number_of_calls]=(char*)malloc(strlen(functionName)+1);
-			strcpy(mainCodeCallTree.calledFunctions[mainCodeCallTree.number_of_calls++], functionName);
-		}
-		free(fn_decorator);
+		if (strcmp(fn_decorator, "exportable")==0) appendCalledFunction(&mainCodeCallTree, functionName);
 		fn_decorator=NULL;
 	}
 	if (currentCall->number_of_calls == 0) {
 		fn->functionCalls=NULL;
 	} else {
-		fn->functionCalls=(char**) malloc(sizeof(char*) * currentCall->number_of_calls);
+		fn->functionCalls=(char**) arenaAllocate(sizeof(char*) * currentCall->number_of_calls);
 		memcpy(fn->functionCalls, currentCall->calledFunctions, sizeof(char*) * currentCall->number_of_calls);
 	}
-	free(currentFunctionName);
+	addFunction(fn);
+	setCurrentArena(previousArena);
 	currentFunctionName=NULL;
 	currentCall=NULL;
-	addFunction(fn);
+}
+
+/**
+ * Records that a function is called from the main code or a function, the name of this is kept until the program is linked so
+ * it is allocated from the retained arena
+ */
+static void appendCalledFunction(struct function_call_tree_node * callNode, char * functionName) {
+	struct memory_arena * previousArena=setRetainedArena();
+	callNode->calledFunctions[callNode->number_of_calls++]=arenaDuplicateString(functionName);
+	setCurrentArena(previousArena);
 }
 
 /**
@@ -614,15 +1038,15 @@ void appendNewFunctionStatement(char* functionName, struct stack_t * args, struc
  */
 struct memorycontainer* appendArraySetStatement( char* identifier, struct stack_t* indexContainer,
 		struct memorycontainer* expressionContainer) {
-	struct memorycontainer* memoryContainer = (struct memorycontainer*) malloc(sizeof(struct memorycontainer));
+	struct memorycontainer* memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
 	memoryContainer->length=(sizeof(unsigned char)*2)+sizeof(unsigned short);
-	memoryContainer->data=(char*) malloc(memoryContainer->length);
+	memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
 	memoryContainer->lineDefns=NULL;
 
 	unsigned int position=0;
 
 	position=appendStatement(memoryContainer, ARRAYSET_TOKEN, position);
-	position=appendVariable(memoryContainer, getVariableId(identifier, 1), position);
+	position=appendVariableSlot(memoryContainer, getVariableId(identifier, 1), position);
 
 	unsigned char numIndexes=(unsigned char) getStackSize(indexContainer);
 	memcpy(&memoryContainer->data[position], &numIndexes, sizeof(unsigned char));
@@ -652,7 +1076,7 @@ struct memorycontainer* appendLetWithOperatorStatement(struct memorycontainer* i
 	} else {
 		fprintf(stderr, "Can not find operator with id of %c\n", operator);
 	}
-	struct memorycontainer* identifier_clone=cloneMemory(identifier);
+	struct memorycontainer* identifier_clone=cloneMemoryWithLineDefinitions(identifier);
 	struct memorycontainer* rhs=createExpression(token, identifier, expressionContainer);
 	if (operator == 6) {
 		// Floor
@@ -666,12 +1090,24 @@ struct memorycontainer* appendLetWithOperatorStatement(struct memorycontainer* i
 }
 
 /**
- * Appends and returns a let statement which sets and declares scalars
+ * Appends and returns a let statement which sets and declares scalars, common forms of this are fused into superinstructions
  */
 struct memorycontainer* appendLetStatement(struct memorycontainer* identifier, struct memorycontainer* expressionContainer) {
-	struct memorycontainer* memoryContainer = (struct memorycontainer*) malloc(sizeof(struct memorycontainer));
+	struct memorycontainer* superinstruction=appendLetSuperinstruction(identifier, expressionContainer);
+	if (superinstruction != NULL) return superinstruction;
+	return appendExpressionLetStatement(identifier, expressionContainer);
+}
+
+/**
+ * Appends and returns a let statement which can also be held within an expression (such as setting the arguments of a function call),
+ * these are evaluated as part of the expression so are never fused into superinstructions
+ */
+static struct memorycontainer* appendExpressionLetStatement(struct memorycontainer* identifier, struct memorycontainer* expressionContainer) {
+	identifier=compileArrayAccessIndexes(identifier);
+	expressionContainer=compileExpression(expressionContainer, 0);
+	struct memorycontainer* memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
 	memoryContainer->length=identifier->length+sizeof(unsigned char) + expressionContainer->length;
-	memoryContainer->data=(char*) malloc(memoryContainer->length);
+	memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
 	memoryContainer->lineDefns=NULL;
 
 	unsigned int position=0;
@@ -683,10 +1119,115 @@ struct memorycontainer* appendLetStatement(struct memorycontainer* identifier, s
 	return memoryContainer;
 }
 
+/**
+ * Appends a superinstruction for an assignment of one of the common forms, which are incrementing a variable by a constant, loading
+ * an element of a one dimensional array into a variable and storing to an element of a one dimensional array. Constant and variable
+ * operands are held as they are encoded in expressions, NULL is returned if the assignment is not of one of these forms
+ */
+static struct memorycontainer* appendLetSuperinstruction(struct memorycontainer* identifier, struct memorycontainer* expressionContainer) {
+	unsigned char * lhs=(unsigned char*) identifier->data, * rhs=(unsigned char*) expressionContainer->data;
+	unsigned int operandLength, position=0;
+	struct memorycontainer* memoryContainer;
+	if (hasLocationLineDefinitions(identifier) || expressionContainer->length == 0) return NULL;
+	if (lhs[0] == IDENTIFIER_TOKEN && !hasLocationLineDefinitions(expressionContainer)) {
+		if ((rhs[0] == ADD_TOKEN || rhs[0] == SUB_TOKEN) && expressionContainer->length == sizeof(unsigned char)*3+sizeof(unsigned short)+sizeof(int) &&
+				rhs[1] == IDENTIFIER_TOKEN && rhs[4] == INTEGER_TOKEN && memcmp(&lhs[1], &rhs[2], sizeof(unsigned short)) == 0) {
+			// x=x+c or x=x-c, held as the variable, operator and constant
+			memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
+			memoryContainer->length=sizeof(unsigned char)*2+sizeof(unsigned short)+sizeof(int);
+			memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
+			memoryContainer->lineDefns=NULL;
+			position=appendStatement(memoryContainer, INCREMENT_TOKEN, position);
+			memcpy(&memoryContainer->data[position], &lhs[1], sizeof(unsigned short));
+			moveLineDefinitions(&identifier->lineDefns, 1, sizeof(unsigned short), &memoryContainer->lineDefns, position);
+			position+=sizeof(unsigned short);
+			position=appendStatement(memoryContainer, rhs[0], position);
+			memcpy(&memoryContainer->data[position], &rhs[5], sizeof(int));
+		} else if (rhs[0] == ARRAYACCESS_TOKEN && expressionContainer->length > sizeof(unsigned char)*2+sizeof(unsigned short) &&
+				rhs[3] == 1 && (operandLength=getSuperinstructionOperandLength(expressionContainer, 4)) > 0 &&
+				expressionContainer->length == sizeof(unsigned char)*2+sizeof(unsigned short)+operandLength) {
+			// x=a[i], held as the variable, array and index
+			memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
+			memoryContainer->length=sizeof(unsigned char)+sizeof(unsigned short)*2+operandLength;
+			memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
+			memoryContainer->lineDefns=NULL;
+			position=appendStatement(memoryContainer, LET_FROM_ARRAY_TOKEN, position);
+			memcpy(&memoryContainer->data[position], &lhs[1], sizeof(unsigned short));
+			moveLineDefinitions(&identifier->lineDefns, 1, sizeof(unsigned short), &memoryContainer->lineDefns, position);
+			position+=sizeof(unsigned short);
+			memcpy(&memoryContainer->data[position], &rhs[1], sizeof(unsigned short));
+			moveLineDefinitions(&expressionContainer->lineDefns, 1, sizeof(unsigned short), &memoryContainer->lineDefns, position);
+			position+=sizeof(unsigned short);
+			memcpy(&memoryContainer->data[position], &rhs[4], operandLength);
+			moveLineDefinitions(&expressionContainer->lineDefns, 4, operandLength, &memoryContainer->lineDefns, position);
+		} else {
+			return NULL;
+		}
+	} else if (lhs[0] == ARRAYACCESS_TOKEN && lhs[3] == 1 && (operandLength=getSuperinstructionOperandLength(identifier, 4)) > 0 &&
+			identifier->length == sizeof(unsigned char)*2+sizeof(unsigned short)+operandLength) {
+		// a[i]=expression, held as the array and index followed by the expression
+		expressionContainer=compileExpression(expressionContainer, 0);
+		memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
+		memoryContainer->length=sizeof(unsigned char)+sizeof(unsigned short)+operandLength+expressionContainer->length;
+		memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
+		memoryContainer->lineDefns=NULL;
+		position=appendStatement(memoryContainer, LET_TO_ARRAY_TOKEN, position);
+		memcpy(&memoryContainer->data[position], &lhs[1], sizeof(unsigned short));
+		moveLineDefinitions(&identifier->lineDefns, 1, sizeof(unsigned short), &memoryContainer->lineDefns, position);
+		position+=sizeof(unsigned short);
+		memcpy(&memoryContainer->data[position], &lhs[4], operandLength);
+		moveLineDefinitions(&identifier->lineDefns, 4, operandLength, &memoryContainer->lineDefns, position);
+		position+=operandLength;
+		appendMemory(memoryContainer, expressionContainer, position);
+	} else {
+		return NULL;
+	}
+	return memoryContainer;
+}
+
+/**
+ * Determines whether a condition is the comparison of two constants or variables, in which case the conditional is fused into a
+ * compare and branch superinstruction. The condition is held as it is, as its operands are encoded in the same way
+ */
+static int isCompareAndBranchCondition(struct memorycontainer* expression) {
+	unsigned char comparison=((unsigned char*) expression->data)[0];
+	unsigned int operandLength1, operandLength2;
+	if (hasLocationLineDefinitions(expression) || expression->length == 0 || comparison < EQ_TOKEN || comparison > GEQ_TOKEN) return 0;
+	operandLength1=getSuperinstructionOperandLength(expression, sizeof(unsigned char));
+	if (operandLength1 == 0) return 0;
+	operandLength2=getSuperinstructionOperandLength(expression, sizeof(unsigned char)+operandLength1);
+	return operandLength2 > 0 && expression->length == sizeof(unsigned char)+operandLength1+operandLength2;
+}
+
+/**
+ * Retrieves the length of a superinstruction operand (a variable or integer, real or boolean constant) at some position in an
+ * expression, or zero if the expression here is not one of these
+ */
+static unsigned int getSuperinstructionOperandLength(struct memorycontainer* expression, unsigned int position) {
+	if (position >= expression->length) return 0;
+	unsigned char token=((unsigned char*) expression->data)[position];
+	if (token == IDENTIFIER_TOKEN) return sizeof(unsigned char)+sizeof(unsigned short);
+	if (token == INTEGER_TOKEN || token == REAL_TOKEN || token == BOOLEAN_TOKEN) return sizeof(unsigned char)+sizeof(int);
+	return 0;
+}
+
+/**
+ * Determines whether some code holds any line definitions of locations in the code, that is other than those of global variable
+ * ids which are only recorded when a module is compiled to an object and are moved along with the ids
+ */
+static int hasLocationLineDefinitions(struct memorycontainer* code) {
+	struct lineDefinition * root;
+	for (root=code->lineDefns;root != NULL;root=root->next) {
+		if (root->type != 5) return 1;
+	}
+	return 0;
+}
+
 static struct memorycontainer* appendLetIfNoAliasStatement(struct memorycontainer* identifier, struct memorycontainer* expressionContainer) {
-	struct memorycontainer* memoryContainer = (struct memorycontainer*) malloc(sizeof(struct memorycontainer));
+	expressionContainer=compileExpression(expressionContainer, 0);
+	struct memorycontainer* memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
 	memoryContainer->length=identifier->length+sizeof(unsigned char)+ expressionContainer->length;
-	memoryContainer->data=(char*) malloc(memoryContainer->length);
+	memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
 	memoryContainer->lineDefns=NULL;
 
 	unsigned int position=0;
@@ -699,9 +1240,10 @@ static struct memorycontainer* appendLetIfNoAliasStatement(struct memorycontaine
 }
 
 struct memorycontainer* appendReturnStatementWithExpression(struct memorycontainer* expressionContainer) {
-	struct memorycontainer* memoryContainer = (struct memorycontainer*) malloc(sizeof(struct memorycontainer));
+	expressionContainer=compileExpression(expressionContainer, 0);
+	struct memorycontainer* memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
 	memoryContainer->length=sizeof(unsigned char)+expressionContainer->length;
-	memoryContainer->data=(char*) malloc(memoryContainer->length);
+	memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
 	memoryContainer->lineDefns=NULL;
 
 	unsigned int position=0;
@@ -714,9 +1256,9 @@ struct memorycontainer* appendReturnStatementWithExpression(struct memorycontain
  * Appends a return statement
  */
 struct memorycontainer* appendReturnStatement(void) {
-	struct memorycontainer* memoryContainer = (struct memorycontainer*) malloc(sizeof(struct memorycontainer));
+	struct memorycontainer* memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
 	memoryContainer->length=sizeof(unsigned char);
-	memoryContainer->data=(char*) malloc(memoryContainer->length);
+	memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
 	memoryContainer->lineDefns=NULL;
 
 	appendStatement(memoryContainer, RETURN_TOKEN, 0);
@@ -727,9 +1269,9 @@ struct memorycontainer* appendReturnStatement(void) {
  * Appends and returns a stop statement
  */
 struct memorycontainer* appendStopStatement() {
-	struct memorycontainer* memoryContainer = (struct memorycontainer*) malloc(sizeof(struct memorycontainer));
+	struct memorycontainer* memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
 	memoryContainer->length=sizeof(unsigned char);
-	memoryContainer->data=(char*) malloc(memoryContainer->length);
+	memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
 	memoryContainer->lineDefns=NULL;
 
 	appendStatement(memoryContainer, STOP_TOKEN, 0);
@@ -740,7 +1282,7 @@ struct memorycontainer* appendStopStatement() {
  * Appends and returns an empty statement for pass, this is a noop
  */
 struct memorycontainer* appendPassStatement() {
-	struct memorycontainer* memoryContainer = (struct memorycontainer*) malloc(sizeof(struct memorycontainer));
+	struct memorycontainer* memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
 	memoryContainer->length=0;
 	memoryContainer->data=NULL;
 	memoryContainer->lineDefns=NULL;
@@ -752,9 +1294,9 @@ struct memorycontainer* appendPassStatement() {
  * Creates an expression from a string
  */
 struct memorycontainer* createStringExpression(char * string) {
-	struct memorycontainer* memoryContainer = (struct memorycontainer*) malloc(sizeof(struct memorycontainer));
+	struct memorycontainer* memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
 	memoryContainer->length=strlen(string)-1+sizeof(unsigned char);
-	memoryContainer->data=(char*) malloc(memoryContainer->length);
+	memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
 	memoryContainer->lineDefns=NULL;
 
 	unsigned char token=STRING_TOKEN;
@@ -772,9 +1314,9 @@ struct memorycontainer* createStringExpression(char * string) {
  * Creates an expression containing an integer
  */
 struct memorycontainer* createIntegerExpression(int number) {
-	struct memorycontainer* memoryContainer = (struct memorycontainer*) malloc(sizeof(struct memorycontainer));
+	struct memorycontainer* memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
 	memoryContainer->length=sizeof(int) + sizeof(unsigned char);
-	memoryContainer->data=(char*) malloc(memoryContainer->length);
+	memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
 	memoryContainer->lineDefns=NULL;
 
 	int location=appendStatement(memoryContainer, INTEGER_TOKEN, 0);
@@ -783,9 +1325,9 @@ struct memorycontainer* createIntegerExpression(int number) {
 }
 
 struct memorycontainer* createBooleanExpression(int booleanVal) {
-	struct memorycontainer* memoryContainer = (struct memorycontainer*) malloc(sizeof(struct memorycontainer));
+	struct memorycontainer* memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
 	memoryContainer->length=sizeof(int) + sizeof(unsigned char);
-	memoryContainer->data=(char*) malloc(memoryContainer->length);
+	memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
 	memoryContainer->lineDefns=NULL;
 
 	int location=appendStatement(memoryContainer, BOOLEAN_TOKEN, 0);
@@ -799,15 +1341,15 @@ struct memorycontainer* createArrayExpression(struct stack_t* arrayVals, struct
 	int i;
 	for (i=0;i<lenOfArray;i++) {
 		if (expressionContainer == NULL) {
-			expressionContainer=getExpressionAt(arrayVals, i);
+			expressionContainer=compileExpression(getExpressionAt(arrayVals, i), 0);
 		} else {
-			expressionContainer=concatenateMemory(expressionContainer, getExpressionAt(arrayVals, i));
+			expressionContainer=concatenateMemory(expressionContainer, compileExpression(getExpressionAt(arrayVals, i), 0));
 		}
 	}
 
-	struct memorycontainer* memoryContainer = (struct memorycontainer*) malloc(sizeof(struct memorycontainer));
+	struct memorycontainer* memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
 	memoryContainer->length=sizeof(unsigned char)*2 + sizeof(int);
-	memoryContainer->data=(char*) malloc(memoryContainer->length);
+	memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
 	memoryContainer->lineDefns=NULL;
 
 	int location=appendStatement(memoryContainer, ARRAY_TOKEN, 0);
@@ -815,14 +1357,14 @@ struct memorycontainer* createArrayExpression(struct stack_t* arrayVals, struct
     location+=sizeof(int);
 	unsigned char hasRepetitionExpr=repetitionExpr == NULL ? 0 : 1;
 	memcpy(&memoryContainer->data[location], &hasRepetitionExpr, sizeof(unsigned char));
-	if (repetitionExpr != NULL) memoryContainer=concatenateMemory(memoryContainer, repetitionExpr);
+	if (repetitionExpr != NULL) memoryContainer=concatenateMemory(memoryContainer, compileExpression(repetitionExpr, 0));
 	return concatenateMemory(memoryContainer, expressionContainer);
 }
 
 struct memorycontainer* createNoneExpression(void) {
-	struct memorycontainer* memoryContainer = (struct memorycontainer*) malloc(sizeof(struct memorycontainer));
+	struct memorycontainer* memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
 	memoryContainer->length=sizeof(unsigned char);
-	memoryContainer->data=(char*) malloc(memoryContainer->length);
+	memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
 	memoryContainer->lineDefns=NULL;
 
 	appendStatement(memoryContainer, NONE_TOKEN, 0);
@@ -833,9 +1375,9 @@ struct memorycontainer* createNoneExpression(void) {
  * Creates an expression wrapping a real number
  */
 struct memorycontainer* createRealExpression(float number) {
-	struct memorycontainer* memoryContainer = (struct memorycontainer*) malloc(sizeof(struct memorycontainer));
+	struct memorycontainer* memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
 	memoryContainer->length=sizeof(float) + sizeof(unsigned char);
-	memoryContainer->data=(char*) malloc(memoryContainer->length);
+	memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
 	memoryContainer->lineDefns=NULL;
 
 	int location=appendStatement(memoryContainer, REAL_TOKEN, 0);
@@ -848,37 +1390,30 @@ struct memorycontainer* createRealExpression(float number) {
  * of an assignment then force it to be an identifier, otherwise don't (as it might be a function variable.)
  */
 struct memorycontainer* createIdentifierExpression(char * identifier, char forceVariableIdentifier) {
-    struct memorycontainer* memoryContainer = (struct memorycontainer*) malloc(sizeof(struct memorycontainer));
+    struct memorycontainer* memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
     if (forceVariableIdentifier || doesVariableExist(identifier)) {
         memoryContainer->length=sizeof(unsigned char)+sizeof(unsigned short);
-        memoryContainer->data=(char*) malloc(memoryContainer->length);
+        memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
         memoryContainer->lineDefns=NULL;
 
         int location=appendStatement(memoryContainer, IDENTIFIER_TOKEN, 0);
-        appendVariable(memoryContainer, getVariableId(identifier, forceVariableIdentifier ? 1 : 0), location);
+        appendVariableSlot(memoryContainer, getVariableId(identifier, forceVariableIdentifier ? 1 : 0), location);
     } else {
         memoryContainer->length=sizeof(unsigned char)+sizeof(unsigned short);
-        memoryContainer->data=(char*) malloc(memoryContainer->length);
+        memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
         appendStatement(memoryContainer, FN_ADDR_TOKEN, 0);
 
-        struct lineDefinition * defn = (struct lineDefinition*) malloc(sizeof(struct lineDefinition));
+        struct lineDefinition * defn = (struct lineDefinition*) arenaAllocate(sizeof(struct lineDefinition));
 
         defn->next=NULL;
         defn->type=4;
         defn->linenumber=line_num;
-        defn->name=(char*) malloc(strlen(identifier)+1);
-        strcpy(defn->name, identifier);
+        defn->name=arenaDuplicateString(identifier);
         defn->currentpoint=sizeof(unsigned char);
 
         memoryContainer->lineDefns=defn;
 
-        if (currentCall==NULL) {
-            mainCodeCallTree.calledFunctions[mainCodeCallTree.number_of_calls]=(char*)malloc(strlen(identifier)+1);
-            strcpy(mainCodeCallTree.calledFunctions[mainCodeCallTree.number_of_calls++], identifier);
-        } else {
-            currentCall->calledFunctions[currentCall->number_of_calls]=(char*)malloc(strlen(identifier)+1);
-            strcpy(currentCall->calledFunctions[currentCall->number_of_calls++], identifier);
-        }
+        appendCalledFunction(currentCall == NULL ? &mainCodeCallTree : currentCall, identifier);
     }
 	return memoryContainer;
 }
@@ -889,15 +1424,15 @@ struct memorycontainer* createIdentifierExpression(char * identifier, char force
 struct memorycontainer* createIdentifierArrayAccessExpression(char* identifier, struct stack_t* index_expressions) {
     int lenOfIndexes=getStackSize(index_expressions);
 
-	struct memorycontainer* memoryContainer = (struct memorycontainer*) malloc(sizeof(struct memorycontainer));
+	struct memorycontainer* memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
 	memoryContainer->length=sizeof(unsigned short)+(sizeof(unsigned char)*2);
-	memoryContainer->data=(char*) malloc(memoryContainer->length);
+	memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
 	memoryContainer->lineDefns=NULL;
 
 	unsigned int position=0;
 
 	position=appendStatement(memoryContainer, ARRAYACCESS_TOKEN, position);
-	position=appendVariable(memoryContainer, getVariableId(identifier, 1), position);
+	position=appendVariableSlot(memoryContainer, getVariableId(identifier, 1), position);
 	unsigned char packageNumDims=(unsigned char) lenOfIndexes;
     memcpy(&memoryContainer->data[position], &packageNumDims, sizeof(unsigned char));
     position+=sizeof(unsigned char);
@@ -910,15 +1445,23 @@ struct memorycontainer* createIdentifierArrayAccessExpression(char* identifier,
 }
 
 struct memorycontainer* createNotExpression(struct memorycontainer* expression) {
+	int constantCondition=getConstantCondition(expression);
+	if (constantCondition >= 0) {
+		discardMemory(expression);
+		struct memorycontainer* folded=createBooleanExpression(!constantCondition);
+		bytesOptimisedAway+=sizeof(unsigned char);
+		bytesOptimisedAway-=folded->length;
+		return folded;
+	}
 	return createUnaryExpression(NOT_TOKEN, expression);
 }
 
 struct memorycontainer* createOrExpression(struct memorycontainer* expression1, struct memorycontainer* expression2) {
-	return createExpression(OR_TOKEN, expression1, expression2);
+	return createShortCircuitExpression(OR_TOKEN, expression1, expression2);
 }
 
 struct memorycontainer* createAndExpression(struct memorycontainer* expression1, struct memorycontainer* expression2) {
-	return createExpression(AND_TOKEN, expression1, expression2);
+	return createShortCircuitExpression(AND_TOKEN, expression1, expression2);
 }
 
 struct memorycontainer* createEqExpression(struct memorycontainer* expression1, struct memorycontainer* expression2) {
@@ -990,9 +1533,10 @@ struct memorycontainer* createModExpression(struct memorycontainer* expression1,
  * Enters a scope block, pushes a new scope store onto the stack
  */
 void enterScope() {
-	struct scope_info * newScope=(struct scope_info*) malloc(sizeof(struct scope_info));
+	struct scope_info * newScope=(struct scope_info*) arenaAllocate(sizeof(struct scope_info));
 	newScope->next=scope;
-	newScope->variables=NULL;
+	newScope->variableTable=NULL;
+	newScope->arena=getCurrentArena();
 	scope=newScope;
 }
 
@@ -1002,30 +1546,26 @@ void enterScope() {
 void leaveScope() {
 	struct scope_info * oldScope=scope;
 	scope=scope->next;
-	struct variable_node * var=oldScope->variables, *nextVar;
-	while (var!=NULL) {
-		nextVar=var->next;
-		free(var->name);
-		free(var);
-		var=nextVar;
-	}
-	free(oldScope);
+	freeHashTable(oldScope->variableTable);
 }
 
 static struct memorycontainer* createUnaryExpression(unsigned char token, struct memorycontainer* expression) {
-	struct memorycontainer* memoryContainer = (struct memorycontainer*) malloc(sizeof(struct memorycontainer));
+	struct memorycontainer* memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
 	memoryContainer->length=expression->length + sizeof(unsigned char);
-	memoryContainer->data=(char*) malloc(memoryContainer->length);
+	memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
 
 	unsigned int location=0;
 	location=appendStatement(memoryContainer, token, location);
 	memcpy(&memoryContainer->data[location], expression->data, expression->length);
 
 	memoryContainer->lineDefns=expression->lineDefns;
+	struct lineDefinition * root=memoryContainer->lineDefns;
+	while (root != NULL) {
+		root->currentpoint+=sizeof(unsigned char);
+		root=root->next;
+	}
 
 	// Free up the expression memory
-	free(expression->data);
-	free(expression);
 	return memoryContainer;
 }
 
@@ -1033,9 +1573,12 @@ static struct memorycontainer* createUnaryExpression(unsigned char token, struct
  * Creates an expression from two other expressions with some operator (such as add, equality test etc...)
  */
 static struct memorycontainer* createExpression(unsigned char token, struct memorycontainer* expression1, struct memorycontainer* expression2) {
-	struct memorycontainer* memoryContainer = (struct memorycontainer*) malloc(sizeof(struct memorycontainer));
+	struct memorycontainer* memoryContainer=simplifyAlgebraicIdentity(token, expression1, expression2);
+	if (memoryContainer != NULL) return memoryContainer;
+
+	memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
 	memoryContainer->length=expression1->length + expression2->length + sizeof(unsigned char);
-	memoryContainer->data=(char*) malloc(memoryContainer->length);
+	memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
 
 	unsigned int location=0;
 	location=appendStatement(memoryContainer, token, location);
@@ -1059,82 +1602,1983 @@ static struct memorycontainer* createExpression(unsigned char token, struct memo
 	}
 
 	// Free up the expression 1 and expression 2 memory
-	free(expression1->data);
-	free(expression1);
-	free(expression2->data);
-	free(expression2);
 	return memoryContainer;
 }
 
 /**
- * Adds a variable to the symbol table if it is not already present
+ * Creates a logical and or or expression, the length of the second expression follows the operator so that the interpreter can
+ * skip over it when the first expression alone determines the result
  */
-void addVariableIfNeeded( char * name) {
-	getVariableId(name, 1);
+static struct memorycontainer* createShortCircuitExpression(unsigned char token, struct memorycontainer* expression1,
+		struct memorycontainer* expression2) {
+	int condition1=getConstantCondition(expression1), condition2=getConstantCondition(expression2);
+	if (condition1 >= 0 && (condition1 == (token == OR_TOKEN) || condition2 >= 0)) {
+		// Either the first operand alone determines the result, or both operands are known
+		struct memorycontainer* folded=createBooleanExpression(condition1 == (token == OR_TOKEN) ? condition1 : condition2);
+		discardMemory(expression1);
+		discardMemory(expression2);
+		bytesOptimisedAway+=sizeof(unsigned char)+sizeof(unsigned short);
+		bytesOptimisedAway-=folded->length;
+		return folded;
+	}
+	struct memorycontainer* skipContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
+	skipContainer->length=sizeof(unsigned short);
+	skipContainer->data=(char*) arenaAllocate(skipContainer->length);
+	skipContainer->lineDefns=NULL;
+
+	appendVariable(skipContainer, (unsigned short) expression2->length, 0);
+	return createExpression(token, concatenateMemory(skipContainer, expression1), expression2);
 }
 
 /**
- * Retrieves the ID of a variable from the symbol table, with a flag whether we are to allow adding the variable in
- * if it can not be found
+ * Simplifies the algebraic identities x*1, 1*x, x/1, x-0, x+0 and 0+x to x, returning NULL if the expression is not one of
+ * these. The identity is only removed when x is known to be numeric, as otherwise it might be a string which the zero is
+ * concatenated onto or which the interpreter raises an error for
  */
-static unsigned short getVariableId(char * name, int allowAdd) {
-	struct scope_info * scopeNode=scope;
-	while (scopeNode != NULL) {
-		unsigned short id=findVariable(scopeNode->variables, name);
-		if (id >= 1) return id;
-		scopeNode=scopeNode->next;
+static struct memorycontainer* simplifyAlgebraicIdentity(unsigned char token, struct memorycontainer* expression1,
+		struct memorycontainer* expression2) {
+	struct memorycontainer * kept=NULL, * removed=NULL;
+	if ((token == MUL_TOKEN && isIntegerLiteralOfValue(expression2, 1)) || (token == DIV_TOKEN && isIntegerLiteralOfValue(expression2, 1)) ||
+			(token == SUB_TOKEN && isIntegerLiteralOfValue(expression2, 0))) {
+		if (isNumericExpression(expression1)) {
+			kept=expression1;
+			removed=expression2;
+		}
+	} else if (token == MUL_TOKEN && isIntegerLiteralOfValue(expression1, 1)) {
+		if (isNumericExpression(expression2)) {
+			kept=expression2;
+			removed=expression1;
+		}
+	} else if (token == ADD_TOKEN && isIntegerLiteralOfValue(expression2, 0) && isNumericExpression(expression1)) {
+		kept=expression1;
+		removed=expression2;
+	} else if (token == ADD_TOKEN && isIntegerLiteralOfValue(expression1, 0) && isNumericExpression(expression2)) {
+		kept=expression2;
+		removed=expression1;
 	}
+	if (kept == NULL) return NULL;
+	discardMemory(removed);
+	bytesOptimisedAway+=sizeof(unsigned char);
+	return kept;
+}
 
-	if (allowAdd) {
-		return addVariable(name);
-	} else {
-		fprintf(stderr, "Can not find variable name %s at line %d, you must declare this before use\n", name, line_num);
-		exit(0);
+/**
+ * Determines whether an expression is just a literal of some token
+ */
+static int isLiteral(struct memorycontainer* expression, unsigned char token) {
+	return expression != NULL && expression->lineDefns == NULL && ((unsigned char*) expression->data)[0] == token &&
+			expression->length == sizeof(unsigned char) + (token == REAL_TOKEN ? sizeof(float) : sizeof(int));
+}
+
+/**
+ * Determines whether an expression is an integer literal of some value
+ */
+static int isIntegerLiteralOfValue(struct memorycontainer* expression, int value) {
+	int literalValue;
+	if (!isLiteral(expression, INTEGER_TOKEN)) return 0;
+	memcpy(&literalValue, &expression->data[sizeof(unsigned char)], sizeof(int));
+	return literalValue == value;
+}
+
+/**
+ * Determines whether an expression is known to result in a number, this is a numeric literal or an operator other than addition
+ * (which also concatenates strings) as the interpreter only supports these for numbers
+ */
+static int isNumericExpression(struct memorycontainer* expression) {
+	unsigned char token=((unsigned char*) expression->data)[0];
+	if (token == INTEGER_TOKEN || token == REAL_TOKEN) return isLiteral(expression, token);
+	return token == SUB_TOKEN || token == MUL_TOKEN || token == DIV_TOKEN || token == MOD_TOKEN || token == POW_TOKEN;
+}
+
+/**
+ * Determines whether a condition is a literal whose truth is known when assembling, returning this truth or -1 if it is not.
+ * This follows the interpreter, where integers and booleans are true when they are positive
+ */
+static int getConstantCondition(struct memorycontainer* expression) {
+	int value;
+	if (!isLiteral(expression, BOOLEAN_TOKEN) && !isLiteral(expression, INTEGER_TOKEN)) return -1;
+	memcpy(&value, &expression->data[sizeof(unsigned char)], sizeof(int));
+	return value > 0;
+}
+
+/**
+ * Discards code which has been optimised away along with its line definitions, nothing outside of a block can jump into it
+ */
+static void discardMemory(struct memorycontainer* memory) {
+	if (memory == NULL) return;
+	bytesOptimisedAway+=memory->length;
+}
+
+/**
+ * Compiles an expression to the register format if this is enabled, expressions which are a single operand are left as they are
+ * because there is nothing to gain. Conditions are reduced to a truth value following the same rules as the interpreter applies
+ * to conditional expressions held in the prefix format
+ */
+static struct memorycontainer* compileExpression(struct memorycontainer* expression, char isCondition) {
+	if (!registerExpressions || expression == NULL || expression->length == 0) return expression;
+	if (!isRegisterOperator(((unsigned char*) expression->data)[0])) return expression;
+	struct register_code code;
+	code.data=NULL;
+	code.length=code.capacity=0;
+	code.lineDefns=NULL;
+	appendRegisterExpression(&code, expression, 0, isCondition);
+
+	struct memorycontainer* memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
+	memoryContainer->length=code.length;
+	memoryContainer->data=code.data;
+	memoryContainer->lineDefns=code.lineDefns;
+	return memoryContainer;
+}
+
+/**
+ * Compiles the index expressions of an array access on the left hand side of an assignment to the register format
+ */
+static struct memorycontainer* compileArrayAccessIndexes(struct memorycontainer* identifier) {
+	if (!registerExpressions || ((unsigned char*) identifier->data)[0] != ARRAYACCESS_TOKEN) return identifier;
+	struct register_code code;
+	code.data=NULL;
+	code.length=code.capacity=0;
+	code.lineDefns=NULL;
+	unsigned int i, position=sizeof(unsigned char) * 2 + sizeof(unsigned short);
+	unsigned char numIndexes=((unsigned char*) identifier->data)[position-1];
+	copyExpressionIntoRegisterCode(&code, identifier, 0, position);
+	for (i=0;i<numIndexes;i++) {
+		if (isRegisterOperator(((unsigned char*) identifier->data)[position])) {
+			position=appendRegisterExpression(&code, identifier, position, 0);
+		} else {
+			unsigned int indexLength=getExpressionLength(identifier->data, position);
+			copyExpressionIntoRegisterCode(&code, identifier, position, indexLength);
+			position+=indexLength;
+		}
 	}
+	identifier->data=code.data;
+	identifier->length=code.length;
+	identifier->lineDefns=code.lineDefns;
+	return identifier;
 }
 
-static int doesVariableExist(char* name) {
-    struct scope_info * scopeNode=scope;
-	while (scopeNode != NULL) {
-		unsigned short id=findVariable(scopeNode->variables, name);
-		if (id >= 1) return 1;
-		scopeNode=scopeNode->next;
+/**
+ * Appends a register format expression compiled from the prefix expression at some position in the source. The header is the
+ * length of the instructions, which is filled in once the instructions have been compiled
+ */
+static unsigned int appendRegisterExpression(struct register_code* code, struct memorycontainer* source, unsigned int position,
+		char isCondition) {
+	unsigned char token=REGISTER_EXPRESSION_TOKEN;
+	unsigned short instructionsLength=0;
+	emitRegisterCode(code, &token, sizeof(unsigned char));
+	unsigned int headerStart=code->length;
+	emitRegisterCode(code, &instructionsLength, sizeof(unsigned short));
+	position=compileRegisterInstructions(code, source, position, 0, isCondition);
+	instructionsLength=(unsigned short) (code->length - (headerStart + sizeof(unsigned short)));
+	memcpy(&code->data[headerStart], &instructionsLength, sizeof(unsigned short));
+	return position;
+}
+
+/**
+ * Compiles the prefix expression at some position in the source to register instructions which leave its value in the target
+ * register. Sub expressions are placed in the registers following the target, and any expression not supported by the register
+ * format (such as function calls) is copied in unchanged to be evaluated in place. If this is a logical operand then the value
+ * is also reduced to a truth value
+ */
+static unsigned int compileRegisterInstructions(struct register_code* code, struct memorycontainer* source, unsigned int position,
+		unsigned char targetRegister, char isLogical) {
+	unsigned char token=((unsigned char*) source->data)[position];
+	unsigned char numIndexes=token == ARRAYACCESS_TOKEN ? ((unsigned char*) source->data)[position+sizeof(unsigned char)+sizeof(unsigned short)] : 1;
+	unsigned int i, start=position;
+	if (!isRegisterOperator(token) || targetRegister + numIndexes >= MAX_EXPRESSION_REGISTERS) {
+		unsigned int expressionLength=getExpressionLength(source->data, position);
+		if (token == INTEGER_TOKEN || token == REAL_TOKEN || token == BOOLEAN_TOKEN) {
+			emitRegisterInstruction(code, token, targetRegister);
+			emitRegisterCode(code, &source->data[position+sizeof(unsigned char)], expressionLength - sizeof(unsigned char));
+		} else if (token == NONE_TOKEN || token == STRING_TOKEN || token == IDENTIFIER_TOKEN) {
+			emitRegisterInstruction(code, token, targetRegister);
+			copyExpressionIntoRegisterCode(code, source, position+sizeof(unsigned char), expressionLength - sizeof(unsigned char));
+		} else {
+			emitRegisterInstruction(code, REGISTER_EVAL_TOKEN, targetRegister);
+			copyExpressionIntoRegisterCode(code, source, position, expressionLength);
+		}
+		position+=expressionLength;
+	} else if (token == ARRAYACCESS_TOKEN) {
+		position+=sizeof(unsigned char) * 2 + sizeof(unsigned short);
+		for (i=0;i<numIndexes;i++) {
+			position=compileRegisterInstructions(code, source, position, targetRegister+1+i, 0);
+		}
+		emitRegisterInstruction(code, token, targetRegister);
+		copyExpressionIntoRegisterCode(code, source, start+sizeof(unsigned char), sizeof(unsigned short) + sizeof(unsigned char));
+	} else if (token == NOT_TOKEN) {
+		position=compileRegisterInstructions(code, source, position+sizeof(unsigned char), targetRegister, 0);
+		emitRegisterInstruction(code, token, targetRegister);
+		emitRegisterCode(code, &targetRegister, sizeof(unsigned char));
+	} else if (token == AND_TOKEN || token == OR_TOKEN) {
+		// If the first operand does not determine the result then this is the truth value of the second operand
+		unsigned short skipLength=0;
+		position=compileRegisterInstructions(code, source, position+sizeof(unsigned char)+sizeof(unsigned short), targetRegister, 1);
+		emitRegisterInstruction(code, REGISTER_SHORT_CIRCUIT_TOKEN, targetRegister);
+		emitRegisterCode(code, &token, sizeof(unsigned char));
+		unsigned int skipPosition=code->length;
+		emitRegisterCode(code, &skipLength, sizeof(unsigned short));
+		position=compileRegisterInstructions(code, source, position, targetRegister, 1);
+		skipLength=(unsigned short) (code->length - (skipPosition + sizeof(unsigned short)));
+		memcpy(&code->data[skipPosition], &skipLength, sizeof(unsigned short));
+	} else {
+		// Constants and variables are encoded directly as operands, with only sub expressions being computed into registers
+		unsigned int operandStart[2], operandLength[2];
+		unsigned char operandRegister[2], nextRegister=targetRegister, operandToken=REGISTER_OPERAND_TOKEN;
+		position+=sizeof(unsigned char);
+		for (i=0;i<2;i++) {
+			unsigned char operandExpression=((unsigned char*) source->data)[position];
+			operandStart[i]=position;
+			if (operandExpression == INTEGER_TOKEN || operandExpression == REAL_TOKEN || operandExpression == BOOLEAN_TOKEN ||
+					operandExpression == IDENTIFIER_TOKEN) {
+				operandLength[i]=getExpressionLength(source->data, position);
+				position+=operandLength[i];
+			} else {
+				operandLength[i]=0;
+				operandRegister[i]=nextRegister;
+				position=compileRegisterInstructions(code, source, position, nextRegister++, 0);
+			}
+		}
+		emitRegisterInstruction(code, token, targetRegister);
+		for (i=0;i<2;i++) {
+			if (operandLength[i] == 0) {
+				emitRegisterCode(code, &operandToken, sizeof(unsigned char));
+				emitRegisterCode(code, &operandRegister[i], sizeof(unsigned char));
+			} else {
+				copyExpressionIntoRegisterCode(code, source, operandStart[i], operandLength[i]);
+			}
+		}
 	}
-	return 0;
+	if (isLogical) {
+		if (token == IDENTIFIER_TOKEN || token == ARRAYACCESS_TOKEN) {
+			emitRegisterInstruction(code, REGISTER_BOOLEAN_TRUTH_TOKEN, targetRegister);
+		} else if (token != BOOLEAN_TOKEN && token != NOT_TOKEN && token != AND_TOKEN && token != OR_TOKEN && token != EQ_TOKEN &&
+				token != NEQ_TOKEN && token != LT_TOKEN && token != GT_TOKEN && token != LEQ_TOKEN && token != GEQ_TOKEN && token != IS_TOKEN) {
+			emitRegisterInstruction(code, REGISTER_TRUTH_TOKEN, targetRegister);
+		}
+	}
+	return position;
 }
 
 /**
- * Finds a variable in a specific variable list or returns -1 for no variable found
+ * Determines whether an expression token is an operator which is compiled to register instructions
  */
-static unsigned short findVariable(struct variable_node * root,  char * name) {
-	while (root != NULL) {
-		if (areStringsEqualIgnoreCase(root->name, name)) return root->id;
-		root=root->next;
+static int isRegisterOperator(unsigned char token) {
+	return token == OR_TOKEN || token == AND_TOKEN || token == EQ_TOKEN || token == NEQ_TOKEN || token == LT_TOKEN ||
+			token == GT_TOKEN || token == LEQ_TOKEN || token == GEQ_TOKEN || token == ADD_TOKEN || token == SUB_TOKEN ||
+			token == MUL_TOKEN || token == DIV_TOKEN || token == MOD_TOKEN || token == POW_TOKEN || token == IS_TOKEN ||
+			token == NOT_TOKEN || token == ARRAYACCESS_TOKEN;
+}
+
+/**
+ * Retrieves the length in bytes of the prefix expression at some position
+ */
+static unsigned int getExpressionLength(char * data, unsigned int position) {
+	unsigned char token=((unsigned char*) data)[position];
+	unsigned int i, start=position;
+	unsigned short numberItems;
+	position+=sizeof(unsigned char);
+	switch (token) {
+	case INTEGER_TOKEN:
+	case REAL_TOKEN:
+	case BOOLEAN_TOKEN:
+		return sizeof(unsigned char) + sizeof(int);
+	case NONE_TOKEN:
+		return sizeof(unsigned char);
+	case STRING_TOKEN:
+		return sizeof(unsigned char) + strlen(&data[position]) + 1;
+	case IDENTIFIER_TOKEN:
+	case FN_ADDR_TOKEN:
+	case REFERENCE_TOKEN:
+	case SYMBOL_TOKEN:
+		return sizeof(unsigned char) + sizeof(unsigned short);
+	case ARRAYACCESS_TOKEN:
+		numberItems=((unsigned char*) data)[position+sizeof(unsigned short)];
+		position+=sizeof(unsigned short) + sizeof(unsigned char);
+		for (i=0;i<numberItems;i++) position+=getExpressionLength(data, position);
+		return position - start;
+	case NOT_TOKEN:
+		return sizeof(unsigned char) + getExpressionLength(data, position);
+	case AND_TOKEN:
+	case OR_TOKEN:
+		position+=sizeof(unsigned short);
+		position+=getExpressionLength(data, position);
+		return (position - start) + getExpressionLength(data, position);
+	case ARRAY_TOKEN: {
+		int numberElements;
+		memcpy(&numberElements, &data[position], sizeof(int));
+		position+=sizeof(int);
+		if (data[position]) position+=getExpressionLength(data, position+sizeof(unsigned char));
+		position+=sizeof(unsigned char);
+		for (i=0;i<(unsigned int) numberElements;i++) position+=getExpressionLength(data, position);
+		return position - start;
+	}
+	case NATIVE_TOKEN:
+		memcpy(&numberItems, &data[position+sizeof(unsigned char)], sizeof(unsigned short));
+		position+=sizeof(unsigned char) + sizeof(unsigned short);
+		for (i=0;i<numberItems;i++) position+=getExpressionLength(data, position);
+		return position - start;
+	case FNCALL_TOKEN:
+	case FNCALL_BY_VAR_TOKEN:
+		memcpy(&numberItems, &data[position+sizeof(unsigned short)], sizeof(unsigned short));
+		return sizeof(unsigned char) + sizeof(unsigned short) * (2 + numberItems);
+	case LET_TOKEN:
+		// Assignment of a temporary ahead of a function call, which is then followed by the expression itself
+		position+=getExpressionLength(data, position);
+		position+=getExpressionLength(data, position);
+		return (position - start) + getExpressionLength(data, position);
+	case REGISTER_EXPRESSION_TOKEN:
+		memcpy(&numberItems, &data[position], sizeof(unsigned short));
+		return sizeof(unsigned char) + sizeof(unsigned short) + numberItems;
+	default:
+		// Binary operators
+		position+=getExpressionLength(data, position);
+		return (position - start) + getExpressionLength(data, position);
 	}
-	return 0;
 }
 
 /**
- * Tests two strings for equality, ignoring the case - this is for case insensitive variable name matching
+ * Appends some bytes to the register code, growing this as required
  */
-static int areStringsEqualIgnoreCase(char * s1, char * s2) {
-	size_t s1_len=strlen(s1), s2_len=strlen(s2), i;
-	if (s1_len != s2_len) return 0;
-	for (i=0;i<s1_len;i++) {
-		if (tolower(s1[i]) != tolower(s2[i])) return 0;
+static void emitRegisterCode(struct register_code* code, void* bytes, unsigned int length) {
+	if (code->length + length > code->capacity) {
+		code->data=(char*) arenaReallocate(code->data, code->capacity, (code->length + length) * 2);
+		code->capacity=(code->length + length) * 2;
 	}
-	return 1;
+	memcpy(&code->data[code->length], bytes, length);
+	code->length+=length;
 }
 
 /**
- * Adds a variable to the variable list at the top of the scope stack, allocates the ID to be the next free one
+ * Appends the instruction and its target register to the register code
  */
-static unsigned short addVariable(char * name) {
-	struct variable_node * newNode=(struct variable_node*) malloc(sizeof(struct variable_node));
-	newNode->name=(char*) malloc(strlen(name) + 1);
-	strcpy(newNode->name, name);
-	newNode->id = current_var_id++;
-	newNode->next=scope->variables;
-	scope->variables=newNode;
+static void emitRegisterInstruction(struct register_code* code, unsigned char instruction, unsigned char targetRegister) {
+	emitRegisterCode(code, &instruction, sizeof(unsigned char));
+	emitRegisterCode(code, &targetRegister, sizeof(unsigned char));
+}
+
+/**
+ * Copies part of the source expression into the register code unchanged, moving across any line definitions (i.e. the placeholders
+ * for function addresses and global variable ids) which fall within it
+ */
+static void copyExpressionIntoRegisterCode(struct register_code* code, struct memorycontainer* source, unsigned int position,
+		unsigned int length) {
+	unsigned int targetPosition=code->length;
+	emitRegisterCode(code, &source->data[position], length);
+	moveLineDefinitions(&source->lineDefns, position, length, &code->lineDefns, targetPosition);
+}
+
+/**
+ * Inlines calls to small functions in the code of the main program or a function (which starts with its header.) The body of the
+ * function is substituted for the call, with its arguments replaced by the variables passed by the caller, which are these same
+ * variables aliased in a normal call. Function bodies are a native call, which can be inlined at calls which are statements, or
+ * the return of an expression. Each inlined call is removed from the list of functions called by the code, so that a function
+ * which is no longer called is not included in the byte code. Returns the number of call sites which have been inlined
+ */
+int inlineFunctionCalls(struct memorycontainer* code, int isFunction, char ** calledFunctions, int * numberCalledFunctions) {
+	struct code_scan_state state;
+	struct functionDefinition * fn;
+	struct lineDefinition * target;
+	struct code_edit * edits;
+	unsigned int position, j, bodyStart=0, start;
+	unsigned short numberArgs, * callSlots;
+	int numberSites=0, numberCalls, c;
+
+	if (code == NULL || code->length == 0) return 0;
+	if (isFunction) {
+		memcpy(&numberArgs, code->data, sizeof(unsigned short));
+		bodyStart=sizeof(unsigned short) * (2 + numberArgs);
+	}
+	initialiseCodeScanState(&state, code, isFunction);
+	for (position=bodyStart;position < code->length && !state.failed;) position=scanStatement(&state, position);
+	numberCalls=state.callStatements.number + state.callExpressions.number;
+	if (state.failed || numberCalls == 0) {
+		freeCodeScanState(&state);
+		return 0;
+	}
+	edits=(struct code_edit*) malloc(sizeof(struct code_edit) * numberCalls);
+	for (c=0;c<numberCalls;c++) {
+		int isStatement=c < state.callStatements.number;
+		position=isStatement ? state.callStatements.entries[c] : state.callExpressions.entries[c - state.callStatements.number];
+		target=findLineDefinitionAt(code->lineDefns, position + sizeof(unsigned char), 3);
+		fn=target != NULL ? getInlineableFunction(target->name) : NULL;
+		if (fn == NULL) continue;
+		memcpy(&numberArgs, &code->data[position + sizeof(unsigned char) + sizeof(unsigned short)], sizeof(unsigned short));
+		if (numberArgs != ((unsigned short*) fn->contents->data)[0]) continue;
+		// A call which is a statement needs a statement in its place, which the return of an expression only is for a native call
+		start=fn->inlineBody->data[0] == RETURN_EXP_TOKEN ? sizeof(unsigned char) : 0;
+		if (isStatement ? fn->inlineBody->data[start] != NATIVE_TOKEN : start == 0) continue;
+
+		struct memorycontainer* replacement=(struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
+		replacement->length=fn->inlineBody->length - start;
+		replacement->data=(char*) arenaAllocate(replacement->length);
+		replacement->lineDefns=NULL;
+		memcpy(replacement->data, &fn->inlineBody->data[start], replacement->length);
+		callSlots=(unsigned short*) malloc(sizeof(unsigned short) * (numberArgs + 1));
+		memcpy(callSlots, &code->data[position + sizeof(unsigned char) + sizeof(unsigned short) * 2], sizeof(unsigned short) * numberArgs);
+		substituteInlinedArguments(replacement->data, 0, &((unsigned short*) fn->contents->data)[2], callSlots, numberArgs);
+		free(callSlots);
+		removeCalledFunction(calledFunctions, numberCalledFunctions, target->name);
+
+		// Calls which are statements and those in expressions are each in order, so are merged into order as the sites are added
+		for (j=(unsigned int) numberSites;j > 0 && edits[j-1].position > position;j--) edits[j]=edits[j-1];
+		edits[j].position=position;
+		edits[j].length=getExpressionLength(code->data, position);
+		edits[j].replacement=replacement;
+		numberSites++;
+	}
+	if (numberSites > 0) applyCodeEdits(code, &state, edits, numberSites);
+	free(edits);
+	freeCodeScanState(&state);
+	return numberSites;
+}
+
+/**
+ * Determines whether a function, which has had calls in it inlined, can now itself be inlined. This is the case for wrappers
+ * around other small functions, and its body is then the statement between the header and the closing return
+ */
+void updateInlineableBody(struct functionDefinition* fn) {
+	struct lineDefinition * root;
+	unsigned short numberArgs=((unsigned short*) fn->contents->data)[0];
+	unsigned int bodyStart=sizeof(unsigned short) * (2 + numberArgs), bodyEnd=fn->contents->length - sizeof(unsigned char);
+	if (fn->inlineBody != NULL || bodyEnd <= bodyStart || fn->contents->data[bodyEnd] != RETURN_TOKEN) return;
+	for (root=fn->contents->lineDefns;root != NULL;root=root->next) {
+		if ((unsigned int) root->currentpoint >= bodyStart) return;
+	}
+	fn->inlineBody=getInlineableBody(&fn->contents->data[bodyStart], bodyEnd - bodyStart, &((unsigned short*) fn->contents->data)[2],
+			numberArgs);
+}
+
+/**
+ * Gets a copy of the body of a function if it is small enough to be inlined and is a single native call statement, or the return
+ * of an expression, using only constants and the arguments. Otherwise NULL is returned
+ */
+static struct memorycontainer* getInlineableBody(char * data, unsigned int length, unsigned short * argumentSlots, int numberArgs) {
+	unsigned int bodyStart=((unsigned char*) data)[0] == RETURN_EXP_TOKEN ? sizeof(unsigned char) : 0;
+	if (length > MAX_INLINED_FUNCTION_SIZE || length <= bodyStart || (bodyStart == 0 && ((unsigned char*) data)[0] != NATIVE_TOKEN)) return NULL;
+	if (bodyStart + getExpressionLength(data, bodyStart) != length ||
+			!substituteInlinedArguments(data, bodyStart, argumentSlots, NULL, numberArgs)) return NULL;
+	struct memorycontainer* body=(struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
+	body->length=length;
+	body->data=(char*) arenaAllocate(length);
+	body->lineDefns=NULL;
+	memcpy(body->data, data, length);
+	return body;
+}
+
+/**
+ * Determines whether an expression from the body of a function can be inlined, which is the case if it only uses constants and the
+ * arguments of the function. If slots of the caller are provided then the arguments are replaced by these
+ */
+static int substituteInlinedArguments(char * data, unsigned int position, unsigned short * argumentSlots, unsigned short * callSlots,
+		int numberArgs) {
+	unsigned char token=((unsigned char*) data)[position];
+	unsigned short slot, numberItems;
+	int i;
+	position+=sizeof(unsigned char);
+	switch (token) {
+	case INTEGER_TOKEN:
+	case REAL_TOKEN:
+	case BOOLEAN_TOKEN:
+	case STRING_TOKEN:
+	case NONE_TOKEN:
+		return 1;
+	case IDENTIFIER_TOKEN:
+	case ARRAYACCESS_TOKEN:
+		memcpy(&slot, &data[position], sizeof(unsigned short));
+		for (i=0;i<numberArgs && argumentSlots[i] != slot;i++);
+		if (i == numberArgs) return 0;
+		if (callSlots != NULL) memcpy(&data[position], &callSlots[i], sizeof(unsigned short));
+		if (token == IDENTIFIER_TOKEN) return 1;
+		numberItems=((unsigned char*) data)[position + sizeof(unsigned short)];
+		position+=sizeof(unsigned short) + sizeof(unsigned char);
+		break;
+	case NOT_TOKEN:
+		return substituteInlinedArguments(data, position, argumentSlots, callSlots, numberArgs);
+	case NATIVE_TOKEN:
+		memcpy(&numberItems, &data[position + sizeof(unsigned char)], sizeof(unsigned short));
+		position+=sizeof(unsigned char) + sizeof(unsigned short);
+		break;
+	case AND_TOKEN:
+	case OR_TOKEN:
+		position+=sizeof(unsigned short);
+		numberItems=2;
+		break;
+	case ADD_TOKEN:
+	case SUB_TOKEN:
+	case MUL_TOKEN:
+	case DIV_TOKEN:
+	case MOD_TOKEN:
+	case POW_TOKEN:
+	case EQ_TOKEN:
+	case NEQ_TOKEN:
+	case GT_TOKEN:
+	case GEQ_TOKEN:
+	case LT_TOKEN:
+	case LEQ_TOKEN:
+	case IS_TOKEN:
+		numberItems=2;
+		break;
+	default:
+		return 0;
+	}
+	for (i=0;i<numberItems;i++) {
+		if (!substituteInlinedArguments(data, position, argumentSlots, callSlots, numberArgs)) return 0;
+		position+=getExpressionLength(data, position);
+	}
+	return 1;
+}
+
+/**
+ * Removes one entry for a function from a list of called functions
+ */
+static void removeCalledFunction(char ** calledFunctions, int * numberCalledFunctions, char * functionName) {
+	int i;
+	for (i=0;i<*numberCalledFunctions;i++) {
+		if (strcmp(calledFunctions[i], functionName) == 0) {
+			calledFunctions[i]=calledFunctions[--(*numberCalledFunctions)];
+			return;
+		}
+	}
+}
+
+/**
+ * Applies edits, which are in order and do not overlap, to the code. Each replaces some bytes with others, either of which might be
+ * none. The length fields of blocks and the skip fields of short circuiting operators recorded by scanning the code are updated,
+ * and line definitions are moved. Those in an edited region are removed, apart from a label at its start which now points to what
+ * follows the edit
+ */
+static void applyCodeEdits(struct memorycontainer* code, struct code_scan_state* state, struct code_edit* edits, int numberEdits) {
+	struct lineDefinition * root, * next, * kept=NULL;
+	unsigned int i, j, position, start, newLength=code->length, oldPosition, newPosition, * map;
+	unsigned short blockLength;
+	char * newData;
+	int c;
+
+	for (c=0;c<numberEdits;c++) newLength=newLength + edits[c].replacement->length - edits[c].length;
+	newData=(char*) arenaAllocate(newLength);
+	map=(unsigned int*) malloc(sizeof(unsigned int) * (code->length + 1));
+	for (c=0, oldPosition=0, newPosition=0;oldPosition <= code->length;) {
+		map[oldPosition]=newPosition;
+		if (c < numberEdits && oldPosition == edits[c].position) {
+			for (i=1;i<edits[c].length;i++) map[oldPosition+i]=newPosition;
+			if (edits[c].replacement->length > 0) memcpy(&newData[newPosition], edits[c].replacement->data, edits[c].replacement->length);
+			newPosition+=edits[c].replacement->length;
+			oldPosition+=edits[c].length;
+			c++;
+		} else {
+			if (oldPosition < code->length) newData[newPosition++]=code->data[oldPosition];
+			oldPosition++;
+		}
+	}
+
+	for (i=0;i<(unsigned int) (state->lengthFields.number + state->skipFields.number);i++) {
+		int isSkipField=i >= (unsigned int) state->lengthFields.number;
+		position=isSkipField ? state->skipFields.entries[i - state->lengthFields.number] : state->lengthFields.entries[i];
+		for (j=0;j<(unsigned int) numberEdits;j++) {
+			if (position >= edits[j].position && position < edits[j].position + edits[j].length) break;
+		}
+		if (j < (unsigned int) numberEdits) continue;
+		memcpy(&blockLength, &code->data[position], sizeof(unsigned short));
+		start=position + sizeof(unsigned short);
+		// The second operand of a short circuiting operator, which is skipped, follows the first operand
+		if (isSkipField) start+=getExpressionLength(code->data, start);
+		blockLength=(unsigned short) (map[start + blockLength] - map[start]);
+		memcpy(&newData[map[position]], &blockLength, sizeof(unsigned short));
+	}
+
+	for (root=code->lineDefns;root != NULL;root=next) {
+		next=root->next;
+		for (c=0;c<numberEdits;c++) {
+			if ((unsigned int) root->currentpoint >= edits[c].position && (unsigned int) root->currentpoint < edits[c].position + edits[c].length &&
+					(root->type != 0 || (unsigned int) root->currentpoint != edits[c].position)) break;
+		}
+		if (c < numberEdits) continue;
+		root->currentpoint=map[root->currentpoint];
+		root->next=kept;
+		kept=root;
+	}
+	code->lineDefns=kept;
+
+	code->data=newData;
+	code->length=newLength;
+	free(map);
+}
+
+/**
+ * Specialises the byte code of a whole program to the configuration that it is run with, where it is known whether this is the
+ * host or a device, and possibly the id of the core and the number of cores. Natives giving these values in expressions are
+ * replaced by literals, and conditionals whose condition is then known are replaced by the block which runs (or removed.) The
+ * program must not have been linked yet, returns the number of edits made to it
+ */
+int specialiseByteCode(struct memorycontainer* code, int isHost, int coreId, int numberCores) {
+	struct code_scan_state state;
+	struct specialisation_values values;
+	struct lineDefinition * root;
+	struct code_edit * edits=NULL, branchEdits[2];
+	unsigned int position, end=0, * functionStarts;
+	unsigned short numberArgs;
+	int numberEdits=0, capacity=0, numberFunctions=0, i, j, value, isBoolean;
+
+	if (code == NULL || code->length < sizeof(unsigned short)) return 0;
+	values.isHost=isHost;
+	values.coreId=coreId;
+	values.numberCores=numberCores;
+	for (root=code->lineDefns;root != NULL;root=root->next) {
+		if (root->type == 2) numberFunctions++;
+	}
+	functionStarts=(unsigned int*) malloc(sizeof(unsigned int) * (numberFunctions + 1));
+	for (i=0, root=code->lineDefns;root != NULL;root=root->next) {
+		if (root->type != 2) continue;
+		for (j=i++;j > 0 && functionStarts[j-1] > (unsigned int) root->currentpoint;j--) functionStarts[j]=functionStarts[j-1];
+		functionStarts[j]=root->currentpoint;
+	}
+	functionStarts[numberFunctions]=code->length;
+
+	// The main code follows the program header, with each function following this and starting with its own header
+	initialiseCodeScanState(&state, code, 0);
+	position=sizeof(unsigned short);
+	for (i=0;position < code->length && !state.failed;) {
+		if (position == functionStarts[i]) {
+			memcpy(&numberArgs, &code->data[position], sizeof(unsigned short));
+			position+=sizeof(unsigned short) * (2 + numberArgs);
+			i++;
+		} else {
+			position=scanStatement(&state, position);
+		}
+	}
+	if (state.failed) {
+		free(functionStarts);
+		freeCodeScanState(&state);
+		return 0;
+	}
+
+	for (i=0;i<state.branches.number;i++) {
+		int numberBranchEdits=getSpecialisedBranchEdits(code, state.branches.entries[i], &values, branchEdits);
+		for (j=0;j<numberBranchEdits;j++) {
+			edits=appendCodeEdit(edits, &numberEdits, &capacity, branchEdits[j].position, branchEdits[j].length, NULL);
+		}
+	}
+	for (i=0;i<state.natives.number;i++) {
+		position=state.natives.entries[i];
+		if (!getSpecialisedNativeValue(code->data, position, &values, &value, &isBoolean)) continue;
+		edits=appendCodeEdit(edits, &numberEdits, &capacity, position, getExpressionLength(code->data, position),
+				isBoolean ? createBooleanExpression(value) : createIntegerExpression(value));
+	}
+	for (i=1;i<numberEdits;i++) {
+		struct code_edit edit=edits[i];
+		for (j=i;j > 0 && edits[j-1].position > edit.position;j--) edits[j]=edits[j-1];
+		edits[j]=edit;
+	}
+	// Edits inside code which an earlier edit removes are dropped, as that code goes anyway
+	for (i=0, j=0;i<numberEdits;i++) {
+		if (edits[i].position >= end) {
+			end=edits[i].position + edits[i].length;
+			edits[j++]=edits[i];
+		}
+	}
+	numberEdits=j;
+	keepCodeSize(edits, &numberEdits);
+	if (numberEdits > 0) applyCodeEdits(code, &state, edits, numberEdits);
+	free(edits);
+	free(functionStarts);
+	freeCodeScanState(&state);
+	return numberEdits;
+}
+
+/**
+ * Literals only replace natives if this does not make the specialised byte code longer than the generic byte code as a whole, so
+ * that it still fits wherever the generic byte code does. Those which make it longer are dropped in turn until it is not
+ */
+static void keepCodeSize(struct code_edit* edits, int* numberEdits) {
+	int growth=0, editGrowth, i, j;
+	for (i=0;i<*numberEdits;i++) growth+=(int) edits[i].replacement->length - (int) edits[i].length;
+	for (i=0, j=0;i<*numberEdits;i++) {
+		editGrowth=(int) edits[i].replacement->length - (int) edits[i].length;
+		if (growth > 0 && editGrowth > 0) {
+			growth-=editGrowth;
+		} else {
+			edits[j++]=edits[i];
+		}
+	}
+	*numberEdits=j;
+}
+
+/**
+ * Determines the edits which specialise the conditional at some position if its condition is known, returning the number of
+ * these. A conditional which is true loses its test, along with the else block which is jumped over, and one which is false
+ * loses everything apart from any else block. The block of a while loop ends by jumping back to the test, which is where its
+ * label now points to if the test is removed
+ */
+static int getSpecialisedBranchEdits(struct memorycontainer* code, unsigned int position, struct specialisation_values* values,
+		struct code_edit* edits) {
+	unsigned char token=((unsigned char*) code->data)[position];
+	unsigned int lengthPoint=position + sizeof(unsigned char), blockStart, blockEnd;
+	unsigned short blockLength;
+	struct lineDefinition * jump, * root;
+	int truth, isBoolean;
+
+	if (token == IF_COMPARE_TOKEN) {
+		if (!evaluateSpecialisedComparison(code->data, ((unsigned char*) code->data)[lengthPoint], lengthPoint + sizeof(unsigned char),
+				values, &truth)) return 0;
+		lengthPoint+=sizeof(unsigned char);
+		lengthPoint+=getExpressionLength(code->data, lengthPoint);
+	} else {
+		if (!evaluateSpecialisedExpression(code->data, lengthPoint, values, &truth, &isBoolean)) return 0;
+		truth=truth > 0;
+	}
+	lengthPoint+=getExpressionLength(code->data, lengthPoint);
+	memcpy(&blockLength, &code->data[lengthPoint], sizeof(unsigned short));
+	blockStart=lengthPoint + sizeof(unsigned short);
+	blockEnd=blockStart + blockLength;
+	edits[0].replacement=edits[1].replacement=NULL;
+	if (!truth) {
+		edits[0].position=position;
+		edits[0].length=blockEnd - position;
+		return 1;
+	}
+	edits[0].position=position;
+	edits[0].length=blockStart - position;
+	// An else block follows a block which ends by jumping forwards to the label at the end of the else block
+	if (blockLength < sizeof(unsigned char) + sizeof(unsigned short) || code->data[blockEnd - sizeof(unsigned short) - sizeof(unsigned char)] != GOTO_TOKEN) return 1;
+	jump=findLineDefinitionAt(code->lineDefns, blockEnd - sizeof(unsigned short), 1);
+	if (jump == NULL) return 1;
+	for (root=code->lineDefns;root != NULL;root=root->next) {
+		if (root->type == 0 && root->linenumber == jump->linenumber && (unsigned int) root->currentpoint > blockEnd) {
+			edits[1].position=blockEnd - sizeof(unsigned short) - sizeof(unsigned char);
+			edits[1].length=root->currentpoint - edits[1].position;
+			return 2;
+		}
+	}
+	return 1;
+}
+
+/**
+ * Evaluates an expression whose value is fixed by the configuration, returning whether it is. Only integers and booleans are
+ * followed, through the natives whose values are known and the logical, comparison and simple arithmetic operators on these.
+ * Truth follows the interpreter, where a value is true if it is positive
+ */
+static int evaluateSpecialisedExpression(char* data, unsigned int position, struct specialisation_values* values, int* value, int* isBoolean) {
+	unsigned char token=((unsigned char*) data)[position];
+	unsigned int operandPoint=position + sizeof(unsigned char);
+	int value1, value2, isBoolean1, isBoolean2;
+	switch (token) {
+	case INTEGER_TOKEN:
+	case BOOLEAN_TOKEN:
+		memcpy(value, &data[operandPoint], sizeof(int));
+		*isBoolean=token == BOOLEAN_TOKEN;
+		return 1;
+	case NATIVE_TOKEN:
+		return getSpecialisedNativeValue(data, position, values, value, isBoolean);
+	case NOT_TOKEN:
+		if (!evaluateSpecialisedExpression(data, operandPoint, values, &value1, &isBoolean1)) return 0;
+		*value=value1 > 0 ? 0 : 1;
+		*isBoolean=1;
+		return 1;
+	case AND_TOKEN:
+	case OR_TOKEN:
+		// The second operand is not evaluated if the first alone determines the result, so it does not need to be known then
+		operandPoint+=sizeof(unsigned short);
+		if (!evaluateSpecialisedExpression(data, operandPoint, values, &value1, &isBoolean1)) return 0;
+		*isBoolean=1;
+		if ((token == AND_TOKEN) != (value1 > 0)) {
+			*value=value1 > 0;
+			return 1;
+		}
+		if (!evaluateSpecialisedExpression(data, operandPoint + getExpressionLength(data, operandPoint), values, &value2, &isBoolean2)) return 0;
+		*value=value2 > 0;
+		return 1;
+	case EQ_TOKEN:
+	case NEQ_TOKEN:
+	case GT_TOKEN:
+	case GEQ_TOKEN:
+	case LT_TOKEN:
+	case LEQ_TOKEN:
+		*isBoolean=1;
+		return evaluateSpecialisedComparison(data, token, operandPoint, values, value);
+	case ADD_TOKEN:
+	case SUB_TOKEN:
+	case MUL_TOKEN:
+		if (!evaluateSpecialisedExpression(data, operandPoint, values, &value1, &isBoolean1) || isBoolean1 ||
+				!evaluateSpecialisedExpression(data, operandPoint + getExpressionLength(data, operandPoint), values, &value2, &isBoolean2) ||
+				isBoolean2) return 0;
+		if (token == ADD_TOKEN) *value=(int) ((unsigned int) value1 + (unsigned int) value2);
+		if (token == SUB_TOKEN) *value=(int) ((unsigned int) value1 - (unsigned int) value2);
+		if (token == MUL_TOKEN) *value=(int) ((unsigned int) value1 * (unsigned int) value2);
+		*isBoolean=0;
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+/**
+ * Evaluates the comparison of two integer expressions, whose first operand is at some position, if both are known
+ */
+static int evaluateSpecialisedComparison(char* data, unsigned char comparison, unsigned int position, struct specialisation_values* values,
+		int* truth) {
+	int value1, value2, isBoolean1, isBoolean2;
+	if (!evaluateSpecialisedExpression(data, position, values, &value1, &isBoolean1) || isBoolean1 ||
+			!evaluateSpecialisedExpression(data, position + getExpressionLength(data, position), values, &value2, &isBoolean2) ||
+			isBoolean2) return 0;
+	switch (comparison) {
+	case EQ_TOKEN:
+		*truth=value1 == value2;
+		return 1;
+	case NEQ_TOKEN:
+		*truth=value1 != value2;
+		return 1;
+	case GT_TOKEN:
+		*truth=value1 > value2;
+		return 1;
+	case GEQ_TOKEN:
+		*truth=value1 >= value2;
+		return 1;
+	case LT_TOKEN:
+		*truth=value1 < value2;
+		return 1;
+	case LEQ_TOKEN:
+		*truth=value1 <= value2;
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+/**
+ * Gets the value of a call to a native at some position if this is fixed by the configuration, returning whether it is
+ */
+static int getSpecialisedNativeValue(char* data, unsigned int position, struct specialisation_values* values, int* value, int* isBoolean) {
+	unsigned char nativeFunction=((unsigned char*) data)[position + sizeof(unsigned char)] & 0x1F;
+	unsigned short numberArgs;
+	memcpy(&numberArgs, &data[position + sizeof(unsigned char)*2], sizeof(unsigned short));
+	if (numberArgs != 0) return 0;
+	*isBoolean=nativeFunction == NATIVE_FN_RTL_ISHOST || nativeFunction == NATIVE_FN_RTL_ISDEVICE;
+	if (nativeFunction == NATIVE_FN_RTL_ISHOST) {
+		*value=values->isHost ? 1 : 0;
+	} else if (nativeFunction == NATIVE_FN_RTL_ISDEVICE) {
+		*value=values->isHost ? 0 : 1;
+	} else if (nativeFunction == NATIVE_FN_RTL_COREID && values->coreId >= 0) {
+		*value=values->coreId;
+	} else if (nativeFunction == NATIVE_FN_RTL_NUMCORES && values->numberCores >= 0) {
+		*value=values->numberCores;
+	} else {
+		return 0;
+	}
+	return 1;
+}
+
+/**
+ * Appends an edit to a growable list of these, an edit which removes bytes has an empty replacement
+ */
+static struct code_edit* appendCodeEdit(struct code_edit* edits, int* number, int* capacity, unsigned int position, unsigned int length,
+		struct memorycontainer* replacement) {
+	if (*number == *capacity) {
+		*capacity=*capacity == 0 ? 16 : *capacity * 2;
+		edits=(struct code_edit*) realloc(edits, sizeof(struct code_edit) * *capacity);
+	}
+	if (replacement == NULL) {
+		replacement=(struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
+		replacement->length=0;
+		replacement->data=NULL;
+		replacement->lineDefns=NULL;
+	}
+	edits[*number].position=position;
+	edits[*number].length=length;
+	edits[*number].replacement=replacement;
+	(*number)++;
+	return edits;
+}
+
+/**
+ * Loop invariant code motion pass over the code of the main program or a function (which starts with its header.) Expressions
+ * in a loop which give the same value on every iteration are evaluated once into a temporary before the loop. These are built
+ * from constants, variables which the loop does not assign to, and side effect free native functions (and functions which just
+ * call one of these.) Only expressions which can not raise an error are moved, as the loop might never have evaluated them.
+ * Loops are processed outermost first, and the code is walked again after each one is rewritten
+ */
+struct memorycontainer* hoistLoopInvariants(struct memorycontainer* code, int isFunction) {
+	struct code_scan_state state;
+	struct position_list processedLoops;
+	unsigned int position, loopEnd, bodyStart=0;
+	unsigned short numberArgs;
+	int label, rewritten=1;
+	if (code == NULL) return code;
+	if (isFunction) {
+		memcpy(&numberArgs, code->data, sizeof(unsigned short));
+		bodyStart=sizeof(unsigned short) * (2 + numberArgs);
+	}
+	processedLoops.entries=NULL;
+	processedLoops.number=processedLoops.capacity=0;
+	while (rewritten) {
+		rewritten=0;
+		// Walk the entire code to find the length fields that need updating if a loop is rewritten
+		initialiseCodeScanState(&state, code, isFunction);
+		position=bodyStart;
+		while (position < code->length && !state.failed) position=scanStatement(&state, position);
+		position=bodyStart;
+		while (position < code->length && !state.failed && !rewritten) {
+			loopEnd=getLoopEnd(code, position, &label);
+			if (loopEnd > 0 && !containsPositionEntry(&processedLoops, (unsigned int) label)) {
+				appendPositionEntry(&processedLoops, (unsigned int) label);
+				rewritten=hoistLoopInvariantsOutOfLoop(code, position, loopEnd, label, &state.lengthFields, isFunction);
+			}
+			if (!rewritten) {
+				struct code_scan_state walkState;
+				initialiseCodeScanState(&walkState, code, isFunction);
+				position=scanStatement(&walkState, position);
+				freeCodeScanState(&walkState);
+			}
+		}
+		freeCodeScanState(&state);
+	}
+	free(processedLoops.entries);
+	return code;
+}
+
+/**
+ * Hoists the invariant expressions out of the loop which starts at some position and ends before another, returning whether
+ * there were any. Each distinct expression is assigned to a new temporary ahead of the loop (which is where its label now
+ * points to) and replaced by this variable in the loop, with the lengths of conditionals and loops around this updated
+ */
+static int hoistLoopInvariantsOutOfLoop(struct memorycontainer* code, unsigned int loopStart, unsigned int loopEnd, int label,
+		struct position_list* lengthFields, int isFunction) {
+	struct code_scan_state state;
+	struct lineDefinition * root, * next, * kept=NULL;
+	unsigned int position, i, j, * map, * temporaryPoints, preambleStart=0, newLength, start, length, oldPosition, newPosition;
+	unsigned short * temporaries, frameSize, blockLength;
+	char * newData;
+	int c;
+
+	initialiseCodeScanState(&state, code, isFunction);
+	for (position=loopStart;position < loopEnd && !state.failed;) position=scanStatement(&state, position);
+	for (c=0;c<state.assignedSlots.number;c++) {
+		unsigned short slot=(unsigned short) state.assignedSlots.entries[c];
+		if (!(slot & LOCAL_VARIABLE_FLAG) || containsPositionEntry(&state.parameterSlots, slot)) state.assignsAliasable=1;
+	}
+	state.findCandidates=1;
+	for (position=loopStart;position < loopEnd && !state.failed;) position=scanStatement(&state, position);
+	if (state.failed || state.candidates.number == 0) {
+		freeCodeScanState(&state);
+		return 0;
+	}
+
+	// Operands are recorded once their parent is known not to be invariant, so these are put back into the order of the code
+	int numberCandidates=state.candidates.number / 2;
+	for (c=1;c<numberCandidates;c++) {
+		start=state.candidates.entries[c*2];
+		length=state.candidates.entries[c*2+1];
+		for (j=(unsigned int) c;j > 0 && state.candidates.entries[(j-1)*2] > start;j--) {
+			state.candidates.entries[j*2]=state.candidates.entries[(j-1)*2];
+			state.candidates.entries[j*2+1]=state.candidates.entries[(j-1)*2+1];
+		}
+		state.candidates.entries[j*2]=start;
+		state.candidates.entries[j*2+1]=length;
+	}
+	// Each distinct expression is held in a new temporary, the same expression appearing again shares this
+	temporaries=(unsigned short*) malloc(sizeof(unsigned short) * numberCandidates);
+	temporaryPoints=(unsigned int*) malloc(sizeof(unsigned int) * numberCandidates);
+	unsigned int preambleLength=0;
+	for (c=0;c<numberCandidates;c++) {
+		start=state.candidates.entries[c*2];
+		length=state.candidates.entries[c*2+1];
+		temporaryPoints[c]=0;
+		for (j=0;j<(unsigned int) c;j++) {
+			if (temporaryPoints[j] > 0 && areLoopExpressionsEqual(code, state.candidates.entries[j*2], start, length)) break;
+		}
+		if (j < (unsigned int) c) {
+			temporaries[c]=temporaries[j];
+		} else {
+			if (isFunction) {
+				memcpy(&frameSize, &code->data[sizeof(unsigned short)], sizeof(unsigned short));
+				temporaries[c]=LOCAL_VARIABLE_FLAG | frameSize;
+				frameSize++;
+				memcpy(&code->data[sizeof(unsigned short)], &frameSize, sizeof(unsigned short));
+			} else {
+				temporaries[c]=current_global_slot++;
+			}
+			// Offset of the expression in the assignment of the temporary, plus one so that zero marks a repeated expression
+			temporaryPoints[c]=preambleLength + sizeof(unsigned char)*2 + sizeof(unsigned short) + 1;
+			preambleLength+=sizeof(unsigned char)*2 + sizeof(unsigned short) + length;
+		}
+	}
+
+	newLength=code->length + preambleLength;
+	for (c=0;c<numberCandidates;c++) newLength-=state.candidates.entries[c*2+1] - (sizeof(unsigned char) + sizeof(unsigned short));
+	newData=(char*) arenaAllocate(newLength);
+	map=(unsigned int*) malloc(sizeof(unsigned int) * (code->length + 1));
+	for (c=0, oldPosition=0, newPosition=0;oldPosition <= code->length;) {
+		if (oldPosition == loopStart) {
+			// The assignments of the temporaries are placed before the loop
+			preambleStart=newPosition;
+			for (i=0;i<(unsigned int) numberCandidates;i++) {
+				if (temporaryPoints[i] == 0) continue;
+				newData[newPosition++]=LET_TOKEN;
+				newData[newPosition++]=IDENTIFIER_TOKEN;
+				memcpy(&newData[newPosition], &temporaries[i], sizeof(unsigned short));
+				newPosition+=sizeof(unsigned short);
+				memcpy(&newData[newPosition], &code->data[state.candidates.entries[i*2]], state.candidates.entries[i*2+1]);
+				newPosition+=state.candidates.entries[i*2+1];
+			}
+		}
+		map[oldPosition]=newPosition;
+		if (c < numberCandidates && oldPosition == state.candidates.entries[c*2]) {
+			for (i=1;i<state.candidates.entries[c*2+1];i++) map[oldPosition+i]=newPosition;
+			newData[newPosition++]=IDENTIFIER_TOKEN;
+			memcpy(&newData[newPosition], &temporaries[c], sizeof(unsigned short));
+			newPosition+=sizeof(unsigned short);
+			oldPosition+=state.candidates.entries[c*2+1];
+			c++;
+		} else {
+			if (oldPosition < code->length) newData[newPosition++]=code->data[oldPosition];
+			oldPosition++;
+		}
+	}
+	// Anything which went to the start of the loop now goes to the temporaries, apart from the loop jumping back round
+	map[loopStart]=preambleStart;
+
+	for (i=0;i<(unsigned int) lengthFields->number;i++) {
+		position=lengthFields->entries[i];
+		memcpy(&blockLength, &code->data[position], sizeof(unsigned short));
+		start=position + sizeof(unsigned short);
+		blockLength=(unsigned short) (map[start + blockLength] - map[start]);
+		memcpy(&newData[map[position]], &blockLength, sizeof(unsigned short));
+	}
+
+	for (root=code->lineDefns;root != NULL;root=next) {
+		next=root->next;
+		for (c=0;c<numberCandidates;c++) {
+			start=state.candidates.entries[c*2];
+			if ((unsigned int) root->currentpoint >= start && (unsigned int) root->currentpoint < start + state.candidates.entries[c*2+1]) break;
+		}
+		if (c < numberCandidates) {
+			// In a hoisted expression, these move with it to the assignment of its temporary unless they were in a repeat of it
+			if (temporaryPoints[c] == 0) continue;
+			root->currentpoint=preambleStart + temporaryPoints[c] - 1 + (root->currentpoint - start);
+		} else if (root->type == 0 && root->linenumber == label && (unsigned int) root->currentpoint == loopStart) {
+			root->currentpoint=preambleStart + preambleLength;
+		} else {
+			root->currentpoint=map[root->currentpoint];
+		}
+		root->next=kept;
+		kept=root;
+	}
+	code->lineDefns=kept;
+
+	// A condition which is now a comparison of two variables or constants can be run as a compare and branch superinstruction
+	for (i=0;i<(unsigned int) state.conditionals.number;i++) {
+		position=map[state.conditionals.entries[i]] + sizeof(unsigned char);
+		unsigned char comparison=((unsigned char*) newData)[position];
+		if (comparison < EQ_TOKEN || comparison > GEQ_TOKEN) continue;
+		start=position + sizeof(unsigned char);
+		for (j=0;j<2;j++) {
+			unsigned char token=((unsigned char*) newData)[start];
+			if (token != IDENTIFIER_TOKEN && token != INTEGER_TOKEN && token != REAL_TOKEN && token != BOOLEAN_TOKEN) break;
+			start+=getExpressionLength(newData, start);
+		}
+		if (j == 2 && start == position + getExpressionLength(newData, position)) newData[position-sizeof(unsigned char)]=IF_COMPARE_TOKEN;
+	}
+
+	code->data=newData;
+	code->length=newLength;
+	free(map);
+	free(temporaries);
+	free(temporaryPoints);
+	freeCodeScanState(&state);
+	return 1;
+}
+
+/**
+ * Determines whether a loop starts at some position, returning the position after its end (or zero if there is not one here)
+ * and setting the label that it jumps back round to. Loops are either a conditional whose block ends by jumping back to it (a
+ * while loop) or a for loop, whose block is followed by the jump back
+ */
+static unsigned int getLoopEnd(struct memorycontainer* code, unsigned int position, int * label) {
+	unsigned char token=((unsigned char*) code->data)[position];
+	unsigned int lengthPoint, end;
+	unsigned short blockLength;
+	struct lineDefinition * loopLabel, * jump;
+	if (token == IF_TOKEN) {
+		lengthPoint=position + sizeof(unsigned char) + getExpressionLength(code->data, position + sizeof(unsigned char));
+	} else if (token == IF_COMPARE_TOKEN) {
+		lengthPoint=position + sizeof(unsigned char)*2;
+		lengthPoint+=getExpressionLength(code->data, lengthPoint);
+		lengthPoint+=getExpressionLength(code->data, lengthPoint);
+	} else if (token == FOR_TOKEN || token == FOR_RANGE_TOKEN) {
+		lengthPoint=position + sizeof(unsigned char) + sizeof(unsigned short)*4;
+	} else {
+		return 0;
+	}
+	memcpy(&blockLength, &code->data[lengthPoint], sizeof(unsigned short));
+	end=lengthPoint + sizeof(unsigned short) + blockLength;
+	if (token == FOR_TOKEN || token == FOR_RANGE_TOKEN) end+=sizeof(unsigned char) + sizeof(unsigned short);
+	if (end > code->length || end < lengthPoint + sizeof(unsigned short) + sizeof(unsigned char) + sizeof(unsigned short) ||
+			code->data[end - sizeof(unsigned short) - sizeof(unsigned char)] != GOTO_TOKEN) return 0;
+	loopLabel=findLineDefinitionAt(code->lineDefns, position, 0);
+	jump=findLineDefinitionAt(code->lineDefns, end - sizeof(unsigned short), 1);
+	if (loopLabel == NULL || jump == NULL || loopLabel->linenumber != jump->linenumber) return 0;
+	*label=loopLabel->linenumber;
+	return end;
+}
+
+/**
+ * Scans a statement, recording the variables assigned to, length fields, conditionals and calls, and scanning its expressions.
+ * Returns the position of the next statement, with blocks following their conditional or loop directly
+ */
+static unsigned int scanStatement(struct code_scan_state* state, unsigned int position) {
+	unsigned char token=((unsigned char*) state->data)[position];
+	unsigned short slot;
+	int i;
+	state->statementStart=position;
+	position+=sizeof(unsigned char);
+	switch (token) {
+	case LET_TOKEN:
+	case LETNOALIAS_TOKEN:
+		position=scanAssignmentTarget(state, position);
+		return scanStatementExpression(state, position);
+	case IF_TOKEN:
+	case IFELSE_TOKEN:
+		if (state->findCandidates) appendPositionEntry(&state->conditionals, position - sizeof(unsigned char));
+		appendPositionEntry(&state->branches, position - sizeof(unsigned char));
+		position=scanStatementExpression(state, position);
+		appendPositionEntry(&state->lengthFields, position);
+		return position + sizeof(unsigned short);
+	case IF_COMPARE_TOKEN:
+		appendPositionEntry(&state->branches, position - sizeof(unsigned char));
+		position=scanStatementExpression(state, position + sizeof(unsigned char));
+		position=scanStatementExpression(state, position);
+		appendPositionEntry(&state->lengthFields, position);
+		return position + sizeof(unsigned short);
+	case FOR_TOKEN:
+	case FOR_RANGE_TOKEN:
+		// Loop counter, variable, then for a for loop the array (which is read) and trip count, or the stop and step values
+		for (i=0;i<4;i++) {
+			memcpy(&slot, &state->data[position + sizeof(unsigned short) * i], sizeof(unsigned short));
+			if (i != 2 || token == FOR_RANGE_TOKEN) appendPositionEntry(&state->assignedSlots, slot);
+		}
+		appendPositionEntry(&state->lengthFields, position + sizeof(unsigned short) * 4);
+		return position + sizeof(unsigned short) * 5;
+	case GOTO_TOKEN:
+		return position + sizeof(unsigned short);
+	case INCREMENT_TOKEN:
+		memcpy(&slot, &state->data[position], sizeof(unsigned short));
+		appendPositionEntry(&state->assignedSlots, slot);
+		return position + sizeof(unsigned short) + sizeof(unsigned char) + sizeof(int);
+	case LET_FROM_ARRAY_TOKEN:
+	case LET_TO_ARRAY_TOKEN:
+		memcpy(&slot, &state->data[position], sizeof(unsigned short));
+		appendPositionEntry(&state->assignedSlots, slot);
+		position+=sizeof(unsigned short) * (token == LET_FROM_ARRAY_TOKEN ? 2 : 1);
+		position=scanStatementExpression(state, position);
+		return token == LET_TO_ARRAY_TOKEN ? scanStatementExpression(state, position) : position;
+	case FNCALL_TOKEN:
+	case FNCALL_BY_VAR_TOKEN:
+	case NATIVE_TOKEN:
+		// A call on its own is a statement, so only its arguments can be replaced
+		position-=sizeof(unsigned char);
+		scanExpression(state, position);
+		return position + getExpressionLength(state->data, position);
+	case RETURN_EXP_TOKEN:
+		return scanStatementExpression(state, position);
+	case ALIAS_TOKEN:
+		memcpy(&slot, &state->data[position], sizeof(unsigned short));
+		appendPositionEntry(&state->assignedSlots, slot);
+		return scanStatementExpression(state, position + sizeof(unsigned short));
+	case STOP_TOKEN:
+	case RETURN_TOKEN:
+		return position;
+	default:
+		// Unknown statements stop the pass, the code is then left as it is
+		state->failed=1;
+		return position;
+	}
+}
+
+/**
+ * Scans the target of an assignment, which is a variable or an element of an array whose index expressions are scanned
+ */
+static unsigned int scanAssignmentTarget(struct code_scan_state* state, unsigned int position) {
+	unsigned char token=((unsigned char*) state->data)[position], numberIndexes;
+	unsigned short slot;
+	int i;
+	if (token != IDENTIFIER_TOKEN && token != ARRAYACCESS_TOKEN) {
+		state->failed=1;
+		return position + getExpressionLength(state->data, position);
+	}
+	memcpy(&slot, &state->data[position + sizeof(unsigned char)], sizeof(unsigned short));
+	appendPositionEntry(&state->assignedSlots, slot);
+	position+=sizeof(unsigned char) + sizeof(unsigned short);
+	if (token == ARRAYACCESS_TOKEN) {
+		numberIndexes=((unsigned char*) state->data)[position];
+		position+=sizeof(unsigned char);
+		for (i=0;i<numberIndexes;i++) position=scanStatementExpression(state, position);
+	}
+	return position;
+}
+
+/**
+ * Scans an expression held directly by a statement, which is a candidate for hoisting if it is invariant. Returns the position
+ * after the expression
+ */
+static unsigned int scanStatementExpression(struct code_scan_state* state, unsigned int position) {
+	scanOperand(state, position, scanExpression(state, position));
+	return position + getExpressionLength(state->data, position);
+}
+
+/**
+ * Scans an expression, returning whether it is invariant. Operands of an expression which is not invariant are candidates for
+ * hoisting themselves. Short circuiting logical operators, array literals and register format expressions are not looked into
+ * for candidates, as their operands might not be evaluated or are held in a different format, but assignments and calls in them
+ * are still recorded
+ */
+static int scanExpression(struct code_scan_state* state, unsigned int position) {
+	unsigned char token=((unsigned char*) state->data)[position];
+	unsigned int start=position, operandPoint, i;
+	unsigned short slot, numberItems;
+	int invariant, * operandsInvariant;
+	position+=sizeof(unsigned char);
+	switch (token) {
+	case INTEGER_TOKEN:
+	case REAL_TOKEN:
+	case BOOLEAN_TOKEN:
+	case STRING_TOKEN:
+	case NONE_TOKEN:
+		return 1;
+	case IDENTIFIER_TOKEN:
+		memcpy(&slot, &state->data[position], sizeof(unsigned short));
+		return isLoopInvariantVariable(state, slot);
+	case FN_ADDR_TOKEN:
+	case REFERENCE_TOKEN:
+	case SYMBOL_TOKEN:
+		return 0;
+	case ADD_TOKEN:
+	case SUB_TOKEN:
+	case MUL_TOKEN:
+	case DIV_TOKEN:
+	case MOD_TOKEN:
+	case POW_TOKEN: {
+		operandPoint=position + getExpressionLength(state->data, position);
+		int invariant1=scanExpression(state, position), invariant2=scanExpression(state, operandPoint);
+		invariant=invariant1 && invariant2;
+		if (token == DIV_TOKEN || token == MOD_TOKEN) {
+			// Division by zero raises an error, so this is only moved when dividing by some other constant
+			int divisor=0;
+			if (((unsigned char*) state->data)[operandPoint] == INTEGER_TOKEN) {
+				memcpy(&divisor, &state->data[operandPoint + sizeof(unsigned char)], sizeof(int));
+			}
+			if (divisor == 0 || divisor == -1) invariant=0;
+		}
+		if (!invariant) {
+			scanOperand(state, position, invariant1);
+			scanOperand(state, operandPoint, invariant2);
+		}
+		return invariant;
+	}
+	case EQ_TOKEN:
+	case NEQ_TOKEN:
+	case GT_TOKEN:
+	case GEQ_TOKEN:
+	case LT_TOKEN:
+	case LEQ_TOKEN:
+	case IS_TOKEN:
+		operandPoint=position + getExpressionLength(state->data, position);
+		scanOperand(state, position, scanExpression(state, position));
+		scanOperand(state, operandPoint, scanExpression(state, operandPoint));
+		return 0;
+	case NOT_TOKEN:
+		scanOperand(state, position, scanExpression(state, position));
+		return 0;
+	case ARRAYACCESS_TOKEN:
+		numberItems=((unsigned char*) state->data)[position + sizeof(unsigned short)];
+		position+=sizeof(unsigned short) + sizeof(unsigned char);
+		for (i=0;i<numberItems;i++) position=scanStatementExpression(state, position);
+		return 0;
+	case NATIVE_TOKEN:
+		memcpy(&numberItems, &state->data[position + sizeof(unsigned char)], sizeof(unsigned short));
+		if (start != state->statementStart) appendPositionEntry(&state->natives, start);
+		invariant=isSideEffectFreeNative(state->data[position]);
+		position+=sizeof(unsigned char) + sizeof(unsigned short);
+		operandsInvariant=(int*) malloc(sizeof(int) * (numberItems + 1));
+		for (i=0, operandPoint=position;i<numberItems;i++) {
+			operandsInvariant[i]=scanExpression(state, operandPoint);
+			invariant=invariant && operandsInvariant[i];
+			operandPoint+=getExpressionLength(state->data, operandPoint);
+		}
+		for (i=0, operandPoint=position;i<numberItems && !invariant;i++) {
+			if (((unsigned char*) state->data)[operandPoint] == IDENTIFIER_TOKEN) {
+				// Other natives might write into a variable passed to them, such as the buffer of a communication call
+				memcpy(&slot, &state->data[operandPoint + sizeof(unsigned char)], sizeof(unsigned short));
+				appendPositionEntry(&state->assignedSlots, slot);
+			}
+			scanOperand(state, operandPoint, operandsInvariant[i]);
+			operandPoint+=getExpressionLength(state->data, operandPoint);
+		}
+		free(operandsInvariant);
+		return invariant;
+	case FNCALL_TOKEN:
+	case FNCALL_BY_VAR_TOKEN:
+		memcpy(&numberItems, &state->data[position + sizeof(unsigned short)], sizeof(unsigned short));
+		if (token == FNCALL_TOKEN) appendPositionEntry(start == state->statementStart ? &state->callStatements : &state->callExpressions, start);
+		if (token == FNCALL_TOKEN && numberItems == 0 && isSideEffectFreeCall(state, position)) return 1;
+		// Arguments are passed by reference so might be assigned to by the function, as might any global variable
+		state->impureCall=1;
+		for (i=0;i<numberItems;i++) {
+			memcpy(&slot, &state->data[position + sizeof(unsigned short) * (2 + i)], sizeof(unsigned short));
+			appendPositionEntry(&state->assignedSlots, slot);
+		}
+		return 0;
+	case LET_TOKEN:
+		// Assignment of a temporary ahead of a function call, followed by the expression itself
+		position=scanAssignmentTarget(state, position);
+		position=scanStatementExpression(state, position);
+		scanStatementExpression(state, position);
+		return 0;
+	case AND_TOKEN:
+	case OR_TOKEN:
+	case ARRAY_TOKEN:
+	case REGISTER_EXPRESSION_TOKEN:
+		scanOpaqueExpression(state, start);
+		return 0;
+	default:
+		state->failed=1;
+		return 0;
+	}
+}
+
+/**
+ * Records an operand as a candidate for hoisting, when looking for these, if it is invariant and evaluating it does some work
+ */
+static void scanOperand(struct code_scan_state* state, unsigned int position, int invariant) {
+	if (!state->findCandidates || !invariant || !isWorthHoisting(((unsigned char*) state->data)[position])) return;
+	appendPositionEntry(&state->candidates, position);
+	appendPositionEntry(&state->candidates, getExpressionLength(state->data, position));
+}
+
+/**
+ * Scans an expression which is not looked into for candidates. A register format expression can not be walked, so any function
+ * call in one (which has a line definition for its target) is treated as possibly assigning to any variable
+ */
+static void scanOpaqueExpression(struct code_scan_state* state, unsigned int position) {
+	unsigned char token=((unsigned char*) state->data)[position];
+	unsigned int length=getExpressionLength(state->data, position), operandPoint;
+	char findCandidates=state->findCandidates;
+	struct lineDefinition * root;
+	if (token == REGISTER_EXPRESSION_TOKEN) {
+		for (root=state->lineDefns;root != NULL;root=root->next) {
+			if ((unsigned int) root->currentpoint >= position && (unsigned int) root->currentpoint < position + length) state->impureCall=1;
+		}
+		return;
+	}
+	state->findCandidates=0;
+	if (token == ARRAY_TOKEN) {
+		int i, numberElements;
+		memcpy(&numberElements, &state->data[position + sizeof(unsigned char)], sizeof(int));
+		operandPoint=position + sizeof(unsigned char) + sizeof(int);
+		if (state->data[operandPoint]) {
+			scanExpression(state, operandPoint + sizeof(unsigned char));
+			operandPoint+=getExpressionLength(state->data, operandPoint + sizeof(unsigned char));
+		}
+		operandPoint+=sizeof(unsigned char);
+		for (i=0;i<numberElements;i++) {
+			scanExpression(state, operandPoint);
+			operandPoint+=getExpressionLength(state->data, operandPoint);
+		}
+	} else {
+		appendPositionEntry(&state->skipFields, position + sizeof(unsigned char));
+		operandPoint=position + sizeof(unsigned char) + sizeof(unsigned short);
+		scanExpression(state, operandPoint);
+		scanExpression(state, operandPoint + getExpressionLength(state->data, operandPoint));
+	}
+	state->findCandidates=findCandidates;
+}
+
+/**
+ * Determines whether a variable is invariant in the loop. It must not be assigned to in the loop, which must not call a function
+ * that might assign to it. In a function, arguments and global variables might be aliases of each other so are not invariant if
+ * any of these are assigned to
+ */
+static int isLoopInvariantVariable(struct code_scan_state* state, unsigned short slot) {
+	if (aliasingAssembled || state->impureCall || containsPositionEntry(&state->assignedSlots, slot)) return 0;
+	if (state->inFunction && state->assignsAliasable && (!(slot & LOCAL_VARIABLE_FLAG) ||
+			containsPositionEntry(&state->parameterSlots, slot))) return 0;
+	return 1;
+}
+
+/**
+ * Determines whether an invariant expression does enough work to be worth hoisting, which is not the case for a constant or variable
+ */
+static int isWorthHoisting(unsigned char token) {
+	return token != INTEGER_TOKEN && token != REAL_TOKEN && token != BOOLEAN_TOKEN && token != STRING_TOKEN && token != NONE_TOKEN &&
+			token != IDENTIFIER_TOKEN;
+}
+
+/**
+ * Determines whether a native function has no side effects and gives the same result whenever it is called with the same arguments
+ */
+static int isSideEffectFreeNative(unsigned char nativeFunction) {
+	nativeFunction=nativeFunction & 0x1F;
+	return nativeFunction == NATIVE_FN_RTL_ISHOST || nativeFunction == NATIVE_FN_RTL_ISDEVICE || nativeFunction == NATIVE_FN_RTL_NUMCORES ||
+			nativeFunction == NATIVE_FN_RTL_COREID || nativeFunction == NATIVE_FN_RTL_NUMDIMS || nativeFunction == NATIVE_FN_RTL_DSIZE ||
+			nativeFunction == NATIVE_FN_RTL_SIZE;
+}
+
+/**
+ * Determines whether a function call (whose target follows the token at some position) is to a side effect free function
+ */
+static int isSideEffectFreeCall(struct code_scan_state* state, unsigned int position) {
+	struct lineDefinition * target=findLineDefinitionAt(state->lineDefns, position, 3);
+	return target != NULL && isFunctionSideEffectFree(target->name);
+}
+
+/**
+ * Determines whether two expressions of the same length are the same, which includes any function calls being to the same target
+ */
+static int areLoopExpressionsEqual(struct memorycontainer* code, unsigned int position1, unsigned int position2, unsigned int length) {
+	struct lineDefinition * root, * other;
+	if (getExpressionLength(code->data, position1) != length || memcmp(&code->data[position1], &code->data[position2], length) != 0) return 0;
+	for (root=code->lineDefns;root != NULL;root=root->next) {
+		if ((unsigned int) root->currentpoint < position1 || (unsigned int) root->currentpoint >= position1 + length) continue;
+		other=findLineDefinitionAt(code->lineDefns, position2 + (root->currentpoint - position1), root->type);
+		if (other == NULL || root->name == NULL || other->name == NULL || strcmp(root->name, other->name) != 0) return 0;
+	}
+	return 1;
+}
+
+/**
+ * Finds the line definition of some type at a position, or NULL if there is not one
+ */
+static struct lineDefinition* findLineDefinitionAt(struct lineDefinition* root, unsigned int position, char type) {
+	while (root != NULL) {
+		if (root->type == type && (unsigned int) root->currentpoint == position) return root;
+		root=root->next;
+	}
+	return NULL;
+}
+
+static void appendPositionEntry(struct position_list* list, unsigned int entry) {
+	if (list->number == list->capacity) {
+		list->capacity=list->capacity == 0 ? 16 : list->capacity * 2;
+		list->entries=(unsigned int*) realloc(list->entries, sizeof(unsigned int) * list->capacity);
+	}
+	list->entries[list->number++]=entry;
+}
+
+static int containsPositionEntry(struct position_list* list, unsigned int entry) {
+	int i;
+	for (i=0;i<list->number;i++) {
+		if (list->entries[i] == entry) return 1;
+	}
+	return 0;
+}
+
+static void initialiseCodeScanState(struct code_scan_state* state, struct memorycontainer* code, int isFunction) {
+	unsigned short numberArgs, slot;
+	int i;
+	memset(state, 0, sizeof(struct code_scan_state));
+	state->data=code->data;
+	state->lineDefns=code->lineDefns;
+	state->inFunction=(char) isFunction;
+	if (isFunction) {
+		memcpy(&numberArgs, code->data, sizeof(unsigned short));
+		for (i=0;i<numberArgs;i++) {
+			memcpy(&slot, &code->data[sizeof(unsigned short) * (2 + i)], sizeof(unsigned short));
+			appendPositionEntry(&state->parameterSlots, slot);
+		}
+	}
+}
+
+static void freeCodeScanState(struct code_scan_state* state) {
+	free(state->assignedSlots.entries);
+	free(state->parameterSlots.entries);
+	free(state->lengthFields.entries);
+	free(state->candidates.entries);
+	free(state->conditionals.entries);
+	free(state->skipFields.entries);
+	free(state->callStatements.entries);
+	free(state->callExpressions.entries);
+	free(state->branches.entries);
+	free(state->natives.entries);
+}
+
+/**
+ * Static type inference pass over the assembled program, which annotates arithmetic and comparison operators whose operands are
+ * provably both integers or both reals by rewriting them to the typed operator. These skip the runtime type checks entirely, so
+ * anything which is not provable keeps the generic operator. A variable's type is the combination of every value assigned to it,
+ * with variables that are aliased (function arguments and parameters, or those whose symbol or reference is taken) being of any
+ * type. Variables are read as an integer zero before their first assignment, which has the same bit pattern as a real zero.
+ * This is not applied to the register format, whose instructions carry their own operators
+ */
+void inferExpressionTypes(struct memorycontainer* program) {
+	if (registerExpressions || program == NULL || program->length < sizeof(unsigned short)) return;
+	struct type_inference_state state;
+	struct lineDefinition * root;
+	unsigned int i, j, position, numberRegions=1, * regionStarts;
+	unsigned char ** regionLocalTypes;
+	unsigned short numberArgs, * regionNumberLocals;
+
+	for (root=program->lineDefns;root != NULL;root=root->next) {
+		if (root->type == 2) numberRegions++;
+	}
+	// The main code follows the program header, with each function following this and starting with its own header
+	regionStarts=(unsigned int*) malloc(sizeof(unsigned int) * (numberRegions + 1));
+	regionNumberLocals=(unsigned short*) malloc(sizeof(unsigned short) * numberRegions);
+	regionLocalTypes=(unsigned char**) malloc(sizeof(unsigned char*) * numberRegions);
+	regionStarts[0]=sizeof(unsigned short);
+	regionNumberLocals[0]=0;
+	for (i=1, root=program->lineDefns;root != NULL;root=root->next) {
+		if (root->type == 2) regionStarts[i++]=root->currentpoint;
+	}
+	for (i=2;i<numberRegions;i++) {
+		unsigned int start=regionStarts[i];
+		for (j=i;j>1 && regionStarts[j-1] > start;j--) regionStarts[j]=regionStarts[j-1];
+		regionStarts[j]=start;
+	}
+	regionStarts[numberRegions]=program->length;
+
+	memcpy(&state.numberGlobals, program->data, sizeof(unsigned short));
+	state.globalTypes=(unsigned char*) calloc(state.numberGlobals + 1, sizeof(unsigned char));
+	for (i=0;i<numberRegions;i++) {
+		if (i > 0) memcpy(&regionNumberLocals[i], &program->data[regionStarts[i]+sizeof(unsigned short)], sizeof(unsigned short));
+		regionLocalTypes[i]=(unsigned char*) calloc(regionNumberLocals[i] + 1, sizeof(unsigned char));
+	}
+	state.failed=0;
+	state.rewrite=0;
+	// Walk the program until the variable types have settled, and then once more to rewrite the operators
+	while (!state.failed) {
+		state.changed=0;
+		for (i=0;i<numberRegions && !state.failed;i++) {
+			state.localTypes=regionLocalTypes[i];
+			state.numberLocals=regionNumberLocals[i];
+			position=regionStarts[i];
+			if (i > 0) {
+				// The parameters of a function alias the caller's arguments
+				memcpy(&numberArgs, &program->data[position], sizeof(unsigned short));
+				position+=sizeof(unsigned short) * 2;
+				for (j=0;j<numberArgs;j++) {
+					unsigned short slot;
+					memcpy(&slot, &program->data[position], sizeof(unsigned short));
+					assignInferredVariableType(&state, slot, INFERRED_ANY);
+					position+=sizeof(unsigned short);
+				}
+			}
+			while (position < regionStarts[i+1] && !state.failed) position=inferStatementTypes(&state, program->data, position);
+		}
+		if (state.rewrite) break;
+		if (!state.changed) state.rewrite=1;
+	}
+
+	for (i=0;i<numberRegions;i++) free(regionLocalTypes[i]);
+	free(regionLocalTypes);
+	free(regionNumberLocals);
+	free(regionStarts);
+	free(state.globalTypes);
+}
+
+/**
+ * Infers the types of a statement at some position, returning the position of the next statement. Blocks follow their
+ * conditional or loop statement directly so are visited in turn, an unknown statement stops the pass without any rewriting
+ */
+static unsigned int inferStatementTypes(struct type_inference_state* state, char * data, unsigned int position) {
+	unsigned char token=((unsigned char*) data)[position];
+	unsigned short slots[4];
+	position+=sizeof(unsigned char);
+	switch (token) {
+	case LET_TOKEN:
+	case LETNOALIAS_TOKEN:
+		inferAssignmentTypes(state, data, &position);
+		return position;
+	case IF_TOKEN:
+	case IFELSE_TOKEN:
+		inferExpressionType(state, data, &position);
+		return position + sizeof(unsigned short);
+	case IF_COMPARE_TOKEN: {
+		unsigned int comparisonPoint=position;
+		position+=sizeof(unsigned char);
+		unsigned char type1=inferLeafType(state, data, &position);
+		rewriteTypedOperator(state, data, comparisonPoint, type1, inferLeafType(state, data, &position));
+		return position + sizeof(unsigned short);
+	}
+	case FOR_TOKEN:
+		// Loop counter, variable, array and trip count, the variable takes the type of the array's elements
+		memcpy(slots, &data[position], sizeof(unsigned short) * 4);
+		assignInferredVariableType(state, slots[0], INFERRED_INT);
+		assignInferredVariableType(state, slots[1], getInferredVariableType(state, slots[2]));
+		assignInferredVariableType(state, slots[3], INFERRED_INT);
+		return position + sizeof(unsigned short) * 5;
+	case FOR_RANGE_TOKEN:
+		memcpy(slots, &data[position], sizeof(unsigned short) * 2);
+		assignInferredVariableType(state, slots[0], INFERRED_INT);
+		assignInferredVariableType(state, slots[1], INFERRED_INT);
+		return position + sizeof(unsigned short) * 5;
+	case GOTO_TOKEN:
+		return position + sizeof(unsigned short);
+	case FNCALL_TOKEN:
+	case FNCALL_BY_VAR_TOKEN:
+		inferFunctionCallTypes(state, data, &position);
+		return position;
+	case NATIVE_TOKEN:
+	case RETURN_EXP_TOKEN:
+		position-=token == NATIVE_TOKEN ? sizeof(unsigned char) : 0;
+		inferExpressionType(state, data, &position);
+		return position;
+	case ALIAS_TOKEN:
+		memcpy(slots, &data[position], sizeof(unsigned short));
+		assignInferredVariableType(state, slots[0], INFERRED_ANY);
+		position+=sizeof(unsigned short);
+		inferExpressionType(state, data, &position);
+		return position;
+	case STOP_TOKEN:
+	case RETURN_TOKEN:
+		return position;
+	case INCREMENT_TOKEN:
+		memcpy(slots, &data[position], sizeof(unsigned short));
+		assignInferredVariableType(state, slots[0], getInferredArithmeticType(getInferredVariableType(state, slots[0]), INFERRED_INT));
+		return position + sizeof(unsigned short) + sizeof(unsigned char) + sizeof(int);
+	case LET_FROM_ARRAY_TOKEN:
+		memcpy(slots, &data[position], sizeof(unsigned short) * 2);
+		assignInferredVariableType(state, slots[0], getInferredVariableType(state, slots[1]));
+		position+=sizeof(unsigned short) * 2;
+		inferLeafType(state, data, &position);
+		return position;
+	case LET_TO_ARRAY_TOKEN:
+		memcpy(slots, &data[position], sizeof(unsigned short));
+		position+=sizeof(unsigned short);
+		inferLeafType(state, data, &position);
+		assignInferredVariableType(state, slots[0], inferExpressionType(state, data, &position));
+		return position;
+	default:
+		state->failed=1;
+		return position;
+	}
+}
+
+/**
+ * Infers the type of the prefix expression at some position, which is advanced past the expression. Operators are rewritten
+ * to their typed form if this is the rewriting pass and the types of their operands are proven
+ */
+static unsigned char inferExpressionType(struct type_inference_state* state, char * data, unsigned int * position) {
+	unsigned int operatorPoint=*position, i;
+	unsigned char token=((unsigned char*) data)[*position], type1, type2;
+	unsigned short numberItems;
+	switch (token) {
+	case INTEGER_TOKEN:
+	case REAL_TOKEN:
+	case BOOLEAN_TOKEN:
+	case IDENTIFIER_TOKEN:
+		return inferLeafType(state, data, position);
+	case STRING_TOKEN:
+		*position+=sizeof(unsigned char) + strlen(&data[*position+sizeof(unsigned char)]) + 1;
+		return INFERRED_STRING;
+	case NONE_TOKEN:
+		*position+=sizeof(unsigned char);
+		return INFERRED_ANY;
+	case FN_ADDR_TOKEN:
+		*position+=sizeof(unsigned char) + sizeof(unsigned short);
+		return INFERRED_ANY;
+	case REFERENCE_TOKEN:
+	case SYMBOL_TOKEN:
+		// The variable can be changed through the reference or symbol
+		memcpy(&numberItems, &data[*position+sizeof(unsigned char)], sizeof(unsigned short));
+		assignInferredVariableType(state, numberItems, INFERRED_ANY);
+		*position+=sizeof(unsigned char) + sizeof(unsigned short);
+		return INFERRED_ANY;
+	case ARRAYACCESS_TOKEN: {
+		unsigned short slot;
+		memcpy(&slot, &data[*position+sizeof(unsigned char)], sizeof(unsigned short));
+		numberItems=((unsigned char*) data)[*position+sizeof(unsigned char)+sizeof(unsigned short)];
+		*position+=sizeof(unsigned char) * 2 + sizeof(unsigned short);
+		for (i=0;i<numberItems;i++) inferExpressionType(state, data, position);
+		return getInferredVariableType(state, slot);
+	}
+	case ARRAY_TOKEN: {
+		// The array takes the type of its last element
+		int numberElements;
+		memcpy(&numberElements, &data[*position+sizeof(unsigned char)], sizeof(int));
+		*position+=sizeof(unsigned char) + sizeof(int);
+		type1=INFERRED_ANY;
+		if (data[*position]) {
+			*position+=sizeof(unsigned char);
+			inferExpressionType(state, data, position);
+		} else {
+			*position+=sizeof(unsigned char);
+		}
+		for (i=0;i<(unsigned int) numberElements;i++) type1=inferExpressionType(state, data, position);
+		return type1;
+	}
+	case NATIVE_TOKEN:
+		type1=((unsigned char*) data)[*position+sizeof(unsigned char)] & 0x1F;
+		memcpy(&numberItems, &data[*position+sizeof(unsigned char)*2], sizeof(unsigned short));
+		*position+=sizeof(unsigned char) * 2 + sizeof(unsigned short);
+		for (i=0;i<numberItems;i++) inferExpressionType(state, data, position);
+		// The array size and core queries always give an integer
+		if (type1 == NATIVE_FN_RTL_NUMDIMS || type1 == NATIVE_FN_RTL_DSIZE || type1 == NATIVE_FN_RTL_SIZE ||
+				type1 == NATIVE_FN_RTL_NUMCORES || type1 == NATIVE_FN_RTL_COREID) return INFERRED_INT;
+		return INFERRED_ANY;
+	case FNCALL_TOKEN:
+	case FNCALL_BY_VAR_TOKEN:
+		*position+=sizeof(unsigned char);
+		inferFunctionCallTypes(state, data, position);
+		return INFERRED_ANY;
+	case LET_TOKEN:
+		// Assignment of a temporary ahead of a function call, which is then followed by the expression itself
+		*position+=sizeof(unsigned char);
+		inferAssignmentTypes(state, data, position);
+		return inferExpressionType(state, data, position);
+	case NOT_TOKEN:
+		*position+=sizeof(unsigned char);
+		inferExpressionType(state, data, position);
+		return INFERRED_BOOLEAN;
+	case AND_TOKEN:
+	case OR_TOKEN:
+		*position+=sizeof(unsigned char) + sizeof(unsigned short);
+		inferExpressionType(state, data, position);
+		inferExpressionType(state, data, position);
+		return INFERRED_BOOLEAN;
+	case EQ_TOKEN:
+	case NEQ_TOKEN:
+	case LT_TOKEN:
+	case GT_TOKEN:
+	case LEQ_TOKEN:
+	case GEQ_TOKEN:
+	case IS_TOKEN:
+		*position+=sizeof(unsigned char);
+		type1=inferExpressionType(state, data, position);
+		type2=inferExpressionType(state, data, position);
+		if (token != IS_TOKEN) rewriteTypedOperator(state, data, operatorPoint, type1, type2);
+		return INFERRED_BOOLEAN;
+	case ADD_TOKEN:
+	case SUB_TOKEN:
+	case MUL_TOKEN:
+	case DIV_TOKEN:
+	case MOD_TOKEN:
+	case POW_TOKEN:
+		*position+=sizeof(unsigned char);
+		type1=inferExpressionType(state, data, position);
+		type2=inferExpressionType(state, data, position);
+		if (token != POW_TOKEN && (token != MOD_TOKEN || type1 == INFERRED_INT)) rewriteTypedOperator(state, data, operatorPoint, type1, type2);
+		return getInferredArithmeticType(type1, type2);
+	default:
+		state->failed=1;
+		return INFERRED_ANY;
+	}
+}
+
+/**
+ * Infers the type of a constant or variable operand, as held directly in expressions and superinstructions
+ */
+static unsigned char inferLeafType(struct type_inference_state* state, char * data, unsigned int * position) {
+	unsigned char token=((unsigned char*) data)[*position];
+	unsigned short slot;
+	if (token == IDENTIFIER_TOKEN) {
+		memcpy(&slot, &data[*position+sizeof(unsigned char)], sizeof(unsigned short));
+		*position+=sizeof(unsigned char) + sizeof(unsigned short);
+		return getInferredVariableType(state, slot);
+	}
+	*position+=sizeof(unsigned char) + sizeof(int);
+	return token == INTEGER_TOKEN ? INFERRED_INT : token == REAL_TOKEN ? INFERRED_REAL : INFERRED_BOOLEAN;
+}
+
+/**
+ * Infers the types of a function call, whose arguments are aliased by the function's parameters so can be of any type
+ */
+static void inferFunctionCallTypes(struct type_inference_state* state, char * data, unsigned int * position) {
+	unsigned short numberArgs, slot, i;
+	memcpy(&numberArgs, &data[*position+sizeof(unsigned short)], sizeof(unsigned short));
+	*position+=sizeof(unsigned short) * 2;
+	for (i=0;i<numberArgs;i++) {
+		memcpy(&slot, &data[*position], sizeof(unsigned short));
+		assignInferredVariableType(state, slot, INFERRED_ANY);
+		*position+=sizeof(unsigned short);
+	}
+}
+
+/**
+ * Infers the types of an assignment to a variable or array element, the array takes the type of the element assigned
+ */
+static unsigned char inferAssignmentTypes(struct type_inference_state* state, char * data, unsigned int * position) {
+	unsigned short slot, i;
+	unsigned char numberIndexes=0;
+	memcpy(&slot, &data[*position+sizeof(unsigned char)], sizeof(unsigned short));
+	if (((unsigned char*) data)[*position] == ARRAYACCESS_TOKEN) numberIndexes=((unsigned char*) data)[*position+sizeof(unsigned char)+sizeof(unsigned short)];
+	*position+=sizeof(unsigned char) + sizeof(unsigned short) + (((unsigned char*) data)[*position] == ARRAYACCESS_TOKEN ? sizeof(unsigned char) : 0);
+	for (i=0;i<numberIndexes;i++) inferExpressionType(state, data, position);
+	unsigned char type=inferExpressionType(state, data, position);
+	assignInferredVariableType(state, slot, type);
+	return type;
+}
+
+/**
+ * Rewrites an arithmetic or comparison operator to its typed form if both operands are proven to be integers or reals
+ */
+static void rewriteTypedOperator(struct type_inference_state* state, char * data, unsigned int operatorPoint, unsigned char type1,
+		unsigned char type2) {
+	if (!state->rewrite || type1 != type2) return;
+	unsigned char token=((unsigned char*) data)[operatorPoint];
+	if (type1 == INFERRED_INT) {
+		data[operatorPoint]=token-EQ_TOKEN+INT_TYPED_TOKEN_BASE;
+	} else if (type1 == INFERRED_REAL) {
+		data[operatorPoint]=token-EQ_TOKEN+REAL_TYPED_TOKEN_BASE;
+	}
+}
+
+/**
+ * Infers the type of an arithmetic result, following the same rules as the interpreter
+ */
+static unsigned char getInferredArithmeticType(unsigned char type1, unsigned char type2) {
+	if (type1 == INFERRED_ANY || type2 == INFERRED_ANY) return INFERRED_ANY;
+	if (type1 == INFERRED_INT && type2 == INFERRED_INT) return INFERRED_INT;
+	if (type1 == INFERRED_STRING || type2 == INFERRED_STRING) return INFERRED_STRING;
+	return INFERRED_REAL;
+}
+
+/**
+ * Retrieves the inferred type of a variable when it is read, a variable not yet assigned holds an integer zero
+ */
+static unsigned char getInferredVariableType(struct type_inference_state* state, unsigned short slot) {
+	unsigned char type=*getInferredVariableTypeEntry(state, slot);
+	return type == INFERRED_UNASSIGNED ? INFERRED_INT : type;
+}
+
+/**
+ * Combines the type of a value assigned to a variable with its existing type, recording whether this has changed
+ */
+static void assignInferredVariableType(struct type_inference_state* state, unsigned short slot, unsigned char type) {
+	unsigned char * entry=getInferredVariableTypeEntry(state, slot);
+	unsigned char combinedType=*entry == INFERRED_UNASSIGNED || *entry == type ? type : INFERRED_ANY;
+	if (combinedType != *entry) {
+		*entry=combinedType;
+		state->changed=1;
+	}
+}
+
+/**
+ * Retrieves the inferred type entry of a variable slot, slots outside of the table share a final entry which is of any type
+ */
+static unsigned char* getInferredVariableTypeEntry(struct type_inference_state* state, unsigned short slot) {
+	if (slot & LOCAL_VARIABLE_FLAG) {
+		slot&=~LOCAL_VARIABLE_FLAG;
+		if (slot >= state->numberLocals) {
+			state->localTypes[state->numberLocals]=INFERRED_ANY;
+			return &state->localTypes[state->numberLocals];
+		}
+		return &state->localTypes[slot];
+	}
+	if (slot >= state->numberGlobals) {
+		state->globalTypes[state->numberGlobals]=INFERRED_ANY;
+		return &state->globalTypes[state->numberGlobals];
+	}
+	return &state->globalTypes[slot];
+}
+
+/**
+ * Adds a variable to the symbol table if it is not already present
+ */
+void addVariableIfNeeded( char * name) {
+	getVariableId(name, 1);
+}
+
+/**
+ * Gets the names of a range of global variable slots, as held in the global scope at the bottom of the scope stack. The name of
+ * a slot which is not in this scope, such as a loop variable declared in a nested scope, is left as NULL
+ */
+char** getGlobalVariableNames(unsigned short firstSlot, unsigned short numberSlots) {
+	struct scope_info * globalScope=scope;
+	struct hash_table_entry * entry;
+	int i;
+	char ** names=(char**) calloc(numberSlots + 1, sizeof(char*));
+	while (globalScope != NULL && globalScope->next != NULL) globalScope=globalScope->next;
+	if (globalScope == NULL || globalScope->variableTable == NULL) return names;
+	for (i=0;i<globalScope->variableTable->numberBuckets;i++) {
+		for (entry=globalScope->variableTable->buckets[i];entry != NULL;entry=entry->next) {
+			struct variable_node * variable=(struct variable_node*) entry->value;
+			if (variable->id >= firstSlot && variable->id - firstSlot < numberSlots) names[variable->id - firstSlot]=variable->name;
+		}
+	}
+	return names;
+}
+
+/**
+ * Gets the global slot for a variable of a module object which is being linked, a named variable is the global of that name
+ * (which is added if needed) whereas one without a name is given a slot of its own
+ */
+unsigned short linkGlobalVariable(char * name) {
+	if (name == NULL) return current_global_slot++;
+	return getVariableId(name, 1);
+}
+
+/**
+ * Retrieves the ID of a variable from the symbol table, with a flag whether we are to allow adding the variable in
+ * if it can not be found
+ */
+static unsigned short getVariableId(char * name, int allowAdd) {
+	struct scope_info * scopeNode=scope;
+	while (scopeNode != NULL) {
+		int id=findVariable(scopeNode, name);
+		if (id >= 0) return (unsigned short) id;
+		scopeNode=scopeNode->next;
+	}
+
+	if (allowAdd) {
+		return addVariable(name);
+	} else {
+		fprintf(stderr, "Can not find variable name %s at line %d, you must declare this before use\n", name, line_num);
+		exit(0);
+	}
+}
+
+/**
+ * Appends the slot of a variable to some memory and returns the new current location. When a module is compiled to an object the
+ * ids of global variables are recorded by line definitions, so that these are relocated to the slots of the program which the
+ * object is linked into
+ */
+static unsigned int appendVariableSlot(struct memorycontainer* memory, unsigned short slot, unsigned int position) {
+	if (isCompilingModuleObject() && !(slot & LOCAL_VARIABLE_FLAG)) {
+		struct lineDefinition * defn = (struct lineDefinition*) arenaAllocate(sizeof(struct lineDefinition));
+		defn->next=memory->lineDefns;
+		defn->type=5;
+		defn->name=NULL;
+		defn->linenumber=line_num;
+		defn->currentpoint=position;
+		memory->lineDefns=defn;
+	}
+	return appendVariable(memory, slot, position);
+}
+
+/**
+ * Determines whether a variable has been declared in any of the scopes which are currently entered
+ */
+int doesVariableExist(char* name) {
+    struct scope_info * scopeNode=scope;
+	while (scopeNode != NULL) {
+		if (findVariable(scopeNode, name) >= 0) return 1;
+		scopeNode=scopeNode->next;
+	}
+	return 0;
+}
+
+/**
+ * Finds a variable in a specific scope or returns -1 for no variable found, variable names are matched ignoring their case
+ */
+static int findVariable(struct scope_info * scopeNode,  char * name) {
+	if (scopeNode->variableTable == NULL) return -1;
+	struct variable_node * variable=(struct variable_node*) getHashTableEntry(scopeNode->variableTable, name);
+	return variable != NULL ? variable->id : -1;
+}
+
+/**
+ * Adds a variable to the scope at the top of the scope stack, allocates the slot to be the next free one. Variables
+ * declared in a function are given a slot in that function's frame, otherwise they are global
+ */
+static unsigned short addVariable(char * name) {
+	struct memory_arena * previousArena=setCurrentArena(scope->arena);
+	struct variable_node * newNode=(struct variable_node*) arenaAllocate(sizeof(struct variable_node));
+	newNode->name=arenaDuplicateString(name);
+	setCurrentArena(previousArena);
+	if (currentFunctionName != NULL) {
+		newNode->id = LOCAL_VARIABLE_FLAG | current_local_slot++;
+	} else {
+		newNode->id = current_global_slot++;
+	}
+	if (scope->variableTable == NULL) scope->variableTable=createHashTable(1);
+	putHashTableEntry(scope->variableTable, name, newNode);
 	return newNode->id;
 }
@@ -58,11 +58,17 @@
 #define NATIVE_RTL_DEREFRENCE_STR "rtl_dereference"
 #define NATIVE_RTL_FLATTEN_STR "rtl_flatten"
 #define NATIVE_RTL_ARRAY_COPY_STR "rtl_arraycopy"
+#define NATIVE_RTL_SIZE_STR "rtl_size"
 
 extern int line_num;
 extern char * fn_decorator;
+extern int registerExpressions;
+extern unsigned int bytesOptimisedAway;
+extern int currentForLine;
 
-// Used for tracking gotos and line numberings (which are resolved once the byte code is assembled)
+// Used for tracking gotos and line numberings (which are resolved once the byte code is assembled.) The type is a label (0), goto
+// (1), function start (2), function call (3), function address (4) or, when a module is compiled to an object, a global variable
+// id (5) which is relocated as the object is linked
 struct lineDefinition {
 	char type;
 	char * name;
@@ -88,12 +94,27 @@ struct functionDefinition {
 	char * name;
 	struct memorycontainer * contents;
 	int numberEntriesInSymbolTable, recursive, number_of_fn_calls, called;
+	unsigned int bytesOptimisedAway;
+	char sideEffectFree;
+	struct memorycontainer * inlineBody;
 	char ** functionCalls;
 };
 
 void enterFunction(char*);
+void addFunctionSource(char*, char*);
 unsigned short getNumberEntriesInSymbolTable(void);
+unsigned short getNumberEntriesInHostSymbolTable(void);
+unsigned short getNumberGlobalSymbolTableEntries(void);
+char** getGlobalVariableNames(unsigned short, unsigned short);
+unsigned short linkGlobalVariable(char*);
+int doesVariableExist(char*);
 void setNumberEntriesInSymbolTable(unsigned short);
+struct memorycontainer* appendProgramHeader(void);
+void inferExpressionTypes(struct memorycontainer*);
+int inlineFunctionCalls(struct memorycontainer*, int, char**, int*);
+void updateInlineableBody(struct functionDefinition*);
+struct memorycontainer* hoistLoopInvariants(struct memorycontainer*, int);
+int specialiseByteCode(struct memorycontainer*, int, int, int);
 void appendNewFunctionStatement(char*, struct stack_t*, struct memorycontainer*);
 void appendArgument(char*);
 struct memorycontainer* appendCallFunctionStatement(char*, struct stack_t*);
@@ -0,0 +1,338 @@
+/*
+ * Copyright (c) 2016, Nick Brown
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Cache of compiled programs on disk, keyed by a hash of the preprocessed source code (which includes the source of each imported
+ * file) so that a program which has not changed since it was last run is loaded rather than lexed, parsed and compiled again
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "bytecodecache.h"
+#include "byteassembler.h"
+#include "memorymanager.h"
+#include "arena.h"
+#include "misc.h"
+
+#define CACHE_MAGIC 0x43595045
+#define CACHE_FORMAT_VERSION 1
+#define CACHE_FILENAME_EXTENSION ".epyc"
+
+// Header at the start of each cache file, the magic, version, key and source length must all match for the program to be used
+struct cache_file_header {
+	unsigned int magic, version;
+	unsigned long long key;
+	unsigned int sourceLength, byteCodeLength, unlinkedLength, numberLineDefinitions, numberExportableFunctions;
+	int calledFunctionSymbolEntries, recursiveFunctionSymbolEntries;
+	unsigned short globalSymbolEntries;
+};
+
+// A line definition of the unlinked program as held in the cache file, this is followed by the characters of its name
+struct cache_line_definition {
+	int linenumber, currentpoint, nameLength;
+	char type;
+};
+
+// An exportable function as held in the cache file, this is followed by the characters of its name
+struct cache_exportable_function {
+	unsigned short functionLocation, nameLength;
+};
+
+// The contents of a cache file which has been read in, and the position that these are being read from
+struct cache_reader {
+	char * data;
+	size_t length, position;
+};
+
+static int createCacheDirectory(char*);
+static char* readCacheFile(char*, size_t*);
+static int readFromCache(struct cache_reader*, void*, size_t);
+static char* readBytesFromCache(struct cache_reader*, size_t);
+static struct memorycontainer* readUnlinkedMemory(struct cache_reader*, struct cache_file_header*);
+static void writeUnlinkedMemory(FILE*, struct memorycontainer*);
+
+/**
+ * Loads the compiled program for some preprocessed source code, and the key of any module objects linked into it, from the cache
+ * returning 1 if this was found or 0 if the source needs to be compiled. A cache file which is out of date or can not be read is
+ * ignored rather than reported
+ */
+int loadCachedByteCode(char * source, unsigned long long linkedModulesKey, int registerExpressions) {
+	struct cache_reader reader;
+	struct cache_file_header header;
+	struct cache_exportable_function * exportableFunctions=NULL;
+	struct memorycontainer * unlinkedProgram=NULL;
+	struct memory_arena * previousArena;
+	char * byteCodeInCache, * byteCode, ** exportableFunctionNames=NULL;
+	unsigned int i;
+	int loaded=0;
+	unsigned long long key=hashBytes(getByteCodeCacheKey(source, registerExpressions), &linkedModulesKey, sizeof(unsigned long long));
+	char * cacheFilename=getByteCodeCacheFilename(key, CACHE_FILENAME_EXTENSION, 0);
+	if (cacheFilename == NULL) return 0;
+	reader.data=readCacheFile(cacheFilename, &reader.length);
+	reader.position=0;
+	free(cacheFilename);
+	if (reader.data == NULL) return 0;
+	if (!readFromCache(&reader, &header, sizeof(struct cache_file_header)) || header.magic != CACHE_MAGIC ||
+			header.version != CACHE_FORMAT_VERSION || header.key != key || header.sourceLength != strlen(source)) {
+		free(reader.data);
+		return 0;
+	}
+	byteCodeInCache=readBytesFromCache(&reader, header.byteCodeLength);
+	// The unlinked program is held in the program arena, as this lives for as long as the byte code is run
+	previousArena=setCurrentArena(NULL);
+	if (byteCodeInCache != NULL && header.unlinkedLength > 0) unlinkedProgram=readUnlinkedMemory(&reader, &header);
+	setCurrentArena(previousArena);
+	if (byteCodeInCache != NULL && (header.unlinkedLength == 0 || unlinkedProgram != NULL)) {
+		exportableFunctions=(struct cache_exportable_function*) malloc(sizeof(struct cache_exportable_function) *
+				(header.numberExportableFunctions + 1));
+		exportableFunctionNames=(char**) malloc(sizeof(char*) * (header.numberExportableFunctions + 1));
+		for (i=0;i<header.numberExportableFunctions;i++) {
+			if (!readFromCache(&reader, &exportableFunctions[i], sizeof(struct cache_exportable_function))) break;
+			exportableFunctionNames[i]=readBytesFromCache(&reader, exportableFunctions[i].nameLength + 1);
+			if (exportableFunctionNames[i] == NULL || exportableFunctionNames[i][exportableFunctions[i].nameLength] != '\0') break;
+		}
+		loaded=i == header.numberExportableFunctions && reader.position == reader.length;
+	}
+	if (loaded) {
+		byteCode=(char*) malloc(header.byteCodeLength);
+		memcpy(byteCode, byteCodeInCache, header.byteCodeLength);
+		setMemoryFilledSize(header.byteCodeLength);
+		setAssembledCode(byteCode);
+		setNumberEntriesInSymbolTable(header.globalSymbolEntries);
+		setNumberSymbolTableEntriesForFunctions(header.calledFunctionSymbolEntries, header.recursiveFunctionSymbolEntries);
+		setUnlinkedMemory(unlinkedProgram);
+		// The table is built by adding to its head, so the functions are added in reverse to keep the order they were written in
+		for (i=header.numberExportableFunctions;i>0;i--) {
+			addExportableFunction(exportableFunctionNames[i-1], exportableFunctions[i-1].functionLocation);
+		}
+	}
+	free(exportableFunctions);
+	free(exportableFunctionNames);
+	free(reader.data);
+	return loaded;
+}
+
+/**
+ * Stores the program compiled from some preprocessed source code, and any module objects linked into it, in the cache. This is
+ * written to a temporary file which is then renamed, so that a partially written file is never read by another run of the program
+ */
+void storeCachedByteCode(char * source, unsigned long long linkedModulesKey, int registerExpressions) {
+	struct cache_file_header header;
+	struct cache_exportable_function exportableFunction;
+	struct exportableFunctionTableNode * exportableNode;
+	struct memorycontainer * unlinkedProgram=getUnlinkedMemory();
+	struct lineDefinition * root;
+	if (unlinkedProgram != NULL && unlinkedProgram->length == 0) unlinkedProgram=NULL;
+	memset(&header, 0, sizeof(struct cache_file_header));
+	header.magic=CACHE_MAGIC;
+	header.version=CACHE_FORMAT_VERSION;
+	header.key=hashBytes(getByteCodeCacheKey(source, registerExpressions), &linkedModulesKey, sizeof(unsigned long long));
+	char * cacheFilename=getByteCodeCacheFilename(header.key, CACHE_FILENAME_EXTENSION, 1);
+	if (cacheFilename == NULL) return;
+	char * temporaryFilename=(char*) malloc(strlen(cacheFilename) + 24);
+	sprintf(temporaryFilename, "%s.%d.tmp", cacheFilename, (int) getpid());
+	FILE * cacheFile=fopen(temporaryFilename, "wb");
+	if (cacheFile != NULL) {
+		header.sourceLength=strlen(source);
+		header.byteCodeLength=getMemoryFilledSize();
+		header.globalSymbolEntries=getNumberGlobalSymbolTableEntries();
+		header.calledFunctionSymbolEntries=getNumberSymbolTableEntriesForCalledFunctions();
+		header.recursiveFunctionSymbolEntries=getNumberSymbolTableEntriesForRecursion();
+		header.numberExportableFunctions=numberExportableFunctionsInTable;
+		if (unlinkedProgram != NULL) {
+			header.unlinkedLength=unlinkedProgram->length;
+			for (root=unlinkedProgram->lineDefns;root != NULL;root=root->next) header.numberLineDefinitions++;
+		}
+		fwrite(&header, sizeof(struct cache_file_header), 1, cacheFile);
+		fwrite(getAssembledCode(), sizeof(char), header.byteCodeLength, cacheFile);
+		if (unlinkedProgram != NULL) writeUnlinkedMemory(cacheFile, unlinkedProgram);
+		for (exportableNode=exportableFunctionTable;exportableNode != NULL;exportableNode=exportableNode->next) {
+			exportableFunction.functionLocation=exportableNode->functionLocation;
+			exportableFunction.nameLength=(unsigned short) strlen(exportableNode->functionName);
+			fwrite(&exportableFunction, sizeof(struct cache_exportable_function), 1, cacheFile);
+			fwrite(exportableNode->functionName, sizeof(char), exportableFunction.nameLength + 1, cacheFile);
+		}
+		if (ferror(cacheFile) || fclose(cacheFile) != 0 || rename(temporaryFilename, cacheFilename) != 0) unlink(temporaryFilename);
+	}
+	free(temporaryFilename);
+	free(cacheFilename);
+}
+
+/**
+ * Reads the unlinked program, which is its code followed by its line definitions. These are added to the end of the list so that
+ * it is in the same order as when the program was compiled, as the first of any duplicate labels or functions is linked to
+ */
+static struct memorycontainer* readUnlinkedMemory(struct cache_reader * reader, struct cache_file_header * header) {
+	struct cache_line_definition definitionInCache;
+	struct lineDefinition * defn, ** tail;
+	unsigned int i;
+	char * code=readBytesFromCache(reader, header->unlinkedLength), * name;
+	if (code == NULL) return NULL;
+	struct memorycontainer * memoryContainer=(struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
+	memoryContainer->length=header->unlinkedLength;
+	memoryContainer->data=(char*) arenaAllocate(header->unlinkedLength);
+	memcpy(memoryContainer->data, code, header->unlinkedLength);
+	memoryContainer->lineDefns=NULL;
+	tail=&memoryContainer->lineDefns;
+	for (i=0;i<header->numberLineDefinitions;i++) {
+		if (!readFromCache(reader, &definitionInCache, sizeof(struct cache_line_definition))) return NULL;
+		defn=(struct lineDefinition*) arenaAllocate(sizeof(struct lineDefinition));
+		defn->type=definitionInCache.type;
+		defn->linenumber=definitionInCache.linenumber;
+		defn->currentpoint=definitionInCache.currentpoint;
+		defn->name=NULL;
+		if (definitionInCache.nameLength >= 0) {
+			name=readBytesFromCache(reader, (size_t) definitionInCache.nameLength + 1);
+			if (name == NULL || name[definitionInCache.nameLength] != '\0') return NULL;
+			defn->name=arenaDuplicateString(name);
+		}
+		defn->next=NULL;
+		*tail=defn;
+		tail=&defn->next;
+	}
+	return memoryContainer;
+}
+
+/**
+ * Writes out the unlinked program, only the names of the function related line definitions are needed to link this
+ */
+static void writeUnlinkedMemory(FILE * cacheFile, struct memorycontainer * unlinkedProgram) {
+	struct cache_line_definition definitionInCache;
+	struct lineDefinition * root;
+	fwrite(unlinkedProgram->data, sizeof(char), unlinkedProgram->length, cacheFile);
+	for (root=unlinkedProgram->lineDefns;root != NULL;root=root->next) {
+		memset(&definitionInCache, 0, sizeof(struct cache_line_definition));
+		definitionInCache.type=root->type;
+		definitionInCache.linenumber=root->linenumber;
+		definitionInCache.currentpoint=root->currentpoint;
+		definitionInCache.nameLength=root->type > 1 && root->name != NULL ? (int) strlen(root->name) : -1;
+		fwrite(&definitionInCache, sizeof(struct cache_line_definition), 1, cacheFile);
+		if (definitionInCache.nameLength >= 0) fwrite(root->name, sizeof(char), definitionInCache.nameLength + 1, cacheFile);
+	}
+}
+
+/**
+ * Reads the entire contents of a cache file, returning NULL if there is not one
+ */
+static char* readCacheFile(char * cacheFilename, size_t * length) {
+	struct stat fileInfo;
+	char * contents;
+	if (stat(cacheFilename, &fileInfo) != 0 || fileInfo.st_size <= 0) return NULL;
+	FILE * cacheFile=fopen(cacheFilename, "rb");
+	if (cacheFile == NULL) return NULL;
+	*length=(size_t) fileInfo.st_size;
+	contents=(char*) malloc(*length);
+	if (fread(contents, sizeof(char), *length, cacheFile) != *length) {
+		free(contents);
+		contents=NULL;
+	}
+	fclose(cacheFile);
+	return contents;
+}
+
+/**
+ * Copies the next number of bytes from the cache file being read, returning 0 if the file is too short to hold these
+ */
+static int readFromCache(struct cache_reader * reader, void * destination, size_t length) {
+	char * data=readBytesFromCache(reader, length);
+	if (data == NULL) return 0;
+	memcpy(destination, data, length);
+	return 1;
+}
+
+/**
+ * Gets the next number of bytes from the cache file being read, or NULL if the file is too short to hold these
+ */
+static char* readBytesFromCache(struct cache_reader * reader, size_t length) {
+	if (length > reader->length - reader->position) return NULL;
+	char * data=&reader->data[reader->position];
+	reader->position+=length;
+	return data;
+}
+
+/**
+ * Hashes the preprocessed source code along with what else determines the byte code compiled from it, which is whether
+ * expressions are compiled to the register format and the interpreter executable itself (so rebuilding this misses the cache)
+ */
+unsigned long long getByteCodeCacheKey(char * source, int registerExpressions) {
+	struct stat executableInfo;
+	unsigned long long key=hashBytes(HASH_BYTES_OFFSET_BASIS, source, strlen(source));
+	char flags=(char) registerExpressions;
+	key=hashBytes(key, &flags, sizeof(char));
+	if (stat("/proc/self/exe", &executableInfo) == 0) {
+		key=hashBytes(key, &executableInfo.st_size, sizeof(executableInfo.st_size));
+		key=hashBytes(key, &executableInfo.st_mtime, sizeof(executableInfo.st_mtime));
+		key=hashBytes(key, &executableInfo.st_ino, sizeof(executableInfo.st_ino));
+	}
+	return key;
+}
+
+/**
+ * Gets the name of the cache file for a key and extension, this is in the directory given by EPYTHONCACHE or otherwise
+ * .cache/epython in the home directory. NULL is returned if there is no cache directory, or if it can not be created when this
+ * is requested
+ */
+char* getByteCodeCacheFilename(unsigned long long key, char * extension, int createDirectory) {
+	char * directory=getenv("EPYTHONCACHE"), * cacheFilename;
+	if (directory != NULL) {
+		if (directory[0] == '\0') return NULL;
+		cacheFilename=(char*) malloc(strlen(directory) + 32);
+		strcpy(cacheFilename, directory);
+	} else {
+		directory=getenv("HOME");
+		if (directory == NULL || directory[0] == '\0') return NULL;
+		cacheFilename=(char*) malloc(strlen(directory) + 48);
+		sprintf(cacheFilename, "%s/.cache/epython", directory);
+	}
+	if (createDirectory && !createCacheDirectory(cacheFilename)) {
+		free(cacheFilename);
+		return NULL;
+	}
+	cacheFilename=(char*) realloc(cacheFilename, strlen(cacheFilename) + strlen(extension) + 20);
+	sprintf(&cacheFilename[strlen(cacheFilename)], "/%016llx%s", key, extension);
+	return cacheFilename;
+}
+
+/**
+ * Creates the cache directory along with any of its parents which do not exist, returning 1 if it exists afterwards
+ */
+static int createCacheDirectory(char * directory) {
+	char * separator;
+	for (separator=strchr(&directory[1], '/');separator != NULL;separator=strchr(&separator[1], '/')) {
+		*separator='\0';
+		if (mkdir(directory, 0755) != 0 && errno != EEXIST) {
+			*separator='/';
+			return 0;
+		}
+		*separator='/';
+	}
+	return mkdir(directory, 0755) == 0 || errno == EEXIST;
+}
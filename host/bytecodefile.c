@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2016, Nick Brown
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Byte code files, which hold the compiled program in a versioned container. This is a header, a table of sections and then the
+ * sections themselves, with the code last and starting on a page boundary so that it is mapped into memory rather than read
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include "bytecodefile.h"
+#include "byteassembler.h"
+#include "memorymanager.h"
+#include "misc.h"
+
+#define BYTE_CODE_FILE_MAGIC 0x42595045
+#define BYTE_CODE_FILE_VERSION 3
+
+// Types of section, a loader skips any that it does not know. Source line maps and constant pools are reserved for when the
+// compiler produces these, currently strings and other constants are held inline in the code
+#define CODE_SECTION 1
+#define EXPORTABLE_FUNCTIONS_SECTION 2
+#define LINE_MAP_SECTION 3
+#define CONSTANT_POOL_SECTION 4
+
+// Header at the start of the file, the checksum covers the header (with the checksum itself zeroed), the section table and then
+// the contents of each section in turn
+struct byte_code_file_header {
+	unsigned int magic, version;
+	unsigned long long checksum;
+	unsigned int numberSections, globalSymbolEntries;
+	int calledFunctionSymbolEntries, recursiveFunctionSymbolEntries;
+};
+
+// An entry in the section table, giving where a section is in the file
+struct byte_code_file_section {
+	unsigned int type, reserved;
+	unsigned long long offset, length;
+};
+
+// An exportable function in its section, which is the number of functions followed by each of these and its name in turn
+struct byte_code_file_function {
+	unsigned short functionLocation, nameLength;
+};
+
+static char* getExportableFunctionsSection(size_t*);
+static int loadExportableFunctionsSection(char*, size_t);
+static void reportByteCodeFileError(char*, char*);
+
+/**
+ * Writes out the byte code to a file, this is exited from if the file can not be written
+ */
+void writeOutByteCode(char * compiledByteFilename) {
+	struct byte_code_file_header header;
+	struct byte_code_file_section sections[2];
+	size_t exportableFunctionsLength, pageSize=(size_t) sysconf(_SC_PAGESIZE), position;
+	char * exportableFunctions=getExportableFunctionsSection(&exportableFunctionsLength), * code=getAssembledCode();
+	FILE * byteFile=fopen(compiledByteFilename, "wb");
+	if (byteFile == NULL) reportByteCodeFileError("Writing byte code to file '%s' failed\n", compiledByteFilename);
+	memset(&header, 0, sizeof(struct byte_code_file_header));
+	memset(sections, 0, sizeof(sections));
+	header.magic=BYTE_CODE_FILE_MAGIC;
+	header.version=BYTE_CODE_FILE_VERSION;
+	header.numberSections=2;
+	header.globalSymbolEntries=getNumberGlobalSymbolTableEntries();
+	header.calledFunctionSymbolEntries=getNumberSymbolTableEntriesForCalledFunctions();
+	header.recursiveFunctionSymbolEntries=getNumberSymbolTableEntriesForRecursion();
+	position=sizeof(struct byte_code_file_header) + sizeof(sections);
+	sections[0].type=EXPORTABLE_FUNCTIONS_SECTION;
+	sections[0].offset=position;
+	sections[0].length=exportableFunctionsLength;
+	position+=exportableFunctionsLength;
+	sections[1].type=CODE_SECTION;
+	sections[1].offset=((position + pageSize - 1) / pageSize) * pageSize;
+	sections[1].length=getMemoryFilledSize();
+	header.checksum=hashBytes(HASH_BYTES_OFFSET_BASIS, &header, sizeof(struct byte_code_file_header));
+	header.checksum=hashBytes(header.checksum, sections, sizeof(sections));
+	header.checksum=hashBytes(header.checksum, exportableFunctions, exportableFunctionsLength);
+	header.checksum=hashBytes(header.checksum, code, sections[1].length);
+	fwrite(&header, sizeof(struct byte_code_file_header), 1, byteFile);
+	fwrite(sections, sizeof(struct byte_code_file_section), 2, byteFile);
+	fwrite(exportableFunctions, sizeof(char), exportableFunctionsLength, byteFile);
+	for (;position < sections[1].offset;position++) fputc(0, byteFile);
+	fwrite(code, sizeof(char), sections[1].length, byteFile);
+	if (ferror(byteFile) || fclose(byteFile) != 0) reportByteCodeFileError("Writing byte code to file '%s' failed\n", compiledByteFilename);
+	free(exportableFunctions);
+}
+
+/**
+ * Loads the byte code from a file, which is mapped read only so the code is not copied. Files written before the container was
+ * versioned are rejected, as the layout of the symbols and code in these is not the one that the interpreter now runs
+ */
+void loadByteCode(char * loadByteFilename) {
+	struct stat fileInfo;
+	struct byte_code_file_header header;
+	struct byte_code_file_section section, * codeSection=NULL, * exportableSection=NULL;
+	size_t length, i;
+	int isCodeMapped=0;
+	unsigned long long checksum, expectedChecksum;
+	char * contents, * sectionTable;
+	int byteFile=open(loadByteFilename, O_RDONLY);
+	if (byteFile == -1 || fstat(byteFile, &fileInfo) != 0 || fileInfo.st_size <= 0) {
+		reportByteCodeFileError("Opening of byte code file '%s' failed, are you sure this file exists?\n", loadByteFilename);
+	}
+	length=(size_t) fileInfo.st_size;
+	contents=(char*) mmap(NULL, length, PROT_READ, MAP_PRIVATE, byteFile, 0);
+	if (contents == MAP_FAILED) reportByteCodeFileError("Reading byte code file '%s' failed\n", loadByteFilename);
+	if (length >= sizeof(struct byte_code_file_header)) memcpy(&header, contents, sizeof(struct byte_code_file_header));
+	if (length < sizeof(struct byte_code_file_header) || header.magic != BYTE_CODE_FILE_MAGIC) {
+		reportByteCodeFileError("Byte code file '%s' is of an older format, recompile this file from its source code\n", loadByteFilename);
+	}
+	if (header.version != BYTE_CODE_FILE_VERSION) {
+		reportByteCodeFileError("Byte code file '%s' is of a version which is not supported, recompile the source code\n", loadByteFilename);
+	}
+	sectionTable=&contents[sizeof(struct byte_code_file_header)];
+	if (header.numberSections > (length - sizeof(struct byte_code_file_header)) / sizeof(struct byte_code_file_section)) {
+		reportByteCodeFileError("Byte code file '%s' is corrupt\n", loadByteFilename);
+	}
+	expectedChecksum=header.checksum;
+	header.checksum=0;
+	checksum=hashBytes(HASH_BYTES_OFFSET_BASIS, &header, sizeof(struct byte_code_file_header));
+	checksum=hashBytes(checksum, sectionTable, header.numberSections * sizeof(struct byte_code_file_section));
+	for (i=0;i<header.numberSections;i++) {
+		memcpy(&section, &sectionTable[i * sizeof(struct byte_code_file_section)], sizeof(struct byte_code_file_section));
+		if (section.offset > length || section.length > length - section.offset) {
+			reportByteCodeFileError("Byte code file '%s' is corrupt\n", loadByteFilename);
+		}
+		checksum=hashBytes(checksum, &contents[section.offset], section.length);
+		if (section.type == CODE_SECTION) codeSection=(struct byte_code_file_section*) &sectionTable[i * sizeof(struct byte_code_file_section)];
+		if (section.type == EXPORTABLE_FUNCTIONS_SECTION) {
+			exportableSection=(struct byte_code_file_section*) &sectionTable[i * sizeof(struct byte_code_file_section)];
+		}
+	}
+	if (checksum != expectedChecksum || codeSection == NULL) reportByteCodeFileError("Byte code file '%s' is corrupt\n", loadByteFilename);
+	memcpy(&section, codeSection, sizeof(struct byte_code_file_section));
+	setMemoryFilledSize((unsigned int) section.length);
+	setNumberEntriesInSymbolTable((unsigned short) header.globalSymbolEntries);
+	setNumberSymbolTableEntriesForFunctions(header.calledFunctionSymbolEntries, header.recursiveFunctionSymbolEntries);
+	if (section.offset % (unsigned long long) sysconf(_SC_PAGESIZE) == 0) {
+		// The mapping of the file is kept for the code, which is shared read only with every other process that loads the file
+		setAssembledCode(&contents[section.offset]);
+		isCodeMapped=1;
+	} else {
+		// Written on a machine with smaller pages than this one, so the code can not be mapped on its own
+		char * code=(char*) malloc(section.length);
+		memcpy(code, &contents[section.offset], section.length);
+		setAssembledCode(code);
+	}
+	if (exportableSection != NULL) {
+		memcpy(&section, exportableSection, sizeof(struct byte_code_file_section));
+		if (!loadExportableFunctionsSection(&contents[section.offset], section.length)) {
+			reportByteCodeFileError("Byte code file '%s' is corrupt\n", loadByteFilename);
+		}
+	}
+	if (!isCodeMapped) munmap(contents, length);
+	close(byteFile);
+}
+
+/**
+ * Gets the section holding the exportable function table and sets its length, functions are held in the order of the table
+ */
+static char* getExportableFunctionsSection(size_t * length) {
+	struct exportableFunctionTableNode * exportableNode;
+	struct byte_code_file_function function;
+	unsigned int numberFunctions=0;
+	*length=sizeof(unsigned int);
+	for (exportableNode=exportableFunctionTable;exportableNode != NULL;exportableNode=exportableNode->next) {
+		*length+=sizeof(struct byte_code_file_function) + strlen(exportableNode->functionName) + 1;
+		numberFunctions++;
+	}
+	char * section=(char*) malloc(*length), * position=section + sizeof(unsigned int);
+	memcpy(section, &numberFunctions, sizeof(unsigned int));
+	for (exportableNode=exportableFunctionTable;exportableNode != NULL;exportableNode=exportableNode->next) {
+		function.functionLocation=exportableNode->functionLocation;
+		function.nameLength=(unsigned short) strlen(exportableNode->functionName);
+		memcpy(position, &function, sizeof(struct byte_code_file_function));
+		position+=sizeof(struct byte_code_file_function);
+		memcpy(position, exportableNode->functionName, function.nameLength + 1);
+		position+=function.nameLength + 1;
+	}
+	return section;
+}
+
+/**
+ * Adds the functions in the exportable functions section to the exportable function table, returning 0 if the section is
+ * malformed. The table is built by adding to its head, so the functions are added from the end of the section backwards
+ */
+static int loadExportableFunctionsSection(char * section, size_t length) {
+	struct byte_code_file_function * functions;
+	unsigned int numberFunctions, i;
+	size_t position=sizeof(unsigned int);
+	int loaded;
+	char ** names;
+	if (length < sizeof(unsigned int)) return 0;
+	memcpy(&numberFunctions, section, sizeof(unsigned int));
+	if (numberFunctions > length / sizeof(struct byte_code_file_function)) return 0;
+	functions=(struct byte_code_file_function*) malloc(sizeof(struct byte_code_file_function) * (numberFunctions + 1));
+	names=(char**) malloc(sizeof(char*) * (numberFunctions + 1));
+	for (i=0;i<numberFunctions;i++) {
+		if (length - position < sizeof(struct byte_code_file_function)) break;
+		memcpy(&functions[i], &section[position], sizeof(struct byte_code_file_function));
+		position+=sizeof(struct byte_code_file_function);
+		if (length - position < (size_t) functions[i].nameLength + 1 || section[position + functions[i].nameLength] != '\0') break;
+		names[i]=&section[position];
+		position+=functions[i].nameLength + 1;
+	}
+	loaded=i == numberFunctions;
+	if (loaded) {
+		for (;i>0;i--) addExportableFunction(names[i-1], functions[i-1].functionLocation);
+	}
+	free(functions);
+	free(names);
+	return loaded;
+}
+
+/**
+ * Reports an error with a byte code file and exits
+ */
+static void reportByteCodeFileError(char * message, char * filename) {
+	fprintf(stderr, message, filename);
+	exit(0);
+}
@@ -0,0 +1,990 @@
+/*
+ * Copyright (c) 2016, Nick Brown
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Ahead of time translation of the byte code to C, which is then built against the host runtime to give an executable that
+ * runs the code without the interpreter's dispatch. Every statement becomes a labelled block of C, with jumps between the
+ * statements made directly. Assignments, conditionals and loops whose arithmetic and comparisons are on integers or reals are
+ * translated to the equivalent C, guarded by checks on the types of the variables they use. Operators that were not typed when
+ * compiled take the type of their constants, which the same checks then confirm. Elements of one dimensional arrays are read and
+ * written directly once their indexes have been checked, and natives (and so messaging) are called in the runtime with their
+ * arguments evaluated in C. Everything else, and those statements when the checks fail, calls into the interpreter to run that
+ * one statement. This includes all function calls, string operations and arrays of more than one dimension
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "c-translator.h"
+#include "memorymanager.h"
+#include "byteassembler.h"
+#include "basictokens.h"
+
+// Maximum number of variables (and of array indexes) that a statement translated directly to C can use
+#define MAX_TRANSLATED_VARIABLES 16
+// Type of a variable which is only written or whose value is passed to the runtime, so this can hold any scalar
+#define TRANSLATED_ANY_TYPE -1
+// Dtype of a variable whose value is passed to the runtime, which handles whatever this holds
+#define TRANSLATED_ANY_DTYPE -1
+
+// A variable used by a statement translated directly to C, along with the type and dtype that it must hold for this to run
+struct translated_variable {
+	unsigned short slot;
+	char type, dtype;
+};
+
+// An index into a one dimensional array used by a statement translated directly to C, the variable of the array and the point of
+// the index expression in the byte code
+struct translated_index {
+	int variable;
+	unsigned int position;
+};
+
+// State of the translation, statementStarts marks the points in the byte code at which statements (and so labels) start
+struct translation {
+	FILE * file;
+	char * code;
+	unsigned int length;
+	char * statementStarts;
+	struct translated_variable variables[MAX_TRANSLATED_VARIABLES];
+	struct translated_index indexes[MAX_TRANSLATED_VARIABLES];
+	int numberVariables, numberIndexes, numberStatements, numberTranslatedStatements;
+};
+
+static void findStatements(struct translation*, unsigned int, unsigned int);
+static unsigned int getNextStatement(char*, unsigned int);
+static int skipExpression(char*, unsigned int*);
+static int skipAssignment(char*, unsigned int*);
+static void skipLeaf(char*, unsigned int*);
+static void writeRuntimeHelpers(struct translation*);
+static void writeByteCode(struct translation*);
+static void writeStatement(struct translation*, unsigned int, unsigned int);
+static int writeTranslatedAssignment(struct translation*, unsigned int, unsigned int);
+static int writeTranslatedLetToArray(struct translation*, unsigned int, unsigned int);
+static int writeTranslatedStore(struct translation*, unsigned short, char, unsigned int, unsigned int, unsigned int);
+static int writeTranslatedLetFromArray(struct translation*, unsigned int, unsigned int);
+static int writeTranslatedNative(struct translation*, unsigned int, unsigned int);
+static int writeTranslatedConditional(struct translation*, unsigned int, unsigned int);
+static int writeTranslatedIncrement(struct translation*, unsigned int, unsigned int);
+static int writeTranslatedForRange(struct translation*, unsigned int, unsigned int);
+static char getExpressionType(struct translation*, unsigned int);
+static char getOperandsType(struct translation*, unsigned int);
+static int isIntegerNative(struct translation*, unsigned int);
+static int isTranslatableExpression(struct translation*, unsigned int*, char);
+static int isTranslatableCondition(struct translation*, unsigned int*);
+static int isTranslatableValue(struct translation*, unsigned int*);
+static int isTranslatableNative(struct translation*, unsigned int*);
+static void writeExpression(struct translation*, unsigned int*);
+static void writeCondition(struct translation*, unsigned int*);
+static void writeValue(struct translation*, unsigned int*);
+static void writeNativeCall(struct translation*, unsigned int);
+static int addTranslatedVariable(struct translation*, unsigned short, char, char);
+static int addTranslatedElement(struct translation*, unsigned short, char, unsigned int*);
+static int findTranslatedVariable(struct translation*, unsigned short);
+static void writeVariableGuards(struct translation*);
+static void writeJump(struct translation*, unsigned int);
+static unsigned char getGenericToken(unsigned char);
+static char getTypedTokenType(unsigned char);
+
+/**
+ * Translates the assembled byte code to C and writes this out to a file. The main code and each function are translated in
+ * turn, where functions are found from their locations recorded when the code was compiled
+ */
+void writeOutTranslatedCode(char * translatedFilename) {
+	struct translation translation;
+	struct exportableFunctionTableNode * fn;
+	unsigned int i, j, numberRegions=1, * regionStarts, position;
+	unsigned short numberArgs;
+
+	translation.code=getAssembledCode();
+	translation.length=getMemoryFilledSize();
+	translation.statementStarts=(char*) calloc(translation.length, sizeof(char));
+	translation.numberStatements=translation.numberTranslatedStatements=0;
+	regionStarts=(unsigned int*) malloc(sizeof(unsigned int) * (numberExportableFunctionsInTable + 2));
+	regionStarts[0]=sizeof(unsigned short);
+	for (fn=exportableFunctionTable;fn != NULL;fn=fn->next) {
+		for (i=1;i<numberRegions && regionStarts[i] != fn->functionLocation;i++);
+		if (i < numberRegions) continue;
+		for (j=numberRegions;j>1 && regionStarts[j-1] > fn->functionLocation;j--) regionStarts[j]=regionStarts[j-1];
+		regionStarts[j]=fn->functionLocation;
+		numberRegions++;
+	}
+	regionStarts[numberRegions]=translation.length;
+	for (i=0;i<numberRegions;i++) {
+		position=regionStarts[i];
+		if (i > 0) {
+			// The function's header is the number of arguments, frame size and the slots of the arguments
+			memcpy(&numberArgs, &translation.code[position], sizeof(unsigned short));
+			position+=sizeof(unsigned short) * (2 + numberArgs);
+		}
+		findStatements(&translation, position, regionStarts[i+1]);
+	}
+
+	translation.file=fopen(translatedFilename, "w");
+	if (translation.file == NULL) {
+		fprintf(stderr, "Writing translated code to file '%s' failed\n", translatedFilename);
+		exit(0);
+	}
+	fprintf(translation.file, "/*\n * Translated to C from ePython byte code, build with make translated SOURCE=%s\n */\n\n", translatedFilename);
+	fprintf(translation.file, "#include <stdio.h>\n#include <stdlib.h>\n#include <string.h>\n#include \"interpreter.h\"\n\n");
+	writeByteCode(&translation);
+	fprintf(translation.file, "struct value_defn runTranslatedCode(char*, unsigned int, unsigned int, int);\n\n");
+	writeRuntimeHelpers(&translation);
+	fprintf(translation.file, "struct value_defn runTranslatedCode(char * assembled, unsigned int currentPoint, unsigned int length, int threadId) {\n");
+	fprintf(translation.file, "\tstruct value_defn value, empty;\n\tunsigned int p=currentPoint;\n");
+	fprintf(translation.file, "\tempty.type=NONE_TYPE;\n\tempty.dtype=SCALAR;\n\tvalue=empty;\n");
+	// Entry to a function, and jumps to points only known when running, go through a switch on the point in the byte code
+	fprintf(translation.file, "dispatch: __attribute__((unused));\n\tswitch (p) {\n");
+	for (position=0;position<translation.length;position++) {
+		if (translation.statementStarts[position]) fprintf(translation.file, "\tcase %u: goto s%u;\n", position, position);
+	}
+	fprintf(translation.file, "\tdefault:\n\t\tfprintf(stderr, \"No translated code at point %%u of the byte code\\n\", p);\n\t\texit(0);\n\t}\n");
+	for (i=0;i<numberRegions;i++) {
+		for (position=regionStarts[i];position<regionStarts[i+1];position++) {
+			if (translation.statementStarts[position]) writeStatement(&translation, position, getNextStatement(translation.code, position));
+		}
+		fprintf(translation.file, "\treturn empty;\n");
+	}
+	fprintf(translation.file, "}\n");
+	fclose(translation.file);
+	printf("%d of %d statements translated to C, the others are run by the interpreter\n", translation.numberTranslatedStatements,
+			translation.numberStatements);
+	free(translation.statementStarts);
+	free(regionStarts);
+}
+
+/**
+ * Writes out the functions that the translated statements use to read and write variables, array elements and values
+ */
+static void writeRuntimeHelpers(struct translation * translation) {
+	fprintf(translation->file, "static inline int getTranslatedInt(struct symbol_node * symbol) {\n\tint value;\n"
+			"\tmemcpy(&value, symbol->value.data, sizeof(int));\n\treturn value;\n}\n\n");
+	fprintf(translation->file, "static inline float getTranslatedReal(struct symbol_node * symbol) {\n\tfloat value;\n"
+			"\tmemcpy(&value, symbol->value.data, sizeof(float));\n\treturn value;\n}\n\n");
+	// Array memory is the number of dimensions followed by the size of each and then the elements
+	fprintf(translation->file, "static inline char * getTranslatedElement(struct symbol_node * symbol, int index) {\n\tchar * memory;\n"
+			"\tmemcpy(&memory, symbol->value.data, sizeof(char*));\n"
+			"\treturn memory + sizeof(unsigned char) + sizeof(int) * (index + 1);\n}\n\n");
+	fprintf(translation->file, "static inline int isTranslatedArray(struct symbol_node * symbol) {\n\tchar * memory;\n"
+			"\tmemcpy(&memory, symbol->value.data, sizeof(char*));\n\treturn (memory[0] & 0xF) == 1;\n}\n\n");
+	fprintf(translation->file, "static inline int isTranslatedIndex(struct symbol_node * symbol, int index) {\n\tint size;\n"
+			"\tmemcpy(&size, getTranslatedElement(symbol, -1), sizeof(int));\n\treturn index >= 0 && index < size;\n}\n\n");
+	fprintf(translation->file, "static inline int getTranslatedIntElement(struct symbol_node * symbol, int index) {\n\tint value;\n"
+			"\tmemcpy(&value, getTranslatedElement(symbol, index), sizeof(int));\n\treturn value;\n}\n\n");
+	fprintf(translation->file, "static inline float getTranslatedRealElement(struct symbol_node * symbol, int index) {\n\tfloat value;\n"
+			"\tmemcpy(&value, getTranslatedElement(symbol, index), sizeof(float));\n\treturn value;\n}\n\n");
+	fprintf(translation->file, "static inline struct value_defn getTranslatedElementValue(struct symbol_node * symbol, int index) {\n"
+			"\tstruct value_defn value;\n\tvalue.type=symbol->value.type;\n\tvalue.dtype=SCALAR;\n"
+			"\tmemcpy(value.data, getTranslatedElement(symbol, index), sizeof(int));\n\treturn value;\n}\n\n");
+	fprintf(translation->file, "static inline struct value_defn getTranslatedConstant(char type, char * data) {\n"
+			"\tstruct value_defn value;\n\tvalue.type=type;\n\tvalue.dtype=SCALAR;\n"
+			"\tif (type == STRING_TYPE) {\n\t\tmemcpy(&value.data, &data, sizeof(char*));\n"
+			"\t} else {\n\t\tmemcpy(value.data, data, sizeof(int));\n\t}\n\treturn value;\n}\n\n");
+	fprintf(translation->file, "static inline struct value_defn getTranslatedIntValue(int data) {\n"
+			"\treturn getTranslatedConstant(INT_TYPE, (char*) &data);\n}\n\n");
+	fprintf(translation->file, "static inline struct value_defn getTranslatedRealValue(float data) {\n"
+			"\treturn getTranslatedConstant(REAL_TYPE, (char*) &data);\n}\n\n");
+	fprintf(translation->file, "static inline int getTranslatedNativeInt(unsigned char fnCode, int threadId) {\n\tstruct value_defn value;\n"
+			"\tint data;\n\tcallTranslatedNative(&value, fnCode, 0, NULL, threadId);\n"
+			"\tmemcpy(&data, value.data, sizeof(int));\n\treturn data;\n}\n\n");
+}
+
+/**
+ * Marks the start of each statement in a region of the byte code, which are laid out one after another
+ */
+static void findStatements(struct translation * translation, unsigned int position, unsigned int end) {
+	while (position < end) {
+		translation->statementStarts[position]=1;
+		unsigned int nextPosition=getNextStatement(translation->code, position);
+		if (nextPosition == 0 || nextPosition > end) {
+			fprintf(stderr, "Can not translate the statement at point %u of the byte code to C\n", position);
+			exit(0);
+		}
+		position=nextPosition;
+	}
+}
+
+/**
+ * Retrieves the point of the statement following that at some position, or zero if the statement is not known
+ */
+static unsigned int getNextStatement(char * code, unsigned int position) {
+	unsigned char token=((unsigned char*) code)[position];
+	unsigned short numberArgs;
+	position+=sizeof(unsigned char);
+	switch (token) {
+	case LET_TOKEN:
+	case LETNOALIAS_TOKEN:
+		return skipAssignment(code, &position) ? position : 0;
+	case IF_TOKEN:
+	case IFELSE_TOKEN:
+		return skipExpression(code, &position) ? position + sizeof(unsigned short) : 0;
+	case IF_COMPARE_TOKEN:
+		position+=sizeof(unsigned char);
+		skipLeaf(code, &position);
+		skipLeaf(code, &position);
+		return position + sizeof(unsigned short);
+	case FOR_TOKEN:
+	case FOR_RANGE_TOKEN:
+		return position + sizeof(unsigned short) * 5;
+	case GOTO_TOKEN:
+		return position + sizeof(unsigned short);
+	case FNCALL_TOKEN:
+	case FNCALL_BY_VAR_TOKEN:
+		memcpy(&numberArgs, &code[position+sizeof(unsigned short)], sizeof(unsigned short));
+		return position + sizeof(unsigned short) * (2 + numberArgs);
+	case NATIVE_TOKEN:
+		position-=sizeof(unsigned char);
+		return skipExpression(code, &position) ? position : 0;
+	case RETURN_EXP_TOKEN:
+		return skipExpression(code, &position) ? position : 0;
+	case ALIAS_TOKEN:
+		position+=sizeof(unsigned short);
+		return skipExpression(code, &position) ? position : 0;
+	case STOP_TOKEN:
+	case RETURN_TOKEN:
+		return position;
+	case INCREMENT_TOKEN:
+		return position + sizeof(unsigned short) + sizeof(unsigned char) + sizeof(int);
+	case LET_FROM_ARRAY_TOKEN:
+		position+=sizeof(unsigned short) * 2;
+		skipLeaf(code, &position);
+		return position;
+	case LET_TO_ARRAY_TOKEN:
+		position+=sizeof(unsigned short);
+		skipLeaf(code, &position);
+		return skipExpression(code, &position) ? position : 0;
+	default:
+		return 0;
+	}
+}
+
+/**
+ * Skips over the prefix expression at some position, returning zero if this contains something that is not known
+ */
+static int skipExpression(char * code, unsigned int * position) {
+	unsigned char token=getGenericToken(((unsigned char*) code)[*position]);
+	unsigned short numberItems, i;
+	int numberElements, j;
+	switch (token) {
+	case INTEGER_TOKEN:
+	case REAL_TOKEN:
+	case BOOLEAN_TOKEN:
+	case IDENTIFIER_TOKEN:
+		skipLeaf(code, position);
+		return 1;
+	case STRING_TOKEN:
+		*position+=sizeof(unsigned char) + strlen(&code[*position+sizeof(unsigned char)]) + 1;
+		return 1;
+	case NONE_TOKEN:
+		*position+=sizeof(unsigned char);
+		return 1;
+	case FN_ADDR_TOKEN:
+	case REFERENCE_TOKEN:
+	case SYMBOL_TOKEN:
+		*position+=sizeof(unsigned char) + sizeof(unsigned short);
+		return 1;
+	case ARRAYACCESS_TOKEN:
+		numberItems=((unsigned char*) code)[*position+sizeof(unsigned char)+sizeof(unsigned short)];
+		*position+=sizeof(unsigned char) * 2 + sizeof(unsigned short);
+		for (i=0;i<numberItems;i++) {
+			if (!skipExpression(code, position)) return 0;
+		}
+		return 1;
+	case ARRAY_TOKEN:
+		memcpy(&numberElements, &code[*position+sizeof(unsigned char)], sizeof(int));
+		*position+=sizeof(unsigned char) + sizeof(int);
+		if (code[(*position)++] && !skipExpression(code, position)) return 0;
+		for (j=0;j<numberElements;j++) {
+			if (!skipExpression(code, position)) return 0;
+		}
+		return 1;
+	case NATIVE_TOKEN:
+		memcpy(&numberItems, &code[*position+sizeof(unsigned char)*2], sizeof(unsigned short));
+		*position+=sizeof(unsigned char) * 2 + sizeof(unsigned short);
+		for (i=0;i<numberItems;i++) {
+			if (!skipExpression(code, position)) return 0;
+		}
+		return 1;
+	case FNCALL_TOKEN:
+	case FNCALL_BY_VAR_TOKEN:
+		memcpy(&numberItems, &code[*position+sizeof(unsigned char)+sizeof(unsigned short)], sizeof(unsigned short));
+		*position+=sizeof(unsigned char) + sizeof(unsigned short) * (2 + numberItems);
+		return 1;
+	case LET_TOKEN:
+		// Assignment of a temporary ahead of a function call, which is then followed by the expression itself
+		*position+=sizeof(unsigned char);
+		return skipAssignment(code, position) && skipExpression(code, position);
+	case NOT_TOKEN:
+		*position+=sizeof(unsigned char);
+		return skipExpression(code, position);
+	case AND_TOKEN:
+	case OR_TOKEN:
+		*position+=sizeof(unsigned char) + sizeof(unsigned short);
+		return skipExpression(code, position) && skipExpression(code, position);
+	case EQ_TOKEN:
+	case NEQ_TOKEN:
+	case LT_TOKEN:
+	case GT_TOKEN:
+	case LEQ_TOKEN:
+	case GEQ_TOKEN:
+	case IS_TOKEN:
+	case ADD_TOKEN:
+	case SUB_TOKEN:
+	case MUL_TOKEN:
+	case DIV_TOKEN:
+	case MOD_TOKEN:
+	case POW_TOKEN:
+		*position+=sizeof(unsigned char);
+		return skipExpression(code, position) && skipExpression(code, position);
+	default:
+		return 0;
+	}
+}
+
+/**
+ * Skips over the target of an assignment, a variable or array element, and the value assigned to it
+ */
+static int skipAssignment(char * code, unsigned int * position) {
+	unsigned char numberIndexes=0, i;
+	if (((unsigned char*) code)[*position] == ARRAYACCESS_TOKEN) {
+		numberIndexes=((unsigned char*) code)[*position+sizeof(unsigned char)+sizeof(unsigned short)];
+		*position+=sizeof(unsigned char);
+	}
+	*position+=sizeof(unsigned char) + sizeof(unsigned short);
+	for (i=0;i<numberIndexes;i++) {
+		if (!skipExpression(code, position)) return 0;
+	}
+	return skipExpression(code, position);
+}
+
+/**
+ * Skips over a constant or variable operand, as held directly in expressions and superinstructions
+ */
+static void skipLeaf(char * code, unsigned int * position) {
+	*position+=sizeof(unsigned char) + (code[*position] == IDENTIFIER_TOKEN ? sizeof(unsigned short) : sizeof(int));
+}
+
+/**
+ * Writes out the byte code, which the interpreter runs statements from, along with the size of the symbol table
+ */
+static void writeByteCode(struct translation * translation) {
+	unsigned int i;
+	fprintf(translation->file, "char translatedByteCode[]={");
+	for (i=0;i<translation->length;i++) {
+		if (i % 16 == 0) fprintf(translation->file, "\n\t");
+		fprintf(translation->file, "%d%s", translation->code[i], i < translation->length-1 ? ", " : "");
+	}
+	fprintf(translation->file, "};\nunsigned int translatedByteCodeLength=%u;\n", translation->length);
+	fprintf(translation->file, "unsigned short translatedNumberSymbols=%u;\n\n", getNumberEntriesInHostSymbolTable());
+}
+
+/**
+ * Writes out the C of a statement, as a block labelled with its point in the byte code. Where the statement can be translated
+ * directly this comes first, and otherwise (or if its checks fail) the interpreter runs the statement. Statements which change
+ * the flow of control go to the statement that the interpreter returns, if this is not the next one
+ */
+static void writeStatement(struct translation * translation, unsigned int position, unsigned int next) {
+	unsigned char token=((unsigned char*) translation->code)[position];
+	unsigned short target;
+	int translated=0;
+	fprintf(translation->file, "s%u:\n", position);
+	translation->numberStatements++;
+	switch (token) {
+	case GOTO_TOKEN:
+		translation->numberTranslatedStatements++;
+		memcpy(&target, &translation->code[position+sizeof(unsigned char)], sizeof(unsigned short));
+		if (target <= position) fprintf(translation->file, "\tif (stopInterpreter[threadId]) return empty;\n");
+		writeJump(translation, target);
+		return;
+	case STOP_TOKEN:
+	case RETURN_TOKEN:
+		translation->numberTranslatedStatements++;
+		fprintf(translation->file, "\treturn empty;\n");
+		return;
+	case LET_TOKEN:
+		translated=writeTranslatedAssignment(translation, position, next);
+		break;
+	case LET_TO_ARRAY_TOKEN:
+		translated=writeTranslatedLetToArray(translation, position, next);
+		break;
+	case LET_FROM_ARRAY_TOKEN:
+		translated=writeTranslatedLetFromArray(translation, position, next);
+		break;
+	case NATIVE_TOKEN:
+		translated=writeTranslatedNative(translation, position, next);
+		break;
+	case IF_TOKEN:
+	case IFELSE_TOKEN:
+	case IF_COMPARE_TOKEN:
+		translated=writeTranslatedConditional(translation, position, next);
+		break;
+	case INCREMENT_TOKEN:
+		translated=writeTranslatedIncrement(translation, position, next);
+		break;
+	case FOR_RANGE_TOKEN:
+		translated=writeTranslatedForRange(translation, position, next);
+		break;
+	}
+	if (translated) translation->numberTranslatedStatements++;
+	fprintf(translation->file, "\tp=runTranslatedStatement(assembled, %u, length, &value, threadId);\n", position);
+	fprintf(translation->file, "\tif (stopInterpreter[threadId]) return empty;\n");
+	if (token == RETURN_EXP_TOKEN) {
+		fprintf(translation->file, "\treturn value;\n");
+	} else if (token == IF_TOKEN || token == IFELSE_TOKEN || token == IF_COMPARE_TOKEN || token == FOR_TOKEN ||
+			token == FOR_RANGE_TOKEN) {
+		fprintf(translation->file, "\tif (p != %u) goto dispatch;\n", next);
+	}
+}
+
+/**
+ * Translates an assignment to a scalar or to an element of a one dimensional array, returning whether this was possible
+ */
+static int writeTranslatedAssignment(struct translation * translation, unsigned int position, unsigned int next) {
+	unsigned short slot;
+	unsigned char identifierType=((unsigned char*) translation->code)[position+sizeof(unsigned char)];
+	unsigned int indexPoint=0, expressionPoint=position+sizeof(unsigned char)*2+sizeof(unsigned short);
+	memcpy(&slot, &translation->code[position+sizeof(unsigned char)*2], sizeof(unsigned short));
+	if (identifierType == ARRAYACCESS_TOKEN) {
+		if (translation->code[expressionPoint] != 1) return 0;
+		indexPoint=expressionPoint+sizeof(unsigned char);
+		expressionPoint=indexPoint;
+		if (!skipExpression(translation->code, &expressionPoint)) return 0;
+	} else if (identifierType != IDENTIFIER_TOKEN) {
+		return 0;
+	}
+	return writeTranslatedStore(translation, slot, identifierType == ARRAYACCESS_TOKEN ? ARRAY : SCALAR, indexPoint, expressionPoint, next);
+}
+
+/**
+ * Translates the store array element superinstruction, whose index is a constant or variable
+ */
+static int writeTranslatedLetToArray(struct translation * translation, unsigned int position, unsigned int next) {
+	unsigned short slot;
+	unsigned int indexPoint=position+sizeof(unsigned char)+sizeof(unsigned short), expressionPoint=indexPoint;
+	memcpy(&slot, &translation->code[position+sizeof(unsigned char)], sizeof(unsigned short));
+	skipLeaf(translation->code, &expressionPoint);
+	return writeTranslatedStore(translation, slot, ARRAY, indexPoint, expressionPoint, next);
+}
+
+/**
+ * Translates the store of an expression to a variable, or to an element of a one dimensional array if the dtype is ARRAY. Integer
+ * and real expressions are computed and stored directly, any other value (such as the result of a native) is assigned by the
+ * runtime
+ */
+static int writeTranslatedStore(struct translation * translation, unsigned short slot, char dtype, unsigned int indexPoint,
+		unsigned int expressionPoint, unsigned int next) {
+	unsigned int endPoint=expressionPoint, indexEnd=indexPoint;
+	unsigned char token=((unsigned char*) translation->code)[expressionPoint];
+	char type=token == NATIVE_TOKEN ? TRANSLATED_ANY_TYPE : getExpressionType(translation, expressionPoint);
+	int target;
+	translation->numberVariables=translation->numberIndexes=0;
+	if (token == NATIVE_TOKEN) {
+		if (!isTranslatableNative(translation, &endPoint)) return 0;
+	} else if (type != TRANSLATED_ANY_TYPE) {
+		if (!isTranslatableExpression(translation, &endPoint, type)) return 0;
+	} else if (!isTranslatableValue(translation, &endPoint)) {
+		return 0;
+	}
+	if (dtype == ARRAY) {
+		target=addTranslatedElement(translation, slot, TRANSLATED_ANY_TYPE, &indexEnd);
+	} else {
+		target=addTranslatedVariable(translation, slot, TRANSLATED_ANY_TYPE, type == TRANSLATED_ANY_TYPE ? TRANSLATED_ANY_DTYPE : SCALAR);
+	}
+	if (target < 0) return 0;
+	writeVariableGuards(translation);
+	if (token == NATIVE_TOKEN) {
+		writeNativeCall(translation, expressionPoint);
+	} else {
+		if (type == TRANSLATED_ANY_TYPE) {
+			fprintf(translation->file, "\t\t\tstruct value_defn result=");
+			writeValue(translation, &expressionPoint);
+		} else {
+			fprintf(translation->file, "\t\t\t%s result=", type == INT_TYPE ? "int" : "float");
+			writeExpression(translation, &expressionPoint);
+		}
+		fprintf(translation->file, ";\n");
+	}
+	if (type == TRANSLATED_ANY_TYPE) {
+		fprintf(translation->file, "\t\t\tsetTranslatedVariableValue(v%d, result, ", target);
+		if (dtype == ARRAY) {
+			writeExpression(translation, &indexPoint);
+		} else {
+			fprintf(translation->file, "-1");
+		}
+		fprintf(translation->file, ");\n\t\t");
+	} else {
+		fprintf(translation->file, "\t\t\tv%d->value.type=%s;\n", target, type == INT_TYPE ? "INT_TYPE" : "REAL_TYPE");
+		if (dtype == ARRAY) {
+			fprintf(translation->file, "\t\t\tmemcpy(getTranslatedElement(v%d, ", target);
+			writeExpression(translation, &indexPoint);
+			fprintf(translation->file, "), &result, sizeof(result));\n\t\t");
+		} else {
+			fprintf(translation->file, "\t\t\tmemcpy(v%d->value.data, &result, sizeof(result));\n\t\t", target);
+		}
+	}
+	writeJump(translation, next);
+	fprintf(translation->file, "\t\t}\n\t}\n");
+	return 1;
+}
+
+/**
+ * Translates the load array element superinstruction, whose index is a constant or variable. The element is assigned by the
+ * runtime as the type of the array is only known when this runs
+ */
+static int writeTranslatedLetFromArray(struct translation * translation, unsigned int position, unsigned int next) {
+	unsigned short slots[2];
+	unsigned int indexPoint=position+sizeof(unsigned char)+sizeof(unsigned short)*2, endPoint=indexPoint;
+	memcpy(slots, &translation->code[position+sizeof(unsigned char)], sizeof(unsigned short) * 2);
+	translation->numberVariables=translation->numberIndexes=0;
+	int array=addTranslatedElement(translation, slots[1], TRANSLATED_ANY_TYPE, &endPoint);
+	int target=addTranslatedVariable(translation, slots[0], TRANSLATED_ANY_TYPE, TRANSLATED_ANY_DTYPE);
+	if (array < 0 || target < 0) return 0;
+	writeVariableGuards(translation);
+	fprintf(translation->file, "\t\t\tsetTranslatedVariableValue(v%d, getTranslatedElementValue(v%d, ", target, array);
+	writeExpression(translation, &indexPoint);
+	fprintf(translation->file, "), -1);\n\t\t");
+	writeJump(translation, next);
+	fprintf(translation->file, "\t\t}\n\t}\n");
+	return 1;
+}
+
+/**
+ * Translates a call to a native function whose value is not used, such as sending a message or displaying a value
+ */
+static int writeTranslatedNative(struct translation * translation, unsigned int position, unsigned int next) {
+	unsigned int endPoint=position;
+	translation->numberVariables=translation->numberIndexes=0;
+	if (!isTranslatableNative(translation, &endPoint)) return 0;
+	writeVariableGuards(translation);
+	writeNativeCall(translation, position);
+	fprintf(translation->file, "\t\t");
+	writeJump(translation, next);
+	fprintf(translation->file, "\t\t}\n\t}\n");
+	return 1;
+}
+
+/**
+ * Translates a conditional whose condition compares integer or real expressions, returning whether this was possible
+ */
+static int writeTranslatedConditional(struct translation * translation, unsigned int position, unsigned int next) {
+	// The condition follows the token, for compare and branch this is the comparison operator followed by its two operands
+	unsigned int conditionPoint=position+sizeof(unsigned char), endPoint=conditionPoint;
+	unsigned short blockLength;
+	memcpy(&blockLength, &translation->code[next-sizeof(unsigned short)], sizeof(unsigned short));
+	translation->numberVariables=translation->numberIndexes=0;
+	if (!isTranslatableCondition(translation, &endPoint)) return 0;
+	writeVariableGuards(translation);
+	fprintf(translation->file, "\t\t\tif (");
+	writeCondition(translation, &conditionPoint);
+	fprintf(translation->file, ")\n\t\t\t");
+	writeJump(translation, next);
+	fprintf(translation->file, "\t\t");
+	writeJump(translation, next+blockLength);
+	fprintf(translation->file, "\t\t}\n\t}\n");
+	return 1;
+}
+
+/**
+ * Translates the increment of an integer scalar by a constant, otherwise the interpreter follows the rules of addition
+ */
+static int writeTranslatedIncrement(struct translation * translation, unsigned int position, unsigned int next) {
+	unsigned short slot;
+	int constant;
+	memcpy(&slot, &translation->code[position+sizeof(unsigned char)], sizeof(unsigned short));
+	memcpy(&constant, &translation->code[position+sizeof(unsigned char)*2+sizeof(unsigned short)], sizeof(int));
+	translation->numberVariables=translation->numberIndexes=0;
+	addTranslatedVariable(translation, slot, INT_TYPE, SCALAR);
+	writeVariableGuards(translation);
+	fprintf(translation->file, "\t\t\tint result=getTranslatedInt(v0)%s%d;\n",
+			translation->code[position+sizeof(unsigned char)+sizeof(unsigned short)] == ADD_TOKEN ? "+" : "-", constant);
+	fprintf(translation->file, "\t\t\tmemcpy(v0->value.data, &result, sizeof(int));\n\t\t");
+	writeJump(translation, next);
+	fprintf(translation->file, "\t\t}\n\t}\n");
+	return 1;
+}
+
+/**
+ * Translates a counted loop iteration where the current, stop and step values are integer scalars
+ */
+static int writeTranslatedForRange(struct translation * translation, unsigned int position, unsigned int next) {
+	unsigned short slots[4], blockLength;
+	int i;
+	memcpy(slots, &translation->code[position+sizeof(unsigned char)], sizeof(unsigned short) * 4);
+	memcpy(&blockLength, &translation->code[next-sizeof(unsigned short)], sizeof(unsigned short));
+	translation->numberVariables=translation->numberIndexes=0;
+	for (i=0;i<4;i++) {
+		if (addTranslatedVariable(translation, slots[i], i == 1 ? TRANSLATED_ANY_TYPE : INT_TYPE, SCALAR) != i) return 0;
+	}
+	writeVariableGuards(translation);
+	fprintf(translation->file, "\t\t\tint current=getTranslatedInt(v0), stop=getTranslatedInt(v2), step=getTranslatedInt(v3);\n");
+	fprintf(translation->file, "\t\t\tif ((step > 0 && current <= stop) || (step < 0 && current >= stop)) {\n");
+	fprintf(translation->file, "\t\t\t\tv1->value.type=INT_TYPE;\n\t\t\t\tmemcpy(v1->value.data, &current, sizeof(int));\n");
+	fprintf(translation->file, "\t\t\t\tcurrent+=step;\n\t\t\t\tmemcpy(v0->value.data, &current, sizeof(int));\n\t\t\t");
+	writeJump(translation, next);
+	fprintf(translation->file, "\t\t\t}\n\t\t\t");
+	// The block is followed by the jump back to this statement
+	writeJump(translation, next+blockLength+sizeof(unsigned char)+sizeof(unsigned short));
+	fprintf(translation->file, "\t\t}\n\t}\n");
+	return 1;
+}
+
+/**
+ * Retrieves the type of an integer or real expression, from the type of its operator or constant, or TRANSLATED_ANY_TYPE if
+ * this is not known
+ */
+static char getExpressionType(struct translation * translation, unsigned int position) {
+	unsigned char token=((unsigned char*) translation->code)[position];
+	char type=getTypedTokenType(token);
+	if (token == INTEGER_TOKEN || token == REAL_TOKEN) return token == INTEGER_TOKEN ? INT_TYPE : REAL_TYPE;
+	if (token == NATIVE_TOKEN) return isIntegerNative(translation, position) ? INT_TYPE : TRANSLATED_ANY_TYPE;
+	if (type != TRANSLATED_ANY_TYPE || token < ADD_TOKEN || token > MOD_TOKEN) return type;
+	return getOperandsType(translation, position+sizeof(unsigned char));
+}
+
+/**
+ * Retrieves the type of the operands of an operator that was not typed when compiled, which is that of the first operand whose type
+ * is known. The guards then check that variables are of this type, so that the operator works in the same way as in C
+ */
+static char getOperandsType(struct translation * translation, unsigned int position) {
+	char type=getExpressionType(translation, position);
+	if (type == TRANSLATED_ANY_TYPE && skipExpression(translation->code, &position)) type=getExpressionType(translation, position);
+	return type;
+}
+
+/**
+ * Determines whether the native at some point returns an integer without side effects, so can be called as part of an expression
+ */
+static int isIntegerNative(struct translation * translation, unsigned int position) {
+	unsigned char fnIdentifier=translation->code[position+sizeof(unsigned char)] & 0x1F;
+	unsigned short numberArgs;
+	memcpy(&numberArgs, &translation->code[position+sizeof(unsigned char)*2], sizeof(unsigned short));
+	return numberArgs == 0 && (fnIdentifier == NATIVE_FN_RTL_COREID || fnIdentifier == NATIVE_FN_RTL_NUMCORES);
+}
+
+/**
+ * Determines whether an expression is made up of arithmetic operators, constants, variables and one dimensional array elements
+ * all of some type, recording the variables and array indexes that it uses
+ */
+static int isTranslatableExpression(struct translation * translation, unsigned int * position, char type) {
+	unsigned char token=((unsigned char*) translation->code)[*position];
+	char tokenType=getTypedTokenType(token);
+	unsigned short slot;
+	if (token == NATIVE_TOKEN) {
+		if (type != INT_TYPE || !isIntegerNative(translation, *position)) return 0;
+		*position+=sizeof(unsigned char)*2 + sizeof(unsigned short);
+		return 1;
+	}
+	*position+=sizeof(unsigned char);
+	if (token == INTEGER_TOKEN || token == REAL_TOKEN) {
+		*position+=sizeof(int);
+		return type == (token == INTEGER_TOKEN ? INT_TYPE : REAL_TYPE);
+	}
+	if (token == IDENTIFIER_TOKEN || token == ARRAYACCESS_TOKEN) {
+		memcpy(&slot, &translation->code[*position], sizeof(unsigned short));
+		*position+=sizeof(unsigned short);
+		if (token == IDENTIFIER_TOKEN) return addTranslatedVariable(translation, slot, type, SCALAR) >= 0;
+		if (translation->code[(*position)++] != 1) return 0;
+		return addTranslatedElement(translation, slot, type, position) >= 0;
+	}
+	token=getGenericToken(token);
+	if ((tokenType != TRANSLATED_ANY_TYPE && tokenType != type) || token < ADD_TOKEN || token > MOD_TOKEN) return 0;
+	if (token == MOD_TOKEN && type != INT_TYPE) return 0;
+	return isTranslatableExpression(translation, position, type) && isTranslatableExpression(translation, position, type);
+}
+
+/**
+ * Determines whether a condition is made up of comparisons of translatable expressions, combined with and or or
+ */
+static int isTranslatableCondition(struct translation * translation, unsigned int * position) {
+	unsigned char token=((unsigned char*) translation->code)[*position];
+	char type=getTypedTokenType(token);
+	*position+=sizeof(unsigned char);
+	if (token == AND_TOKEN || token == OR_TOKEN) {
+		*position+=sizeof(unsigned short);
+		return isTranslatableCondition(translation, position) && isTranslatableCondition(translation, position);
+	}
+	token=getGenericToken(token);
+	if (token < EQ_TOKEN || token > GEQ_TOKEN) return 0;
+	if (type == TRANSLATED_ANY_TYPE) type=getOperandsType(translation, *position);
+	if (type == TRANSLATED_ANY_TYPE) return 0;
+	return isTranslatableExpression(translation, position, type) && isTranslatableExpression(translation, position, type);
+}
+
+/**
+ * Determines whether a value can be evaluated in C and passed to the runtime, which is a string or boolean constant, a variable or
+ * one dimensional array element of any type, or an integer or real expression. The variables are recorded
+ */
+static int isTranslatableValue(struct translation * translation, unsigned int * position) {
+	unsigned char token=((unsigned char*) translation->code)[*position];
+	unsigned short slot;
+	char type;
+	if (token == STRING_TOKEN || token == BOOLEAN_TOKEN) return skipExpression(translation->code, position);
+	if (token == IDENTIFIER_TOKEN || token == ARRAYACCESS_TOKEN) {
+		memcpy(&slot, &translation->code[*position+sizeof(unsigned char)], sizeof(unsigned short));
+		*position+=sizeof(unsigned char) + sizeof(unsigned short);
+		if (token == IDENTIFIER_TOKEN) return addTranslatedVariable(translation, slot, TRANSLATED_ANY_TYPE, TRANSLATED_ANY_DTYPE) >= 0;
+		if (translation->code[(*position)++] != 1) return 0;
+		return addTranslatedElement(translation, slot, TRANSLATED_ANY_TYPE, position) >= 0;
+	}
+	type=getExpressionType(translation, *position);
+	return type != TRANSLATED_ANY_TYPE && isTranslatableExpression(translation, position, type);
+}
+
+/**
+ * Determines whether a call to a native function can be made from C, which is the case when all of its arguments can be evaluated
+ */
+static int isTranslatableNative(struct translation * translation, unsigned int * position) {
+	unsigned short numberArgs, i;
+	memcpy(&numberArgs, &translation->code[*position+sizeof(unsigned char)*2], sizeof(unsigned short));
+	*position+=sizeof(unsigned char)*2 + sizeof(unsigned short);
+	for (i=0;i<numberArgs;i++) {
+		if (!isTranslatableValue(translation, position)) return 0;
+	}
+	return 1;
+}
+
+/**
+ * Writes out the C of a translatable expression, variables being those recorded when it was checked
+ */
+static void writeExpression(struct translation * translation, unsigned int * position) {
+	static const char * operators[]={"+", "-", "*", "/", "%"};
+	unsigned char token=((unsigned char*) translation->code)[*position];
+	unsigned short slot;
+	int i;
+	*position+=sizeof(unsigned char);
+	if (token == INTEGER_TOKEN) {
+		memcpy(&i, &translation->code[*position], sizeof(int));
+		*position+=sizeof(int);
+		fprintf(translation->file, "(%d)", i);
+	} else if (token == REAL_TOKEN) {
+		float value;
+		memcpy(&value, &translation->code[*position], sizeof(float));
+		*position+=sizeof(float);
+		fprintf(translation->file, "(%af)", value);
+	} else if (token == IDENTIFIER_TOKEN) {
+		memcpy(&slot, &translation->code[*position], sizeof(unsigned short));
+		*position+=sizeof(unsigned short);
+		i=findTranslatedVariable(translation, slot);
+		fprintf(translation->file, "getTranslated%s(v%d)", translation->variables[i].type == INT_TYPE ? "Int" : "Real", i);
+	} else if (token == ARRAYACCESS_TOKEN) {
+		memcpy(&slot, &translation->code[*position], sizeof(unsigned short));
+		*position+=sizeof(unsigned short) + sizeof(unsigned char);
+		i=findTranslatedVariable(translation, slot);
+		fprintf(translation->file, "getTranslated%sElement(v%d, ", translation->variables[i].type == INT_TYPE ? "Int" : "Real", i);
+		writeExpression(translation, position);
+		fprintf(translation->file, ")");
+	} else if (token == NATIVE_TOKEN) {
+		fprintf(translation->file, "getTranslatedNativeInt(%u, threadId)", ((unsigned char*) translation->code)[*position]);
+		*position+=sizeof(unsigned char) + sizeof(unsigned short);
+	} else {
+		fprintf(translation->file, "(");
+		writeExpression(translation, position);
+		fprintf(translation->file, " %s ", operators[getGenericToken(token)-ADD_TOKEN]);
+		writeExpression(translation, position);
+		fprintf(translation->file, ")");
+	}
+}
+
+/**
+ * Writes out the C of a translatable condition
+ */
+static void writeCondition(struct translation * translation, unsigned int * position) {
+	static const char * operators[]={"==", "!=", "<", ">", "<=", ">="};
+	unsigned char token=getGenericToken(((unsigned char*) translation->code)[*position]);
+	*position+=sizeof(unsigned char);
+	if (token == AND_TOKEN || token == OR_TOKEN) {
+		*position+=sizeof(unsigned short);
+		fprintf(translation->file, "(");
+		writeCondition(translation, position);
+		fprintf(translation->file, " %s ", token == AND_TOKEN ? "&&" : "||");
+		writeCondition(translation, position);
+		fprintf(translation->file, ")");
+	} else {
+		fprintf(translation->file, "(");
+		writeExpression(translation, position);
+		fprintf(translation->file, " %s ", operators[token-EQ_TOKEN]);
+		writeExpression(translation, position);
+		fprintf(translation->file, ")");
+	}
+}
+
+/**
+ * Writes out the C of a translatable value, which gives the value_defn to pass to the runtime
+ */
+static void writeValue(struct translation * translation, unsigned int * position) {
+	unsigned char token=((unsigned char*) translation->code)[*position];
+	unsigned short slot;
+	if (token == STRING_TOKEN || token == BOOLEAN_TOKEN) {
+		fprintf(translation->file, "getTranslatedConstant(%s, &assembled[%u])", token == STRING_TOKEN ? "STRING_TYPE" : "BOOLEAN_TYPE",
+				*position+(unsigned int) sizeof(unsigned char));
+		skipExpression(translation->code, position);
+	} else if (token == IDENTIFIER_TOKEN || token == ARRAYACCESS_TOKEN) {
+		memcpy(&slot, &translation->code[*position+sizeof(unsigned char)], sizeof(unsigned short));
+		*position+=sizeof(unsigned char) + sizeof(unsigned short);
+		if (token == IDENTIFIER_TOKEN) {
+			fprintf(translation->file, "getTranslatedIdentifierValue(v%d)", findTranslatedVariable(translation, slot));
+		} else {
+			*position+=sizeof(unsigned char);
+			fprintf(translation->file, "getTranslatedElementValue(v%d, ", findTranslatedVariable(translation, slot));
+			writeExpression(translation, position);
+			fprintf(translation->file, ")");
+		}
+	} else {
+		fprintf(translation->file, "getTranslated%sValue(", getExpressionType(translation, *position) == INT_TYPE ? "Int" : "Real");
+		writeExpression(translation, position);
+		fprintf(translation->file, ")");
+	}
+}
+
+/**
+ * Writes out the evaluation of the arguments of a native function and the call to it, whose value is placed in result
+ */
+static void writeNativeCall(struct translation * translation, unsigned int position) {
+	unsigned char fnCode=((unsigned char*) translation->code)[position+sizeof(unsigned char)];
+	unsigned short numberArgs, i;
+	memcpy(&numberArgs, &translation->code[position+sizeof(unsigned char)*2], sizeof(unsigned short));
+	position+=sizeof(unsigned char)*2 + sizeof(unsigned short);
+	fprintf(translation->file, "\t\t\tstruct value_defn result");
+	if (numberArgs > 0) fprintf(translation->file, ", args[%u]", numberArgs);
+	fprintf(translation->file, ";\n");
+	for (i=0;i<numberArgs;i++) {
+		fprintf(translation->file, "\t\t\targs[%u]=", i);
+		writeValue(translation, &position);
+		fprintf(translation->file, ";\n");
+	}
+	fprintf(translation->file, "\t\t\tcallTranslatedNative(&result, %u, %u, %s, threadId);\n", fnCode, numberArgs,
+			numberArgs > 0 ? "args" : "NULL");
+	fprintf(translation->file, "\t\t\tif (stopInterpreter[threadId]) return empty;\n");
+}
+
+/**
+ * Records a variable used by a statement, returning its index or -1 if the statement can not be translated because the variable
+ * must hold different types or dtypes, or uses too many variables
+ */
+static int addTranslatedVariable(struct translation * translation, unsigned short slot, char type, char dtype) {
+	int i;
+	for (i=0;i<translation->numberVariables;i++) {
+		if (translation->variables[i].slot == slot) {
+			if (translation->variables[i].type == TRANSLATED_ANY_TYPE) translation->variables[i].type=type;
+			if (translation->variables[i].dtype == TRANSLATED_ANY_DTYPE) translation->variables[i].dtype=dtype;
+			if (type != TRANSLATED_ANY_TYPE && translation->variables[i].type != type) return -1;
+			if (dtype != TRANSLATED_ANY_DTYPE && translation->variables[i].dtype != dtype) return -1;
+			return i;
+		}
+	}
+	if (translation->numberVariables == MAX_TRANSLATED_VARIABLES) return -1;
+	translation->variables[translation->numberVariables].slot=slot;
+	translation->variables[translation->numberVariables].type=type;
+	translation->variables[translation->numberVariables].dtype=dtype;
+	return translation->numberVariables++;
+}
+
+/**
+ * Records an access to an element of a one dimensional array, whose integer index expression is at some position, returning the
+ * index of the array's variable or -1 if this can not be translated. The index is checked along with the variables, so an access
+ * outside of the array is left to the interpreter to raise the error or extend the array
+ */
+static int addTranslatedElement(struct translation * translation, unsigned short slot, char type, unsigned int * position) {
+	unsigned int indexPoint=*position;
+	int k;
+	if (!isTranslatableExpression(translation, position, INT_TYPE)) return -1;
+	k=addTranslatedVariable(translation, slot, type, ARRAY);
+	if (k < 0 || translation->numberIndexes == MAX_TRANSLATED_VARIABLES) return -1;
+	translation->indexes[translation->numberIndexes].variable=k;
+	translation->indexes[translation->numberIndexes].position=indexPoint;
+	translation->numberIndexes++;
+	return k;
+}
+
+/**
+ * Retrieves the index of a variable recorded for the statement being translated
+ */
+static int findTranslatedVariable(struct translation * translation, unsigned short slot) {
+	int i;
+	for (i=0;translation->variables[i].slot != slot;i++);
+	return i;
+}
+
+/**
+ * Writes out the lookup of the variables used by a statement, and the check that they are of the types and dtypes required and
+ * that array indexes are within the arrays. This opens two blocks, which are closed once the translated statement has been written
+ */
+static void writeVariableGuards(struct translation * translation) {
+	int i, numberGuards=0;
+	unsigned int position;
+	fprintf(translation->file, "\t{\n");
+	for (i=0;i<translation->numberVariables;i++) {
+		fprintf(translation->file, "\t\tstruct symbol_node * v%d=getTranslatedVariableSymbol(%u, threadId);\n", i,
+				translation->variables[i].slot);
+	}
+	fprintf(translation->file, "\t\tif (");
+	for (i=0;i<translation->numberVariables;i++) {
+		if (translation->variables[i].dtype == TRANSLATED_ANY_DTYPE) continue;
+		fprintf(translation->file, "%sv%d->value.dtype == %s", numberGuards++ > 0 ? " && " : "", i,
+				translation->variables[i].dtype == ARRAY ? "ARRAY" : "SCALAR");
+		if (translation->variables[i].dtype == ARRAY) fprintf(translation->file, " && isTranslatedArray(v%d)", i);
+		if (translation->variables[i].type != TRANSLATED_ANY_TYPE) {
+			fprintf(translation->file, " && v%d->value.type == %s", i, translation->variables[i].type == INT_TYPE ? "INT_TYPE" : "REAL_TYPE");
+		}
+	}
+	// Indexes are checked in the order recorded, so that the index of an element used in another index is checked first
+	for (i=0;i<translation->numberIndexes;i++) {
+		position=translation->indexes[i].position;
+		fprintf(translation->file, "%sisTranslatedIndex(v%d, ", numberGuards++ > 0 ? " && " : "", translation->indexes[i].variable);
+		writeExpression(translation, &position);
+		fprintf(translation->file, ")");
+	}
+	if (numberGuards == 0) fprintf(translation->file, "1");
+	fprintf(translation->file, ") {\n");
+}
+
+/**
+ * Writes out a jump to the statement at some point, which is made through the switch if this is not a statement in the code
+ */
+static void writeJump(struct translation * translation, unsigned int target) {
+	if (target < translation->length && translation->statementStarts[target]) {
+		fprintf(translation->file, "\tgoto s%u;\n", target);
+	} else {
+		fprintf(translation->file, "\t{ p=%u; goto dispatch; }\n", target);
+	}
+}
+
+/**
+ * Retrieves the generic token of an operator, which might have been typed
+ */
+static unsigned char getGenericToken(unsigned char token) {
+	if (token >= INT_TYPED_TOKEN_BASE) return ((token-INT_TYPED_TOKEN_BASE) & 0xF)+EQ_TOKEN;
+	return token;
+}
+
+/**
+ * Retrieves the type of the operands of a typed operator, or TRANSLATED_ANY_TYPE if the operator is not typed
+ */
+static char getTypedTokenType(unsigned char token) {
+	if (token >= INT_TYPED_TOKEN_BASE && token < REAL_TYPED_TOKEN_BASE) return INT_TYPE;
+	if (token >= REAL_TYPED_TOKEN_BASE && token < REAL_TYPED_TOKEN_BASE + 0x10) return REAL_TYPE;
+	return TRANSLATED_ANY_TYPE;
+}
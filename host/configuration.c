@@ -36,6 +36,13 @@
 #define TOTAL_CORES 1
 #endif
 
+#ifdef HOST_TRANSLATED
+// The code is built into the executable, so this can be run without any arguments
+#define ARGUMENTS_REQUIRED 0
+#else
+#define ARGUMENTS_REQUIRED 1
+#endif
+
 static void parseCommandLineArguments(struct interpreterconfiguration*, int, char**);
 static void parseCoreActiveInfo(struct interpreterconfiguration*, char*);
 static int areStringsEqualIgnoreCase(char*, char*);
@@ -51,8 +58,11 @@ struct interpreterconfiguration* readConfiguration(int argc, char *argv[]) {
 	configuration->intentActive=(char*) malloc(TOTAL_CORES);
 	for (i=0;i<TOTAL_CORES;i++) configuration->intentActive[i]=1;
 	configuration->displayStats=configuration->displayTiming=configuration->forceCodeOnCore=
-			configuration->forceCodeOnShared=configuration->forceDataOnShared=configuration->displayPPCode=0;
-	configuration->filename=configuration->compiledByteFilename=configuration->loadByteFilename=configuration->pipedInContents=NULL;
+			configuration->forceCodeOnShared=configuration->forceDataOnShared=configuration->displayPPCode=configuration->registerExpressions=
+			configuration->countSuperinstructions=configuration->jit=configuration->linkModules=0;
+	configuration->useByteCodeCache=1;
+	configuration->filename=configuration->compiledByteFilename=configuration->loadByteFilename=configuration->pipedInContents=
+			configuration->translatedFilename=NULL;
 	parseCommandLineArguments(configuration, argc, argv);
 	return configuration;
 }
@@ -61,7 +71,7 @@ struct interpreterconfiguration* readConfiguration(int argc, char *argv[]) {
  * Parses command line arguments
  */
 static void parseCommandLineArguments(struct interpreterconfiguration* configuration, int argc, char *argv[]) {
-	if (argc == 1) {
+	if (argc == 1 && ARGUMENTS_REQUIRED) {
 		displayHelp();
 		exit(0);
 	} else {
@@ -86,6 +96,25 @@ static void parseCommandLineArguments(struct interpreterconfiguration* configura
 			} else if (areStringsEqualIgnoreCase(argv[i], "-elf")) {
 				configuration->loadElf=1;
 		                configuration->loadSrec=0;
+			} else if (areStringsEqualIgnoreCase(argv[i], "-reg")) {
+				configuration->registerExpressions=1;
+			} else if (areStringsEqualIgnoreCase(argv[i], "-sicount")) {
+				configuration->countSuperinstructions=1;
+			} else if (areStringsEqualIgnoreCase(argv[i], "-nocache")) {
+				configuration->useByteCodeCache=0;
+			} else if (areStringsEqualIgnoreCase(argv[i], "-linkmodules")) {
+				configuration->linkModules=1;
+#ifdef HOST_STANDALONE
+			} else if (areStringsEqualIgnoreCase(argv[i], "-jit")) {
+				configuration->jit=1;
+			} else if (areStringsEqualIgnoreCase(argv[i], "-emitc")) {
+				if (i+1 ==argc) {
+					fprintf(stderr, "When specifying to translate to C then you must provide a filename for this\n");
+					exit(0);
+				} else {
+					configuration->translatedFilename=argv[++i];
+				}
+#endif
 			} else if (areStringsEqualIgnoreCase(argv[i], "-t")) {
 				configuration->displayTiming=1;
 			} else if (areStringsEqualIgnoreCase(argv[i], "-fullpython")) {
@@ -164,12 +193,17 @@ static void parseCommandLineArguments(struct interpreterconfiguration* configura
 				}
 			}
 		}
-		if (configuration->loadByteFilename == NULL && configuration->filename == NULL && configuration->pipedInContents == NULL) {
+		if (ARGUMENTS_REQUIRED && configuration->loadByteFilename == NULL && configuration->filename == NULL &&
+				configuration->pipedInContents == NULL) {
 			fprintf(stderr, "You must supply a file to run as an argument, see -h for details\n");
 			exit(0);
 		}
 #ifndef HOST_STANDALONE
 		for (i=0;i<16;i++) if (configuration->intentActive[i]) configuration->coreProcs++;
+		if (configuration->registerExpressions && configuration->coreProcs > 0 && configuration->compiledByteFilename == NULL) {
+			fprintf(stderr, "Expressions in the register format can only be run by host processes, use -reg with -d 0\n");
+			exit(0);
+		}
 #endif
 	}
 }
@@ -236,6 +270,16 @@ static void displayHelp() {
 #endif
 	printf("-s             Display parse statistics\n");
 	printf("-pp            Display preprocessed code\n");
+	printf("-reg           Compile expressions to the register based format, which only host processes run\n");
+	printf("-sicount       Display how many times each superinstruction fired on the host\n");
+	printf("-nocache       Always compile the source code, rather than loading unchanged programs from the byte code cache\n");
+	printf("-linkmodules   Compile each imported module once into an object which is linked in, rather than including its source\n");
+#ifdef HOST_STANDALONE
+	printf("-jit           Compile hot loops to native code (x86-64 only)\n");
+	printf("-emitc file    Translate the Python code to C and exit (does not run code), build with make translated SOURCE=file\n");
+	printf("               Only integer and real arithmetic and control flow become C, function calls, natives, arrays and\n");
+	printf("               strings are still run by the interpreter\n");
+#endif
 	printf("-o filename    Write out the compiled byte representation of processed Python code and exits (does not run code)\n");
 	printf("-l filename    Loads from compiled byte representation of code and runs this\n");
 	printf("-help          Display this help and quit\n");
@@ -32,8 +32,8 @@
 // Configuration structure which is filled based upon command line arguments
 struct interpreterconfiguration {
 	char * intentActive;
-	char displayStats, displayTiming, forceCodeOnCore, forceCodeOnShared, forceDataOnShared, displayPPCode;
-	char * filename, *compiledByteFilename, *loadByteFilename, *pipedInContents;
+	char displayStats, displayTiming, forceCodeOnCore, forceCodeOnShared, forceDataOnShared, displayPPCode, registerExpressions, countSuperinstructions, jit, useByteCodeCache, linkModules;
+	char * filename, *compiledByteFilename, *loadByteFilename, *pipedInContents, *translatedFilename;
 	int hostProcs, coreProcs, loadElf, loadSrec, fullPythonHost;
 };
 
@@ -55,7 +55,7 @@ volatile unsigned int * pb;
 
 static void initialiseCores(struct shared_basic*, int, struct interpreterconfiguration*);
 static void loadBinaryInterpreterOntoCores(struct interpreterconfiguration*, char);
-static void placeByteCode(struct shared_basic*, int, char*);
+static void placeByteCode(struct shared_basic*, int, char*, char*);
 static void checkStatusFlagsOfCore(struct shared_basic*, struct interpreterconfiguration*, int);
 static void deactivateCore(struct interpreterconfiguration*, int);
 static void startApplicableCores(struct shared_basic*, struct interpreterconfiguration*);
@@ -77,6 +77,8 @@ static char * allocateChunkInSharedHeapMemory(size_t, struct core_ctrl *);
 struct shared_basic * loadCodeOntoEpiphany(struct interpreterconfiguration* configuration) {
 	struct shared_basic * basicCode;
 	int i, result, codeOnCore=0;
+	unsigned int specialisedLength;
+	char * specialisedCode;
 	e_set_host_verbosity(H_D0);
 	result = e_init(NULL);
 	if (result == E_ERR) fprintf(stderr, "Error on initialisation\n");
@@ -89,7 +91,13 @@ struct shared_basic * loadCodeOntoEpiphany(struct interpreterconfiguration* conf
 	if (result == E_ERR) fprintf(stderr, "Error allocating memory\n");
 
 	basicCode=(void*) management_DRAM.base;
-	basicCode->length=getMemoryFilledSize();
+	// All cores share the one copy of the byte code, so this is only specialised to being on a device and the number of cores
+	specialisedCode=configuration->fullPythonHost ? NULL : getSpecialisedByteCode(0, -1, configuration->coreProcs+configuration->hostProcs,
+			&specialisedLength);
+	basicCode->length=specialisedCode != NULL ? specialisedLength : getMemoryFilledSize();
+	if (specialisedCode != NULL && configuration->displayStats) {
+		printf("%u bytes for code specialised to the device\n", specialisedLength);
+	}
 
 	if (configuration->forceCodeOnCore) {
 		codeOnCore=1;
@@ -108,7 +116,8 @@ struct shared_basic * loadCodeOntoEpiphany(struct interpreterconfiguration* conf
 	basicCode->baseHostPid=configuration->coreProcs;
 
 	initialiseCores(basicCode, codeOnCore, configuration);
-	placeByteCode(basicCode, codeOnCore, configuration->intentActive);
+	placeByteCode(basicCode, codeOnCore, configuration->intentActive, specialisedCode != NULL ? specialisedCode : getAssembledCode());
+	free(specialisedCode);
 	startApplicableCores(basicCode, configuration);
 
 	pb=(unsigned int*) malloc(sizeof(unsigned int) * TOTAL_CORES);
@@ -278,10 +287,10 @@ static int doesFileExist(char * filename) {
 /**
  * Places the bytecode representation of the users Python code onto the cores
  */
-static void placeByteCode(struct shared_basic * basicState, int codeOnCore, char * intentActive) {
+static void placeByteCode(struct shared_basic * basicState, int codeOnCore, char * intentActive, char * code) {
 	basicState->data=(void*) (SHARED_CODE_AREA_START+management_DRAM.base);
 	basicState->esdata=(void*) (SHARED_CODE_AREA_START+(void*)management_DRAM.ephy_base);
-	memcpy(basicState->data, getAssembledCode(), basicState->length);
+	memcpy(basicState->data, code, basicState->length);
 	if (!codeOnCore) {
 		basicState->edata=basicState->esdata;
 	} else {
@@ -2,6 +2,9 @@
 #include "byteassembler.h"
 #include "memorymanager.h"
 #include "stack.h"
+#include "arena.h"
+#include "ir.h"
+#include "basictokens.h"
 #include <string.h>
 #include <stdlib.h>
 #include <stddef.h>
@@ -23,9 +26,9 @@ void yyerror (char const *msg) {
 	int integer;
 	unsigned char uchar;
 	float real;	
-	struct memorycontainer * data;
+	struct ir_node * ir;
 	char *string;
-	struct stack_t * stack;
+	struct ir_list * irlist;
 }
 
 %token <integer> INTEGER
@@ -51,18 +54,24 @@ void yyerror (char const *msg) {
 %type <string> ident declareident fn_entry
 %type <integer> unary_operator 
 %type <uchar> opassgn
-%type <data> constant expression logical_or_expression logical_and_expression equality_expression relational_expression additive_expression multiplicative_expression value statement statements line lines codeblock elifblock identscalararray identscalararraylhs
-%type <stack> fndeclarationargs fncallargs commaseparray arrayaccessor
+%type <ir> constant expression logical_or_expression logical_and_expression equality_expression relational_expression additive_expression multiplicative_expression value statement statements line codeblock elifblock identscalararray identscalararraylhs
+%type <irlist> fndeclarationargs fncallargs commaseparray arrayaccessor lines toplevellines
 
 %start program 
 
 %%
 
-program : lines { compileMemory($1); }
+program : toplevellines { compileMemory(lowerIr($1)); }
+
+toplevellines
+        : /*blank*/ { $$=createIrList(); }
+        | toplevellines statement { appendIrStatements($1, $2); $$=lowerIrBatch($1); }
+        | toplevellines NEWLINE { $$=$1; }
+;
 
 lines
-        : line
-        | lines line { $$=concatenateMemory($1, $2); }
+        : line { $$=createIrList(); appendIrStatements($$, $1); }
+        | lines line { appendIrStatements($1, $2); $$=$1; }
 ;
 
 line
@@ -72,64 +81,64 @@ line
 ;
 
 statements
-	: statement statements { $$=concatenateMemory($1, $2); }
-	| statement
+	: statement statements { $$=prependIrStatement($2, $1); }
+	| statement { $$ = $1; }
 ;
 
 statement	
-	: FOR declareident IN expression COLON codeblock { $$=appendForStatement($2, $4, $6); leaveScope(); }
-	| WHILE expression COLON codeblock { $$=appendWhileStatement($2, $4); }	
-	| IF expression COLON codeblock { $$=appendIfStatement($2, $4); }
-	| IF expression COLON codeblock ELSE COLON codeblock { $$=appendIfElseStatement($2, $4, $7); }
-	| IF expression COLON codeblock elifblock { $$=appendIfElseStatement($2, $4, $5); }		
-	| IF expression COLON statements { $$=appendIfStatement($2, $4); }
-	| ELIF expression COLON codeblock { $$=appendIfStatement($2, $4); }		
-    	| identscalararraylhs ASSGN expression { $$=appendLetStatement($1, $3); }
-    	| identscalararray opassgn expression { $$=appendLetWithOperatorStatement($1, $3, $2); }
-	| PRINT expression { $$=appendNativeCallFunctionStatement("rtl_print", NULL, $2); }	
-	| EXIT LPAREN RPAREN{ $$=appendStopStatement(); }
-	| QUIT LPAREN RPAREN{ $$=appendStopStatement(); }
-	| fn_entry LPAREN fndeclarationargs RPAREN COLON codeblock { appendNewFunctionStatement($1, $3, $6); leaveScope(); $$ = NULL; }
-	| RET { $$ = appendReturnStatement(); }	
-	| RET expression { $$ = appendReturnStatementWithExpression($2); }
-	| ident LPAREN fncallargs RPAREN { $$=appendCallFunctionStatement($1, $3); }
-	| NATIVE ident LPAREN fncallargs RPAREN { $$=appendNativeCallFunctionStatement($2, $4, NULL); }
-	| PASS { $$=appendPassStatement(); }
-	| AT ident {  fn_decorator=(char*) malloc(strlen($2)+1); strcpy(fn_decorator, $2); $$ = NULL; }
-	| ALIAS LPAREN ident COMMA expression RPAREN { $$=appendAliasStatement($3, $5); }
+	: FOR declareident IN expression COLON codeblock { $$=createIrFor($2, $4, $6); }
+	| WHILE expression COLON codeblock { $$=createIrWhile($2, $4); }	
+	| IF expression COLON codeblock { $$=createIrIf($2, $4, NULL); }
+	| IF expression COLON codeblock ELSE COLON codeblock { $$=createIrIf($2, $4, $7); }
+	| IF expression COLON codeblock elifblock { $$=createIrIf($2, $4, $5); }		
+	| IF expression COLON statements { $$=createIrIf($2, $4, NULL); }
+	| ELIF expression COLON codeblock { $$=createIrIf($2, $4, NULL); }		
+    	| identscalararraylhs ASSGN expression { $$=createIrLet($1, $3); }
+    	| identscalararray opassgn expression { $$=createIrLetWithOperator($1, $3, $2); }
+	| PRINT expression { $$=createIrNativeCall("rtl_print", NULL, $2); }	
+	| EXIT LPAREN RPAREN{ $$=createIrStop(); }
+	| QUIT LPAREN RPAREN{ $$=createIrStop(); }
+	| fn_entry LPAREN fndeclarationargs RPAREN COLON codeblock { $$=createIrFunction($1, $3, $6); }
+	| RET { $$ = createIrReturn(NULL); }	
+	| RET expression { $$ = createIrReturn($2); }
+	| ident LPAREN fncallargs RPAREN { $$=createIrCall($1, $3); }
+	| NATIVE ident LPAREN fncallargs RPAREN { $$=createIrNativeCall($2, $4, NULL); }
+	| PASS { $$=createIrPass(); }
+	| AT ident { $$=createIrDecorator($2); }
+	| ALIAS LPAREN ident COMMA expression RPAREN { $$=createIrAlias($3, $5); }
 ;
 
 arrayaccessor
-	: SLBRACE expression SRBRACE { $$=getNewStack(); pushExpression($$, $2); }
-	| arrayaccessor SLBRACE expression SRBRACE { pushExpression($1, $3); }
+	: SLBRACE expression SRBRACE { $$=createIrList(); appendIrNode($$, $2); }
+	| arrayaccessor SLBRACE expression SRBRACE { appendIrNode($1, $3); }
 ;
 
 fncallargs
-	: /*blank*/ { $$=getNewStack(); }	
-	| expression { $$=getNewStack(); pushExpression($$, $1); }
-	| fncallargs COMMA expression { pushExpression($1, $3); $$=$1; }
+	: /*blank*/ { $$=createIrList(); }	
+	| expression { $$=createIrList(); appendIrNode($$, $1); }
+	| fncallargs COMMA expression { appendIrNode($1, $3); $$=$1; }
 	;
 
 fndeclarationargs
-	: /*blank*/ { enterScope(); $$=getNewStack(); }
-	| ident { $$=getNewStack(); enterScope(); pushIdentifier($$, $1); appendArgument($1); }
-	| ident ASSGN expression { $$=getNewStack(); enterScope(); pushIdentifierAssgnExpression($$, $1, $3); appendArgument($1); }
-	| fndeclarationargs COMMA ident { pushIdentifier($1, $3); $$=$1; appendArgument($3); }	
-	| fndeclarationargs COMMA ident ASSGN expression { pushIdentifierAssgnExpression($1, $3, $5); $$=$1; appendArgument($3); }
+	: /*blank*/ { $$=createIrList(); }
+	| ident { $$=createIrList(); appendIrNode($$, createIrParameter($1, NULL)); }
+	| ident ASSGN expression { $$=createIrList(); appendIrNode($$, createIrParameter($1, $3)); }
+	| fndeclarationargs COMMA ident { appendIrNode($1, createIrParameter($3, NULL)); $$=$1; }	
+	| fndeclarationargs COMMA ident ASSGN expression { appendIrNode($1, createIrParameter($3, $5)); $$=$1; }
 	;
 	
 fn_entry
-	: DEF ident { enterFunction($2); $$=$2; }
+	: DEF ident { $$=$2; }
 	;
 
 codeblock
-	: NEWLINE indent_rule lines outdent_rule { $$=$3; }
+	: NEWLINE indent_rule lines outdent_rule { $$=createIrBlock($3, 1); }
 	
 indent_rule
-	: INDENT { enterScope(); }
+	: INDENT
 	
 outdent_rule
-	: OUTDENT { leaveScope(); }
+	: OUTDENT
 	
 opassgn
 	: ADDADD { $$=0; }
@@ -141,101 +150,101 @@ opassgn
 	| FLOORDIVFLOORDIV { $$=6; }
 
 declareident
-	 : ident { $$=$1; enterScope(); addVariableIfNeeded($1); }
+	 : ident { $$=$1; }
 ;
 
 elifblock
-	: ELIF expression COLON codeblock { $$=appendIfStatement($2, $4); }
-	| ELIF expression COLON codeblock ELSE COLON codeblock { $$=appendIfElseStatement($2, $4, $7); }
-	| ELIF expression COLON codeblock elifblock { $$=appendIfElseStatement($2, $4, $5); }
+	: ELIF expression COLON codeblock { $$=createIrIf($2, $4, NULL); }
+	| ELIF expression COLON codeblock ELSE COLON codeblock { $$=createIrIf($2, $4, $7); }
+	| ELIF expression COLON codeblock elifblock { $$=createIrIf($2, $4, $5); }
 ;
 
 expression
 	: logical_or_expression { $$=$1; }
-	| NOT logical_or_expression { $$=createNotExpression($2); }
+	| NOT logical_or_expression { $$=createIrNot($2); }
 ;
 
 logical_or_expression
 	: logical_and_expression { $$=$1; }
-	| logical_or_expression OR logical_and_expression { $$=createOrExpression($1, $3); }
+	| logical_or_expression OR logical_and_expression { $$=createIrOperator(OR_TOKEN, $1, $3); }
 
 logical_and_expression
 	: equality_expression { $$=$1; }
-	| logical_and_expression AND equality_expression { $$=createAndExpression($1, $3); }
+	| logical_and_expression AND equality_expression { $$=createIrOperator(AND_TOKEN, $1, $3); }
 ;
 
 equality_expression
 	: relational_expression { $$=$1; }
-	| equality_expression EQ relational_expression { $$=createEqExpression($1, $3); }
-	| equality_expression NEQ relational_expression { $$=createNeqExpression($1, $3); }
-	| equality_expression IS relational_expression { $$=createIsExpression($1, $3); }
+	| equality_expression EQ relational_expression { $$=createIrOperator(EQ_TOKEN, $1, $3); }
+	| equality_expression NEQ relational_expression { $$=createIrOperator(NEQ_TOKEN, $1, $3); }
+	| equality_expression IS relational_expression { $$=createIrOperator(IS_TOKEN, $1, $3); }
 ;
 
 relational_expression
 	: additive_expression { $$=$1; }
-	| relational_expression GT additive_expression { $$=createGtExpression($1, $3); }
-	| relational_expression LT additive_expression { $$=createLtExpression($1, $3); }
-	| relational_expression LEQ additive_expression { $$=createLeqExpression($1, $3); }
-	| relational_expression GEQ additive_expression { $$=createGeqExpression($1, $3); }
+	| relational_expression GT additive_expression { $$=createIrOperator(GT_TOKEN, $1, $3); }
+	| relational_expression LT additive_expression { $$=createIrOperator(LT_TOKEN, $1, $3); }
+	| relational_expression LEQ additive_expression { $$=createIrOperator(LEQ_TOKEN, $1, $3); }
+	| relational_expression GEQ additive_expression { $$=createIrOperator(GEQ_TOKEN, $1, $3); }
 ;
 
 additive_expression
 	: multiplicative_expression { $$=$1; }
-	| additive_expression ADD multiplicative_expression { $$=createAddExpression($1, $3); }
-	| additive_expression SUB multiplicative_expression { $$=createSubExpression($1, $3); }
+	| additive_expression ADD multiplicative_expression { $$=createIrOperator(ADD_TOKEN, $1, $3); }
+	| additive_expression SUB multiplicative_expression { $$=createIrOperator(SUB_TOKEN, $1, $3); }
 ;
 
 multiplicative_expression
 	: value { $$=$1; }
-	| multiplicative_expression MULT value { $$=createMulExpression($1, $3); }
-	| multiplicative_expression DIV value { $$=createDivExpression($1, $3); }
-	| multiplicative_expression FLOORDIV value { $$=createFloorDivExpression($1, $3); }
-	| multiplicative_expression MOD value { $$=createModExpression($1, $3); }
-	| multiplicative_expression POW value { $$=createPowExpression($1, $3); }
+	| multiplicative_expression MULT value { $$=createIrOperator(MUL_TOKEN, $1, $3); }
+	| multiplicative_expression DIV value { $$=createIrOperator(DIV_TOKEN, $1, $3); }
+	| multiplicative_expression FLOORDIV value { $$=createIrFloorDiv($1, $3); }
+	| multiplicative_expression MOD value { $$=createIrOperator(MOD_TOKEN, $1, $3); }
+	| multiplicative_expression POW value { $$=createIrOperator(POW_TOKEN, $1, $3); }
 	| STR LPAREN expression RPAREN { $$=$3; } 	
-	| SLBRACE commaseparray SRBRACE { $$=createArrayExpression($2, NULL); }
-	| SLBRACE commaseparray SRBRACE MULT value { $$=createArrayExpression($2, $5); }
-	| INPUT LPAREN RPAREN { $$=appendNativeCallFunctionStatement("rtl_input", NULL, NULL); }
-	| INPUT LPAREN expression RPAREN { $$=appendNativeCallFunctionStatement("rtl_inputprint", NULL, $3); }	
+	| SLBRACE commaseparray SRBRACE { $$=createIrArray($2, NULL); }
+	| SLBRACE commaseparray SRBRACE MULT value { $$=createIrArray($2, $5); }
+	| INPUT LPAREN RPAREN { $$=createIrNativeCall("rtl_input", NULL, NULL); }
+	| INPUT LPAREN expression RPAREN { $$=createIrNativeCall("rtl_inputprint", NULL, $3); }	
 ;
 
 commaseparray
-	: expression { $$=getNewStack(); pushExpression($$, $1); }
-	| commaseparray COMMA expression { pushExpression($1, $3); }
+	: expression { $$=createIrList(); appendIrNode($$, $1); }
+	| commaseparray COMMA expression { appendIrNode($1, $3); }
 ;
 
 value
 	: constant { $$=$1; }
 	| LPAREN expression RPAREN { $$=$2; }
 	| identscalararray { $$=$1; }
-	| ident LPAREN fncallargs RPAREN { $$=appendCallFunctionStatement($1, $3); }
-	| NATIVE ident LPAREN fncallargs RPAREN { $$=appendNativeCallFunctionStatement($2, $4, NULL); }
-	| ID LPAREN ident RPAREN { $$=appendReferenceStatement($3); }
-	| SYMBOL LPAREN ident RPAREN { $$=appendSymbolStatement($3); }
+	| ident LPAREN fncallargs RPAREN { $$=createIrCall($1, $3); }
+	| NATIVE ident LPAREN fncallargs RPAREN { $$=createIrNativeCall($2, $4, NULL); }
+	| ID LPAREN ident RPAREN { $$=createIrReference($3); }
+	| SYMBOL LPAREN ident RPAREN { $$=createIrSymbol($3); }
 ;
 
 identscalararray
-	: ident { $$=createIdentifierExpression($1, 0); }
-	| ident arrayaccessor { $$=createIdentifierArrayAccessExpression($1, $2); }
+	: ident { $$=createIrVariable($1, 0); }
+	| ident arrayaccessor { $$=createIrArrayAccess($1, $2); }
 ;
 
 identscalararraylhs
-	: ident { $$=createIdentifierExpression($1, 1); }
-	| ident arrayaccessor { $$=createIdentifierArrayAccessExpression($1, $2); }
+	: ident { $$=createIrVariable($1, 1); }
+	| ident arrayaccessor { $$=createIrArrayAccess($1, $2); }
 
 ident
-	: IDENTIFIER { $$ = malloc(strlen($1)+1); strcpy($$, $1); }	
+	: IDENTIFIER { $$ = arenaDuplicateString($1); }	
 ;
 
 constant
-        : INTEGER { $$=createIntegerExpression($1); }
-        | REAL { $$=createRealExpression($1); }
-	| unary_operator INTEGER { $$=createIntegerExpression($1 * $2); }	
-	| unary_operator REAL { $$=createRealExpression($1 * $2); }		
-	| STRING { $$=createStringExpression($1); }	
-	| TRUE { $$=createBooleanExpression(1); }
-	| FALSE { $$=createBooleanExpression(0); }
-	| NONE { $$=createNoneExpression(); }
+        : INTEGER { $$=createIrInteger($1); }
+        | REAL { $$=createIrReal($1); }
+	| unary_operator INTEGER { $$=createIrInteger($1 * $2); }	
+	| unary_operator REAL { $$=createIrReal($1 * $2); }		
+	| STRING { $$=createIrString($1); }	
+	| TRUE { $$=createIrBoolean(1); }
+	| FALSE { $$=createIrBoolean(0); }
+	| NONE { $$=createIrNone(); }
 ;
 
 unary_operator
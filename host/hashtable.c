@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2016, Nick Brown
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Hash tables used by the compiler to look up variables, labels and functions by name or line id in constant time, rather
+ * than walking a list for each lookup
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "hashtable.h"
+
+#define INITIAL_NUMBER_BUCKETS 16
+
+static unsigned int hashName(char*, char);
+static unsigned int hashNumber(int);
+static int areNamesEqual(char*, char*, char);
+static struct hash_table_entry* findEntry(struct hash_table*, char*, int, unsigned int);
+static void addEntry(struct hash_table*, char*, int, unsigned int, void*);
+static void growHashTable(struct hash_table*);
+
+/**
+ * Creates an empty hash table, with a flag for whether names are to be compared ignoring their case
+ */
+struct hash_table* createHashTable(int ignoreCase) {
+	struct hash_table* table=(struct hash_table*) malloc(sizeof(struct hash_table));
+	table->numberBuckets=INITIAL_NUMBER_BUCKETS;
+	table->numberEntries=0;
+	table->ignoreCase=(char) ignoreCase;
+	table->buckets=(struct hash_table_entry**) calloc(table->numberBuckets, sizeof(struct hash_table_entry*));
+	return table;
+}
+
+/**
+ * Frees a hash table and its entries, the values which these refer to are left alone
+ */
+void freeHashTable(struct hash_table* table) {
+	struct hash_table_entry * entry, * next;
+	int i;
+	if (table == NULL) return;
+	for (i=0;i<table->numberBuckets;i++) {
+		for (entry=table->buckets[i];entry != NULL;entry=next) {
+			next=entry->next;
+			free(entry->name);
+			free(entry);
+		}
+	}
+	free(table->buckets);
+	free(table);
+}
+
+/**
+ * Gets the value held against a name, or NULL if there is not one
+ */
+void* getHashTableEntry(struct hash_table* table, char * name) {
+	struct hash_table_entry * entry=findEntry(table, name, 0, hashName(name, table->ignoreCase));
+	return entry != NULL ? entry->value : NULL;
+}
+
+/**
+ * Holds a value against a name, replacing any value that is already held against it
+ */
+void putHashTableEntry(struct hash_table* table, char * name, void * value) {
+	unsigned int hash=hashName(name, table->ignoreCase);
+	struct hash_table_entry * entry=findEntry(table, name, 0, hash);
+	if (entry != NULL) {
+		entry->value=value;
+	} else {
+		addEntry(table, name, 0, hash, value);
+	}
+}
+
+/**
+ * Gets the value held against a number, or NULL if there is not one
+ */
+void* getHashTableNumberEntry(struct hash_table* table, int number) {
+	struct hash_table_entry * entry=findEntry(table, NULL, number, hashNumber(number));
+	return entry != NULL ? entry->value : NULL;
+}
+
+/**
+ * Holds a value against a number, replacing any value that is already held against it
+ */
+void putHashTableNumberEntry(struct hash_table* table, int number, void * value) {
+	unsigned int hash=hashNumber(number);
+	struct hash_table_entry * entry=findEntry(table, NULL, number, hash);
+	if (entry != NULL) {
+		entry->value=value;
+	} else {
+		addEntry(table, NULL, number, hash, value);
+	}
+}
+
+/**
+ * Finds the entry for a name, or for a number if the name is NULL, whose hash is provided
+ */
+static struct hash_table_entry* findEntry(struct hash_table* table, char * name, int number, unsigned int hash) {
+	struct hash_table_entry * entry=table->buckets[hash & (table->numberBuckets - 1)];
+	while (entry != NULL) {
+		if (name != NULL ? entry->name != NULL && areNamesEqual(entry->name, name, table->ignoreCase) :
+				entry->name == NULL && entry->number == number) return entry;
+		entry=entry->next;
+	}
+	return NULL;
+}
+
+/**
+ * Adds a new entry, the table is doubled in size once it holds more entries than it has buckets
+ */
+static void addEntry(struct hash_table* table, char * name, int number, unsigned int hash, void * value) {
+	struct hash_table_entry * entry=(struct hash_table_entry*) malloc(sizeof(struct hash_table_entry));
+	if (name != NULL) {
+		entry->name=(char*) malloc(strlen(name) + 1);
+		strcpy(entry->name, name);
+	} else {
+		entry->name=NULL;
+	}
+	entry->number=number;
+	entry->value=value;
+	entry->next=table->buckets[hash & (table->numberBuckets - 1)];
+	table->buckets[hash & (table->numberBuckets - 1)]=entry;
+	if (++table->numberEntries > table->numberBuckets) growHashTable(table);
+}
+
+/**
+ * Doubles the number of buckets in a hash table and moves the entries into their new buckets
+ */
+static void growHashTable(struct hash_table* table) {
+	struct hash_table_entry ** oldBuckets=table->buckets, * entry, * next;
+	int i, numberOldBuckets=table->numberBuckets;
+	table->numberBuckets*=2;
+	table->buckets=(struct hash_table_entry**) calloc(table->numberBuckets, sizeof(struct hash_table_entry*));
+	for (i=0;i<numberOldBuckets;i++) {
+		for (entry=oldBuckets[i];entry != NULL;entry=next) {
+			unsigned int bucket=(entry->name != NULL ? hashName(entry->name, table->ignoreCase) : hashNumber(entry->number)) &
+					(table->numberBuckets - 1);
+			next=entry->next;
+			entry->next=table->buckets[bucket];
+			table->buckets[bucket]=entry;
+		}
+	}
+	free(oldBuckets);
+}
+
+/**
+ * FNV-1a hash of a name, which is case folded first if the case is to be ignored
+ */
+static unsigned int hashName(char * name, char ignoreCase) {
+	unsigned int hash=2166136261u;
+	for (;*name != '\0';name++) {
+		hash^=(unsigned char) (ignoreCase ? tolower((unsigned char) *name) : *name);
+		hash*=16777619u;
+	}
+	return hash;
+}
+
+/**
+ * Hash of a number, which mixes the bits so that consecutive numbers are spread across the buckets
+ */
+static unsigned int hashNumber(int number) {
+	unsigned int hash=(unsigned int) number;
+	hash^=hash >> 16;
+	hash*=0x45d9f3bu;
+	hash^=hash >> 16;
+	return hash;
+}
+
+/**
+ * Tests two names for equality, ignoring their case if required
+ */
+static int areNamesEqual(char * s1, char * s2, char ignoreCase) {
+	if (!ignoreCase) return strcmp(s1, s2) == 0;
+	for (;*s1 != '\0' && *s2 != '\0';s1++, s2++) {
+		if (tolower((unsigned char) *s1) != tolower((unsigned char) *s2)) return 0;
+	}
+	return *s1 == *s2;
+}
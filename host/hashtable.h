@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2016, Nick Brown
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HASHTABLE_H_
+#define HASHTABLE_H_
+
+// An entry in a hash table, which is keyed by either a name or a number
+struct hash_table_entry {
+	char * name;
+	int number;
+	void * value;
+	struct hash_table_entry * next;
+};
+
+// Hash table with separate chaining that grows as entries are added, names are optionally compared ignoring their case
+struct hash_table {
+	struct hash_table_entry ** buckets;
+	int numberBuckets, numberEntries;
+	char ignoreCase;
+};
+
+struct hash_table* createHashTable(int);
+void freeHashTable(struct hash_table*);
+void* getHashTableEntry(struct hash_table*, char*);
+void putHashTableEntry(struct hash_table*, char*, void*);
+void* getHashTableNumberEntry(struct hash_table*, int);
+void putHashTableNumberEntry(struct hash_table*, int, void*);
+
+#endif /* HASHTABLE_H_ */
@@ -149,6 +149,24 @@ void callNativeFunction(struct value_defn * value, unsigned char fnIdentifier, i
         value->type=INT_TYPE;
         value->dtype=SCALAR;
 			cpy(value->data, &dimSize, sizeof(int));
+    } else if (fnIdentifier==NATIVE_FN_RTL_SIZE) {
+        // The total number of elements is the product of the dimension sizes held in the array header
+        int totalSize=0, dimSize, i;
+        if (parameters[0].dtype == ARRAY) {
+            char * ptr;
+            cpy(&ptr, parameters[0].data, sizeof(char*));
+            unsigned char num_dims;
+            cpy(&num_dims, ptr, sizeof(unsigned char));
+            num_dims=num_dims & 0xF;
+            if (num_dims > 0) totalSize=1;
+            for (i=0;i<num_dims;i++) {
+                cpy(&dimSize, &ptr[(i * sizeof(int)) + sizeof(unsigned char)], sizeof(int));
+                totalSize*=dimSize;
+            }
+        }
+        value->type=INT_TYPE;
+        value->dtype=SCALAR;
+			cpy(value->data, &totalSize, sizeof(int));
     } else if (fnIdentifier==NATIVE_FN_RTL_INPUT) {
         *value=getInputFromUser(threadId);
     } else if (fnIdentifier==NATIVE_FN_RTL_INPUTPRINT) {
@@ -0,0 +1,1064 @@
+/*
+ * Copyright (c) 2016, Nick Brown
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * The IR which the parser builds for a program, this is a tree of statements and typed expressions that refer to variables
+ * and functions by name. It is not a control flow graph, the two dataflow optimisations here (constant propagation and dead
+ * store elimination) only look along runs of straight line statements. Operators of numeric literals are folded here too, as
+ * the IR is built and again as constants are propagated, and the other optimisations still work on the byte code. The top level
+ * statements are optimised and lowered to byte code by the byte assembler in batches as they are parsed, so the IR of only one
+ * batch is held at a time
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "ir.h"
+#include "memorymanager.h"
+#include "basictokens.h"
+#include "hashtable.h"
+#include "arena.h"
+#include "stack.h"
+#include "misc.h"
+
+extern char * parsing_filename;
+
+#define INITIAL_IR_LIST_SIZE 4
+// Number of top level statements which are parsed before these are optimised and lowered as a batch
+#define IR_LOWERING_BATCH_SIZE 1024
+// Largest integer power which is folded, the interpreter raises to a power by repeated multiplication
+#define MAX_FOLDED_POWER 64
+
+/*
+ * State of the dataflow optimisations over a straight line run of statements. The constant, if any, that each variable holds
+ * and the store to each variable which has not yet been read are tracked by name. Variables whose storage might be shared with
+ * others, as they have been aliased or had their reference or symbol taken, are never tracked
+ */
+struct ir_dataflow_state {
+	struct hash_table * constants, * pendingStores, * aliasedNames;
+};
+
+static int numberPropagatedConstants=0;
+static int numberRemovedStores=0;
+// The IR is allocated from an arena of its own, which is released once each batch of top level statements has been lowered
+static struct memory_arena * irArena=NULL;
+// Byte code of the batches lowered so far, and the names of variables that might share storage in these
+static struct stack_t * loweredBatches=NULL;
+static struct hash_table * aliasedNames=NULL;
+// Whether the whole program has been parsed, until it is a function might have a variable that it uses aliased afterwards
+static int programParsed=0;
+// Names of the variables that the top level statements of the batch being optimised refer to, these might be global
+static struct hash_table * topLevelNames=NULL;
+// Each top level statement is lowered in a scratch arena of its own, which is reset once its byte code has been copied out
+static struct memory_arena * statementArena=NULL;
+
+static void* allocateIr(size_t);
+static void* reallocateIr(void*, size_t, size_t);
+static void optimiseAndLowerIrBatch(struct ir_list*);
+static struct memorycontainer* lowerIrBatchStatements(struct ir_list*);
+static struct ir_node* createIrNode(unsigned char);
+static unsigned char getIrOperatorType(unsigned char, struct ir_node*, struct ir_node*);
+static void foldIrOperator(struct ir_node*);
+static void setIrFoldedValue(struct ir_node*, unsigned char, int, float);
+static void collectIrAliasedNames(struct ir_node*, struct hash_table*, int);
+static void collectIrTopLevelNames(struct ir_node*);
+static void collectIrUntrackedNames(struct ir_node*, struct hash_table*, struct hash_table*);
+static void optimiseIrStatements(struct ir_list*, struct hash_table*);
+static void optimiseIrBody(struct ir_node**, struct hash_table*);
+static void optimiseIrAssignment(struct ir_dataflow_state*, struct ir_node**);
+static void propagateIrConstants(struct ir_dataflow_state*, struct ir_node**, int);
+static void propagateIrListConstants(struct ir_dataflow_state*, struct ir_list*);
+static void recordIrReads(struct ir_dataflow_state*, struct ir_node*);
+static void recordIrRead(struct ir_dataflow_state*, char*);
+static void resetIrDataflowState(struct ir_dataflow_state*);
+static int containsIrBarrier(struct ir_node*);
+static int isIrBarrierNative(char*);
+static int isIrConstant(struct ir_node*);
+static int isIrLiteral(struct ir_node*);
+static struct memorycontainer* lowerIrStatements(struct ir_list*);
+static struct memorycontainer* lowerIrNode(struct ir_node*);
+static struct memorycontainer* lowerIrOperator(unsigned char, struct memorycontainer*, struct memorycontainer*);
+static struct memorycontainer* lowerIrFunction(struct ir_node*);
+static struct stack_t* lowerIrArguments(struct ir_list*);
+
+/**
+ * Creates an empty list of IR nodes
+ */
+struct ir_list* createIrList(void) {
+	struct ir_list * list=(struct ir_list*) allocateIr(sizeof(struct ir_list));
+	list->number=0;
+	list->capacity=INITIAL_IR_LIST_SIZE;
+	list->nodes=(struct ir_node**) allocateIr(sizeof(struct ir_node*) * list->capacity);
+	return list;
+}
+
+/**
+ * Appends a node onto the end of a list, doubling the capacity of the list if it is full
+ */
+void appendIrNode(struct ir_list* list, struct ir_node* node) {
+	if (node == NULL) return;
+	if (list->number == list->capacity) {
+		list->nodes=(struct ir_node**) reallocateIr(list->nodes, sizeof(struct ir_node*) * list->capacity,
+				sizeof(struct ir_node*) * list->capacity * 2);
+		list->capacity*=2;
+	}
+	list->nodes[list->number++]=node;
+}
+
+/**
+ * Appends the statements of a line, which might be NULL, onto a list. A line is either a single statement or, where there are
+ * many, a block which is not a scope
+ */
+void appendIrStatements(struct ir_list* list, struct ir_node* statements) {
+	int i;
+	if (statements == NULL) return;
+	if (statements->kind == IR_BLOCK && !statements->operator) {
+		for (i=0;i<statements->arguments->number;i++) appendIrNode(list, statements->arguments->nodes[i]);
+	} else {
+		appendIrNode(list, statements);
+	}
+}
+
+/**
+ * Inserts a statement before the others on its line, these are turned into a block (that is not a scope) if they are a single
+ * statement
+ */
+struct ir_node* prependIrStatement(struct ir_node* statements, struct ir_node* statement) {
+	struct ir_list * list;
+	if (statements->kind != IR_BLOCK || statements->operator) {
+		list=createIrList();
+		appendIrNode(list, statements);
+		statements=createIrBlock(list, 0);
+	}
+	list=statements->arguments;
+	appendIrNode(list, statement);
+	memmove(&list->nodes[1], list->nodes, sizeof(struct ir_node*) * (list->number - 1));
+	list->nodes[0]=statement;
+	return statements;
+}
+
+/**
+ * Creates a block of statements, a block which is a scope has the variables declared in it removed at its end
+ */
+struct ir_node* createIrBlock(struct ir_list* statements, int isScope) {
+	struct ir_node * node=createIrNode(IR_BLOCK);
+	node->arguments=statements != NULL ? statements : createIrList();
+	node->operator=(unsigned char) isScope;
+	return node;
+}
+
+struct ir_node* createIrInteger(int value) {
+	struct ir_node * node=createIrNode(IR_INTEGER);
+	node->value.integerValue=value;
+	node->valueType=IR_TYPE_INT;
+	return node;
+}
+
+struct ir_node* createIrReal(float value) {
+	struct ir_node * node=createIrNode(IR_REAL);
+	node->value.realValue=value;
+	node->valueType=IR_TYPE_REAL;
+	return node;
+}
+
+struct ir_node* createIrBoolean(int value) {
+	struct ir_node * node=createIrNode(IR_BOOLEAN);
+	node->value.integerValue=value;
+	node->valueType=IR_TYPE_BOOLEAN;
+	return node;
+}
+
+/**
+ * Creates a string literal, the string is copied as the lexer's text (which includes the quotes) is only valid until the
+ * next token is read
+ */
+struct ir_node* createIrString(char * string) {
+	struct ir_node * node=createIrNode(IR_STRING);
+	node->value.name=arenaDuplicateString(string);
+	node->valueType=IR_TYPE_STRING;
+	return node;
+}
+
+struct ir_node* createIrNone(void) {
+	struct ir_node * node=createIrNode(IR_NONE);
+	node->valueType=IR_TYPE_NONE;
+	return node;
+}
+
+/**
+ * Creates an array literal from its elements, or from a single element list which is repeated some number of times
+ */
+struct ir_node* createIrArray(struct ir_list* elements, struct ir_node* repetition) {
+	struct ir_node * node=createIrNode(IR_ARRAY);
+	node->arguments=elements;
+	node->left=repetition;
+	node->valueType=IR_TYPE_ARRAY;
+	return node;
+}
+
+/**
+ * Creates a reference to a variable, which is declared if it does not exist when this is forced (as it is being assigned to)
+ */
+struct ir_node* createIrVariable(char * name, char forceDeclaration) {
+	struct ir_node * node=createIrNode(IR_VARIABLE);
+	node->value.name=name;
+	node->operator=(unsigned char) forceDeclaration;
+	return node;
+}
+
+struct ir_node* createIrArrayAccess(char * name, struct ir_list* indexes) {
+	struct ir_node * node=createIrNode(IR_ARRAY_ACCESS);
+	node->value.name=name;
+	node->arguments=indexes;
+	return node;
+}
+
+/**
+ * Creates an operator expression, the operator being its byte code token (such as ADD_TOKEN)
+ */
+struct ir_node* createIrOperator(unsigned char operator, struct ir_node* left, struct ir_node* right) {
+	struct ir_node * node=createIrNode(IR_OPERATOR);
+	node->operator=operator;
+	node->left=left;
+	node->right=right;
+	node->valueType=getIrOperatorType(operator, left, right);
+	foldIrOperator(node);
+	return node;
+}
+
+/**
+ * Creates a floor division, this is a division whose result is then floored by the maths native function
+ */
+struct ir_node* createIrFloorDiv(struct ir_node* left, struct ir_node* right) {
+	struct ir_list * arguments=createIrList();
+	appendIrNode(arguments, createIrInteger(FLOOR_MATHS_OP));
+	appendIrNode(arguments, createIrOperator(DIV_TOKEN, left, right));
+	return createIrNativeCall(NATIVE_RTL_MATH_STR, arguments, NULL);
+}
+
+struct ir_node* createIrNot(struct ir_node* expression) {
+	struct ir_node * node=createIrNode(IR_NOT);
+	node->left=expression;
+	node->valueType=IR_TYPE_BOOLEAN;
+	return node;
+}
+
+/**
+ * Creates a call of a function, by its name or the name of a variable holding it. These are the call edges between functions
+ */
+struct ir_node* createIrCall(char * name, struct ir_list* arguments) {
+	struct ir_node * node=createIrNode(IR_CALL);
+	node->value.name=name;
+	node->arguments=arguments;
+	return node;
+}
+
+/**
+ * Creates a call of a native function, with either a list of arguments or a single argument (or neither)
+ */
+struct ir_node* createIrNativeCall(char * name, struct ir_list* arguments, struct ir_node* singleArgument) {
+	struct ir_node * node=createIrNode(IR_NATIVE_CALL);
+	node->value.name=name;
+	node->arguments=arguments;
+	node->left=singleArgument;
+	return node;
+}
+
+struct ir_node* createIrReference(char * name) {
+	struct ir_node * node=createIrNode(IR_REFERENCE);
+	node->value.name=name;
+	return node;
+}
+
+struct ir_node* createIrSymbol(char * name) {
+	struct ir_node * node=createIrNode(IR_SYMBOL);
+	node->value.name=name;
+	return node;
+}
+
+/**
+ * Creates an assignment of a value to a variable or array element
+ */
+struct ir_node* createIrLet(struct ir_node* target, struct ir_node* value) {
+	struct ir_node * node=createIrNode(IR_LET);
+	node->left=target;
+	node->right=value;
+	return node;
+}
+
+/**
+ * Creates an assignment with an operator (such as +=), the operator is the position of this in the grammar's list of them
+ */
+struct ir_node* createIrLetWithOperator(struct ir_node* target, struct ir_node* value, unsigned char operator) {
+	struct ir_node * node=createIrNode(IR_LET_WITH_OPERATOR);
+	node->left=target;
+	node->right=value;
+	node->operator=operator;
+	return node;
+}
+
+/**
+ * Creates a conditional, the else body is either a block or the conditional of an elif
+ */
+struct ir_node* createIrIf(struct ir_node* condition, struct ir_node* body, struct ir_node* elseBody) {
+	struct ir_node * node=createIrNode(IR_IF);
+	node->left=condition;
+	node->body=body;
+	node->right=elseBody;
+	return node;
+}
+
+struct ir_node* createIrWhile(struct ir_node* condition, struct ir_node* body) {
+	struct ir_node * node=createIrNode(IR_WHILE);
+	node->left=condition;
+	node->body=body;
+	return node;
+}
+
+/**
+ * Creates a for loop, the loop variable is declared in a scope of its own around the body
+ */
+struct ir_node* createIrFor(char * name, struct ir_node* expression, struct ir_node* body) {
+	struct ir_node * node=createIrNode(IR_FOR);
+	node->value.name=name;
+	node->left=expression;
+	node->body=body;
+	return node;
+}
+
+/**
+ * Creates a function definition, the arguments are a list of its parameters
+ */
+struct ir_node* createIrFunction(char * name, struct ir_list* parameters, struct ir_node* body) {
+	struct ir_node * node=createIrNode(IR_FUNCTION);
+	// The whole program is parsed before it is lowered, so where each function is defined is known by then
+	addFunctionSource(name, parsing_filename);
+	node->value.name=name;
+	node->arguments=parameters;
+	node->body=body;
+	return node;
+}
+
+/**
+ * Creates a parameter of a function, with its default value or NULL if it does not have one
+ */
+struct ir_node* createIrParameter(char * name, struct ir_node* defaultValue) {
+	struct ir_node * node=createIrNode(IR_PARAMETER);
+	node->value.name=name;
+	node->left=defaultValue;
+	return node;
+}
+
+/**
+ * Creates a return from a function, with the expression whose value is returned or NULL if there is none
+ */
+struct ir_node* createIrReturn(struct ir_node* expression) {
+	struct ir_node * node=createIrNode(IR_RETURN);
+	node->left=expression;
+	return node;
+}
+
+struct ir_node* createIrStop(void) {
+	return createIrNode(IR_STOP);
+}
+
+struct ir_node* createIrPass(void) {
+	return createIrNode(IR_PASS);
+}
+
+/**
+ * Creates a decorator, which applies to the next function that is defined
+ */
+struct ir_node* createIrDecorator(char * name) {
+	struct ir_node * node=createIrNode(IR_DECORATOR);
+	node->value.name=name;
+	return node;
+}
+
+struct ir_node* createIrAlias(char * name, struct ir_node* expression) {
+	struct ir_node * node=createIrNode(IR_ALIAS);
+	node->value.name=name;
+	node->left=expression;
+	return node;
+}
+
+/**
+ * Lowers the top level statements parsed so far as a batch once there are enough of these, releasing their IR, and returns the
+ * list which further statements are to be appended to
+ */
+struct ir_list* lowerIrBatch(struct ir_list* statements) {
+	if (statements->number < IR_LOWERING_BATCH_SIZE) return statements;
+	optimiseAndLowerIrBatch(statements);
+	return createIrList();
+}
+
+/**
+ * Lowers the last of the top level statements once the whole program has been parsed, and returns the byte code of the program
+ */
+struct memorycontainer* lowerIr(struct ir_list* statements) {
+	struct memorycontainer* memory;
+	programParsed=1;
+	optimiseAndLowerIrBatch(statements);
+	memory=concatenateMemoryList(loweredBatches);
+	freeHashTable(aliasedNames);
+	loweredBatches=NULL;
+	aliasedNames=NULL;
+	programParsed=0;
+	return memory;
+}
+
+int getNumberPropagatedConstants(void) {
+	return numberPropagatedConstants;
+}
+
+int getNumberRemovedStores(void) {
+	return numberRemovedStores;
+}
+
+/**
+ * Runs the dataflow optimisations over a batch of top level statements and lowers these to byte code. Along each straight line
+ * run of statements constants which are assigned to variables are propagated to where the variables are read, and stores to
+ * variables that are overwritten before they are read are removed, operators are folded as constants are propagated into them. The
+ * byte assembler is called in the same order as the statements were parsed, so that variables are declared, and scopes entered
+ * and left, as they appear in the source code
+ */
+static void optimiseAndLowerIrBatch(struct ir_list* statements) {
+	int parsedLine=line_num, i;
+	if (loweredBatches == NULL) loweredBatches=getNewStack();
+	if (aliasedNames == NULL) aliasedNames=createHashTable(1);
+	for (i=0;i<statements->number;i++) collectIrAliasedNames(statements->nodes[i], aliasedNames, 0);
+	if (!programParsed) {
+		topLevelNames=createHashTable(1);
+		for (i=0;i<statements->number;i++) collectIrTopLevelNames(statements->nodes[i]);
+	}
+	optimiseIrStatements(statements, aliasedNames);
+	if (topLevelNames != NULL) freeHashTable(topLevelNames);
+	topLevelNames=NULL;
+	pushExpression(loweredBatches, lowerIrBatchStatements(statements));
+	line_num=parsedLine;
+	if (irArena != NULL) freeArena(irArena);
+	irArena=NULL;
+	if (statementArena != NULL) freeArena(statementArena);
+	statementArena=NULL;
+}
+
+/**
+ * Lowers a batch of top level statements to byte code. Most of what the byte assembler allocates for a statement, including the
+ * body of a function, is only needed whilst this is assembled. Therefore each statement is lowered in the statement arena and just
+ * its byte code and line definitions are copied out before the arena is reset, the byte assembler allocates what outlives the
+ * statement, such as variables and functions, from the retained arena
+ */
+static struct memorycontainer* lowerIrBatchStatements(struct ir_list* statements) {
+	struct stack_t * lowered=getNewStack();
+	struct memorycontainer * memory;
+	struct memory_arena * previousArena;
+	int i;
+	if (statementArena == NULL) statementArena=createArena();
+	for (i=0;i<statements->number;i++) {
+		if (statements->nodes[i] == NULL) continue;
+		previousArena=enterScratchArena(statementArena);
+		memory=lowerIrNode(statements->nodes[i]);
+		leaveScratchArena(previousArena);
+		if (memory != NULL) pushExpression(lowered, cloneMemoryWithLineDefinitions(memory));
+		resetArena(statementArena);
+	}
+	return concatenateMemoryList(lowered);
+}
+
+/**
+ * Allocates memory for the IR from its arena
+ */
+static void* allocateIr(size_t size) {
+	struct memory_arena * previousArena;
+	void * memory;
+	if (irArena == NULL) irArena=createArena();
+	previousArena=setCurrentArena(irArena);
+	memory=arenaAllocate(size);
+	setCurrentArena(previousArena);
+	return memory;
+}
+
+static void* reallocateIr(void * memory, size_t oldSize, size_t newSize) {
+	struct memory_arena * previousArena=setCurrentArena(irArena);
+	memory=arenaReallocate(memory, oldSize, newSize);
+	setCurrentArena(previousArena);
+	return memory;
+}
+
+
+/**
+ * Creates an IR node of some kind, at the line which is being parsed
+ */
+static struct ir_node* createIrNode(unsigned char kind) {
+	struct ir_node * node=(struct ir_node*) allocateIr(sizeof(struct ir_node));
+	memset(node, 0, sizeof(struct ir_node));
+	node->kind=kind;
+	node->line=line_num;
+	node->valueType=IR_TYPE_ANY;
+	return node;
+}
+
+/**
+ * Determines the type that an operator results in from the types of its operands. Comparisons result in a boolean, arithmetic
+ * on integers in an integer and on numbers one of which is real in a real, and adding to a string concatenates onto it
+ */
+static unsigned char getIrOperatorType(unsigned char operator, struct ir_node* left, struct ir_node* right) {
+	switch (operator) {
+	case EQ_TOKEN: case NEQ_TOKEN: case LT_TOKEN: case GT_TOKEN: case LEQ_TOKEN: case GEQ_TOKEN: case IS_TOKEN:
+		return IR_TYPE_BOOLEAN;
+	case ADD_TOKEN: case SUB_TOKEN: case MUL_TOKEN: case DIV_TOKEN: case MOD_TOKEN: case POW_TOKEN:
+		if (operator == ADD_TOKEN && (left->valueType == IR_TYPE_STRING || right->valueType == IR_TYPE_STRING)) return IR_TYPE_STRING;
+		if (left->valueType == IR_TYPE_INT && right->valueType == IR_TYPE_INT) return IR_TYPE_INT;
+		if ((left->valueType == IR_TYPE_INT || left->valueType == IR_TYPE_REAL) &&
+				(right->valueType == IR_TYPE_INT || right->valueType == IR_TYPE_REAL)) return IR_TYPE_REAL;
+		return IR_TYPE_ANY;
+	default:
+		return IR_TYPE_ANY;
+	}
+}
+
+/**
+ * Folds an operator whose operands are both numeric literals, the node becomes the literal that it results in. This follows the
+ * arithmetic of the interpreter, integers wrap around, a comparison results in a boolean and an integer is converted to a real if
+ * the other operand is real. Division by zero, and integer division which overflows, are left for the interpreter to raise
+ */
+static void foldIrOperator(struct ir_node* node) {
+	struct ir_node * left=node->left, * right=node->right;
+	int i, value1, value2;
+	if ((left->kind != IR_INTEGER && left->kind != IR_REAL) || (right->kind != IR_INTEGER && right->kind != IR_REAL)) return;
+	if (left->kind == IR_INTEGER && right->kind == IR_INTEGER) {
+		unsigned int result=0;
+		value1=left->value.integerValue;
+		value2=right->value.integerValue;
+		switch (node->operator) {
+		case ADD_TOKEN: result=(unsigned int) value1 + (unsigned int) value2; break;
+		case SUB_TOKEN: result=(unsigned int) value1 - (unsigned int) value2; break;
+		case MUL_TOKEN: result=(unsigned int) value1 * (unsigned int) value2; break;
+		case DIV_TOKEN:
+		case MOD_TOKEN:
+			if (value2 == 0 || (value1 == INT_MIN && value2 == -1)) return;
+			result=(unsigned int) (node->operator == DIV_TOKEN ? value1 / value2 : value1 % value2);
+			break;
+		case POW_TOKEN:
+			if (value2 > MAX_FOLDED_POWER) return;
+			result=value2 == 0 ? 1 : (unsigned int) value1;
+			for (i=1;i<value2;i++) result=result * (unsigned int) value1;
+			break;
+		case EQ_TOKEN: setIrFoldedValue(node, IR_BOOLEAN, value1 == value2, 0); return;
+		case NEQ_TOKEN: setIrFoldedValue(node, IR_BOOLEAN, value1 != value2, 0); return;
+		case GT_TOKEN: setIrFoldedValue(node, IR_BOOLEAN, value1 > value2, 0); return;
+		case GEQ_TOKEN: setIrFoldedValue(node, IR_BOOLEAN, value1 >= value2, 0); return;
+		case LT_TOKEN: setIrFoldedValue(node, IR_BOOLEAN, value1 < value2, 0); return;
+		case LEQ_TOKEN: setIrFoldedValue(node, IR_BOOLEAN, value1 <= value2, 0); return;
+		default: return;
+		}
+		setIrFoldedValue(node, IR_INTEGER, (int) result, 0);
+	} else {
+		float real1, real2, result=0;
+		real1=left->kind == IR_INTEGER ? (float) left->value.integerValue : left->value.realValue;
+		real2=right->kind == IR_INTEGER ? (float) right->value.integerValue : right->value.realValue;
+		switch (node->operator) {
+		case ADD_TOKEN: result=real1 + real2; break;
+		case SUB_TOKEN: result=real1 - real2; break;
+		case MUL_TOKEN: result=real1 * real2; break;
+		case DIV_TOKEN: result=real1 / real2; break;
+		case POW_TOKEN:
+			// The interpreter only raises a real to an integer power
+			if (right->kind != IR_INTEGER || right->value.integerValue > MAX_FOLDED_POWER) return;
+			value2=right->value.integerValue;
+			result=value2 == 0 ? 1 : real1;
+			for (i=1;i<value2;i++) result=result * real1;
+			break;
+		case EQ_TOKEN: setIrFoldedValue(node, IR_BOOLEAN, real1 == real2, 0); return;
+		case NEQ_TOKEN: setIrFoldedValue(node, IR_BOOLEAN, real1 != real2, 0); return;
+		case GT_TOKEN: setIrFoldedValue(node, IR_BOOLEAN, real1 > real2, 0); return;
+		case GEQ_TOKEN: setIrFoldedValue(node, IR_BOOLEAN, real1 >= real2, 0); return;
+		case LT_TOKEN: setIrFoldedValue(node, IR_BOOLEAN, real1 < real2, 0); return;
+		case LEQ_TOKEN: setIrFoldedValue(node, IR_BOOLEAN, real1 <= real2, 0); return;
+		default: return;
+		}
+		setIrFoldedValue(node, IR_REAL, 0, result);
+	}
+}
+
+/**
+ * Turns a folded operator into the literal that it results in, which is an integer, real or boolean
+ */
+static void setIrFoldedValue(struct ir_node* node, unsigned char kind, int integerValue, float realValue) {
+	node->kind=kind;
+	node->operator=0;
+	node->left=NULL;
+	node->right=NULL;
+	if (kind == IR_REAL) {
+		node->value.realValue=realValue;
+		node->valueType=IR_TYPE_REAL;
+	} else {
+		node->value.integerValue=integerValue;
+		node->valueType=kind == IR_BOOLEAN ? IR_TYPE_BOOLEAN : IR_TYPE_INT;
+	}
+}
+
+/**
+ * Collects the names of variables whose storage might be shared, these have had their reference or symbol taken or been
+ * aliased, along with the variables read in the expression which something is aliased to
+ */
+static void collectIrAliasedNames(struct ir_node* node, struct hash_table* aliasedNames, int inAlias) {
+	int i;
+	if (node == NULL) return;
+	if (node->kind == IR_REFERENCE || node->kind == IR_SYMBOL || node->kind == IR_ALIAS ||
+			(inAlias && (node->kind == IR_VARIABLE || node->kind == IR_ARRAY_ACCESS))) {
+		putHashTableEntry(aliasedNames, node->value.name, node->value.name);
+	}
+	inAlias=inAlias || node->kind == IR_ALIAS;
+	collectIrAliasedNames(node->left, aliasedNames, inAlias);
+	collectIrAliasedNames(node->right, aliasedNames, inAlias);
+	collectIrAliasedNames(node->body, aliasedNames, inAlias);
+	if (node->arguments != NULL) {
+		for (i=0;i<node->arguments->number;i++) collectIrAliasedNames(node->arguments->nodes[i], aliasedNames, inAlias);
+	}
+}
+
+/**
+ * Collects the names of the variables that a top level statement refers to, outside of the functions that it defines
+ */
+static void collectIrTopLevelNames(struct ir_node* node) {
+	int i;
+	if (node == NULL || node->kind == IR_FUNCTION) return;
+	if (node->kind == IR_VARIABLE || node->kind == IR_ARRAY_ACCESS || node->kind == IR_FOR) {
+		putHashTableEntry(topLevelNames, node->value.name, node->value.name);
+	}
+	collectIrTopLevelNames(node->left);
+	collectIrTopLevelNames(node->right);
+	collectIrTopLevelNames(node->body);
+	if (node->arguments != NULL) {
+		for (i=0;i<node->arguments->number;i++) collectIrTopLevelNames(node->arguments->nodes[i]);
+	}
+}
+
+/**
+ * Collects the names of the variables in a function that are not to be tracked as the program has not yet been parsed. These are
+ * the names which have been aliased so far and those which might be global, as they are already declared or the top level
+ * statements of the batch refer to them, since a global might be aliased later in the program
+ */
+static void collectIrUntrackedNames(struct ir_node* node, struct hash_table* untrackedNames, struct hash_table* aliasedNames) {
+	int i;
+	if (node == NULL) return;
+	if ((node->kind == IR_VARIABLE || node->kind == IR_ARRAY_ACCESS) && (getHashTableEntry(aliasedNames, node->value.name) != NULL ||
+			getHashTableEntry(topLevelNames, node->value.name) != NULL || doesVariableExist(node->value.name))) {
+		putHashTableEntry(untrackedNames, node->value.name, node->value.name);
+	}
+	collectIrUntrackedNames(node->left, untrackedNames, aliasedNames);
+	collectIrUntrackedNames(node->right, untrackedNames, aliasedNames);
+	collectIrUntrackedNames(node->body, untrackedNames, aliasedNames);
+	if (node->arguments != NULL) {
+		for (i=0;i<node->arguments->number;i++) collectIrUntrackedNames(node->arguments->nodes[i], untrackedNames, aliasedNames);
+	}
+}
+
+/**
+ * Optimises a list of statements, these are split into straight line runs at each control flow statement and anything which
+ * might read or change variables that are not named in it (such as a call.) The bodies of control flow statements are optimised
+ * on their own, as they might be run many times or not at all. In batches lowered before the end of the program only the local
+ * variables of a function are tracked in its body, as it might be called after a global variable that it uses has been aliased
+ */
+static void optimiseIrStatements(struct ir_list* statements, struct hash_table* aliasedNames) {
+	struct ir_dataflow_state state;
+	struct hash_table * untrackedNames;
+	struct ir_node * node;
+	int i;
+	state.constants=NULL;
+	state.pendingStores=NULL;
+	state.aliasedNames=aliasedNames;
+	for (i=0;i<statements->number;i++) {
+		node=statements->nodes[i];
+		if (node == NULL) continue;
+		switch (node->kind) {
+		case IR_LET:
+		case IR_LET_WITH_OPERATOR:
+			optimiseIrAssignment(&state, &statements->nodes[i]);
+			break;
+		case IR_IF:
+			// The condition is evaluated before the block ends, whereas a loop's condition is evaluated after its body too
+			if (!containsIrBarrier(node->left)) propagateIrConstants(&state, &node->left, 1);
+			resetIrDataflowState(&state);
+			optimiseIrBody(&node->body, aliasedNames);
+			optimiseIrBody(&node->right, aliasedNames);
+			break;
+		case IR_WHILE:
+		case IR_FOR:
+			resetIrDataflowState(&state);
+			optimiseIrBody(&node->body, aliasedNames);
+			break;
+		case IR_FUNCTION:
+			resetIrDataflowState(&state);
+			if (programParsed) {
+				optimiseIrBody(&node->body, aliasedNames);
+			} else {
+				untrackedNames=createHashTable(1);
+				collectIrUntrackedNames(node->body, untrackedNames, aliasedNames);
+				optimiseIrBody(&node->body, untrackedNames);
+				freeHashTable(untrackedNames);
+			}
+			break;
+		default:
+			if (!containsIrBarrier(node)) {
+				propagateIrConstants(&state, &node->left, 0);
+				propagateIrListConstants(&state, node->arguments);
+			}
+			recordIrReads(&state, node);
+			if (containsIrBarrier(node) || node->kind == IR_RETURN || node->kind == IR_STOP) resetIrDataflowState(&state);
+		}
+	}
+	resetIrDataflowState(&state);
+}
+
+/**
+ * Optimises the body of a control flow statement, which is either a block or (for an elif) another conditional
+ */
+static void optimiseIrBody(struct ir_node** body, struct hash_table* aliasedNames) {
+	if (*body == NULL) return;
+	if ((*body)->kind == IR_BLOCK) {
+		optimiseIrStatements((*body)->arguments, aliasedNames);
+	} else {
+		struct ir_list * statements=createIrList();
+		appendIrNode(statements, *body);
+		optimiseIrStatements(statements, aliasedNames);
+		*body=statements->nodes[0];
+	}
+}
+
+/**
+ * Optimises an assignment, the constants held by variables are propagated into the value and a store of a literal to a
+ * variable is kept as pending, so that it is removed if the variable is assigned to again before being read
+ */
+static void optimiseIrAssignment(struct ir_dataflow_state* state, struct ir_node** statement) {
+	struct ir_node * node=*statement, * target=node->left;
+	struct ir_node ** pendingStore;
+	if (containsIrBarrier(node)) {
+		// Whatever is called might read a pending store or change a variable, this is before the value is stored
+		resetIrDataflowState(state);
+	} else {
+		propagateIrConstants(state, &node->right, 0);
+		if (target->kind == IR_ARRAY_ACCESS) propagateIrListConstants(state, target->arguments);
+	}
+	recordIrReads(state, node->right);
+	if (target->kind == IR_ARRAY_ACCESS || node->kind == IR_LET_WITH_OPERATOR) recordIrReads(state, target);
+	if (target->kind != IR_VARIABLE && target->kind != IR_ARRAY_ACCESS) return;
+	if (getHashTableEntry(state->aliasedNames, target->value.name) != NULL) return;
+	if (state->constants == NULL) state->constants=createHashTable(1);
+	if (state->pendingStores == NULL) state->pendingStores=createHashTable(1);
+	if (node->kind == IR_LET && target->kind == IR_VARIABLE) {
+		pendingStore=(struct ir_node**) getHashTableEntry(state->pendingStores, target->value.name);
+		if (pendingStore != NULL) {
+			*pendingStore=NULL;
+			numberRemovedStores++;
+		}
+		putHashTableEntry(state->constants, target->value.name, isIrConstant(node->right) ? node->right : NULL);
+		putHashTableEntry(state->pendingStores, target->value.name, isIrLiteral(node->right) ? statement : NULL);
+	} else {
+		putHashTableEntry(state->constants, target->value.name, NULL);
+	}
+}
+
+/**
+ * Replaces the variables read by an expression, which are known to hold a constant, with that constant. Where the expression is
+ * a condition (or an operand of a logical operator) an integer is left in its variable, as the interpreter only treats a variable
+ * as true if it holds a boolean whereas a positive integer literal is true. The arguments of calls are left alone too, as these
+ * are passed by reference and so a function might assign to them
+ */
+static void propagateIrConstants(struct ir_dataflow_state* state, struct ir_node** expression, int isCondition) {
+	struct ir_node * node=*expression, * constant;
+	if (node == NULL || state->constants == NULL) return;
+	if (node->kind == IR_VARIABLE) {
+		constant=(struct ir_node*) getHashTableEntry(state->constants, node->value.name);
+		if (constant != NULL && !(isCondition && constant->kind == IR_INTEGER)) {
+			*expression=createIrNode(constant->kind);
+			(*expression)->value=constant->value;
+			(*expression)->valueType=constant->valueType;
+			(*expression)->line=node->line;
+			numberPropagatedConstants++;
+		}
+	} else if (node->kind != IR_CALL) {
+		isCondition=node->kind == IR_NOT || (node->kind == IR_OPERATOR && (node->operator == AND_TOKEN || node->operator == OR_TOKEN));
+		propagateIrConstants(state, &node->left, isCondition);
+		propagateIrConstants(state, &node->right, isCondition);
+		propagateIrListConstants(state, node->arguments);
+		if (node->kind == IR_OPERATOR) foldIrOperator(node);
+	}
+}
+
+static void propagateIrListConstants(struct ir_dataflow_state* state, struct ir_list* expressions) {
+	int i;
+	if (expressions == NULL) return;
+	for (i=0;i<expressions->number;i++) propagateIrConstants(state, &expressions->nodes[i], 0);
+}
+
+/**
+ * Records the variables that an expression or statement reads, so that the pending stores to these are kept
+ */
+static void recordIrReads(struct ir_dataflow_state* state, struct ir_node* node) {
+	int i;
+	if (node == NULL || state->pendingStores == NULL) return;
+	if (node->kind == IR_VARIABLE || node->kind == IR_ARRAY_ACCESS || node->kind == IR_CALL || node->kind == IR_REFERENCE ||
+			node->kind == IR_SYMBOL || node->kind == IR_ALIAS) {
+		recordIrRead(state, node->value.name);
+	}
+	recordIrReads(state, node->left);
+	recordIrReads(state, node->right);
+	if (node->arguments != NULL) {
+		for (i=0;i<node->arguments->number;i++) recordIrReads(state, node->arguments->nodes[i]);
+	}
+}
+
+static void recordIrRead(struct ir_dataflow_state* state, char * name) {
+	if (getHashTableEntry(state->pendingStores, name) != NULL) putHashTableEntry(state->pendingStores, name, NULL);
+}
+
+/**
+ * Forgets everything known at the end of a straight line run, any pending stores are kept as they might be read afterwards
+ */
+static void resetIrDataflowState(struct ir_dataflow_state* state) {
+	if (state->constants != NULL) freeHashTable(state->constants);
+	if (state->pendingStores != NULL) freeHashTable(state->pendingStores);
+	state->constants=NULL;
+	state->pendingStores=NULL;
+}
+
+/**
+ * Determines whether an expression or simple statement ends a straight line run, as it calls a function (which might read or
+ * change any global variable) or a native function that might let another core change memory which a variable refers to
+ */
+static int containsIrBarrier(struct ir_node* node) {
+	int i;
+	if (node == NULL) return 0;
+	if (node->kind == IR_CALL || (node->kind == IR_NATIVE_CALL && isIrBarrierNative(node->value.name))) return 1;
+	if (containsIrBarrier(node->left) || containsIrBarrier(node->right)) return 1;
+	if (node->arguments != NULL) {
+		for (i=0;i<node->arguments->number;i++) {
+			if (containsIrBarrier(node->arguments->nodes[i])) return 1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Determines whether a native function is a barrier, all are apart from those which just compute a value or print
+ */
+static int isIrBarrierNative(char * name) {
+	return strcmp(name, NATIVE_RTL_PRINT_STR) != 0 && strcmp(name, NATIVE_RTL_MATH_STR) != 0 &&
+			strcmp(name, NATIVE_RTL_NUMCORES_STR) != 0 && strcmp(name, NATIVE_RTL_COREID_STR) != 0 &&
+			strcmp(name, NATIVE_RTL_ISHOST_STR) != 0 && strcmp(name, NATIVE_RTL_ISDEVICE_STR) != 0 &&
+			strcmp(name, NATIVE_RTL_NUMDIMS_STR) != 0 && strcmp(name, NATIVE_RTL_DSIZE_STR) != 0 &&
+			strcmp(name, NATIVE_RTL_SIZE_STR) != 0;
+}
+
+/**
+ * Determines whether an expression is a numeric or boolean constant, which can be propagated
+ */
+static int isIrConstant(struct ir_node* node) {
+	return node->kind == IR_INTEGER || node->kind == IR_REAL || node->kind == IR_BOOLEAN;
+}
+
+/**
+ * Determines whether an expression is a literal, storing which has no effect other than setting the variable
+ */
+static int isIrLiteral(struct ir_node* node) {
+	return isIrConstant(node) || node->kind == IR_STRING || node->kind == IR_NONE;
+}
+
+/**
+ * Lowers a list of statements to byte code, each is lowered in turn and they are then concatenated
+ */
+static struct memorycontainer* lowerIrStatements(struct ir_list* statements) {
+	struct stack_t * lowered=getNewStack();
+	int i;
+	for (i=0;i<statements->number;i++) {
+		if (statements->nodes[i] != NULL) pushExpression(lowered, lowerIrNode(statements->nodes[i]));
+	}
+	return concatenateMemoryList(lowered);
+}
+
+/**
+ * Lowers an IR node to byte code. The operands of a node are lowered first, and then the line number is set to where the node
+ * was parsed before the byte assembler is called, as this records the line of calls and reports undeclared variables
+ */
+static struct memorycontainer* lowerIrNode(struct ir_node* node) {
+	struct memorycontainer * left, * right, * body, * elseBody;
+	struct stack_t * arguments;
+	switch (node->kind) {
+	case IR_INTEGER:
+		return createIntegerExpression(node->value.integerValue);
+	case IR_REAL:
+		return createRealExpression(node->value.realValue);
+	case IR_BOOLEAN:
+		return createBooleanExpression(node->value.integerValue);
+	case IR_STRING:
+		// The byte assembler removes the quotes from the string it is given
+		return createStringExpression(arenaDuplicateString(node->value.name));
+	case IR_NONE:
+		return createNoneExpression();
+	case IR_ARRAY:
+		arguments=lowerIrArguments(node->arguments);
+		left=node->left != NULL ? lowerIrNode(node->left) : NULL;
+		return createArrayExpression(arguments, left);
+	case IR_VARIABLE:
+		line_num=node->line;
+		return createIdentifierExpression(node->value.name, (char) node->operator);
+	case IR_ARRAY_ACCESS:
+		arguments=lowerIrArguments(node->arguments);
+		line_num=node->line;
+		return createIdentifierArrayAccessExpression(node->value.name, arguments);
+	case IR_OPERATOR:
+		left=lowerIrNode(node->left);
+		right=lowerIrNode(node->right);
+		return lowerIrOperator(node->operator, left, right);
+	case IR_NOT:
+		return createNotExpression(lowerIrNode(node->left));
+	case IR_CALL:
+		arguments=lowerIrArguments(node->arguments);
+		line_num=node->line;
+		return appendCallFunctionStatement(node->value.name, arguments);
+	case IR_NATIVE_CALL:
+		arguments=lowerIrArguments(node->arguments);
+		left=node->left != NULL ? lowerIrNode(node->left) : NULL;
+		return appendNativeCallFunctionStatement(node->value.name, arguments, left);
+	case IR_REFERENCE:
+		line_num=node->line;
+		return appendReferenceStatement(node->value.name);
+	case IR_SYMBOL:
+		line_num=node->line;
+		return appendSymbolStatement(node->value.name);
+	case IR_LET:
+	case IR_LET_WITH_OPERATOR:
+		left=lowerIrNode(node->left);
+		right=lowerIrNode(node->right);
+		line_num=node->line;
+		if (node->kind == IR_LET) return appendLetStatement(left, right);
+		return appendLetWithOperatorStatement(left, right, node->operator);
+	case IR_IF:
+		left=lowerIrNode(node->left);
+		body=lowerIrNode(node->body);
+		if (node->right == NULL) return appendIfStatement(left, body);
+		elseBody=lowerIrNode(node->right);
+		return appendIfElseStatement(left, body, elseBody);
+	case IR_WHILE:
+		left=lowerIrNode(node->left);
+		body=lowerIrNode(node->body);
+		return appendWhileStatement(left, body);
+	case IR_FOR:
+		enterScope();
+		addVariableIfNeeded(node->value.name);
+		left=lowerIrNode(node->left);
+		body=lowerIrNode(node->body);
+		right=appendForStatement(node->value.name, left, body);
+		leaveScope();
+		return right;
+	case IR_FUNCTION:
+		return lowerIrFunction(node);
+	case IR_RETURN:
+		if (node->left == NULL) return appendReturnStatement();
+		return appendReturnStatementWithExpression(lowerIrNode(node->left));
+	case IR_STOP:
+		return appendStopStatement();
+	case IR_PASS:
+		return appendPassStatement();
+	case IR_DECORATOR:
+		fn_decorator=node->value.name;
+		return NULL;
+	case IR_ALIAS:
+		left=lowerIrNode(node->left);
+		line_num=node->line;
+		return appendAliasStatement(node->value.name, left);
+	case IR_BLOCK:
+		if (node->operator) enterScope();
+		body=lowerIrStatements(node->arguments);
+		if (node->operator) leaveScope();
+		return body;
+	default:
+		return NULL;
+	}
+}
+
+/**
+ * Lowers an operator expression to the byte assembler's function for that operator
+ */
+static struct memorycontainer* lowerIrOperator(unsigned char operator, struct memorycontainer* left, struct memorycontainer* right) {
+	switch (operator) {
+	case OR_TOKEN: return createOrExpression(left, right);
+	case AND_TOKEN: return createAndExpression(left, right);
+	case EQ_TOKEN: return createEqExpression(left, right);
+	case NEQ_TOKEN: return createNeqExpression(left, right);
+	case IS_TOKEN: return createIsExpression(left, right);
+	case GT_TOKEN: return createGtExpression(left, right);
+	case LT_TOKEN: return createLtExpression(left, right);
+	case GEQ_TOKEN: return createGeqExpression(left, right);
+	case LEQ_TOKEN: return createLeqExpression(left, right);
+	case ADD_TOKEN: return createAddExpression(left, right);
+	case SUB_TOKEN: return createSubExpression(left, right);
+	case MUL_TOKEN: return createMulExpression(left, right);
+	case DIV_TOKEN: return createDivExpression(left, right);
+	case MOD_TOKEN: return createModExpression(left, right);
+	default: return createPowExpression(left, right);
+	}
+}
+
+/**
+ * Lowers a function definition, which is added to the memory manager's functions rather than being part of the code it is
+ * defined in. The scope of the function is entered along with its first parameter, after that parameter's default value
+ */
+static struct memorycontainer* lowerIrFunction(struct ir_node* node) {
+	struct stack_t * parameters=getNewStack();
+	struct memorycontainer * defaultValue;
+	int i;
+	enterFunction(node->value.name);
+	if (node->arguments->number == 0) enterScope();
+	for (i=0;i<node->arguments->number;i++) {
+		struct ir_node * parameter=node->arguments->nodes[i];
+		defaultValue=parameter->left != NULL ? lowerIrNode(parameter->left) : NULL;
+		if (i == 0) enterScope();
+		if (defaultValue != NULL) {
+			pushIdentifierAssgnExpression(parameters, parameter->value.name, defaultValue);
+		} else {
+			pushIdentifier(parameters, parameter->value.name);
+		}
+		appendArgument(parameter->value.name);
+	}
+	appendNewFunctionStatement(node->value.name, parameters, lowerIrNode(node->body));
+	leaveScope();
+	return NULL;
+}
+
+/**
+ * Lowers a list of arguments to a stack of their byte code, a NULL list (as opposed to an empty one) is left as NULL
+ */
+static struct stack_t* lowerIrArguments(struct ir_list* arguments) {
+	struct stack_t * lowered;
+	int i;
+	if (arguments == NULL) return NULL;
+	lowered=getNewStack();
+	for (i=0;i<arguments->number;i++) pushExpression(lowered, lowerIrNode(arguments->nodes[i]));
+	return lowered;
+}
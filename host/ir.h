@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2016, Nick Brown
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef IR_H_
+#define IR_H_
+
+#include "byteassembler.h"
+
+// Kinds of IR node, the expressions and then the statements
+#define IR_INTEGER 0
+#define IR_REAL 1
+#define IR_BOOLEAN 2
+#define IR_STRING 3
+#define IR_NONE 4
+#define IR_ARRAY 5
+#define IR_VARIABLE 6
+#define IR_ARRAY_ACCESS 7
+#define IR_OPERATOR 8
+#define IR_NOT 9
+#define IR_CALL 10
+#define IR_NATIVE_CALL 11
+#define IR_REFERENCE 12
+#define IR_SYMBOL 13
+#define IR_LET 14
+#define IR_LET_WITH_OPERATOR 15
+#define IR_IF 16
+#define IR_WHILE 17
+#define IR_FOR 18
+#define IR_FUNCTION 19
+#define IR_PARAMETER 20
+#define IR_RETURN 21
+#define IR_STOP 22
+#define IR_PASS 23
+#define IR_DECORATOR 24
+#define IR_ALIAS 25
+#define IR_BLOCK 26
+
+// Types of the values which IR expressions result in, any if this is not known until the program is run
+#define IR_TYPE_ANY 0
+#define IR_TYPE_INT 1
+#define IR_TYPE_REAL 2
+#define IR_TYPE_BOOLEAN 3
+#define IR_TYPE_STRING 4
+#define IR_TYPE_NONE 5
+#define IR_TYPE_ARRAY 6
+
+// A growable list of IR nodes, such as the statements of a block or the arguments of a call
+struct ir_list {
+	struct ir_node ** nodes;
+	int number, capacity;
+};
+
+/*
+ * A node of the IR that the parser builds, before this is lowered to byte code. The operator is the byte code token of an
+ * operator expression, the operator of an assignment with an operator, whether a variable is forced to be declared or whether
+ * a block is a scope. The value is the name that a node refers to (or the text of a string literal), or the value of a numeric
+ * or boolean literal. This is a tree, blocks are a list of statements and there is no control flow graph
+ */
+struct ir_node {
+	unsigned char kind, operator, valueType;
+	int line;
+	union {
+		char * name;
+		int integerValue;
+		float realValue;
+	} value;
+	struct ir_node * left, * right, * body;
+	struct ir_list * arguments;
+};
+
+struct ir_list* createIrList(void);
+void appendIrNode(struct ir_list*, struct ir_node*);
+void appendIrStatements(struct ir_list*, struct ir_node*);
+struct ir_node* prependIrStatement(struct ir_node*, struct ir_node*);
+struct ir_node* createIrBlock(struct ir_list*, int);
+struct ir_node* createIrInteger(int);
+struct ir_node* createIrReal(float);
+struct ir_node* createIrBoolean(int);
+struct ir_node* createIrString(char*);
+struct ir_node* createIrNone(void);
+struct ir_node* createIrArray(struct ir_list*, struct ir_node*);
+struct ir_node* createIrVariable(char*, char);
+struct ir_node* createIrArrayAccess(char*, struct ir_list*);
+struct ir_node* createIrOperator(unsigned char, struct ir_node*, struct ir_node*);
+struct ir_node* createIrFloorDiv(struct ir_node*, struct ir_node*);
+struct ir_node* createIrNot(struct ir_node*);
+struct ir_node* createIrCall(char*, struct ir_list*);
+struct ir_node* createIrNativeCall(char*, struct ir_list*, struct ir_node*);
+struct ir_node* createIrReference(char*);
+struct ir_node* createIrSymbol(char*);
+struct ir_node* createIrLet(struct ir_node*, struct ir_node*);
+struct ir_node* createIrLetWithOperator(struct ir_node*, struct ir_node*, unsigned char);
+struct ir_node* createIrIf(struct ir_node*, struct ir_node*, struct ir_node*);
+struct ir_node* createIrWhile(struct ir_node*, struct ir_node*);
+struct ir_node* createIrFor(char*, struct ir_node*, struct ir_node*);
+struct ir_node* createIrFunction(char*, struct ir_list*, struct ir_node*);
+struct ir_node* createIrParameter(char*, struct ir_node*);
+struct ir_node* createIrReturn(struct ir_node*);
+struct ir_node* createIrStop(void);
+struct ir_node* createIrPass(void);
+struct ir_node* createIrDecorator(char*);
+struct ir_node* createIrAlias(char*, struct ir_node*);
+struct ir_list* lowerIrBatch(struct ir_list*);
+struct memorycontainer* lowerIr(struct ir_list*);
+int getNumberPropagatedConstants(void);
+int getNumberRemovedStores(void);
+
+#endif /* IR_H_ */
@@ -0,0 +1,821 @@
+/*
+ * Copyright (c) 2016, Nick Brown
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Template JIT for the standalone host interpreter, which compiles hot loops of the byte code to native x86-64 code. Each
+ * statement maps onto a fixed sequence of instructions working directly on the symbol table, so execution can leave the native
+ * code at any statement and carry on in the interpreter. Loops are only compiled if every statement in them is supported, and
+ * the code is specialised for the types of the variables that the loop accesses when it was compiled, which are checked each
+ * time that the loop is entered. Anything else, such as calls to functions or natives, is left to the interpreter
+ */
+
+// Needed for MAP_ANONYMOUS when compiling to the C99 standard
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include "jit.h"
+#include "basictokens.h"
+#if defined(__x86_64__)
+#include <sys/mman.h>
+#endif
+
+// Number of times that a loop goes round before it is compiled, and the number of attempts made at compiling it
+#define JIT_COMPILE_THRESHOLD 16
+#define JIT_MAX_COMPILE_ATTEMPTS 3
+#define JIT_LOOP_TABLE_SIZE 64
+// Registers as encoded in the reg field of the ModRM byte
+#define JIT_EAX 0
+#define JIT_ECX 1
+#define JIT_EDX 2
+
+int jitEnabled=0;
+
+// A variable accessed by a compiled loop, along with the type and dtype that the code was compiled for
+struct jit_variable {
+	unsigned short slot;
+	char type, dtype;
+};
+
+// Compiled code is called with the symbols of its variables and the flag signalling that the interpreter should stop, and
+// returns the point in the byte code at which the interpreter carries on
+typedef unsigned int (*compiled_loop)(struct symbol_node**, volatile char*);
+
+// A loop, identified by the point of its first statement in the byte code, which is either being profiled or has been compiled
+struct jit_loop {
+	unsigned int position;
+	int count, attempts, numberVariables;
+	compiled_loop code;
+	struct jit_variable * variables;
+	struct jit_loop * next;
+};
+
+// A jump in the native code to a statement in the byte code, either to its native code or out to the interpreter
+struct jit_fixup {
+	unsigned int nativePoint, target;
+	char exitToInterpreter;
+};
+
+// State of the compilation of a loop, which covers the byte code from start up to (but not including) end
+struct jit_compilation {
+	char * assembled;
+	unsigned char * code;
+	unsigned int start, end, codeLength, codeCapacity, statementStart;
+	int * nativePoints, numberFixups, fixupCapacity, numberVariables;
+	struct jit_fixup * fixups;
+	struct jit_variable * variables;
+	struct symbol_node * globals, * locals;
+	char failed;
+};
+
+// Loops of each host thread, hashed on their position in the byte code
+static struct jit_loop *** loopTables;
+
+static struct jit_loop* findLoop(int, unsigned int);
+static struct symbol_node* resolveSymbol(struct symbol_node*, struct symbol_node*, unsigned short);
+static int checkLoopVariables(struct jit_loop*, struct symbol_node*, struct symbol_node*, struct symbol_node**);
+#if defined(__x86_64__)
+static void compileLoop(struct jit_loop*, char*, struct symbol_node*, struct symbol_node*);
+static unsigned int compileStatement(struct jit_compilation*, unsigned int);
+static unsigned int compileForRange(struct jit_compilation*, unsigned int);
+static void compileAssignment(struct jit_compilation*, unsigned int*);
+static void compileCondition(struct jit_compilation*, unsigned int*);
+static int compileExpression(struct jit_compilation*, unsigned int*);
+static void compileOperands(struct jit_compilation*, unsigned int*, int*, int*);
+static int compileArithmetic(struct jit_compilation*, unsigned char, int, int);
+static void compileComparison(struct jit_compilation*, unsigned char, int, int);
+static void compileRealOperands(struct jit_compilation*, int, int);
+static void compileArrayElementAccess(struct jit_compilation*, unsigned char, unsigned char, int);
+static int getVariableIndex(struct jit_compilation*, unsigned short, char);
+static unsigned char getOperator(char);
+static void emitBytes(struct jit_compilation*, int, ...);
+static void emitInt(struct jit_compilation*, int);
+static void emitVariableAccess(struct jit_compilation*, unsigned char, unsigned char, int);
+static void emitJumpToStatement(struct jit_compilation*, unsigned int, char);
+static unsigned int emitLocalJump(struct jit_compilation*);
+static void patchLocalJump(struct jit_compilation*, unsigned int);
+static void patchJump(struct jit_compilation*, unsigned int, unsigned int);
+#endif
+
+/**
+ * Enables the JIT for some number of host threads, each of which profiles and compiles its loops separately
+ */
+void initJit(int numberThreads) {
+#if defined(__x86_64__)
+	int i;
+	loopTables=(struct jit_loop***) malloc(sizeof(struct jit_loop**) * numberThreads);
+	for (i=0;i<numberThreads;i++) loopTables[i]=(struct jit_loop**) calloc(JIT_LOOP_TABLE_SIZE, sizeof(struct jit_loop*));
+	jitEnabled=1;
+#else
+	fprintf(stderr, "The JIT is only supported on x86-64, the code will be interpreted\n");
+#endif
+}
+
+/**
+ * Called when a loop goes round, with the position of its first statement. If the loop is hot it is compiled, and if the
+ * compiled code can be run with the variables as they are then it is, returning the point in the byte code at which the
+ * interpreter carries on. Otherwise the position is returned unchanged for the interpreter to run the loop itself
+ */
+unsigned int runCompiledLoop(char * assembled, unsigned int position, struct symbol_node * globals, struct symbol_node * locals,
+		volatile char * stop, int threadId) {
+	struct jit_loop * loop=findLoop(threadId, position);
+	if (loop->code == NULL) {
+		if (loop->attempts >= JIT_MAX_COMPILE_ATTEMPTS || ++loop->count < JIT_COMPILE_THRESHOLD) return position;
+		// The variables might not have their final types yet, in which case this is attempted again once it has gone round more
+		loop->count=0;
+		loop->attempts++;
+#if defined(__x86_64__)
+		compileLoop(loop, assembled, globals, locals);
+#endif
+		if (loop->code == NULL) return position;
+	}
+	struct symbol_node * symbols[loop->numberVariables + 1];
+	if (!checkLoopVariables(loop, globals, locals, symbols)) return position;
+	return loop->code(symbols, stop);
+}
+
+/**
+ * Finds the loop at some position for a thread, creating it if this is the first time that it has gone round
+ */
+static struct jit_loop* findLoop(int threadId, unsigned int position) {
+	struct jit_loop ** bucket=&loopTables[threadId][position % JIT_LOOP_TABLE_SIZE], * loop;
+	for (loop=*bucket;loop != NULL;loop=loop->next) {
+		if (loop->position == position) return loop;
+	}
+	loop=(struct jit_loop*) malloc(sizeof(struct jit_loop));
+	loop->position=position;
+	loop->count=loop->attempts=loop->numberVariables=0;
+	loop->code=NULL;
+	loop->variables=NULL;
+	loop->next=*bucket;
+	*bucket=loop;
+	return loop;
+}
+
+/**
+ * Resolves the symbol of a variable slot, following aliases in the same way as the interpreter
+ */
+static struct symbol_node* resolveSymbol(struct symbol_node * globals, struct symbol_node * locals, unsigned short slot) {
+	struct symbol_node * symbol=slot & LOCAL_VARIABLE_FLAG ? &locals[slot & ~LOCAL_VARIABLE_FLAG] : &globals[slot];
+	if (symbol->state != UNALLOCATED) {
+		while (symbol->state == ALIAS) symbol=&globals[symbol->alias];
+	}
+	return symbol;
+}
+
+/**
+ * Checks that the variables of a compiled loop have the types and dtypes that the code was compiled for (and that arrays are one
+ * dimensional), filling in their symbols if so. Variables not yet allocated are allocated as an integer zero, as when the
+ * interpreter first reads them
+ */
+static int checkLoopVariables(struct jit_loop * loop, struct symbol_node * globals, struct symbol_node * locals,
+		struct symbol_node ** symbols) {
+	int i;
+	char * arrayMemory;
+	for (i=0;i<loop->numberVariables;i++) {
+		symbols[i]=resolveSymbol(globals, locals, loop->variables[i].slot);
+		if (symbols[i]->state == UNALLOCATED) {
+			if (loop->variables[i].type != INT_TYPE || loop->variables[i].dtype != SCALAR) return 0;
+		} else {
+			if (symbols[i]->value.type != loop->variables[i].type || symbols[i]->value.dtype != loop->variables[i].dtype) return 0;
+			if (loop->variables[i].dtype == ARRAY) {
+				memcpy(&arrayMemory, symbols[i]->value.data, sizeof(char*));
+				if ((arrayMemory[0] & 0xF) != 1) return 0;
+			}
+		}
+	}
+	for (i=0;i<loop->numberVariables;i++) {
+		if (symbols[i]->state == UNALLOCATED) {
+			symbols[i]->state=ALLOCATED;
+			symbols[i]->value.type=INT_TYPE;
+			symbols[i]->value.dtype=SCALAR;
+			memset(symbols[i]->value.data, 0, sizeof(symbols[i]->value.data));
+		}
+	}
+	return 1;
+}
+
+#if defined(__x86_64__)
+/**
+ * Compiles a loop, which starts with a conditional (a while loop) or a counted loop and finishes with the jump back to this. On
+ * success the code is placed in executable memory, otherwise the loop is left without code
+ */
+static void compileLoop(struct jit_loop * loop, char * assembled, struct symbol_node * globals, struct symbol_node * locals) {
+	struct jit_compilation comp;
+	unsigned int position=loop->position, blockPoint;
+	unsigned short blockLength, target;
+	int i;
+	unsigned char token=((unsigned char*) assembled)[position];
+	memset(&comp, 0, sizeof(struct jit_compilation));
+	comp.assembled=assembled;
+	comp.globals=globals;
+	comp.locals=locals;
+	comp.start=position;
+	if (token == FOR_RANGE_TOKEN) {
+		blockPoint=position+sizeof(unsigned char)+sizeof(unsigned short)*4;
+	} else if (token == IF_TOKEN || token == IF_COMPARE_TOKEN) {
+		blockPoint=position+sizeof(unsigned char);
+		if (token == IF_COMPARE_TOKEN) {
+			blockPoint+=sizeof(unsigned char);
+			compileExpression(&comp, &blockPoint);
+			compileExpression(&comp, &blockPoint);
+		} else {
+			compileCondition(&comp, &blockPoint);
+		}
+	} else {
+		comp.failed=1;
+	}
+	if (comp.failed) {
+		// Not a loop that can be compiled, whatever the types of its variables
+		loop->attempts=JIT_MAX_COMPILE_ATTEMPTS;
+		free(comp.code);
+		free(comp.fixups);
+		free(comp.variables);
+		return;
+	}
+	memcpy(&blockLength, &assembled[blockPoint], sizeof(unsigned short));
+	comp.end=blockPoint+sizeof(unsigned short)+blockLength+(token == FOR_RANGE_TOKEN ? sizeof(unsigned char)+sizeof(unsigned short) : 0);
+	memcpy(&target, &assembled[comp.end-sizeof(unsigned short)], sizeof(unsigned short));
+	if (((unsigned char*) assembled)[comp.end-sizeof(unsigned short)-sizeof(unsigned char)] != GOTO_TOKEN || target != position) {
+		loop->attempts=JIT_MAX_COMPILE_ATTEMPTS;
+		free(comp.code);
+		free(comp.fixups);
+		free(comp.variables);
+		return;
+	}
+	// The condition was compiled to find the end of the loop, this is discarded and the loop compiled from the start
+	comp.codeLength=comp.numberFixups=comp.numberVariables=0;
+	comp.nativePoints=(int*) malloc(sizeof(int) * (comp.end - comp.start));
+	for (i=0;i<(int) (comp.end - comp.start);i++) comp.nativePoints[i]=-1;
+	// mov r10, rsp as expressions push their intermediate values, which are discarded when leaving part way through one
+	emitBytes(&comp, 3, 0x49, 0x89, 0xE2);
+	while (position < comp.end && !comp.failed) {
+		comp.nativePoints[position - comp.start]=comp.codeLength;
+		position=compileStatement(&comp, position);
+	}
+	for (i=0;i<comp.numberFixups && !comp.failed;i++) {
+		target=comp.fixups[i].target;
+		if (!comp.fixups[i].exitToInterpreter && target >= comp.start && target < comp.end) {
+			if (comp.nativePoints[target - comp.start] < 0) comp.failed=1;
+			if (!comp.failed) patchJump(&comp, comp.fixups[i].nativePoint, comp.nativePoints[target - comp.start]);
+		} else {
+			// Leave the native code, returning the point at which the interpreter carries on: mov rsp, r10 then mov eax, imm32 and ret
+			patchJump(&comp, comp.fixups[i].nativePoint, comp.codeLength);
+			emitBytes(&comp, 4, 0x4C, 0x89, 0xD4, 0xB8);
+			emitInt(&comp, comp.fixups[i].target);
+			emitBytes(&comp, 1, 0xC3);
+		}
+	}
+	if (!comp.failed) {
+		void * executable=mmap(NULL, comp.codeLength, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (executable != MAP_FAILED) {
+			memcpy(executable, comp.code, comp.codeLength);
+			if (mprotect(executable, comp.codeLength, PROT_READ | PROT_EXEC) == 0) {
+				loop->code=(compiled_loop) executable;
+				loop->variables=comp.variables;
+				loop->numberVariables=comp.numberVariables;
+				comp.variables=NULL;
+			} else {
+				munmap(executable, comp.codeLength);
+			}
+		}
+	}
+	free(comp.nativePoints);
+	free(comp.code);
+	free(comp.fixups);
+	free(comp.variables);
+}
+
+/**
+ * Compiles a statement at some position in the byte code, returning the position of the next statement
+ */
+static unsigned int compileStatement(struct jit_compilation * comp, unsigned int position) {
+	unsigned char token=((unsigned char*) comp->assembled)[position];
+	unsigned short blockLength, slot;
+	int constant, k;
+	comp->statementStart=position;
+	position+=sizeof(unsigned char);
+	switch (token) {
+	case LET_TOKEN:
+		compileAssignment(comp, &position);
+		return position;
+	case IF_TOKEN:
+	case IFELSE_TOKEN:
+	case IF_COMPARE_TOKEN:
+		if (token == IF_COMPARE_TOKEN) {
+			unsigned char operator=getOperator(comp->assembled[position]);
+			int type1, type2;
+			position+=sizeof(unsigned char);
+			compileOperands(comp, &position, &type1, &type2);
+			compileComparison(comp, operator, type1, type2);
+		} else {
+			compileCondition(comp, &position);
+		}
+		memcpy(&blockLength, &comp->assembled[position], sizeof(unsigned short));
+		position+=sizeof(unsigned short);
+		// test eax, eax then jz to after the block
+		emitBytes(comp, 4, 0x85, 0xC0, 0x0F, 0x84);
+		emitJumpToStatement(comp, position+blockLength, 0);
+		return position;
+	case GOTO_TOKEN:
+		memcpy(&slot, &comp->assembled[position], sizeof(unsigned short));
+		if (slot <= comp->statementStart) {
+			// Going round a loop, leave the native code if the interpreter has been told to stop: cmp byte [rsi], 0 then jne
+			emitBytes(comp, 5, 0x80, 0x3E, 0x00, 0x0F, 0x85);
+			emitJumpToStatement(comp, slot, 1);
+		}
+		emitBytes(comp, 1, 0xE9);
+		emitJumpToStatement(comp, slot, 0);
+		return position+sizeof(unsigned short);
+	case INCREMENT_TOKEN:
+		memcpy(&slot, &comp->assembled[position], sizeof(unsigned short));
+		memcpy(&constant, &comp->assembled[position+sizeof(unsigned short)+sizeof(unsigned char)], sizeof(int));
+		k=getVariableIndex(comp, slot, SCALAR);
+		if (k < 0 || comp->variables[k].type != INT_TYPE) {
+			comp->failed=1;
+			return position;
+		}
+		// add or sub dword [r8+data], imm32
+		emitVariableAccess(comp, 0x81, comp->assembled[position+sizeof(unsigned short)] == ADD_TOKEN ? 0 : 5, k);
+		emitInt(comp, constant);
+		return position+sizeof(unsigned short)+sizeof(unsigned char)+sizeof(int);
+	case LET_FROM_ARRAY_TOKEN: {
+		unsigned short arraySlot;
+		memcpy(&slot, &comp->assembled[position], sizeof(unsigned short));
+		memcpy(&arraySlot, &comp->assembled[position+sizeof(unsigned short)], sizeof(unsigned short));
+		position+=sizeof(unsigned short)*2;
+		if (compileExpression(comp, &position) != INT_TYPE) comp->failed=1;
+		int arrayIndex=getVariableIndex(comp, arraySlot, ARRAY);
+		k=getVariableIndex(comp, slot, SCALAR);
+		if (comp->failed || arrayIndex < 0 || k < 0 || comp->variables[k].type != comp->variables[arrayIndex].type) {
+			comp->failed=1;
+			return position;
+		}
+		compileArrayElementAccess(comp, 0x8B, JIT_EAX, arrayIndex);
+		emitVariableAccess(comp, 0x89, JIT_EAX, k);
+		return position;
+	}
+	case LET_TO_ARRAY_TOKEN: {
+		int type;
+		memcpy(&slot, &comp->assembled[position], sizeof(unsigned short));
+		position+=sizeof(unsigned short);
+		if (compileExpression(comp, &position) != INT_TYPE) comp->failed=1;
+		// push rax then the value is moved into ecx and the index popped back into eax
+		emitBytes(comp, 1, 0x50);
+		type=compileExpression(comp, &position);
+		emitBytes(comp, 3, 0x89, 0xC1, 0x58);
+		k=getVariableIndex(comp, slot, ARRAY);
+		if (comp->failed || k < 0 || comp->variables[k].type != type) {
+			comp->failed=1;
+			return position;
+		}
+		compileArrayElementAccess(comp, 0x89, JIT_ECX, k);
+		return position;
+	}
+	case FOR_RANGE_TOKEN:
+		return compileForRange(comp, position);
+	default:
+		comp->failed=1;
+		return position;
+	}
+}
+
+/**
+ * Compiles a counted loop iteration, where the current, stop and step values are integers. If the current value has not
+ * passed the stop value in the direction of the step then it is assigned to the loop variable and advanced by the step,
+ * otherwise this jumps to after the loop
+ */
+static unsigned int compileForRange(struct jit_compilation * comp, unsigned int position) {
+	unsigned short slots[4], blockLength;
+	int i, k[4];
+	memcpy(slots, &comp->assembled[position], sizeof(unsigned short)*4);
+	memcpy(&blockLength, &comp->assembled[position+sizeof(unsigned short)*4], sizeof(unsigned short));
+	position+=sizeof(unsigned short)*5;
+	unsigned int exitPoint=position+blockLength+sizeof(unsigned char)+sizeof(unsigned short);
+	for (i=0;i<4;i++) {
+		k[i]=getVariableIndex(comp, slots[i], SCALAR);
+		if (k[i] < 0 || comp->variables[k[i]].type != INT_TYPE) {
+			comp->failed=1;
+			return position;
+		}
+	}
+	emitVariableAccess(comp, 0x8B, JIT_EAX, k[0]);
+	emitVariableAccess(comp, 0x8B, JIT_ECX, k[2]);
+	emitVariableAccess(comp, 0x8B, JIT_EDX, k[3]);
+	// test edx, edx then jle to the negative step test
+	emitBytes(comp, 4, 0x85, 0xD2, 0x0F, 0x8E);
+	unsigned int negativeStep=emitLocalJump(comp);
+	// cmp eax, ecx then jg out of the loop, otherwise jmp to the body
+	emitBytes(comp, 4, 0x39, 0xC8, 0x0F, 0x8F);
+	emitJumpToStatement(comp, exitPoint, 0);
+	emitBytes(comp, 1, 0xE9);
+	unsigned int body=emitLocalJump(comp);
+	patchLocalJump(comp, negativeStep);
+	// jz out of the loop for a zero step (the flags are still from the test), then cmp eax, ecx and jl out of the loop
+	emitBytes(comp, 2, 0x0F, 0x84);
+	emitJumpToStatement(comp, exitPoint, 0);
+	emitBytes(comp, 4, 0x39, 0xC8, 0x0F, 0x8C);
+	emitJumpToStatement(comp, exitPoint, 0);
+	patchLocalJump(comp, body);
+	emitVariableAccess(comp, 0x89, JIT_EAX, k[1]);
+	// add eax, edx
+	emitBytes(comp, 2, 0x01, 0xD0);
+	emitVariableAccess(comp, 0x89, JIT_EAX, k[0]);
+	return position;
+}
+
+/**
+ * Compiles an assignment to a variable or to an element of a one dimensional array, the value must be of the same type as the
+ * variable (or array) so that the types that the loop was compiled for are kept
+ */
+static void compileAssignment(struct jit_compilation * comp, unsigned int * position) {
+	unsigned char identifierType=((unsigned char*) comp->assembled)[*position];
+	unsigned short slot;
+	int k, type;
+	memcpy(&slot, &comp->assembled[*position+sizeof(unsigned char)], sizeof(unsigned short));
+	*position+=sizeof(unsigned char)+sizeof(unsigned short);
+	if (identifierType == ARRAYACCESS_TOKEN) {
+		if (comp->assembled[*position] != 1) {
+			comp->failed=1;
+			return;
+		}
+		*position+=sizeof(unsigned char);
+		if (compileExpression(comp, position) != INT_TYPE) comp->failed=1;
+		emitBytes(comp, 1, 0x50);
+		type=compileExpression(comp, position);
+		emitBytes(comp, 3, 0x89, 0xC1, 0x58);
+		k=getVariableIndex(comp, slot, ARRAY);
+		if (comp->failed || k < 0 || comp->variables[k].type != type) {
+			comp->failed=1;
+			return;
+		}
+		compileArrayElementAccess(comp, 0x89, JIT_ECX, k);
+	} else {
+		type=compileExpression(comp, position);
+		k=getVariableIndex(comp, slot, SCALAR);
+		if (comp->failed || k < 0 || comp->variables[k].type != type) {
+			comp->failed=1;
+			return;
+		}
+		emitVariableAccess(comp, 0x89, JIT_EAX, k);
+	}
+}
+
+/**
+ * Compiles a condition, leaving one in eax if it holds and zero otherwise
+ */
+static void compileCondition(struct jit_compilation * comp, unsigned int * position) {
+	unsigned char operator=getOperator(comp->assembled[*position]), operandOperator;
+	int type1, type2;
+	*position+=sizeof(unsigned char);
+	switch (operator) {
+	case EQ_TOKEN:
+	case NEQ_TOKEN:
+	case LT_TOKEN:
+	case GT_TOKEN:
+	case LEQ_TOKEN:
+	case GEQ_TOKEN:
+		compileOperands(comp, position, &type1, &type2);
+		compileComparison(comp, operator, type1, type2);
+		return;
+	case AND_TOKEN:
+	case OR_TOKEN: {
+		// The second condition is skipped if the first determines the result: test eax, eax then jz for and or jnz for or
+		*position+=sizeof(unsigned short);
+		compileCondition(comp, position);
+		emitBytes(comp, 4, 0x85, 0xC0, 0x0F, operator == AND_TOKEN ? 0x84 : 0x85);
+		unsigned int shortCircuit=emitLocalJump(comp);
+		compileCondition(comp, position);
+		patchLocalJump(comp, shortCircuit);
+		return;
+	}
+	case NOT_TOKEN:
+		// The operand holds if its integer value is greater than zero: test eax, eax then setle al and movzx eax, al
+		operandOperator=getOperator(comp->assembled[*position]);
+		if ((operandOperator >= OR_TOKEN && operandOperator <= GEQ_TOKEN) || operandOperator == NOT_TOKEN ||
+				operandOperator == BOOLEAN_TOKEN) {
+			compileCondition(comp, position);
+		} else {
+			compileExpression(comp, position);
+		}
+		emitBytes(comp, 8, 0x85, 0xC0, 0x0F, 0x9E, 0xC0, 0x0F, 0xB6, 0xC0);
+		return;
+	case BOOLEAN_TOKEN: {
+		int value;
+		memcpy(&value, &comp->assembled[*position], sizeof(int));
+		*position+=sizeof(int);
+		emitBytes(comp, 1, 0xB8);
+		emitInt(comp, value > 0);
+		return;
+	}
+	default:
+		comp->failed=1;
+		return;
+	}
+}
+
+/**
+ * Compiles an integer or real expression, leaving its value in eax (reals as their bit pattern) and returning its type
+ */
+static int compileExpression(struct jit_compilation * comp, unsigned int * position) {
+	unsigned char operator=getOperator(comp->assembled[*position]);
+	unsigned short slot;
+	int value, k, type1, type2;
+	*position+=sizeof(unsigned char);
+	switch (operator) {
+	case INTEGER_TOKEN:
+	case REAL_TOKEN:
+		// mov eax, imm32
+		memcpy(&value, &comp->assembled[*position], sizeof(int));
+		*position+=sizeof(int);
+		emitBytes(comp, 1, 0xB8);
+		emitInt(comp, value);
+		return operator == INTEGER_TOKEN ? INT_TYPE : REAL_TYPE;
+	case IDENTIFIER_TOKEN:
+		memcpy(&slot, &comp->assembled[*position], sizeof(unsigned short));
+		*position+=sizeof(unsigned short);
+		k=getVariableIndex(comp, slot, SCALAR);
+		if (k < 0) return -1;
+		emitVariableAccess(comp, 0x8B, JIT_EAX, k);
+		return comp->variables[k].type;
+	case ARRAYACCESS_TOKEN:
+		memcpy(&slot, &comp->assembled[*position], sizeof(unsigned short));
+		*position+=sizeof(unsigned short);
+		if (comp->assembled[*position] != 1) {
+			comp->failed=1;
+			return -1;
+		}
+		*position+=sizeof(unsigned char);
+		if (compileExpression(comp, position) != INT_TYPE) comp->failed=1;
+		k=getVariableIndex(comp, slot, ARRAY);
+		if (comp->failed || k < 0) {
+			comp->failed=1;
+			return -1;
+		}
+		compileArrayElementAccess(comp, 0x8B, JIT_EAX, k);
+		return comp->variables[k].type;
+	case ADD_TOKEN:
+	case SUB_TOKEN:
+	case MUL_TOKEN:
+	case DIV_TOKEN:
+	case MOD_TOKEN:
+		compileOperands(comp, position, &type1, &type2);
+		return compileArithmetic(comp, operator, type1, type2);
+	default:
+		comp->failed=1;
+		return -1;
+	}
+}
+
+/**
+ * Compiles the two operands of an operator, leaving the first in eax and the second in ecx
+ */
+static void compileOperands(struct jit_compilation * comp, unsigned int * position, int * type1, int * type2) {
+	*type1=compileExpression(comp, position);
+	// push rax
+	emitBytes(comp, 1, 0x50);
+	*type2=compileExpression(comp, position);
+	// mov ecx, eax then pop rax
+	emitBytes(comp, 3, 0x89, 0xC1, 0x58);
+	if (*type1 < 0 || *type2 < 0) comp->failed=1;
+}
+
+/**
+ * Compiles an arithmetic operator on eax and ecx, leaving the result in eax and returning its type. If either operand is a real
+ * then so is the result, with the integer raised to a real, in the same way as the interpreter
+ */
+static int compileArithmetic(struct jit_compilation * comp, unsigned char operator, int type1, int type2) {
+	if (type1 == INT_TYPE && type2 == INT_TYPE) {
+		switch (operator) {
+		case ADD_TOKEN: emitBytes(comp, 2, 0x01, 0xC8); break;
+		case SUB_TOKEN: emitBytes(comp, 2, 0x29, 0xC8); break;
+		case MUL_TOKEN: emitBytes(comp, 3, 0x0F, 0xAF, 0xC1); break;
+		// cdq then idiv ecx, with the remainder moved from edx for modulo
+		case DIV_TOKEN: emitBytes(comp, 3, 0x99, 0xF7, 0xF9); break;
+		default: emitBytes(comp, 5, 0x99, 0xF7, 0xF9, 0x89, 0xD0); break;
+		}
+		return INT_TYPE;
+	}
+	if (operator == MOD_TOKEN) {
+		comp->failed=1;
+		return -1;
+	}
+	compileRealOperands(comp, type1, type2);
+	// addss, subss, mulss or divss xmm0, xmm1 then movd eax, xmm0
+	emitBytes(comp, 4, 0xF3, 0x0F, operator == ADD_TOKEN ? 0x58 : operator == SUB_TOKEN ? 0x5C : operator == MUL_TOKEN ? 0x59 : 0x5E, 0xC1);
+	emitBytes(comp, 4, 0x66, 0x0F, 0x7E, 0xC0);
+	return REAL_TYPE;
+}
+
+/**
+ * Compiles a comparison of eax and ecx, leaving one in eax if it holds and zero otherwise. Reals are compared unordered so
+ * that, as in C, only not equal holds when either is not a number
+ */
+static void compileComparison(struct jit_compilation * comp, unsigned char operator, int type1, int type2) {
+	static const unsigned char integerConditions[]={0x94, 0x95, 0x9C, 0x9F, 0x9E, 0x9D};
+	if (comp->failed) return;
+	if (type1 == INT_TYPE && type2 == INT_TYPE) {
+		// cmp eax, ecx then setcc al
+		emitBytes(comp, 5, 0x39, 0xC8, 0x0F, integerConditions[operator-EQ_TOKEN], 0xC0);
+	} else {
+		compileRealOperands(comp, type1, type2);
+		switch (operator) {
+		// ucomiss xmm0, xmm1 then sete al, setnp cl and and al, cl
+		case EQ_TOKEN: emitBytes(comp, 11, 0x0F, 0x2E, 0xC1, 0x0F, 0x94, 0xC0, 0x0F, 0x9B, 0xC1, 0x20, 0xC8); break;
+		// ucomiss xmm0, xmm1 then setne al, setp cl and or al, cl
+		case NEQ_TOKEN: emitBytes(comp, 11, 0x0F, 0x2E, 0xC1, 0x0F, 0x95, 0xC0, 0x0F, 0x9A, 0xC1, 0x08, 0xC8); break;
+		// Less than is greater than with the operands swapped: ucomiss xmm1, xmm0 then seta al or setae al
+		case LT_TOKEN: emitBytes(comp, 6, 0x0F, 0x2E, 0xC8, 0x0F, 0x97, 0xC0); break;
+		case LEQ_TOKEN: emitBytes(comp, 6, 0x0F, 0x2E, 0xC8, 0x0F, 0x93, 0xC0); break;
+		case GT_TOKEN: emitBytes(comp, 6, 0x0F, 0x2E, 0xC1, 0x0F, 0x97, 0xC0); break;
+		default: emitBytes(comp, 6, 0x0F, 0x2E, 0xC1, 0x0F, 0x93, 0xC0); break;
+		}
+	}
+	// movzx eax, al
+	emitBytes(comp, 3, 0x0F, 0xB6, 0xC0);
+}
+
+/**
+ * Moves the operands in eax and ecx into xmm0 and xmm1 as reals, converting integers with cvtsi2ss and moving the bit pattern of
+ * reals with movd
+ */
+static void compileRealOperands(struct jit_compilation * comp, int type1, int type2) {
+	if (type1 == INT_TYPE) {
+		emitBytes(comp, 4, 0xF3, 0x0F, 0x2A, 0xC0);
+	} else {
+		emitBytes(comp, 4, 0x66, 0x0F, 0x6E, 0xC0);
+	}
+	if (type2 == INT_TYPE) {
+		emitBytes(comp, 4, 0xF3, 0x0F, 0x2A, 0xC9);
+	} else {
+		emitBytes(comp, 4, 0x66, 0x0F, 0x6E, 0xC9);
+	}
+}
+
+/**
+ * Loads (opcode 0x8B) or stores (opcode 0x89) a register to the element of a one dimensional array whose index is in eax. An index
+ * outside of the array leaves the native code at the start of the statement, for the interpreter to raise the error or extend the
+ * array
+ */
+static void compileArrayElementAccess(struct jit_compilation * comp, unsigned char opcode, unsigned char reg, int k) {
+	// mov r8, [rdi+8k] then mov r9, [r8+data] for the array memory, whose size follows the number of dimensions
+	emitBytes(comp, 3, 0x4C, 0x8B, 0x87);
+	emitInt(comp, k * (int) sizeof(struct symbol_node*));
+	emitBytes(comp, 3, 0x4D, 0x8B, 0x88);
+	emitInt(comp, (int) (offsetof(struct symbol_node, value) + offsetof(struct value_defn, data)));
+	// cmp eax, [r9+1] then jae, which as an unsigned comparison also catches negative indexes
+	emitBytes(comp, 6, 0x41, 0x3B, 0x41, 0x01, 0x0F, 0x83);
+	emitJumpToStatement(comp, comp->statementStart, 1);
+	// mov to or from [r9+rax*4+5], as the elements follow the number of dimensions and the size
+	emitBytes(comp, 5, 0x41, opcode, 0x44 | (reg << 3), 0x81, 0x05);
+}
+
+/**
+ * Retrieves the index of a variable in the compiled loop's variables, adding it if this is the first time that it is used. The
+ * variable must be an integer or a real of the dtype required, as it currently is in the symbol table
+ */
+static int getVariableIndex(struct jit_compilation * comp, unsigned short slot, char dtype) {
+	int i;
+	for (i=0;i<comp->numberVariables;i++) {
+		if (comp->variables[i].slot == slot) {
+			if (comp->variables[i].dtype != dtype) break;
+			return i;
+		}
+	}
+	if (i < comp->numberVariables) {
+		comp->failed=1;
+		return -1;
+	}
+	struct symbol_node * symbol=resolveSymbol(comp->globals, comp->locals, slot);
+	char type=INT_TYPE, symbolDtype=SCALAR;
+	if (symbol->state != UNALLOCATED) {
+		type=symbol->value.type;
+		symbolDtype=symbol->value.dtype;
+	}
+	if ((type != INT_TYPE && type != REAL_TYPE) || symbolDtype != dtype) {
+		comp->failed=1;
+		return -1;
+	}
+	if (dtype == ARRAY) {
+		char * arrayMemory;
+		memcpy(&arrayMemory, symbol->value.data, sizeof(char*));
+		if ((arrayMemory[0] & 0xF) != 1) {
+			comp->failed=1;
+			return -1;
+		}
+	}
+	comp->variables=(struct jit_variable*) realloc(comp->variables, sizeof(struct jit_variable) * (comp->numberVariables + 1));
+	comp->variables[comp->numberVariables].slot=slot;
+	comp->variables[comp->numberVariables].type=type;
+	comp->variables[comp->numberVariables].dtype=dtype;
+	return comp->numberVariables++;
+}
+
+/**
+ * Retrieves the generic operator of a token, which might have been typed
+ */
+static unsigned char getOperator(char token) {
+	unsigned char operator=(unsigned char) token;
+	if (operator >= INT_TYPED_TOKEN_BASE) return ((operator-INT_TYPED_TOKEN_BASE) & 0xF)+EQ_TOKEN;
+	return operator;
+}
+
+/**
+ * Emits some number of bytes of native code
+ */
+static void emitBytes(struct jit_compilation * comp, int number, ...) {
+	va_list bytes;
+	int i;
+	if (comp->codeLength + number > comp->codeCapacity) {
+		comp->codeCapacity=(comp->codeCapacity + number) * 2;
+		comp->code=(unsigned char*) realloc(comp->code, comp->codeCapacity);
+	}
+	va_start(bytes, number);
+	for (i=0;i<number;i++) comp->code[comp->codeLength++]=(unsigned char) va_arg(bytes, int);
+	va_end(bytes);
+}
+
+/**
+ * Emits a 32 bit immediate or displacement
+ */
+static void emitInt(struct jit_compilation * comp, int value) {
+	unsigned char * bytes=(unsigned char*) &value;
+	emitBytes(comp, 4, bytes[0], bytes[1], bytes[2], bytes[3]);
+}
+
+/**
+ * Emits an instruction on the data of a variable's symbol, the pointer to which is first loaded into r8 with mov r8, [rdi+8k].
+ * The instruction is opcode with reg (a register or opcode extension) and [r8+data] as its operand
+ */
+static void emitVariableAccess(struct jit_compilation * comp, unsigned char opcode, unsigned char reg, int k) {
+	emitBytes(comp, 3, 0x4C, 0x8B, 0x87);
+	emitInt(comp, k * (int) sizeof(struct symbol_node*));
+	emitBytes(comp, 3, 0x41, opcode, 0x80 | (reg << 3));
+	emitInt(comp, (int) (offsetof(struct symbol_node, value) + offsetof(struct value_defn, data)));
+}
+
+/**
+ * Emits the displacement of a jump to a statement, which is filled in once the loop has been compiled. This is either to the
+ * native code of the statement or, if it is outside of the loop or exitToInterpreter is set, out to the interpreter
+ */
+static void emitJumpToStatement(struct jit_compilation * comp, unsigned int target, char exitToInterpreter) {
+	if (comp->numberFixups == comp->fixupCapacity) {
+		comp->fixupCapacity=(comp->fixupCapacity + 1) * 2;
+		comp->fixups=(struct jit_fixup*) realloc(comp->fixups, sizeof(struct jit_fixup) * comp->fixupCapacity);
+	}
+	comp->fixups[comp->numberFixups].nativePoint=comp->codeLength;
+	comp->fixups[comp->numberFixups].target=target;
+	comp->fixups[comp->numberFixups++].exitToInterpreter=exitToInterpreter;
+	emitInt(comp, 0);
+}
+
+/**
+ * Emits the displacement of a forward jump within the native code, returning its point to be patched once the target is known
+ */
+static unsigned int emitLocalJump(struct jit_compilation * comp) {
+	unsigned int point=comp->codeLength;
+	emitInt(comp, 0);
+	return point;
+}
+
+/**
+ * Patches a forward jump within the native code to target the next instruction emitted
+ */
+static void patchLocalJump(struct jit_compilation * comp, unsigned int point) {
+	patchJump(comp, point, comp->codeLength);
+}
+
+/**
+ * Patches the displacement of a jump at some point to target another point in the native code
+ */
+static void patchJump(struct jit_compilation * comp, unsigned int point, unsigned int target) {
+	int displacement=(int) target - (int) (point + sizeof(int));
+	memcpy(&comp->code[point], &displacement, sizeof(int));
+}
+#endif
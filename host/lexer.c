@@ -706,6 +706,7 @@ char *yytext;
 #line 2 "epython.l"
 #include "parser.h"
 #include "stack.h"
+#include "arena.h"
 
 static const unsigned int TAB_WIDTH = 4;
 
@@ -1031,9 +1032,8 @@ YY_RULE_SETUP
 									if (parsing_filename != NULL) {
 										pushIdentifier(&filenameStack, parsing_filename); 
 										push(&lineNumberStack, line_num);
-										free(parsing_filename);
 									}
-									parsing_filename=(char*) malloc(yyleng-3);
+									parsing_filename=(char*) arenaAllocate(yyleng-3);
 									strncpy(parsing_filename, &yytext[3], yyleng-4);
 									parsing_filename[yyleng-4]='\0';									
 									line_num=1; 
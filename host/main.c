@@ -30,7 +30,11 @@
 #include <time.h>
 #include <pthread.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
 
 #include "stack.h"
 #include "ctype.h"
@@ -41,6 +45,16 @@
 #include "byteassembler.h"
 #include "python_interoperability.h"
 #include "misc.h"
+#include "hashtable.h"
+#include "arena.h"
+#include "bytecodecache.h"
+#include "bytecodefile.h"
+#include "moduleobject.h"
+#include "ir.h"
+#ifdef HOST_STANDALONE
+#include "jit.h"
+#include "c-translator.h"
+#endif
 #ifndef HOST_STANDALONE
 #include "shared.h"
 #include "device-support.h"
@@ -65,30 +79,65 @@ struct fullPythonInteractivityThreadWrapper {
     pthread_t* emanagementThread;
 };
 
-struct included_source_files {
-    char * fileName;
-    struct included_source_files * next;
+// Buffer which the preprocessed source code is appended to, the capacity of this doubles whenever it fills up
+struct source_buffer {
+	char * data;
+	size_t length, capacity;
+};
+
+// Paths of the modules imported by a source file, in the order that these are first imported, and whether any module is imported
+// after a top level statement of the file
+struct import_list {
+	char ** paths;
+	int number, capacity, importAfterStatement;
 };
 
-#define TEXTUAL_BASIC_SIZE_STRIDE 5000
+#define INITIAL_SOURCE_BUFFER_SIZE 5000
+#define MODULE_OBJECT_FILENAME_EXTENSION ".epyo"
 
 extern int yyparse();
 extern int yy_scan_string(const char*);
 extern void initThreadedAspectsForInterpreter(int, int, struct shared_basic*);
+extern void displaySuperinstructionCounts(void);
 
 struct stack_t indent_stack, filenameStack, lineNumberStack;
-struct included_source_files * included_src_root=NULL;
+// Paths of the source files that have been imported, each is only included once
+static struct hash_table * includedSourceFiles=NULL;
+// Paths that the names of imported source files resolve to, and the directories of EPYTHONPATH which are searched for these
+static struct hash_table * resolvedModulePaths=NULL;
+static char ** moduleSearchDirectories=NULL;
+static int numberModuleSearchDirectories=-1;
+// When set the modules imported by a source file are recorded here, rather than their source being included in its place, and
+// whether each import is replaced by a call marking where the top level code of the module runs
+static struct import_list * recordedImports=NULL;
+static int markRecordedImports=0;
+// Paths of the modules linked into the program as objects, and the objects (along with the path of each) in the order that these
+// are linked
+static struct hash_table * linkedModulePaths=NULL;
+static struct module_object ** linkedModuleObjects=NULL;
+static char ** linkedModuleObjectPaths=NULL;
+static int numberLinkedModuleObjects=0;
+// Set in the process which compiles a module to an object, along with whether the object has been written
+static char * moduleObjectFilename=NULL;
+static int moduleObjectWritten=0;
 
 static void doParse(char*);
-static char * getSourceFileContents(char*);
+static char * getSourceFileContents(char*, struct import_list*);
+static char * getLinkedSourceFileContents(char*, unsigned long long*);
+static int linkImportedModules(struct import_list*, unsigned long long*);
+static struct module_object* getModuleObject(char*, unsigned long long*);
+static struct module_object* compileModuleObject(char*, char*);
+static int addImport(struct import_list*, char*);
+static void preprocessSourceFile(char*, struct source_buffer*);
+static void preprocessImport(char*, size_t, struct source_buffer*, int);
+static void appendToSourceBuffer(struct source_buffer*, const char*, size_t);
+static int doesLineContain(char*, size_t, char*);
 static void displayParsedBasicInfo(void);
-void writeOutByteCode(char*);
-void loadByteCode(char*);
 static char* getIncludeFileWithPath(char*);
+static char* findIncludeFileOnPath(char*);
+static void readModuleSearchDirectories(void);
 static void runCodeOnHost(struct interpreterconfiguration*, struct shared_basic*);
 static void * runSpecificHostProcess(void*);
-static void appendIncludedSourceFileToStore(char*);
-static int hasSourceFileAlreadyBeenIncluded(char*);
 static void* runCodeForFullPythonInteractivity(void*);
 #ifndef HOST_STANDALONE
 static void* runCodeOnEpiphany(void*);
@@ -100,19 +149,48 @@ static void* runCodeOnEpiphany(void*);
 int main (int argc, char *argv[]) {
 	srand((unsigned) time(NULL) * getpid());
 	struct interpreterconfiguration* configuration=readConfiguration(argc, argv);
+#ifdef HOST_STANDALONE
+	// Translation to C is from the stack based expressions, and requires the function locations from compiling the source
+	registerExpressions=configuration->registerExpressions && configuration->translatedFilename == NULL;
+	if (configuration->translatedFilename != NULL && configuration->loadByteFilename != NULL) {
+		fprintf(stderr, "Translation to C must be from the Python source code rather than a byte code file\n");
+		exit(0);
+	}
+#else
+	registerExpressions=configuration->registerExpressions;
+#endif
 	if (configuration->filename != NULL) {
-		char * contents = getSourceFileContents(configuration->filename);
+		unsigned long long linkedModulesKey=0;
+		char * contents=configuration->linkModules ? getLinkedSourceFileContents(configuration->filename, &linkedModulesKey) : NULL;
+		if (contents == NULL) contents=getSourceFileContents(configuration->filename, NULL);
 		if (configuration->displayPPCode) printf("%s\n", contents);
-		doParse(contents);
+		// The parse statistics are only known when the source is compiled, so the cache is not loaded from if these are displayed
+		if (!configuration->useByteCodeCache || configuration->displayStats ||
+				!loadCachedByteCode(contents, linkedModulesKey, registerExpressions)) {
+			doParse(contents);
+			if (configuration->useByteCodeCache) storeCachedByteCode(contents, linkedModulesKey, registerExpressions);
+		}
 	} else if (configuration->loadByteFilename != NULL) {
 		loadByteCode(configuration->loadByteFilename);
 	} else if (configuration->pipedInContents != NULL) {
 		if (configuration->displayPPCode) printf("%s\n", configuration->pipedInContents);
 		doParse(configuration->pipedInContents);
+#ifdef HOST_TRANSLATED
+	} else {
+		// Run the code built into the executable, as translated to C
+		setMemoryFilledSize(translatedByteCodeLength);
+		setNumberEntriesInSymbolTable(translatedNumberSymbols);
+		setAssembledCode(translatedByteCode);
+		translatedCode=runTranslatedCode;
+#endif
 	}
 	if (configuration->displayStats) displayParsedBasicInfo();
 	if (configuration->compiledByteFilename != NULL) {
 		writeOutByteCode(configuration->compiledByteFilename);
+#ifdef HOST_STANDALONE
+	} else if (configuration->translatedFilename != NULL) {
+		writeOutTranslatedCode(configuration->translatedFilename);
+#endif
 	} else {
 #ifndef HOST_STANDALONE
 		pthread_t epiphany_management_thread, fullPythonInteractivityThread;
@@ -132,7 +210,7 @@ int main (int argc, char *argv[]) {
 #else
 		pthread_t fullPythonInteractivityThread;
 		struct shared_basic * standAloneState=(struct shared_basic*) malloc(sizeof(struct shared_basic));
-		standAloneState->symbol_size=getNumberEntriesInSymbolTable();
+		standAloneState->symbol_size=getNumberEntriesInHostSymbolTable();
 		standAloneState->num_procs=configuration->coreProcs+configuration->hostProcs;
 		standAloneState->baseHostPid=configuration->coreProcs;
 		if (configuration->fullPythonHost) {
@@ -155,15 +233,26 @@ int main (int argc, char *argv[]) {
 }
 
 /**
- * Calls out to do the lexing and parsing of the source code
+ * Calls out to do the lexing and parsing of the source code. The data structures of the compiler are allocated from an arena,
+ * which is released in one go once the byte code has been compiled
  */
 static void doParse(char * contents) {
+	int i;
+	struct memory_arena * compilerArena=createArena();
+	setCurrentArena(compilerArena);
 	enterScope();
 	initStack(&indent_stack);
 	initStack(&filenameStack);
 	initStack(&lineNumberStack);
+	for (i=0;i<numberLinkedModuleObjects;i++) linkModuleObject(linkedModuleObjects[i], linkedModuleObjectPaths[i]);
 	yy_scan_string(contents);
 	yyparse();
+	if (moduleObjectFilename != NULL) {
+		struct module_object * object=getCompiledModuleObject();
+		moduleObjectWritten=object != NULL && writeModuleObject(moduleObjectFilename, object);
+	}
+	leaveScope();
+	freeArena(compilerArena);
 }
 
 #ifndef HOST_STANDALONE
@@ -197,11 +286,27 @@ static void runCodeOnHost(struct interpreterconfiguration* configuration, struct
 	int i;
 	char * assembledCode=getAssembledCode();
 	unsigned int memoryFilledSize=getMemoryFilledSize();
-	unsigned short entriesInSymbolTable=getNumberEntriesInSymbolTable();
-	if (configuration->hostProcs > 0) initThreadedAspectsForInterpreter(configuration->hostProcs, configuration->coreProcs, basicState);
+	unsigned short entriesInSymbolTable=getNumberEntriesInHostSymbolTable();
+	if (configuration->hostProcs > 0) {
+		initThreadedAspectsForInterpreter(configuration->hostProcs, configuration->coreProcs, basicState);
+		// Displayed once the process exits, which is when the last thread has finished
+		if (configuration->countSuperinstructions) atexit(displaySuperinstructionCounts);
+#ifdef HOST_STANDALONE
+		if (configuration->jit) initJit(configuration->hostProcs);
+#endif
+	}
 	for (i=(configuration->fullPythonHost ? 1 : 0);i<configuration->hostProcs;i++) {
-		threadWrappers[i].assembledCode=assembledCode;
-		threadWrappers[i].memoryFilledSize=memoryFilledSize;
+		// The byte code is specialised to the core id of the thread, apart from when functions are called by location from full
+		// Python, otherwise every thread shares the same byte code
+		threadWrappers[i].assembledCode=configuration->fullPythonHost ? NULL : getSpecialisedByteCode(1, i + configuration->coreProcs,
+				configuration->hostProcs + configuration->coreProcs, &threadWrappers[i].memoryFilledSize);
+		if (threadWrappers[i].assembledCode != NULL && configuration->displayStats) {
+			printf("%u bytes for code specialised to core %d\n", threadWrappers[i].memoryFilledSize, i + configuration->coreProcs);
+		}
+		if (threadWrappers[i].assembledCode == NULL) {
+			threadWrappers[i].assembledCode=assembledCode;
+			threadWrappers[i].memoryFilledSize=memoryFilledSize;
+		}
 		threadWrappers[i].entriesInSymbolTable=entriesInSymbolTable;
 		threadWrappers[i].hostThreadId=i;
 		threadWrappers[i].hostStartPoint=configuration->coreProcs;
@@ -221,196 +326,352 @@ static void * runSpecificHostProcess(void * rawThreadContext) {
 }
 
 /**
- * Given the name of a file will read it and return the char array containing the contents, an error
- * is reported along with program exit if the file cannot be read for whatever reason
+ * Given the name of a file will read it and return the char array containing the contents, preprocessed with the source of any
+ * imported files included in place. If a list of imports is provided then the imported files are instead added to this and left
+ * out of the contents. An error is reported along with program exit if a file cannot be read for whatever reason
  */
-static char * getSourceFileContents(char * filename) {
-	unsigned int contentsSize=TEXTUAL_BASIC_SIZE_STRIDE;
-	char * contents=(char*) malloc(contentsSize);
-	char buffer[1024];
-	FILE * sourceCode=fopen(filename, "r");
-	if (sourceCode != NULL) {
-		sprintf(contents, "<<<%s\n", filename);
-		while (fgets(buffer, 1024, sourceCode) != NULL) {
-			if (strstr(buffer, "import") != NULL && buffer[0] != '#') {
-				char * importPoint=strstr(buffer, "import");
-				char * importPoint_from=strstr(buffer, "from");
-				if (importPoint_from != NULL) {
-					if (importPoint_from < importPoint) importPoint=importPoint_from;
-				}
-				int startIdx=0, idx=0, foundSpace=0;
-				while (importPoint[idx] != '\0' && importPoint[idx] != '\n') {
-					if (isspace(importPoint[idx]) && foundSpace==0) foundSpace=1;
-					if (!isspace(importPoint[idx]) && foundSpace==1) {
-						startIdx=idx;
-						foundSpace=2;
-					}
-					if (isspace(importPoint[idx]) && foundSpace==2) break;
-					idx++;
-				}
-				if (importPoint[idx-1]=='\n') importPoint[idx-1]='\0';
-				importPoint[idx]='\0';
-				char * newFilename=(char*) malloc(strlen(&importPoint[startIdx])+5);
-				sprintf(newFilename, "%s.py", &importPoint[startIdx]);
-				char* entirePathForFile=getIncludeFileWithPath(newFilename);
-				if (entirePathForFile == NULL) {
-					fprintf(stderr, "Opening of Python file '%s' failed, are you sure this file exists?\n", newFilename);
-					exit(0);
-				}
-				if (!hasSourceFileAlreadyBeenIncluded(entirePathForFile)) {
-                    appendIncludedSourceFileToStore(entirePathForFile);
-                    char * importedContents=getSourceFileContents(entirePathForFile);
-                    if (strlen(importedContents)+strlen(contents)+1 >= contentsSize) {
-                        contentsSize=strlen(importedContents)+strlen(contents)+TEXTUAL_BASIC_SIZE_STRIDE;
-                        contents=realloc(contents, contentsSize);
-                    }
-                    sprintf(contents, "%s%s", contents, importedContents);
+static char * getSourceFileContents(char * filename, struct import_list * imports) {
+	struct source_buffer contents;
+	contents.capacity=INITIAL_SOURCE_BUFFER_SIZE;
+	contents.length=0;
+	contents.data=(char*) malloc(contents.capacity);
+	if (imports != NULL) {
+		imports->number=imports->importAfterStatement=0;
+		imports->capacity=8;
+		imports->paths=(char**) malloc(sizeof(char*) * imports->capacity);
+	}
+	recordedImports=imports;
+	preprocessSourceFile(filename, &contents);
+	recordedImports=NULL;
+	appendToSourceBuffer(&contents, "", 1);
+	return contents.data;
+}
+
+/**
+ * Gets the preprocessed source of a file whose imported modules are linked into the program as objects, and sets the key of
+ * these objects. Each import in the file is replaced by a call marking where the top level code of the module (and that of the
+ * modules it imports) runs, as when the source was included. The object of a module is compiled when its source has changed,
+ * and if any module can not be compiled on its own then NULL is returned and the source of the modules is included instead
+ */
+static char * getLinkedSourceFileContents(char * filename, unsigned long long * linkedModulesKey) {
+	struct import_list imports;
+	int i, j;
+	markRecordedImports=1;
+	char * contents=getSourceFileContents(filename, &imports);
+	markRecordedImports=0;
+	*linkedModulesKey=HASH_BYTES_OFFSET_BASIS;
+	if (!linkImportedModules(&imports, linkedModulesKey)) {
+		free(contents);
+		contents=NULL;
+		numberLinkedModuleObjects=0;
+		*linkedModulesKey=0;
+	} else {
+		for (i=0;i<imports.number;i++) {
+			for (j=0;j<numberLinkedModuleObjects && strcmp(linkedModuleObjectPaths[j], imports.paths[i]) != 0;j++);
+			setLinkedModuleImport(i, j);
+		}
+	}
+	free(imports.paths);
+	return contents;
+}
+
+/**
+ * Gets the objects of imported modules which have not already been linked, the modules that each of these imports are linked
+ * before it as when the source was included these would run first. Returns 0 if a module can not be linked as an object
+ */
+static int linkImportedModules(struct import_list * imports, unsigned long long * linkedModulesKey) {
+	struct import_list moduleImports;
+	struct module_object * object;
+	unsigned long long moduleKey;
+	int i, linked;
+	if (linkedModulePaths == NULL) linkedModulePaths=createHashTable(0);
+	for (i=0;i<imports->number;i++) {
+		if (getHashTableEntry(linkedModulePaths, imports->paths[i]) != NULL) continue;
+		putHashTableEntry(linkedModulePaths, imports->paths[i], imports->paths[i]);
+		char * moduleContents=getSourceFileContents(imports->paths[i], &moduleImports);
+		// The modules a module imports are linked, and their top level code run, before it. If the module imports any after
+		// one of its own top level statements then this order differs from including its source, which is done instead
+		linked=!moduleImports.importAfterStatement && linkImportedModules(&moduleImports, linkedModulesKey);
+		free(moduleImports.paths);
+		object=linked ? getModuleObject(moduleContents, &moduleKey) : NULL;
+		free(moduleContents);
+		if (object == NULL) return 0;
+		linkedModuleObjects=(struct module_object**) realloc(linkedModuleObjects, sizeof(struct module_object*) * (numberLinkedModuleObjects + 1));
+		linkedModuleObjectPaths=(char**) realloc(linkedModuleObjectPaths, sizeof(char*) * (numberLinkedModuleObjects + 1));
+		linkedModuleObjectPaths[numberLinkedModuleObjects]=imports->paths[i];
+		linkedModuleObjects[numberLinkedModuleObjects++]=object;
+		*linkedModulesKey=hashBytes(*linkedModulesKey, &moduleKey, sizeof(unsigned long long));
+	}
+	return 1;
+}
+
+/**
+ * Gets the object of a module from the byte code cache, compiling this if the module's source has changed and setting the key
+ * of the object. Returns NULL if there is no cache directory or the module can not be compiled on its own
+ */
+static struct module_object* getModuleObject(char * moduleContents, unsigned long long * moduleKey) {
+	struct module_object * object;
+	*moduleKey=getByteCodeCacheKey(moduleContents, registerExpressions);
+	char * objectFilename=getByteCodeCacheFilename(*moduleKey, MODULE_OBJECT_FILENAME_EXTENSION, 1);
+	if (objectFilename == NULL) return NULL;
+	object=readModuleObject(objectFilename);
+	if (object == NULL) object=compileModuleObject(moduleContents, objectFilename);
+	free(objectFilename);
+	return object;
+}
+
+/**
+ * Compiles a module to an object. This is compiled by a child process, as the state of the compiler is global, with the global
+ * variable ids in its code recorded by the assembler so that these are relocated when the object is linked. Returns NULL if the
+ * child can not be run, or the module fails to compile or to be written out
+ */
+static struct module_object* compileModuleObject(char * moduleContents, char * objectFilename) {
+	pid_t child;
+	int status;
+	// Output is flushed first, as a child which fails to compile the module exits and would otherwise write this out again
+	fflush(stdout);
+	fflush(stderr);
+	child=fork();
+	if (child == 0) {
+		// The module is compiled on its own, so the objects of the modules which it imports are not linked into it. Any errors
+		// are reported when the program falls back to including the module's source in place
+		numberLinkedModuleObjects=0;
+		if (freopen("/dev/null", "w", stdout) == NULL || freopen("/dev/null", "w", stderr) == NULL) _exit(EXIT_FAILURE);
+		moduleObjectFilename=objectFilename;
+		setNumberEntriesInSymbolTable(0);
+		setCompilingModuleObject(1);
+		doParse(moduleContents);
+		_exit(moduleObjectWritten ? EXIT_SUCCESS : EXIT_FAILURE);
+	}
+	if (child < 0 || waitpid(child, &status, 0) != child || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) return NULL;
+	// The compiler reports errors by exiting successfully, in which case the object is not written
+	return readModuleObject(objectFilename);
+}
+
+/**
+ * Adds the path of an imported module to a list of imports, if it is not already in this, and returns its index in the list
+ */
+static int addImport(struct import_list * imports, char * path) {
+	int i;
+	for (i=0;i<imports->number;i++) {
+		if (strcmp(imports->paths[i], path) == 0) return i;
+	}
+	if (imports->number == imports->capacity) {
+		imports->capacity*=2;
+		imports->paths=(char**) realloc(imports->paths, sizeof(char*) * imports->capacity);
+	}
+	imports->paths[imports->number]=path;
+	return imports->number++;
+}
+
+/**
+ * Preprocesses a source file onto the end of the contents, the file is mapped into memory and streamed through a line at a time.
+ * Comment lines are replaced by empty lines to preserve the line numbering and imports by the source of the imported file
+ */
+static void preprocessSourceFile(char * filename, struct source_buffer * contents) {
+	struct stat fileInfo;
+	char * source=NULL;
+	size_t sourceLength=0, lineStart, lineLength, i;
+	int sourceFile=open(filename, O_RDONLY), afterStatement=0;
+	if (sourceFile != -1 && fstat(sourceFile, &fileInfo) == 0) {
+		sourceLength=(size_t) fileInfo.st_size;
+		if (sourceLength > 0) {
+			source=(char*) mmap(NULL, sourceLength, PROT_READ, MAP_PRIVATE, sourceFile, 0);
+			if (source == MAP_FAILED) source=NULL;
+		}
+	}
+	if (sourceFile == -1 || (sourceLength > 0 && source == NULL)) {
+		fprintf(stderr, "Opening of Python file '%s' failed, are you sure this file exists?\n", filename);
+		exit(0);
+	}
+	appendToSourceBuffer(contents, "<<<", 3);
+	appendToSourceBuffer(contents, filename, strlen(filename));
+	appendToSourceBuffer(contents, "\n", 1);
+	for (lineStart=0;lineStart < sourceLength;lineStart+=lineLength) {
+		char * line=&source[lineStart];
+		char * lineEnd=(char*) memchr(line, '\n', sourceLength - lineStart);
+		lineLength=lineEnd != NULL ? (size_t) (lineEnd - line) + 1 : sourceLength - lineStart;
+		if (line[0] != '#' && doesLineContain(line, lineLength, "import")) {
+			preprocessImport(line, lineLength, contents, afterStatement);
+		} else {
+			for (i=0;i<lineLength && isspace(line[i]);i++);
+			if (i == lineLength || line[i] != '#') {
+				// Function definitions and their decorators are not top level statements, as nothing runs where these appear
+				if (i == 0 && lineLength > 0 && line[0] != '@' && !(lineLength > 4 && memcmp(line, "def", 3) == 0 && isspace(line[3]))) {
+					afterStatement=1;
 				}
-				free(newFilename);
-				free(entirePathForFile);
+				appendToSourceBuffer(contents, line, lineLength);
 			} else {
-				int i=0;
-				while(isspace(buffer[i]) && buffer[i] != '\0' && i < 1024) i++;
-				if (buffer[i] != '#') {
-					if (strlen(buffer)+strlen(contents)+1 >= contentsSize) {
-						contentsSize+=TEXTUAL_BASIC_SIZE_STRIDE;
-						contents=realloc(contents, contentsSize);
-					}
-					sprintf(contents, "%s%s", contents, buffer);
-				} else {
-					// Empty line to preserve line numberings
-					if (strlen(buffer)+2 >= contentsSize) {
-						contentsSize+=TEXTUAL_BASIC_SIZE_STRIDE;
-						contents=realloc(contents, contentsSize);
-					}
-					sprintf(contents, "%s\n", contents);
-				}
+				// Empty line to preserve line numberings
+				appendToSourceBuffer(contents, "\n", 1);
 			}
 		}
-		if (strlen(contents)+7 >=contentsSize) {
-			contents=realloc(contents, contentsSize+7);
+	}
+	appendToSourceBuffer(contents, "\n>>>\n", 5);
+	if (source != NULL) munmap(source, sourceLength);
+	close(sourceFile);
+}
+
+/**
+ * Handles an import (or from) statement, the first time that a file is imported its preprocessed source is included in place of
+ * the statement, otherwise the statement is dropped. When imports are recorded the statement is instead replaced by an empty
+ * line, or by a call marking where the top level code of the module runs, and whether this follows a top level statement of the
+ * file is recorded
+ */
+static void preprocessImport(char * line, size_t lineLength, struct source_buffer * contents, int afterStatement) {
+	char * statement=(char*) malloc(lineLength + 1);
+	memcpy(statement, line, lineLength);
+	statement[lineLength]='\0';
+	char * importPoint=strstr(statement, "import");
+	char * importPoint_from=strstr(statement, "from");
+	if (importPoint_from != NULL) {
+		if (importPoint_from < importPoint) importPoint=importPoint_from;
+	}
+	int startIdx=0, idx=0, foundSpace=0;
+	while (importPoint[idx] != '\0' && importPoint[idx] != '\n') {
+		if (isspace(importPoint[idx]) && foundSpace==0) foundSpace=1;
+		if (!isspace(importPoint[idx]) && foundSpace==1) {
+			startIdx=idx;
+			foundSpace=2;
+		}
+		if (isspace(importPoint[idx]) && foundSpace==2) break;
+		idx++;
+	}
+	if (importPoint[idx-1]=='\n') importPoint[idx-1]='\0';
+	importPoint[idx]='\0';
+	char * newFilename=(char*) malloc(strlen(&importPoint[startIdx])+5);
+	sprintf(newFilename, "%s.py", &importPoint[startIdx]);
+	char* entirePathForFile=getIncludeFileWithPath(newFilename);
+	if (entirePathForFile == NULL) {
+		fprintf(stderr, "Opening of Python file '%s' failed, are you sure this file exists?\n", newFilename);
+		exit(0);
+	}
+	if (recordedImports != NULL) {
+		// The module is linked in as an object, the statement is replaced by a single line to preserve the line numbering
+		int importIndex=addImport(recordedImports, entirePathForFile);
+		if (afterStatement) recordedImports->importAfterStatement=1;
+		if (markRecordedImports) {
+			char marker[64];
+			int indent;
+			for (indent=0;indent < (int) lineLength && (line[indent] == ' ' || line[indent] == '\t');indent++);
+			appendToSourceBuffer(contents, line, (size_t) indent);
+			sprintf(marker, "%s%d()\n", LINKED_MODULE_IMPORT_MARKER, importIndex);
+			appendToSourceBuffer(contents, marker, strlen(marker));
+		} else {
+			appendToSourceBuffer(contents, "\n", 1);
 		}
-		sprintf(contents, "%s\n>>>\n", contents);
-		fclose(sourceCode);
-		return contents;
 	} else {
-		fprintf(stderr, "Opening of Python file '%s' failed, are you sure this file exists?\n", filename);
-		exit(0);
+		if (includedSourceFiles == NULL) includedSourceFiles=createHashTable(0);
+		if (getHashTableEntry(includedSourceFiles, entirePathForFile) == NULL) {
+			putHashTableEntry(includedSourceFiles, entirePathForFile, entirePathForFile);
+			preprocessSourceFile(entirePathForFile, contents);
+		}
 	}
+	free(newFilename);
+	free(statement);
 }
 
-static void appendIncludedSourceFileToStore(char * filename) {
-    struct included_source_files * newNode=(struct included_source_files *) malloc(sizeof(struct included_source_files));
-    newNode->fileName=(char*) malloc(strlen(filename) + 1);
-    strcpy(newNode->fileName, filename);
-    newNode->next=included_src_root;
-    included_src_root=newNode;
+/**
+ * Appends some characters onto the end of the contents, doubling its capacity if these do not fit
+ */
+static void appendToSourceBuffer(struct source_buffer * contents, const char * characters, size_t length) {
+	if (contents->length + length > contents->capacity) {
+		while (contents->length + length > contents->capacity) contents->capacity*=2;
+		contents->data=(char*) realloc(contents->data, contents->capacity);
+	}
+	memcpy(&contents->data[contents->length], characters, length);
+	contents->length+=length;
 }
 
-static int hasSourceFileAlreadyBeenIncluded(char * filename) {
-    struct included_source_files * head=included_src_root;
-    while (head != NULL) {
-        if (strcmp(head->fileName, filename) == 0) return 1;
-        head=head->next;
-    }
-    return 0;
+/**
+ * Determines whether a line, which is not null terminated, contains a specific word
+ */
+static int doesLineContain(char * line, size_t lineLength, char * word) {
+	size_t wordLength=strlen(word), i;
+	for (i=0;i + wordLength <= lineLength;i++) {
+		if (line[i] == word[0] && memcmp(&line[i], word, wordLength) == 0) return 1;
+	}
+	return 0;
 }
 
+/**
+ * Gets the path of an imported file, or NULL if it can not be found. The path that each file name resolves to is cached, so
+ * the file system is only searched the first time that a file is imported
+ */
 static char* getIncludeFileWithPath(char * filename) {
+	if (resolvedModulePaths == NULL) resolvedModulePaths=createHashTable(0);
+	char * path=(char*) getHashTableEntry(resolvedModulePaths, filename);
+	if (path == NULL) {
+		path=findIncludeFileOnPath(filename);
+		if (path != NULL) putHashTableEntry(resolvedModulePaths, filename, path);
+	}
+	return path;
+}
+
+/**
+ * Searches for a file in the current directory, then the modules directory and then each directory of EPYTHONPATH in turn
+ */
+static char* findIncludeFileOnPath(char * filename) {
+	int i;
 	if(access(filename, F_OK) != -1 ) {
 		char * tr=(char*) malloc(strlen(filename) + 1);
 		strcpy(tr, filename);
 		return tr;
-	} else {
-	    char * testFilename=(char*) malloc(strlen(filename) + 10);
-	    sprintf(testFilename, "modules/%s", filename);
-	    if(access(testFilename, F_OK) != -1 ) {
-            return testFilename;
-	    } else {
-            free(testFilename);
-	    }
-
-		char * prev = getenv("EPYTHONPATH");
-		if (prev == NULL) return NULL;
-		char * pch=strchr(prev, ':');
-		while (pch != NULL) {
-			char * newPath=(char*) malloc((pch-prev)+1);
-			strncpy(newPath, prev, pch-prev);
-			if (prev[(pch-prev)-1] == '/') {
-				newPath[(pch-prev)-1]='\0';
-			} else {
-				newPath[pch-prev]='\0';
-			}
-			testFilename=(char*) malloc(strlen(newPath) + strlen(filename) + 2);
-			sprintf(testFilename, "%s/%s", newPath, filename);
-			free(newPath);
-			if(access(testFilename, F_OK) != -1 ) return testFilename;
-			free(testFilename);
-			prev=pch+1;
-			pch=strchr(prev,':');
-		}
-		if (prev[strlen(prev)-1] == '/') {
-			prev[strlen(prev)-1]='\0';
-		}
-		testFilename=(char*) malloc(strlen(prev) + strlen(filename) + 2);
-		sprintf(testFilename, "%s/%s", prev, filename);
+	}
+	char * testFilename=(char*) malloc(strlen(filename) + 10);
+	sprintf(testFilename, "modules/%s", filename);
+	if(access(testFilename, F_OK) != -1 ) return testFilename;
+	free(testFilename);
+
+	if (numberModuleSearchDirectories < 0) readModuleSearchDirectories();
+	for (i=0;i<numberModuleSearchDirectories;i++) {
+		testFilename=(char*) malloc(strlen(moduleSearchDirectories[i]) + strlen(filename) + 2);
+		sprintf(testFilename, "%s/%s", moduleSearchDirectories[i], filename);
 		if(access(testFilename, F_OK) != -1 ) return testFilename;
 		free(testFilename);
 	}
 	return NULL;
 }
 
+/**
+ * Splits EPYTHONPATH into the directories that are searched for imported files, the trailing slash of each is removed
+ */
+static void readModuleSearchDirectories(void) {
+	char * searchPath=getenv("EPYTHONPATH"), * pch;
+	numberModuleSearchDirectories=0;
+	if (searchPath == NULL) return;
+	moduleSearchDirectories=(char**) malloc(sizeof(char*) * (strlen(searchPath) + 1));
+	while (1) {
+		pch=strchr(searchPath, ':');
+		size_t directoryLength=pch != NULL ? (size_t) (pch - searchPath) : strlen(searchPath);
+		if (directoryLength > 0) {
+			char * directory=(char*) malloc(directoryLength + 1);
+			memcpy(directory, searchPath, directoryLength);
+			if (directory[directoryLength-1] == '/') directoryLength--;
+			directory[directoryLength]='\0';
+			moduleSearchDirectories[numberModuleSearchDirectories++]=directory;
+		}
+		if (pch == NULL) break;
+		searchPath=pch+1;
+	}
+}
+
 /**
  * Displays the parsed basic information, giving an idea of the size of the processed byte code, symbol table and memory free on each core
  */
 static void displayParsedBasicInfo() {
-	int memSize=getMemoryFilledSize();
-	int symbolEntries=getNumberEntriesInSymbolTable();
+	int memSize=getMemoryFilledSize(), unoptimisedMemSize=getUnoptimisedMemorySize();
+	int symbolEntries=getNumberEntriesInSymbolTable(), inlinedCallSites=getNumberInlinedCallSites();
+	int propagatedConstants=getNumberPropagatedConstants(), removedStores=getNumberRemovedStores();
 #ifndef HOST_STANDALONE
-	printf("%d bytes for code, %lu bytes for symbol table (%d entries), %d bytes free\n",
-			memSize, symbolEntries*sizeof(struct symbol_node), symbolEntries, (0x8000-CORE_DATA_START)-(memSize+(symbolEntries*5)));
+	printf("%d bytes for code (%d before optimisation, %d calls inlined, %d constants propagated, %d dead stores removed), "
+			"%lu bytes for symbol table (%d entries), %d bytes free\n", memSize, unoptimisedMemSize, inlinedCallSites,
+			propagatedConstants, removedStores, symbolEntries*sizeof(struct symbol_node), symbolEntries,
+			(0x8000-CORE_DATA_START)-(memSize+(symbolEntries*5)));
 #else
-	printf("%d bytes for code, %lu bytes for symbol table (%d entries)\n", memSize, symbolEntries*sizeof(struct symbol_node), symbolEntries);
+	printf("%d bytes for code (%d before optimisation, %d calls inlined, %d constants propagated, %d dead stores removed), "
+			"%lu bytes for symbol table (%d entries)\n", memSize, unoptimisedMemSize, inlinedCallSites, propagatedConstants,
+			removedStores, symbolEntries*sizeof(struct symbol_node), symbolEntries);
 #endif
 }
 
-/**
- * Starts the interpreter from a byte code file
- */
-void loadByteCode(char * loadByteFilename) {
-	FILE * byteFile=fopen(loadByteFilename, "rb");
-	if (byteFile != NULL) {
-		unsigned int len;
-		errorCheck(fread(&len, sizeof(unsigned int), 1, byteFile), "Memory filled size from byte code file");
-		setMemoryFilledSize(len);
-		unsigned short symbols;
-		errorCheck(fread(&symbols, sizeof(unsigned short), 1, byteFile), "Number of symbols from byte code file");
-		setNumberEntriesInSymbolTable(symbols);
-		char * code=(char*) malloc(len);
-		errorCheck(fread(code, sizeof(char), len, byteFile), "Byte code from file");
-		setAssembledCode(code);
-		fclose(byteFile);
-	} else {
-		fprintf(stderr, "Opening of byte code file '%s' failed, are you sure this file exists?\n", loadByteFilename);
-		exit(0);
-	}
-}
-
-/**
- * Writes out the byte code to a file
- */
-void writeOutByteCode(char * compiledByteFilename) {
-	FILE * byteFile=fopen(compiledByteFilename, "wb");
-	if (byteFile != NULL) {
-		unsigned int len=getMemoryFilledSize();
-		fwrite(&len, sizeof(unsigned int), 1, byteFile);
-		unsigned short symbols=getNumberEntriesInSymbolTable();
-		fwrite(&symbols, sizeof(unsigned short), 1, byteFile);
-		char * code=getAssembledCode();
-		fwrite(code, sizeof(char), len, byteFile);
-		fclose(byteFile);
-	} else {
-		fprintf(stderr, "Writing byte code to file '%s' failed\n", compiledByteFilename);
-		exit(0);
-	}
-}
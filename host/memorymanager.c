@@ -29,86 +29,498 @@
 #include <string.h>
 #include <stdio.h>
 #include "memorymanager.h"
+#include "basictokens.h"
+#include "hashtable.h"
+#include "arena.h"
+#include "moduleobject.h"
 
 // This is set at the end of parsing to be the entire byte code representation of the users Python program
 struct memorycontainer* assembledMemory=NULL;
 // This is the function list
 struct functionListNode* functionListHead=NULL;
+// Function definitions indexed by name, the most recently added function of a name is held
+static struct hash_table* functionDefinitionTable=NULL;
 // Exportable view of the functions and their location in the byte code
 struct exportableFunctionTableNode* exportableFunctionTable=NULL;
 int numberExportableFunctionsInTable=0;
+// Names of the functions in the exportable function table
+static struct hash_table* exportableFunctionNames=NULL;
+// Number of bytes taken out of the assembled byte code by the optimisations applied as it was assembled
+static unsigned int programBytesOptimisedAway=0;
+// Number of calls which have had the body of the called function substituted for them
+static int numberInlinedCallSites=0;
+// Copy of the compiled program before it is linked, from which byte code specialised to how it is run is produced
+static struct memorycontainer* unlinkedMemory=NULL;
+// Symbol table entries required for the frames of called functions and of those which are recursive, these are kept as the
+// function definitions are released along with the rest of the compiler's memory
+static int calledFunctionSymbolEntries=0, recursiveFunctionSymbolEntries=0;
+// Set when a module is compiled to an object, its top level code is then kept as it is rather than being linked into a program
+static int compilingModuleObject=0;
+static struct memorycontainer* moduleObjectCode=NULL;
+// Top level code of the module objects linked into the program, in the order that these were linked, and the next of these to
+// run. The objects that the imports of the program are linked as, indexed by the position of each import
+static struct memorycontainer** linkedModuleCode=NULL;
+static int numberLinkedModules=0, nextLinkedModuleToRun=0;
+static int * linkedModuleImports=NULL, numberLinkedModuleImports=0;
 
 struct function_call_tree_node mainCodeCallTree;
 
 static void determineUsedFunctions(void);
 static void processUsedFunction(struct functionDefinition*);
-static unsigned short findLocationOfLineNumber(struct lineDefinition*, int);
-static unsigned short findLocationOfFunctionName(struct lineDefinition*, char*, int, int);
+static unsigned short findLocationOfLineNumber(struct hash_table*, int);
+static unsigned short findLocationOfFunctionName(struct hash_table*, char*, int, int);
+static void indexLineDefinitions(struct lineDefinition*, struct hash_table*, struct hash_table*);
 static struct functionDefinition* findFunctionDefinition(char*);
 static int doesFunctionAlreadyExistInExportableTable(char*);
+static void threadJumpChains(struct memorycontainer*);
+static void inlineCalledFunctions(struct memorycontainer*);
+static void linkMemory(struct memorycontainer*, int);
+static struct memorycontainer* appendFunctionLocationMap(struct memorycontainer*);
+static int hasUnresolvedFunctionAddresses(struct module_object*);
 
-int getNumberOfSymbolEntriesNotUsed(void) {
-    int ignoreSymbolEntries=0;
-    struct functionListNode * fnHead=functionListHead;
-    while (fnHead != NULL) {
-        if (!fnHead->fn->called) ignoreSymbolEntries+=fnHead->fn->numberEntriesInSymbolTable;
-        fnHead=fnHead->next;
-    }
-    return ignoreSymbolEntries;
+/**
+ * Gets the number of symbol table entries required for the frames of all functions that are called
+ */
+int getNumberSymbolTableEntriesForCalledFunctions(void) {
+    return calledFunctionSymbolEntries;
 }
 
 /**
- * Compiles the memory by going through and resolving relative links (i.e. gotos) and adds a stop at the end
+ * Sets the number of symbol table entries required for the frames of called functions and of those which are recursive, this is
+ * used when the program is loaded rather than compiled
  */
-void compileMemory(struct memorycontainer* memory) {
+void setNumberSymbolTableEntriesForFunctions(int calledEntries, int recursiveEntries) {
+	calledFunctionSymbolEntries=calledEntries;
+	recursiveFunctionSymbolEntries=recursiveEntries;
+}
+
+/**
+ * Gets the compiled program before it was linked, this is NULL if the byte code was loaded rather than compiled
+ */
+struct memorycontainer* getUnlinkedMemory(void) {
+	return unlinkedMemory;
+}
+
+/**
+ * Sets the program before it was linked, from which byte code specialised to how it is run is produced
+ */
+void setUnlinkedMemory(struct memorycontainer* memory) {
+	unlinkedMemory=memory;
+}
+
+/**
+ * Sets whether the source being compiled is a module which is to be made into an object, rather than a program
+ */
+void setCompilingModuleObject(int compilingModule) {
+	compilingModuleObject=compilingModule;
+}
+
+/**
+ * Determines whether the source being compiled is a module which is to be made into an object
+ */
+int isCompilingModuleObject(void) {
+	return compilingModuleObject;
+}
+
+/**
+ * Gets the module object for the module which has been compiled, whose global variables were allocated slots from the first. The
+ * functions are held in the order that they were defined, so are added to the function list of a program in this order. Returns
+ * NULL if the module refers to a name which is neither one of its variables nor one of its functions, as compiled on its own this
+ * is taken to be the address of a function whereas it might be a variable which the program or another module assigns
+ */
+struct module_object* getCompiledModuleObject(void) {
+	struct functionListNode * fnHead;
 	int i;
+	struct module_object * object=(struct module_object*) arenaAllocate(sizeof(struct module_object));
+	object->numberGlobals=getNumberGlobalSymbolTableEntries();
+	object->globalNames=getGlobalVariableNames(0, (unsigned short) object->numberGlobals);
+	object->numberLabels=-1 - currentForLine;
+	object->numberRootCalls=mainCodeCallTree.number_of_calls;
+	object->rootCalls=mainCodeCallTree.calledFunctions;
+	object->code=moduleObjectCode;
+	if (object->code == NULL) {
+		object->code=(struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
+		object->code->length=0;
+		object->code->data=NULL;
+		object->code->lineDefns=NULL;
+	}
+	object->numberFunctions=0;
+	for (fnHead=functionListHead;fnHead != NULL;fnHead=fnHead->next) object->numberFunctions++;
+	object->functions=(struct functionDefinition**) arenaAllocate(sizeof(struct functionDefinition*) * (object->numberFunctions + 1));
+	for (i=object->numberFunctions-1, fnHead=functionListHead;fnHead != NULL;fnHead=fnHead->next, i--) object->functions[i]=fnHead->fn;
+	if (hasUnresolvedFunctionAddresses(object)) return NULL;
+	extractModuleObjectRelocations(object);
+	return object;
+}
+
+/**
+ * Determines whether the code of a module object takes the address of any function which is not defined in the module
+ */
+static int hasUnresolvedFunctionAddresses(struct module_object * object) {
+	struct memorycontainer ** blocks;
+	struct lineDefinition * root;
+	int i, numberBlocks, unresolved=0;
+	numberBlocks=getModuleObjectCodeBlocks(object, &blocks);
+	for (i=0;i<numberBlocks && !unresolved;i++) {
+		for (root=blocks[i]->lineDefns;root != NULL && !unresolved;root=root->next) {
+			unresolved=root->type == 4 && findFunctionDefinition(root->name) == NULL;
+		}
+	}
+	free(blocks);
+	return unresolved;
+}
+
+/**
+ * Links a module object, compiled from the source file at some path, into the program ahead of the program's own source code
+ * being parsed. The global variables of the module are given their slots in the program, its labels are numbered after those
+ * already used and its functions are added to the function list. Its top level code is kept to run where the program imports
+ * the module. Each object is only linked once
+ */
+void linkModuleObject(struct module_object * object, char * path) {
+	struct memorycontainer ** blocks;
+	struct lineDefinition * root;
+	unsigned short * globalSlots, index;
+	int i, numberBlocks;
+	globalSlots=(unsigned short*) malloc(sizeof(unsigned short) * (object->numberGlobals + 1));
+	for (i=0;i<object->numberGlobals;i++) globalSlots[i]=linkGlobalVariable(object->globalNames[i]);
+	numberBlocks=getModuleObjectCodeBlocks(object, &blocks);
+	for (i=0;i<object->numberRelocations;i++) {
+		struct module_relocation * relocation=&object->relocations[i];
+		memcpy(&index, &blocks[relocation->block]->data[relocation->position], sizeof(unsigned short));
+		memcpy(&blocks[relocation->block]->data[relocation->position], &globalSlots[index], sizeof(unsigned short));
+	}
+	// The labels of the module are numbered downwards from -1, as are those of the program
+	for (i=0;i<numberBlocks;i++) {
+		for (root=blocks[i]->lineDefns;root != NULL;root=root->next) {
+			if (root->type < 2 && root->linenumber < 0) root->linenumber+=currentForLine + 1;
+		}
+	}
+	currentForLine-=object->numberLabels;
+	for (i=0;i<object->numberFunctions;i++) {
+		addFunction(object->functions[i]);
+		addFunctionSource(object->functions[i]->name, path);
+	}
+	for (i=0;i<object->numberRootCalls;i++) mainCodeCallTree.calledFunctions[mainCodeCallTree.number_of_calls++]=object->rootCalls[i];
+	linkedModuleCode=(struct memorycontainer**) realloc(linkedModuleCode, sizeof(struct memorycontainer*) * (numberLinkedModules + 1));
+	linkedModuleCode[numberLinkedModules++]=object->code;
+	free(blocks);
+	free(globalSlots);
+}
+
+/**
+ * Sets the module object, by the order it is linked in, that an import of the program (by its position) is linked as
+ */
+void setLinkedModuleImport(int importIndex, int objectIndex) {
+	if (importIndex >= numberLinkedModuleImports) {
+		linkedModuleImports=(int*) realloc(linkedModuleImports, sizeof(int) * (importIndex + 1));
+		numberLinkedModuleImports=importIndex + 1;
+	}
+	linkedModuleImports[importIndex]=objectIndex;
+}
+
+/**
+ * Gets the code which runs in place of a call to some function if this call marks an import of the program, or NULL if it does
+ * not. This is the top level code of the module and, as when their source was included, that of the modules linked before it
+ * which have not yet run. The code of each module only runs once, so later imports of it are empty
+ */
+struct memorycontainer* getLinkedModuleImportCode(char * functionName) {
+	struct memorycontainer* memoryContainer=NULL;
+	size_t markerLength=strlen(LINKED_MODULE_IMPORT_MARKER);
+	int importIndex;
+	if (strncmp(functionName, LINKED_MODULE_IMPORT_MARKER, markerLength) != 0) return NULL;
+	importIndex=atoi(&functionName[markerLength]);
+	if (importIndex < numberLinkedModuleImports) {
+		for (;nextLinkedModuleToRun <= linkedModuleImports[importIndex] && nextLinkedModuleToRun < numberLinkedModules;nextLinkedModuleToRun++) {
+			if (linkedModuleCode[nextLinkedModuleToRun]->length > 0) {
+				memoryContainer=concatenateMemory(memoryContainer, linkedModuleCode[nextLinkedModuleToRun]);
+			}
+		}
+	}
+	if (memoryContainer == NULL) {
+		memoryContainer=(struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
+		memoryContainer->length=0;
+		memoryContainer->data=NULL;
+		memoryContainer->lineDefns=NULL;
+	}
+	return memoryContainer;
+}
+
+/**
+ * Compiles the memory by going through and resolving relative links (i.e. gotos) and adds a stop at the end. The byte code, and
+ * the program before it was linked, are copied into the program arena as these outlive the arena of the compiler
+ */
+void compileMemory(struct memorycontainer* memory) {
+	struct memorycontainer* compiledMem;
+	struct memory_arena * compilerArena;
+	struct functionListNode * fnHead;
+	if (compilingModuleObject) {
+		moduleObjectCode=memory;
+		return;
+	}
 	determineUsedFunctions();
 	struct memorycontainer* stopStatement=appendStopStatement();
+	programBytesOptimisedAway=bytesOptimisedAway;
 	if (memory != NULL) {
-		struct memorycontainer* compiledMem=concatenateMemory(memory, stopStatement);
-		struct functionListNode * fnHead=functionListHead;
+		inlineCalledFunctions(memory);
+		// Loop invariants are hoisted before the header is created, as this holds the number of global variables
+		unsigned int unhoistedLength=memory->length;
+		memory=hoistLoopInvariants(memory, 0);
+		programBytesOptimisedAway-=memory->length - unhoistedLength;
+		// The program is put together once all of its parts are known, so each is only copied into the byte code once
+		struct stack_t * programParts=getNewStack();
+		pushExpression(programParts, appendProgramHeader());
+		pushExpression(programParts, memory);
+		pushExpression(programParts, stopStatement);
+		fnHead=functionListHead;
 		while (fnHead != NULL) {
-			if (fnHead->fn->called) compiledMem=concatenateMemory(compiledMem, fnHead->fn->contents);
-			if (fnHead->fn->functionCalls != NULL) {
-				for (i=0;i<fnHead->fn->number_of_fn_calls;i++) {
-					free(fnHead->fn->functionCalls[i]);
-				}
-				free(fnHead->fn->functionCalls);
+			if (fnHead->fn->called) {
+				unhoistedLength=fnHead->fn->contents->length;
+				fnHead->fn->contents=hoistLoopInvariants(fnHead->fn->contents, 1);
+				fnHead->fn->numberEntriesInSymbolTable=((unsigned short*) fnHead->fn->contents->data)[1];
+				programBytesOptimisedAway-=fnHead->fn->contents->length - unhoistedLength;
+				pushExpression(programParts, fnHead->fn->contents);
+			} else {
+				programBytesOptimisedAway-=fnHead->fn->bytesOptimisedAway;
 			}
 			fnHead=fnHead->next;
 		}
-		struct lineDefinition * root=compiledMem->lineDefns, *r2;
-		while (root != NULL) {
-			if (root->type==1) {
-				unsigned short lineLocation=findLocationOfLineNumber(compiledMem->lineDefns, root->linenumber);
+		compiledMem=concatenateMemoryList(programParts);
+		compilerArena=setCurrentArena(NULL);
+		unlinkedMemory=cloneMemoryWithLineDefinitions(compiledMem);
+		setCurrentArena(compilerArena);
+		inferExpressionTypes(compiledMem);
+		linkMemory(compiledMem, 1);
+	} else {
+		compiledMem=concatenateMemory(appendProgramHeader(), stopStatement);
+	}
+	compilerArena=setCurrentArena(NULL);
+	assembledMemory=cloneMemory(compiledMem);
+	assembledMemory->lineDefns=NULL;
+	setCurrentArena(compilerArena);
+	for (fnHead=functionListHead;fnHead != NULL;fnHead=fnHead->next) {
+		if (fnHead->fn->called) calledFunctionSymbolEntries+=fnHead->fn->numberEntriesInSymbolTable;
+		if (fnHead->fn->recursive && fnHead->fn->called) recursiveFunctionSymbolEntries+=fnHead->fn->numberEntriesInSymbolTable;
+	}
+	functionListHead=NULL;
+	freeHashTable(functionDefinitionTable);
+	functionDefinitionTable=NULL;
+}
+
+/**
+ * Resolves the relative links of the compiled memory (i.e. gotos and function calls) to locations in the byte code, and threads
+ * jumps to jumps. Functions are optionally added to the exportable function table
+ */
+static void linkMemory(struct memorycontainer* compiledMem, int registerExportable) {
+	struct lineDefinition * root;
+	struct hash_table * labels=createHashTable(0), * functionStarts=createHashTable(0);
+	indexLineDefinitions(compiledMem->lineDefns, labels, functionStarts);
+	for (root=compiledMem->lineDefns;root != NULL;root=root->next) {
+		if (root->type==1) {
+			unsigned short lineLocation=findLocationOfLineNumber(labels, root->linenumber);
+			memcpy(&compiledMem->data[root->currentpoint], &lineLocation, sizeof(unsigned short));
+		} else if (root->type==3 || root->type==4 || root->type==2) {
+			unsigned short lineLocation=findLocationOfFunctionName(functionStarts, root->name, root->linenumber, root->type==4);
+			if (root->type==3 || root->type==4) {
 				memcpy(&compiledMem->data[root->currentpoint], &lineLocation, sizeof(unsigned short));
-			} else if (root->type==3 || root->type==4 || root->type==2) {
-				unsigned short lineLocation=findLocationOfFunctionName(compiledMem->lineDefns, root->name, root->linenumber, root->type==4);
-				if (root->type==3 || root->type==4) {
-					memcpy(&compiledMem->data[root->currentpoint], &lineLocation, sizeof(unsigned short));
-				}
-				if (!doesFunctionAlreadyExistInExportableTable(root->name)) {
-					struct exportableFunctionTableNode* newExportableNode=(struct exportableFunctionTableNode*) malloc(sizeof(struct exportableFunctionTableNode));
-					newExportableNode->functionLocation=lineLocation;
-					newExportableNode->functionName=(char*) malloc(strlen(root->name)+1);
-					strcpy(newExportableNode->functionName, root->name);
-					newExportableNode->next=exportableFunctionTable;
-					exportableFunctionTable=newExportableNode;
-					numberExportableFunctionsInTable++;
-				}
 			}
-			root=root->next;
+			if (registerExportable && !doesFunctionAlreadyExistInExportableTable(root->name)) {
+				addExportableFunction(root->name, lineLocation);
+			}
 		}
-		// Clear up the memory used for these line definition nodes
-		root=compiledMem->lineDefns;
-		while (root != NULL) {
-			r2=root->next;
-			free(root);
-			root=r2;
+	}
+	freeHashTable(labels);
+	freeHashTable(functionStarts);
+	threadJumpChains(compiledMem);
+}
+
+/**
+ * Adds a function and its location in the byte code to the exportable function table
+ */
+void addExportableFunction(char * functionName, unsigned short functionLocation) {
+	struct exportableFunctionTableNode* newExportableNode=(struct exportableFunctionTableNode*) malloc(sizeof(struct exportableFunctionTableNode));
+	newExportableNode->functionLocation=functionLocation;
+	newExportableNode->functionName=(char*) malloc(strlen(functionName)+1);
+	strcpy(newExportableNode->functionName, functionName);
+	newExportableNode->next=exportableFunctionTable;
+	exportableFunctionTable=newExportableNode;
+	numberExportableFunctionsInTable++;
+	if (exportableFunctionNames == NULL) exportableFunctionNames=createHashTable(0);
+	putHashTableEntry(exportableFunctionNames, functionName, newExportableNode);
+}
+
+/**
+ * Indexes the labels of the line definitions by their line id and the function starts by their name, the first of these
+ * in the list is the one that is linked to
+ */
+static void indexLineDefinitions(struct lineDefinition * root, struct hash_table * labels, struct hash_table * functionStarts) {
+	for (;root != NULL;root=root->next) {
+		if (root->type==0 && getHashTableNumberEntry(labels, root->linenumber) == NULL) {
+			putHashTableNumberEntry(labels, root->linenumber, root);
+		} else if (root->type==2 && getHashTableEntry(functionStarts, root->name) == NULL) {
+			putHashTableEntry(functionStarts, root->name, root);
 		}
-		assembledMemory=compiledMem;
-	} else {
-		assembledMemory=stopStatement;
+	}
+}
+
+/**
+ * Gets a copy of the assembled byte code specialised to being run on the host or a device, and if known the id of the core and
+ * number of cores (these are negative otherwise), setting its length. This is produced from the program before it was linked,
+ * so returns NULL if there is not one (when the byte code was loaded rather than compiled) or if nothing was specialised, in
+ * which case the assembled byte code is run as it is. The code which is removed is taken out, so functions move from their
+ * locations in the exportable function table
+ */
+char* getSpecialisedByteCode(int isHost, int coreId, int numberCores, unsigned int* length) {
+	struct memorycontainer* specialisedMem;
+	struct memory_arena * specialisationArena, * previousArena;
+	char * code=NULL;
+	if (unlinkedMemory == NULL) return NULL;
+	// The copy is rewritten and linked in an arena of its own, which is released once the byte code has been copied out of it
+	specialisationArena=createArena();
+	previousArena=setCurrentArena(specialisationArena);
+	specialisedMem=cloneMemoryWithLineDefinitions(unlinkedMemory);
+	if (specialiseByteCode(specialisedMem, isHost, coreId, numberCores) != 0) {
+		inferExpressionTypes(specialisedMem);
+		linkMemory(specialisedMem, 0);
+		specialisedMem=appendFunctionLocationMap(specialisedMem);
+		code=(char*) malloc(specialisedMem->length);
+		memcpy(code, specialisedMem->data, specialisedMem->length);
+		*length=specialisedMem->length;
+	}
+	setCurrentArena(previousArena);
+	freeArena(specialisationArena);
+	return code;
+}
+
+/**
+ * Links the function addresses in byte code specialised to how it is run to the locations of the functions in the generic byte
+ * code, as these addresses are passed between cores whose byte code differs. The code is followed by a map from the generic
+ * location to the location in this code of each function which has moved, for the interpreter to look up when calling a function
+ * by its address. Returns the code as it is if no function has moved
+ */
+static struct memorycontainer* appendFunctionLocationMap(struct memorycontainer* code) {
+	struct memorycontainer* memoryContainer;
+	struct exportableFunctionTableNode * exportedFunction;
+	struct lineDefinition * root;
+	unsigned short * locations, location, numberGlobals, numberLocations=0;
+	int i, numberFunctions=0;
+	for (root=code->lineDefns;root != NULL;root=root->next) {
+		if (root->type == 2) numberFunctions++;
+	}
+	locations=(unsigned short*) malloc(sizeof(unsigned short) * 2 * (numberFunctions + 1));
+	for (root=code->lineDefns;root != NULL;root=root->next) {
+		if (root->type != 2 && root->type != 4) continue;
+		exportedFunction=(struct exportableFunctionTableNode*) getHashTableEntry(exportableFunctionNames, root->name);
+		if (exportedFunction == NULL) continue;
+		if (root->type == 4) {
+			memcpy(&code->data[root->currentpoint], &exportedFunction->functionLocation, sizeof(unsigned short));
+			continue;
+		}
+		location=(unsigned short) root->currentpoint;
+		if (exportedFunction->functionLocation == location) continue;
+		for (i=0;i<numberLocations && locations[i*2] != exportedFunction->functionLocation;i++);
+		if (i < numberLocations) continue;
+		locations[numberLocations*2]=exportedFunction->functionLocation;
+		locations[numberLocations*2+1]=location;
+		numberLocations++;
+	}
+	if (numberLocations == 0) {
+		free(locations);
+		return code;
+	}
+	memoryContainer=(struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
+	memoryContainer->length=code->length + sizeof(unsigned short) * (numberLocations * 2 + 1);
+	memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
+	memoryContainer->lineDefns=NULL;
+	memcpy(memoryContainer->data, code->data, code->length);
+	memcpy(&memoryContainer->data[code->length], locations, sizeof(unsigned short) * numberLocations * 2);
+	memcpy(&memoryContainer->data[memoryContainer->length - sizeof(unsigned short)], &numberLocations, sizeof(unsigned short));
+	memcpy(&numberGlobals, memoryContainer->data, sizeof(unsigned short));
+	numberGlobals|=FUNCTION_LOCATION_MAP_FLAG;
+	memcpy(memoryContainer->data, &numberGlobals, sizeof(unsigned short));
+	free(locations);
+	return memoryContainer;
+}
+
+/**
+ * Clones memory along with its line definitions, which are kept in the same order, so that this can be rewritten and linked
+ * without affecting the original
+ */
+struct memorycontainer* cloneMemoryWithLineDefinitions(struct memorycontainer* m1) {
+	struct memorycontainer* memoryContainer=cloneMemory(m1);
+	struct lineDefinition * root, * defn, ** tail=&memoryContainer->lineDefns;
+	for (root=m1->lineDefns;root != NULL;root=root->next) {
+		defn=(struct lineDefinition*) arenaAllocate(sizeof(struct lineDefinition));
+		memcpy(defn, root, sizeof(struct lineDefinition));
+		if (root->type > 1 && root->name != NULL) defn->name=arenaDuplicateString(root->name);
+		*tail=defn;
+		tail=&defn->next;
+	}
+	*tail=NULL;
+	return memoryContainer;
+}
+
+/**
+ * Inlines calls to small functions throughout the code and then determines which functions are still called, as those which were
+ * only called from inlined sites are no longer needed. The bytes which these took up are counted as optimised away
+ */
+static void inlineCalledFunctions(struct memorycontainer* memory) {
+	struct functionListNode * fnHead;
+	unsigned int originalLength;
+	int inlinedInFunction, inlinedInPass;
+	numberInlinedCallSites=0;
+	do {
+		// Functions can become small enough to inline once the calls in them have been, so these are repeated until nothing changes
+		inlinedInPass=0;
+		for (fnHead=functionListHead;fnHead != NULL;fnHead=fnHead->next) {
+			originalLength=fnHead->fn->contents->length;
+			inlinedInFunction=inlineFunctionCalls(fnHead->fn->contents, 1, fnHead->fn->functionCalls, &fnHead->fn->number_of_fn_calls);
+			if (inlinedInFunction == 0) continue;
+			fnHead->fn->bytesOptimisedAway+=originalLength - fnHead->fn->contents->length;
+			programBytesOptimisedAway+=originalLength - fnHead->fn->contents->length;
+			updateInlineableBody(fnHead->fn);
+			inlinedInPass+=inlinedInFunction;
+		}
+		numberInlinedCallSites+=inlinedInPass;
+	} while (inlinedInPass > 0);
+	originalLength=memory->length;
+	numberInlinedCallSites+=inlineFunctionCalls(memory, 0, mainCodeCallTree.calledFunctions, &mainCodeCallTree.number_of_calls);
+	programBytesOptimisedAway+=originalLength - memory->length;
+	if (numberInlinedCallSites == 0) return;
+	int i, numberFunctions=0;
+	for (fnHead=functionListHead;fnHead != NULL;fnHead=fnHead->next) numberFunctions++;
+	char * previouslyCalled=(char*) malloc(numberFunctions + 1);
+	for (i=0, fnHead=functionListHead;fnHead != NULL;fnHead=fnHead->next, i++) {
+		previouslyCalled[i]=(char) fnHead->fn->called;
+		fnHead->fn->called=0;
+	}
+	determineUsedFunctions();
+	for (i=0, fnHead=functionListHead;fnHead != NULL;fnHead=fnHead->next, i++) {
+		if (previouslyCalled[i] && !fnHead->fn->called) {
+			programBytesOptimisedAway+=fnHead->fn->contents->length + fnHead->fn->bytesOptimisedAway;
+		}
+	}
+	free(previouslyCalled);
+}
+
+/**
+ * Threads jumps which land on another jump, such as the end of a conditional inside a loop, so that these go straight to the
+ * final target. Every goto has a line definition for its target and the targets are always at the start of a statement
+ */
+static void threadJumpChains(struct memorycontainer* compiledMem) {
+	struct lineDefinition * root;
+	unsigned short target, nextTarget;
+	int hops;
+	for (root=compiledMem->lineDefns;root != NULL;root=root->next) {
+		if (root->type != 1) continue;
+		memcpy(&target, &compiledMem->data[root->currentpoint], sizeof(unsigned short));
+		// Bounded as a loop made up only of jumps would otherwise be followed forever
+		for (hops=0;hops < 16 && target + sizeof(unsigned char) + sizeof(unsigned short) <= compiledMem->length &&
+				compiledMem->data[target] == GOTO_TOKEN;hops++) {
+			memcpy(&nextTarget, &compiledMem->data[target+sizeof(unsigned char)], sizeof(unsigned short));
+			if (nextTarget == target) break;
+			target=nextTarget;
+		}
+		memcpy(&compiledMem->data[root->currentpoint], &target, sizeof(unsigned short));
 	}
 }
 
@@ -116,12 +528,7 @@ void compileMemory(struct memorycontainer* memory) {
 * Determines whether a specific function of a specific name already exists in the exportable global function table
 */
 static int doesFunctionAlreadyExistInExportableTable(char* functionName) {
-	struct exportableFunctionTableNode* root=exportableFunctionTable;
-	while (root != NULL) {
-		if (strcmp(root->functionName, functionName) == 0) return 1;
-		root=root->next;
-	}
-	return 0;
+	return exportableFunctionNames != NULL && getHashTableEntry(exportableFunctionNames, functionName) != NULL;
 }
 
 /**
@@ -158,51 +565,56 @@ static void processUsedFunction(struct functionDefinition* specificFunction) {
  * Adds a function to the function list which are all combined in the compile memory function
  */
 void addFunction(struct functionDefinition* functionDefintion) {
-	struct functionListNode * node=(struct functionListNode*) malloc(sizeof(struct functionListNode));
+	struct functionListNode * node=(struct functionListNode*) arenaAllocate(sizeof(struct functionListNode));
 	node->fn=functionDefintion;
 	node->next=functionListHead;
 	functionListHead=node;
+	if (functionDefinitionTable == NULL) functionDefinitionTable=createHashTable(0);
+	putHashTableEntry(functionDefinitionTable, functionDefintion->name, functionDefintion);
+}
+
+/**
+ * Determines whether a function has been marked as having no side effects, so calls to it can be moved out of loops
+ */
+int isFunctionSideEffectFree(char * functionName) {
+	struct functionDefinition* defn=findFunctionDefinition(functionName);
+	return defn != NULL && defn->sideEffectFree;
+}
+
+/**
+ * Gets the definition of a function whose body can be inlined at calls to it, or NULL if there is not one
+ */
+struct functionDefinition* getInlineableFunction(char * functionName) {
+	struct functionDefinition* defn=findFunctionDefinition(functionName);
+	return defn != NULL && defn->inlineBody != NULL ? defn : NULL;
 }
 
 static struct functionDefinition* findFunctionDefinition(char * functionName) {
-	struct functionListNode * node=functionListHead;
-	while (node != NULL) {
-		if (strcmp(node->fn->name, functionName) == 0) return node->fn;
-		node=node->next;
-	}
-	return NULL;
+	if (functionDefinitionTable == NULL) return NULL;
+	return (struct functionDefinition*) getHashTableEntry(functionDefinitionTable, functionName);
 }
 
 int getNumberSymbolTableEntriesForRecursion(void) {
-	int r=0;
-	struct functionListNode * fnHead=functionListHead;
-	while (fnHead != NULL) {
-		if (fnHead->fn->recursive && fnHead->fn->called) r+=fnHead->fn->numberEntriesInSymbolTable;
-		fnHead=fnHead->next;
-	}
-	return r;
+	return recursiveFunctionSymbolEntries;
 }
 
 /**
- * Given a line number will return the byte location of this in the memory
+ * Given a line number will return the byte location of this in the memory, from the labels indexed by their line number
  */
-static unsigned short findLocationOfLineNumber(struct lineDefinition * root, int lineNumber) {
-	while (root != NULL) {
-		if (root->type==0 && root->linenumber == lineNumber) return (unsigned short) root->currentpoint;
-		root=root->next;
-	}
+static unsigned short findLocationOfLineNumber(struct hash_table * labels, int lineNumber) {
+	struct lineDefinition * label=(struct lineDefinition*) getHashTableNumberEntry(labels, lineNumber);
+	if (label != NULL) return (unsigned short) label->currentpoint;
 	fprintf(stderr, "Can not find line %d in goto\n", lineNumber);
 	exit(0);
 }
 
 /**
- * Finds the location of a function name and returns this or raises an error if the function is not found
+ * Finds the location of a function name, from the function starts indexed by their name, and returns this or raises an error
+ * if the function is not found
  */
-static unsigned short findLocationOfFunctionName(struct lineDefinition * root, char * functionName, int line_num_for_error, int isvarorfn) {
-	while (root != NULL) {
-		if (root->type==2 && strcmp(root->name, functionName) == 0) return (unsigned short) root->currentpoint;
-		root=root->next;
-	}
+static unsigned short findLocationOfFunctionName(struct hash_table * functionStarts, char * functionName, int line_num_for_error, int isvarorfn) {
+	struct lineDefinition * functionStart=(struct lineDefinition*) getHashTableEntry(functionStarts, functionName);
+	if (functionStart != NULL) return (unsigned short) functionStart->currentpoint;
 	if (isvarorfn) {
         fprintf(stderr, "Can not find variable or function '%s' in assignment at line number %d\n", functionName, line_num_for_error);
 	} else {
@@ -217,9 +629,9 @@ static unsigned short findLocationOfFunctionName(struct lineDefinition * root, c
 struct memorycontainer* concatenateMemory(struct memorycontainer* m1, struct memorycontainer* m2) {
 	if (m1 == NULL) return m2;
 	if (m2 == NULL) return m1;
-	struct memorycontainer* memoryContainer = (struct memorycontainer*) malloc(sizeof(struct memorycontainer));
+	struct memorycontainer* memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
 	memoryContainer->length=m1->length + m2->length;
-	memoryContainer->data=malloc(memoryContainer->length);
+	memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
 	memoryContainer->lineDefns=m1->lineDefns;
 	if (m1->data != NULL && m1->length > 0) memcpy(memoryContainer->data, m1->data, m1->length);
 	if (m2->data != NULL && m2->length > 0) memcpy(&memoryContainer->data[m1->length], m2->data, m2->length);
@@ -231,18 +643,53 @@ struct memorycontainer* concatenateMemory(struct memorycontainer* m1, struct mem
 		memoryContainer->lineDefns=root;
 		root=r2;
 	}
-	// Free up the m1 and m2 memory
-	free(m1->data);
-	free(m1);
-	free(m2->data);
-	free(m2);
+	return memoryContainer;
+}
+
+/**
+ * Concatenates a list of memory structures, any of which might be NULL, together and returns the result of this. Each is copied
+ * once, so building up a long sequence of statements this way takes linear time where pairwise concatenation would be quadratic.
+ * The list and the memory structures are not used afterwards, and the result is NULL if there are none
+ */
+struct memorycontainer* concatenateMemoryList(struct stack_t* list) {
+	struct memorycontainer* memoryContainer=NULL, * m;
+	struct lineDefinition * root, *r2;
+	unsigned int position=0;
+	int i;
+	for (i=0;i<getStackSize(list);i++) {
+		m=getExpressionAt(list, i);
+		if (m == NULL) continue;
+		if (memoryContainer == NULL) {
+			memoryContainer=(struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
+			memoryContainer->length=0;
+			memoryContainer->lineDefns=NULL;
+		}
+		memoryContainer->length+=m->length;
+	}
+	if (memoryContainer != NULL) {
+		memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
+		for (i=0;i<getStackSize(list);i++) {
+			m=getExpressionAt(list, i);
+			if (m == NULL) continue;
+			if (m->data != NULL && m->length > 0) memcpy(&memoryContainer->data[position], m->data, m->length);
+			root=m->lineDefns;
+			while (root != NULL) {
+				root->currentpoint+=position;
+				r2=root->next;
+				root->next=memoryContainer->lineDefns;
+				memoryContainer->lineDefns=root;
+				root=r2;
+			}
+			position+=m->length;
+		}
+	}
 	return memoryContainer;
 }
 
 struct memorycontainer* cloneMemory(struct memorycontainer* m1) {
-	struct memorycontainer* memoryContainer = (struct memorycontainer*) malloc(sizeof(struct memorycontainer));
+	struct memorycontainer* memoryContainer = (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
 	memoryContainer->length=m1->length;
-	memoryContainer->data=malloc(memoryContainer->length);
+	memoryContainer->data=(char*) arenaAllocate(memoryContainer->length);
 	memoryContainer->lineDefns=m1->lineDefns;
 	if (m1->data != NULL && m1->length > 0) memcpy(memoryContainer->data, m1->data, m1->length);
 	return memoryContainer;
@@ -281,13 +728,23 @@ unsigned int appendMemory(struct memorycontainer* memory, struct memorycontainer
 		root=r2;
 	}
 	position+=statement->length;
-
-	// Free up the statement memory
-	free(statement->data);
-	free(statement);
 	return position;
 }
 
+/**
+ * Gets the length that the assembled memory would have been without the optimisations applied as it was assembled
+ */
+unsigned int getUnoptimisedMemorySize() {
+	return getMemoryFilledSize() + programBytesOptimisedAway;
+}
+
+/**
+ * Gets the number of calls which have been inlined
+ */
+int getNumberInlinedCallSites() {
+	return numberInlinedCallSites;
+}
+
 /**
  * Gets the length of the assembled memory
  */
@@ -300,7 +757,7 @@ unsigned int getMemoryFilledSize() {
  * Sets the length of the assembled memory (when loading from bytecode file)
  */
 void setMemoryFilledSize(unsigned int size) {
-	if (assembledMemory == NULL) assembledMemory= (struct memorycontainer*) malloc(sizeof(struct memorycontainer));
+	if (assembledMemory == NULL) assembledMemory= (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
 	assembledMemory->length=size;
 }
 
@@ -316,6 +773,6 @@ char * getAssembledCode() {
  * Sets the code in the assembled memory (when loading from bytecode file)
  */
 void setAssembledCode(char * a) {
-	if (assembledMemory == NULL) assembledMemory= (struct memorycontainer*) malloc(sizeof(struct memorycontainer));
+	if (assembledMemory == NULL) assembledMemory= (struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
 	assembledMemory->data=a;
 }
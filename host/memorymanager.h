@@ -28,6 +28,10 @@
 #define MEMORYMANAGER_H_
 
 #include "byteassembler.h"
+#include "moduleobject.h"
+
+// Name of the function that a call marking where an imported module's top level code runs calls, followed by the import's index
+#define LINKED_MODULE_IMPORT_MARKER "__linkedmoduleimport"
 
 // Used to maintain a linked list of functions
 struct functionListNode {
@@ -44,19 +48,36 @@ struct exportableFunctionTableNode {
 extern struct exportableFunctionTableNode* exportableFunctionTable;
 extern int numberExportableFunctionsInTable;
 
-int getNumberOfSymbolEntriesNotUsed(void);
+int getNumberSymbolTableEntriesForCalledFunctions(void);
 void addFunction(struct functionDefinition*);
 int getNumberSymbolTableEntriesForRecursion(void);
+void setNumberSymbolTableEntriesForFunctions(int, int);
+int isFunctionSideEffectFree(char*);
+struct functionDefinition* getInlineableFunction(char*);
 void compileMemory(struct memorycontainer*);
 struct memorycontainer* concatenateMemory(struct memorycontainer*, struct memorycontainer*);
+struct memorycontainer* concatenateMemoryList(struct stack_t*);
 struct memorycontainer* cloneMemory(struct memorycontainer*);
+struct memorycontainer* cloneMemoryWithLineDefinitions(struct memorycontainer*);
 unsigned int appendStatement(struct memorycontainer*, unsigned char, unsigned int);
 unsigned int appendMemory(struct memorycontainer*, struct memorycontainer*, unsigned int);
 unsigned int appendVariable(struct memorycontainer*, unsigned short, unsigned int);
 unsigned int getMemoryFilledSize(void);
+unsigned int getUnoptimisedMemorySize(void);
+int getNumberInlinedCallSites(void);
 void setMemoryFilledSize(unsigned int);
 char * getAssembledCode(void);
 void setAssembledCode(char*);
+char* getSpecialisedByteCode(int, int, int, unsigned int*);
+struct memorycontainer* getUnlinkedMemory(void);
+void setUnlinkedMemory(struct memorycontainer*);
+void addExportableFunction(char*, unsigned short);
+void setCompilingModuleObject(int);
+int isCompilingModuleObject(void);
+struct module_object* getCompiledModuleObject(void);
+void linkModuleObject(struct module_object*, char*);
+void setLinkedModuleImport(int, int);
+struct memorycontainer* getLinkedModuleImportCode(char*);
 
 extern struct function_call_tree_node mainCodeCallTree;
 
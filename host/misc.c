@@ -37,6 +37,18 @@ void errorCheck(int value, char * errorMessage) {
     }
 }
 
+/**
+ * Continues a 64 bit FNV-1a hash with some bytes, the hash is started from HASH_BYTES_OFFSET_BASIS
+ */
+unsigned long long hashBytes(unsigned long long hash, const void * bytes, size_t length) {
+	size_t i;
+	for (i=0;i<length;i++) {
+		hash^=((const unsigned char*) bytes)[i];
+		hash*=1099511628211ULL;
+	}
+	return hash;
+}
+
 char* translateErrorCodeToMessage(unsigned char errorCode) {
     char * errorMessage=NULL;
     switch (errorCode) {
@@ -109,6 +121,9 @@ char* translateErrorCodeToMessage(unsigned char errorCode) {
     case ERR_NBSEND_NOT_SUPPORTED:
         errorMessage="Non-blocking sends between device and virtual cores on the host are not yet supported";
         break;
+    case ERR_SYMBOL_TABLE_FULL:
+        errorMessage="Out of symbol table space, function calls are nested too deeply";
+        break;
     }
     if (errorMessage != NULL) {
         char * msgToRet=(char*) malloc(strlen(errorMessage) + 1);
@@ -43,7 +43,13 @@
 #define LOG10_MATHS_OP 13
 #define RANDOM_MATHS_OP 14
 
+#include <stddef.h>
+
+// Starting value of a 64 bit FNV-1a hash, which hashBytes continues
+#define HASH_BYTES_OFFSET_BASIS 14695981039346656037ULL
+
 void errorCheck(int, char*);
 char* translateErrorCodeToMessage(unsigned char);
+unsigned long long hashBytes(unsigned long long, const void*, size_t);
 
 #endif /* CONFIGURATION_H_ */
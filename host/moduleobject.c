@@ -0,0 +1,376 @@
+/*
+ * Copyright (c) 2016, Nick Brown
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Module objects, which are imported modules compiled once on their own and then linked into each program which imports them
+ * rather than the source of the module being included in the program and compiled along with it
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "moduleobject.h"
+#include "arena.h"
+
+#define MODULE_OBJECT_MAGIC 0x4F595045
+#define MODULE_OBJECT_VERSION 1
+
+// Header at the start of a module object file, which is followed by the global variable names, the calls made from the top
+// level code, the top level code, the functions and then the relocations
+struct module_object_header {
+	unsigned int magic, version;
+	int numberGlobals, numberLabels, numberRootCalls, numberFunctions, numberRelocations;
+};
+
+// A function as held in the file, this is followed by its name, the names of the functions it calls, its contents and then its
+// inlineable body if it has one
+struct module_object_function {
+	int numberEntriesInSymbolTable, recursive, numberCalls;
+	unsigned int bytesOptimisedAway;
+	char sideEffectFree, hasInlineBody;
+};
+
+// A block of code as held in the file, this is followed by the code and then each of its line definitions
+struct module_object_block {
+	unsigned int length, numberLineDefinitions;
+};
+
+// A line definition as held in the file, this is followed by its name
+struct module_object_line_definition {
+	int linenumber, currentpoint;
+	char type;
+};
+
+// The contents of a module object file which has been read in, and the position that these are being read from
+struct module_object_reader {
+	char * data;
+	size_t length, position;
+	int failed;
+};
+
+static void writeModuleObjectString(FILE*, char*);
+static void writeModuleObjectBlock(FILE*, struct memorycontainer*);
+static void readModuleObjectBytes(struct module_object_reader*, void*, size_t);
+static char* readModuleObjectString(struct module_object_reader*);
+static char** readModuleObjectStrings(struct module_object_reader*, int);
+static struct memorycontainer* readModuleObjectBlock(struct module_object_reader*);
+static struct functionDefinition* readModuleObjectFunction(struct module_object_reader*);
+
+/**
+ * Writes a module object to a file, this is written to a temporary file which is then renamed so that a partially written
+ * object is never read. Returns 1 if the object was written or 0 otherwise
+ */
+int writeModuleObject(char * objectFilename, struct module_object * object) {
+	struct module_object_header header;
+	struct module_object_function functionInFile;
+	int i, j, written;
+	char * temporaryFilename=(char*) malloc(strlen(objectFilename) + 24);
+	sprintf(temporaryFilename, "%s.%d.tmp", objectFilename, (int) getpid());
+	FILE * objectFile=fopen(temporaryFilename, "wb");
+	if (objectFile == NULL) {
+		free(temporaryFilename);
+		return 0;
+	}
+	memset(&header, 0, sizeof(struct module_object_header));
+	header.magic=MODULE_OBJECT_MAGIC;
+	header.version=MODULE_OBJECT_VERSION;
+	header.numberGlobals=object->numberGlobals;
+	header.numberLabels=object->numberLabels;
+	header.numberRootCalls=object->numberRootCalls;
+	header.numberFunctions=object->numberFunctions;
+	header.numberRelocations=object->numberRelocations;
+	fwrite(&header, sizeof(struct module_object_header), 1, objectFile);
+	for (i=0;i<object->numberGlobals;i++) writeModuleObjectString(objectFile, object->globalNames[i]);
+	for (i=0;i<object->numberRootCalls;i++) writeModuleObjectString(objectFile, object->rootCalls[i]);
+	writeModuleObjectBlock(objectFile, object->code);
+	for (i=0;i<object->numberFunctions;i++) {
+		struct functionDefinition * fn=object->functions[i];
+		memset(&functionInFile, 0, sizeof(struct module_object_function));
+		functionInFile.numberEntriesInSymbolTable=fn->numberEntriesInSymbolTable;
+		functionInFile.recursive=fn->recursive;
+		functionInFile.numberCalls=fn->functionCalls != NULL ? fn->number_of_fn_calls : 0;
+		functionInFile.bytesOptimisedAway=fn->bytesOptimisedAway;
+		functionInFile.sideEffectFree=fn->sideEffectFree;
+		functionInFile.hasInlineBody=fn->inlineBody != NULL;
+		fwrite(&functionInFile, sizeof(struct module_object_function), 1, objectFile);
+		writeModuleObjectString(objectFile, fn->name);
+		for (j=0;j<functionInFile.numberCalls;j++) writeModuleObjectString(objectFile, fn->functionCalls[j]);
+		writeModuleObjectBlock(objectFile, fn->contents);
+		if (fn->inlineBody != NULL) writeModuleObjectBlock(objectFile, fn->inlineBody);
+	}
+	fwrite(object->relocations, sizeof(struct module_relocation), object->numberRelocations, objectFile);
+	written=!ferror(objectFile);
+	if (fclose(objectFile) != 0) written=0;
+	if (written) written=rename(temporaryFilename, objectFilename) == 0;
+	if (!written) unlink(temporaryFilename);
+	free(temporaryFilename);
+	return written;
+}
+
+/**
+ * Reads a module object from a file, which is allocated from the current arena. Returns NULL if there is not a file or if it
+ * is not a valid module object
+ */
+struct module_object* readModuleObject(char * objectFilename) {
+	struct module_object_reader reader;
+	struct module_object_header header;
+	struct module_object * object;
+	struct memorycontainer ** blocks;
+	struct stat fileInfo;
+	unsigned short index;
+	int i, numberBlocks;
+	if (stat(objectFilename, &fileInfo) != 0 || fileInfo.st_size < (off_t) sizeof(struct module_object_header)) return NULL;
+	FILE * objectFile=fopen(objectFilename, "rb");
+	if (objectFile == NULL) return NULL;
+	reader.length=(size_t) fileInfo.st_size;
+	reader.data=(char*) malloc(reader.length);
+	reader.position=0;
+	reader.failed=fread(reader.data, sizeof(char), reader.length, objectFile) != reader.length;
+	fclose(objectFile);
+	readModuleObjectBytes(&reader, &header, sizeof(struct module_object_header));
+	if (reader.failed || header.magic != MODULE_OBJECT_MAGIC || header.version != MODULE_OBJECT_VERSION || header.numberGlobals < 0 ||
+			header.numberLabels < 0 || header.numberRootCalls < 0 || header.numberRootCalls > 256 || header.numberFunctions < 0 ||
+			header.numberRelocations < 0 || (size_t) header.numberGlobals + header.numberFunctions > reader.length) {
+		free(reader.data);
+		return NULL;
+	}
+	object=(struct module_object*) arenaAllocate(sizeof(struct module_object));
+	object->numberGlobals=header.numberGlobals;
+	object->numberLabels=header.numberLabels;
+	object->numberRootCalls=header.numberRootCalls;
+	object->numberFunctions=header.numberFunctions;
+	object->numberRelocations=header.numberRelocations;
+	object->globalNames=readModuleObjectStrings(&reader, header.numberGlobals);
+	object->rootCalls=readModuleObjectStrings(&reader, header.numberRootCalls);
+	object->code=readModuleObjectBlock(&reader);
+	object->functions=(struct functionDefinition**) arenaAllocate(sizeof(struct functionDefinition*) * (header.numberFunctions + 1));
+	for (i=0;i<header.numberFunctions && !reader.failed;i++) object->functions[i]=readModuleObjectFunction(&reader);
+	if (!reader.failed && (size_t) header.numberRelocations > (reader.length - reader.position) / sizeof(struct module_relocation)) {
+		reader.failed=1;
+	}
+	object->relocations=NULL;
+	if (!reader.failed) {
+		object->relocations=(struct module_relocation*) arenaAllocate(sizeof(struct module_relocation) * (header.numberRelocations + 1));
+		readModuleObjectBytes(&reader, object->relocations, sizeof(struct module_relocation) * header.numberRelocations);
+		reader.failed|=reader.position != reader.length;
+	}
+	free(reader.data);
+	if (reader.failed) return NULL;
+	// Each relocation must be of a global variable id which is within its block of code
+	numberBlocks=getModuleObjectCodeBlocks(object, &blocks);
+	for (i=0;i<object->numberRelocations && !reader.failed;i++) {
+		struct module_relocation * relocation=&object->relocations[i];
+		if (relocation->block >= (unsigned int) numberBlocks || relocation->position > blocks[relocation->block]->length ||
+				blocks[relocation->block]->length - relocation->position < sizeof(unsigned short)) {
+			reader.failed=1;
+		} else {
+			memcpy(&index, &blocks[relocation->block]->data[relocation->position], sizeof(unsigned short));
+			reader.failed=index >= object->numberGlobals;
+		}
+	}
+	free(blocks);
+	return reader.failed ? NULL : object;
+}
+
+/**
+ * Takes the line definitions of global variable ids, which the assembler records as it compiles a module to an object, out of the
+ * code of the object and holds each as a relocation. These ids are the index of the variable in the module
+ */
+void extractModuleObjectRelocations(struct module_object * object) {
+	struct memorycontainer ** blocks;
+	struct lineDefinition ** defn;
+	int i, numberBlocks, numberRelocations=0;
+	numberBlocks=getModuleObjectCodeBlocks(object, &blocks);
+	for (i=0;i<numberBlocks;i++) {
+		for (defn=&blocks[i]->lineDefns;*defn != NULL;defn=&(*defn)->next) {
+			if ((*defn)->type == 5) numberRelocations++;
+		}
+	}
+	object->relocations=(struct module_relocation*) arenaAllocate(sizeof(struct module_relocation) * (numberRelocations + 1));
+	object->numberRelocations=0;
+	for (i=0;i<numberBlocks;i++) {
+		defn=&blocks[i]->lineDefns;
+		while (*defn != NULL) {
+			if ((*defn)->type == 5) {
+				object->relocations[object->numberRelocations].block=(unsigned int) i;
+				object->relocations[object->numberRelocations++].position=(unsigned int) (*defn)->currentpoint;
+				*defn=(*defn)->next;
+			} else {
+				defn=&(*defn)->next;
+			}
+		}
+	}
+	free(blocks);
+}
+
+/**
+ * Gets the blocks of code of a module object in order, which is the top level code followed by the contents and then the
+ * inlineable body (if it has one) of each function. Returns the number of blocks, the array of which is to be freed
+ */
+int getModuleObjectCodeBlocks(struct module_object * object, struct memorycontainer *** blocks) {
+	int i, numberBlocks=0;
+	*blocks=(struct memorycontainer**) malloc(sizeof(struct memorycontainer*) * (object->numberFunctions * 2 + 1));
+	(*blocks)[numberBlocks++]=object->code;
+	for (i=0;i<object->numberFunctions;i++) {
+		(*blocks)[numberBlocks++]=object->functions[i]->contents;
+		if (object->functions[i]->inlineBody != NULL) (*blocks)[numberBlocks++]=object->functions[i]->inlineBody;
+	}
+	return numberBlocks;
+}
+
+/**
+ * Writes a name, which is its length (or -1 if there is not one) followed by the null terminated characters
+ */
+static void writeModuleObjectString(FILE * objectFile, char * name) {
+	int length=name != NULL ? (int) strlen(name) : -1;
+	fwrite(&length, sizeof(int), 1, objectFile);
+	if (name != NULL) fwrite(name, sizeof(char), length + 1, objectFile);
+}
+
+/**
+ * Writes a block of code along with its line definitions
+ */
+static void writeModuleObjectBlock(FILE * objectFile, struct memorycontainer * block) {
+	struct module_object_block blockInFile;
+	struct module_object_line_definition definitionInFile;
+	struct lineDefinition * root;
+	blockInFile.length=block->length;
+	blockInFile.numberLineDefinitions=0;
+	for (root=block->lineDefns;root != NULL;root=root->next) blockInFile.numberLineDefinitions++;
+	fwrite(&blockInFile, sizeof(struct module_object_block), 1, objectFile);
+	fwrite(block->data, sizeof(char), block->length, objectFile);
+	for (root=block->lineDefns;root != NULL;root=root->next) {
+		memset(&definitionInFile, 0, sizeof(struct module_object_line_definition));
+		definitionInFile.linenumber=root->linenumber;
+		definitionInFile.currentpoint=root->currentpoint;
+		definitionInFile.type=root->type;
+		fwrite(&definitionInFile, sizeof(struct module_object_line_definition), 1, objectFile);
+		writeModuleObjectString(objectFile, root->type > 1 ? root->name : NULL);
+	}
+}
+
+/**
+ * Copies the next number of bytes from the module object being read, marking the read as failed if the file is too short
+ */
+static void readModuleObjectBytes(struct module_object_reader * reader, void * destination, size_t length) {
+	if (reader->failed || length > reader->length - reader->position) {
+		reader->failed=1;
+		memset(destination, 0, length);
+		return;
+	}
+	memcpy(destination, &reader->data[reader->position], length);
+	reader->position+=length;
+}
+
+/**
+ * Reads a name, which is NULL if there is not one
+ */
+static char* readModuleObjectString(struct module_object_reader * reader) {
+	int length;
+	readModuleObjectBytes(reader, &length, sizeof(int));
+	if (reader->failed || length < 0) return NULL;
+	if ((size_t) length >= reader->length - reader->position || reader->data[reader->position + length] != '\0') {
+		reader->failed=1;
+		return NULL;
+	}
+	char * name=arenaDuplicateString(&reader->data[reader->position]);
+	reader->position+=length + 1;
+	return name;
+}
+
+/**
+ * Reads a number of names into an array
+ */
+static char** readModuleObjectStrings(struct module_object_reader * reader, int number) {
+	int i;
+	char ** names=(char**) arenaAllocate(sizeof(char*) * (number + 1));
+	for (i=0;i<number;i++) names[i]=readModuleObjectString(reader);
+	return names;
+}
+
+/**
+ * Reads a block of code along with its line definitions, these are kept in the order that they were written
+ */
+static struct memorycontainer* readModuleObjectBlock(struct module_object_reader * reader) {
+	struct module_object_block blockInFile;
+	struct module_object_line_definition definitionInFile;
+	struct lineDefinition * defn, ** tail;
+	unsigned int i;
+	struct memorycontainer * block=(struct memorycontainer*) arenaAllocate(sizeof(struct memorycontainer));
+	block->length=0;
+	block->data=NULL;
+	block->lineDefns=NULL;
+	readModuleObjectBytes(reader, &blockInFile, sizeof(struct module_object_block));
+	if (reader->failed || blockInFile.length > reader->length - reader->position) {
+		reader->failed=1;
+		return block;
+	}
+	block->length=blockInFile.length;
+	block->data=(char*) arenaAllocate(blockInFile.length + 1);
+	readModuleObjectBytes(reader, block->data, blockInFile.length);
+	tail=&block->lineDefns;
+	for (i=0;i<blockInFile.numberLineDefinitions && !reader->failed;i++) {
+		readModuleObjectBytes(reader, &definitionInFile, sizeof(struct module_object_line_definition));
+		if (definitionInFile.currentpoint < 0 || (unsigned int) definitionInFile.currentpoint > blockInFile.length) reader->failed=1;
+		defn=(struct lineDefinition*) arenaAllocate(sizeof(struct lineDefinition));
+		defn->linenumber=definitionInFile.linenumber;
+		defn->currentpoint=definitionInFile.currentpoint;
+		defn->type=definitionInFile.type;
+		defn->name=readModuleObjectString(reader);
+		defn->next=NULL;
+		*tail=defn;
+		tail=&defn->next;
+	}
+	return block;
+}
+
+/**
+ * Reads a function, which has not yet been found to be called by the program that the module is linked into
+ */
+static struct functionDefinition* readModuleObjectFunction(struct module_object_reader * reader) {
+	struct module_object_function functionInFile;
+	struct functionDefinition * fn=(struct functionDefinition*) arenaAllocate(sizeof(struct functionDefinition));
+	memset(fn, 0, sizeof(struct functionDefinition));
+	readModuleObjectBytes(reader, &functionInFile, sizeof(struct module_object_function));
+	if (reader->failed || functionInFile.numberCalls < 0 || functionInFile.numberCalls > 256) {
+		reader->failed=1;
+		return fn;
+	}
+	fn->name=readModuleObjectString(reader);
+	fn->numberEntriesInSymbolTable=functionInFile.numberEntriesInSymbolTable;
+	fn->recursive=functionInFile.recursive;
+	fn->number_of_fn_calls=functionInFile.numberCalls;
+	fn->bytesOptimisedAway=functionInFile.bytesOptimisedAway;
+	fn->sideEffectFree=functionInFile.sideEffectFree;
+	fn->functionCalls=functionInFile.numberCalls > 0 ? readModuleObjectStrings(reader, functionInFile.numberCalls) : NULL;
+	fn->contents=readModuleObjectBlock(reader);
+	fn->inlineBody=functionInFile.hasInlineBody ? readModuleObjectBlock(reader) : NULL;
+	if (fn->name == NULL) reader->failed=1;
+	return fn;
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2016, Nick Brown
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef MODULEOBJECT_H_
+#define MODULEOBJECT_H_
+
+#include "byteassembler.h"
+
+// A global variable id in the code of a module object, which is given its slot in the program when the object is linked
+struct module_relocation {
+	unsigned int block, position;
+};
+
+// A module compiled on its own so that it can be linked into programs. The code blocks are the top level code of the module
+// followed by the contents and inlineable body (if any) of each function in turn, global variable ids in these are the index of
+// the variable in the module, with those in the global scope named. Labels are numbered from -1 downwards
+struct module_object {
+	char ** globalNames, ** rootCalls;
+	int numberGlobals, numberLabels, numberRootCalls, numberFunctions, numberRelocations;
+	struct memorycontainer * code;
+	struct functionDefinition ** functions;
+	struct module_relocation * relocations;
+};
+
+int writeModuleObject(char*, struct module_object*);
+struct module_object* readModuleObject(char*);
+void extractModuleObjectRelocations(struct module_object*);
+int getModuleObjectCodeBlocks(struct module_object*, struct memorycontainer***);
+
+#endif /* MODULEOBJECT_H_ */
@@ -1,8 +1,9 @@
-/* A Bison parser, made by GNU Bison 3.0.4.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison implementation for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989-1990, 2000-2015 Free Software Foundation, Inc.
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
    This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
@@ -15,7 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -33,6 +34,10 @@
 /* C LALR(1) parser skeleton written by Richard Stallman, by
    simplifying the original so-called "semantic" parser.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 /* All symbols defined below should begin with yy or YY, to avoid
    infringing on user name space.  This should be done even for local
    variables, as they might otherwise be expanded by user macros.
@@ -40,11 +45,11 @@
    define necessary library symbols; they are noted "INFRINGES ON
    USER NAME SPACE" below.  */
 
-/* Identify Bison output.  */
-#define YYBISON 1
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
 
-/* Bison version.  */
-#define YYBISON_VERSION "3.0.4"
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
 
 /* Skeleton name.  */
 #define YYSKELETON_NAME "yacc.c"
@@ -61,12 +66,15 @@
 
 
 
-/* Copy the first part of user declarations.  */
-#line 1 "epython.y" /* yacc.c:339  */
+/* First part of user prologue.  */
+#line 1 "epython.y"
 
 #include "byteassembler.h"
 #include "memorymanager.h"
 #include "stack.h"
+#include "arena.h"
+#include "ir.h"
+#include "basictokens.h"
 #include <string.h>
 #include <stdlib.h>
 #include <stddef.h>
@@ -83,238 +91,226 @@ void yyerror (char const *msg) {
 	exit(0);
 }
 
-#line 87 "parser.c" /* yacc.c:339  */
+#line 95 "parser.c"
 
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
 # ifndef YY_NULLPTR
-#  if defined __cplusplus && 201103L <= __cplusplus
-#   define YY_NULLPTR nullptr
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
 #  else
-#   define YY_NULLPTR 0
+#   define YY_NULLPTR ((void*)0)
 #  endif
 # endif
 
-/* Enabling verbose error messages.  */
-#ifdef YYERROR_VERBOSE
-# undef YYERROR_VERBOSE
-# define YYERROR_VERBOSE 1
-#else
-# define YYERROR_VERBOSE 0
-#endif
-
-/* In a future release of Bison, this section will be replaced
-   by #include "parser.h".  */
-#ifndef YY_YY_PARSER_H_INCLUDED
-# define YY_YY_PARSER_H_INCLUDED
-/* Debug traces.  */
-#ifndef YYDEBUG
-# define YYDEBUG 0
-#endif
-#if YYDEBUG
-extern int yydebug;
-#endif
-
-/* Token type.  */
-#ifndef YYTOKENTYPE
-# define YYTOKENTYPE
-  enum yytokentype
-  {
-    INTEGER = 258,
-    REAL = 259,
-    STRING = 260,
-    IDENTIFIER = 261,
-    NEWLINE = 262,
-    INDENT = 263,
-    OUTDENT = 264,
-    DIM = 265,
-    SDIM = 266,
-    EXIT = 267,
-    QUIT = 268,
-    ELSE = 269,
-    ELIF = 270,
-    COMMA = 271,
-    WHILE = 272,
-    PASS = 273,
-    AT = 274,
-    FOR = 275,
-    TO = 276,
-    FROM = 277,
-    NEXT = 278,
-    GOTO = 279,
-    PRINT = 280,
-    INPUT = 281,
-    IF = 282,
-    NATIVE = 283,
-    ADD = 284,
-    SUB = 285,
-    COLON = 286,
-    DEF = 287,
-    RET = 288,
-    NONE = 289,
-    FILESTART = 290,
-    IN = 291,
-    ADDADD = 292,
-    SUBSUB = 293,
-    MULMUL = 294,
-    DIVDIV = 295,
-    MODMOD = 296,
-    POWPOW = 297,
-    FLOORDIVFLOORDIV = 298,
-    FLOORDIV = 299,
-    MULT = 300,
-    DIV = 301,
-    MOD = 302,
-    AND = 303,
-    OR = 304,
-    NEQ = 305,
-    LEQ = 306,
-    GEQ = 307,
-    LT = 308,
-    GT = 309,
-    EQ = 310,
-    IS = 311,
-    NOT = 312,
-    STR = 313,
-    ID = 314,
-    SYMBOL = 315,
-    ALIAS = 316,
-    LPAREN = 317,
-    RPAREN = 318,
-    SLBRACE = 319,
-    SRBRACE = 320,
-    TRUE = 321,
-    FALSE = 322,
-    ASSGN = 323,
-    POW = 324
-  };
-#endif
-/* Tokens.  */
-#define INTEGER 258
-#define REAL 259
-#define STRING 260
-#define IDENTIFIER 261
-#define NEWLINE 262
-#define INDENT 263
-#define OUTDENT 264
-#define DIM 265
-#define SDIM 266
-#define EXIT 267
-#define QUIT 268
-#define ELSE 269
-#define ELIF 270
-#define COMMA 271
-#define WHILE 272
-#define PASS 273
-#define AT 274
-#define FOR 275
-#define TO 276
-#define FROM 277
-#define NEXT 278
-#define GOTO 279
-#define PRINT 280
-#define INPUT 281
-#define IF 282
-#define NATIVE 283
-#define ADD 284
-#define SUB 285
-#define COLON 286
-#define DEF 287
-#define RET 288
-#define NONE 289
-#define FILESTART 290
-#define IN 291
-#define ADDADD 292
-#define SUBSUB 293
-#define MULMUL 294
-#define DIVDIV 295
-#define MODMOD 296
-#define POWPOW 297
-#define FLOORDIVFLOORDIV 298
-#define FLOORDIV 299
-#define MULT 300
-#define DIV 301
-#define MOD 302
-#define AND 303
-#define OR 304
-#define NEQ 305
-#define LEQ 306
-#define GEQ 307
-#define LT 308
-#define GT 309
-#define EQ 310
-#define IS 311
-#define NOT 312
-#define STR 313
-#define ID 314
-#define SYMBOL 315
-#define ALIAS 316
-#define LPAREN 317
-#define RPAREN 318
-#define SLBRACE 319
-#define SRBRACE 320
-#define TRUE 321
-#define FALSE 322
-#define ASSGN 323
-#define POW 324
-
-/* Value type.  */
-#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-
-union YYSTYPE
+#include "parser.h"
+/* Symbol kind.  */
+enum yysymbol_kind_t
 {
-#line 22 "epython.y" /* yacc.c:355  */
-
-	int integer;
-	unsigned char uchar;
-	float real;	
-	struct memorycontainer * data;
-	char *string;
-	struct stack_t * stack;
-
-#line 274 "parser.c" /* yacc.c:355  */
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_INTEGER = 3,                    /* INTEGER  */
+  YYSYMBOL_REAL = 4,                       /* REAL  */
+  YYSYMBOL_STRING = 5,                     /* STRING  */
+  YYSYMBOL_IDENTIFIER = 6,                 /* IDENTIFIER  */
+  YYSYMBOL_NEWLINE = 7,                    /* NEWLINE  */
+  YYSYMBOL_INDENT = 8,                     /* INDENT  */
+  YYSYMBOL_OUTDENT = 9,                    /* OUTDENT  */
+  YYSYMBOL_DIM = 10,                       /* DIM  */
+  YYSYMBOL_SDIM = 11,                      /* SDIM  */
+  YYSYMBOL_EXIT = 12,                      /* EXIT  */
+  YYSYMBOL_QUIT = 13,                      /* QUIT  */
+  YYSYMBOL_ELSE = 14,                      /* ELSE  */
+  YYSYMBOL_ELIF = 15,                      /* ELIF  */
+  YYSYMBOL_COMMA = 16,                     /* COMMA  */
+  YYSYMBOL_WHILE = 17,                     /* WHILE  */
+  YYSYMBOL_PASS = 18,                      /* PASS  */
+  YYSYMBOL_AT = 19,                        /* AT  */
+  YYSYMBOL_FOR = 20,                       /* FOR  */
+  YYSYMBOL_TO = 21,                        /* TO  */
+  YYSYMBOL_FROM = 22,                      /* FROM  */
+  YYSYMBOL_NEXT = 23,                      /* NEXT  */
+  YYSYMBOL_GOTO = 24,                      /* GOTO  */
+  YYSYMBOL_PRINT = 25,                     /* PRINT  */
+  YYSYMBOL_INPUT = 26,                     /* INPUT  */
+  YYSYMBOL_IF = 27,                        /* IF  */
+  YYSYMBOL_NATIVE = 28,                    /* NATIVE  */
+  YYSYMBOL_ADD = 29,                       /* ADD  */
+  YYSYMBOL_SUB = 30,                       /* SUB  */
+  YYSYMBOL_COLON = 31,                     /* COLON  */
+  YYSYMBOL_DEF = 32,                       /* DEF  */
+  YYSYMBOL_RET = 33,                       /* RET  */
+  YYSYMBOL_NONE = 34,                      /* NONE  */
+  YYSYMBOL_FILESTART = 35,                 /* FILESTART  */
+  YYSYMBOL_IN = 36,                        /* IN  */
+  YYSYMBOL_ADDADD = 37,                    /* ADDADD  */
+  YYSYMBOL_SUBSUB = 38,                    /* SUBSUB  */
+  YYSYMBOL_MULMUL = 39,                    /* MULMUL  */
+  YYSYMBOL_DIVDIV = 40,                    /* DIVDIV  */
+  YYSYMBOL_MODMOD = 41,                    /* MODMOD  */
+  YYSYMBOL_POWPOW = 42,                    /* POWPOW  */
+  YYSYMBOL_FLOORDIVFLOORDIV = 43,          /* FLOORDIVFLOORDIV  */
+  YYSYMBOL_FLOORDIV = 44,                  /* FLOORDIV  */
+  YYSYMBOL_MULT = 45,                      /* MULT  */
+  YYSYMBOL_DIV = 46,                       /* DIV  */
+  YYSYMBOL_MOD = 47,                       /* MOD  */
+  YYSYMBOL_AND = 48,                       /* AND  */
+  YYSYMBOL_OR = 49,                        /* OR  */
+  YYSYMBOL_NEQ = 50,                       /* NEQ  */
+  YYSYMBOL_LEQ = 51,                       /* LEQ  */
+  YYSYMBOL_GEQ = 52,                       /* GEQ  */
+  YYSYMBOL_LT = 53,                        /* LT  */
+  YYSYMBOL_GT = 54,                        /* GT  */
+  YYSYMBOL_EQ = 55,                        /* EQ  */
+  YYSYMBOL_IS = 56,                        /* IS  */
+  YYSYMBOL_NOT = 57,                       /* NOT  */
+  YYSYMBOL_STR = 58,                       /* STR  */
+  YYSYMBOL_ID = 59,                        /* ID  */
+  YYSYMBOL_SYMBOL = 60,                    /* SYMBOL  */
+  YYSYMBOL_ALIAS = 61,                     /* ALIAS  */
+  YYSYMBOL_LPAREN = 62,                    /* LPAREN  */
+  YYSYMBOL_RPAREN = 63,                    /* RPAREN  */
+  YYSYMBOL_SLBRACE = 64,                   /* SLBRACE  */
+  YYSYMBOL_SRBRACE = 65,                   /* SRBRACE  */
+  YYSYMBOL_TRUE = 66,                      /* TRUE  */
+  YYSYMBOL_FALSE = 67,                     /* FALSE  */
+  YYSYMBOL_ASSGN = 68,                     /* ASSGN  */
+  YYSYMBOL_POW = 69,                       /* POW  */
+  YYSYMBOL_YYACCEPT = 70,                  /* $accept  */
+  YYSYMBOL_program = 71,                   /* program  */
+  YYSYMBOL_toplevellines = 72,             /* toplevellines  */
+  YYSYMBOL_lines = 73,                     /* lines  */
+  YYSYMBOL_line = 74,                      /* line  */
+  YYSYMBOL_statements = 75,                /* statements  */
+  YYSYMBOL_statement = 76,                 /* statement  */
+  YYSYMBOL_arrayaccessor = 77,             /* arrayaccessor  */
+  YYSYMBOL_fncallargs = 78,                /* fncallargs  */
+  YYSYMBOL_fndeclarationargs = 79,         /* fndeclarationargs  */
+  YYSYMBOL_fn_entry = 80,                  /* fn_entry  */
+  YYSYMBOL_codeblock = 81,                 /* codeblock  */
+  YYSYMBOL_indent_rule = 82,               /* indent_rule  */
+  YYSYMBOL_outdent_rule = 83,              /* outdent_rule  */
+  YYSYMBOL_opassgn = 84,                   /* opassgn  */
+  YYSYMBOL_declareident = 85,              /* declareident  */
+  YYSYMBOL_elifblock = 86,                 /* elifblock  */
+  YYSYMBOL_expression = 87,                /* expression  */
+  YYSYMBOL_logical_or_expression = 88,     /* logical_or_expression  */
+  YYSYMBOL_logical_and_expression = 89,    /* logical_and_expression  */
+  YYSYMBOL_equality_expression = 90,       /* equality_expression  */
+  YYSYMBOL_relational_expression = 91,     /* relational_expression  */
+  YYSYMBOL_additive_expression = 92,       /* additive_expression  */
+  YYSYMBOL_multiplicative_expression = 93, /* multiplicative_expression  */
+  YYSYMBOL_commaseparray = 94,             /* commaseparray  */
+  YYSYMBOL_value = 95,                     /* value  */
+  YYSYMBOL_identscalararray = 96,          /* identscalararray  */
+  YYSYMBOL_identscalararraylhs = 97,       /* identscalararraylhs  */
+  YYSYMBOL_ident = 98,                     /* ident  */
+  YYSYMBOL_constant = 99,                  /* constant  */
+  YYSYMBOL_unary_operator = 100            /* unary_operator  */
 };
+typedef enum yysymbol_kind_t yysymbol_kind_t;
 
-typedef union YYSTYPE YYSTYPE;
-# define YYSTYPE_IS_TRIVIAL 1
-# define YYSTYPE_IS_DECLARED 1
-#endif
 
 
-extern YYSTYPE yylval;
 
-int yyparse (void);
+#ifdef short
+# undef short
+#endif
 
-#endif /* !YY_YY_PARSER_H_INCLUDED  */
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
 
-/* Copy the second part of user declarations.  */
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
+#endif
 
-#line 291 "parser.c" /* yacc.c:358  */
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
 
-#ifdef short
-# undef short
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
+typedef signed char yytype_int8;
 #endif
 
-#ifdef YYTYPE_UINT8
-typedef YYTYPE_UINT8 yytype_uint8;
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
 #else
-typedef unsigned char yytype_uint8;
+typedef short yytype_int16;
 #endif
 
-#ifdef YYTYPE_INT8
-typedef YYTYPE_INT8 yytype_int8;
-#else
-typedef signed char yytype_int8;
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
 #endif
 
-#ifdef YYTYPE_UINT16
-typedef YYTYPE_UINT16 yytype_uint16;
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
 #else
-typedef unsigned short int yytype_uint16;
+typedef short yytype_uint8;
 #endif
 
-#ifdef YYTYPE_INT16
-typedef YYTYPE_INT16 yytype_int16;
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
 #else
-typedef short int yytype_int16;
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
 #endif
 
 #ifndef YYSIZE_T
@@ -322,15 +318,28 @@ typedef short int yytype_int16;
 #  define YYSIZE_T __SIZE_TYPE__
 # elif defined size_t
 #  define YYSIZE_T size_t
-# elif ! defined YYSIZE_T
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
 #  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
 #  define YYSIZE_T size_t
 # else
-#  define YYSIZE_T unsigned int
+#  define YYSIZE_T unsigned
 # endif
 #endif
 
-#define YYSIZE_MAXIMUM ((YYSIZE_T) -1)
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_uint8 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
 
 #ifndef YY_
 # if defined YYENABLE_NLS && YYENABLE_NLS
@@ -344,47 +353,43 @@ typedef short int yytype_int16;
 # endif
 #endif
 
-#ifndef YY_ATTRIBUTE
-# if (defined __GNUC__                                               \
-      && (2 < __GNUC__ || (__GNUC__ == 2 && 96 <= __GNUC_MINOR__)))  \
-     || defined __SUNPRO_C && 0x5110 <= __SUNPRO_C
-#  define YY_ATTRIBUTE(Spec) __attribute__(Spec)
-# else
-#  define YY_ATTRIBUTE(Spec) /* empty */
-# endif
-#endif
 
 #ifndef YY_ATTRIBUTE_PURE
-# define YY_ATTRIBUTE_PURE   YY_ATTRIBUTE ((__pure__))
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
 #endif
 
 #ifndef YY_ATTRIBUTE_UNUSED
-# define YY_ATTRIBUTE_UNUSED YY_ATTRIBUTE ((__unused__))
-#endif
-
-#if !defined _Noreturn \
-     && (!defined __STDC_VERSION__ || __STDC_VERSION__ < 201112)
-# if defined _MSC_VER && 1200 <= _MSC_VER
-#  define _Noreturn __declspec (noreturn)
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
 # else
-#  define _Noreturn YY_ATTRIBUTE ((__noreturn__))
+#  define YY_ATTRIBUTE_UNUSED
 # endif
 #endif
 
 /* Suppress unused-variable warnings by "using" E.  */
 #if ! defined lint || defined __GNUC__
-# define YYUSE(E) ((void) (E))
+# define YY_USE(E) ((void) (E))
 #else
-# define YYUSE(E) /* empty */
+# define YY_USE(E) /* empty */
 #endif
 
-#if defined __GNUC__ && 407 <= __GNUC__ * 100 + __GNUC_MINOR__
 /* Suppress an incorrect diagnostic about yylval being uninitialized.  */
-# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN \
-    _Pragma ("GCC diagnostic push") \
-    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")\
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
     _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
-# define YY_IGNORE_MAYBE_UNINITIALIZED_END \
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
     _Pragma ("GCC diagnostic pop")
 #else
 # define YY_INITIAL_VALUE(Value) Value
@@ -397,8 +402,22 @@ typedef short int yytype_int16;
 # define YY_INITIAL_VALUE(Value) /* Nothing. */
 #endif
 
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
 
-#if ! defined yyoverflow || YYERROR_VERBOSE
+#if !defined yyoverflow
 
 /* The parser invokes alloca or malloc; define the necessary symbols.  */
 
@@ -463,8 +482,7 @@ void free (void *); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 # endif
-#endif /* ! defined yyoverflow || YYERROR_VERBOSE */
-
+#endif /* !defined yyoverflow */
 
 #if (! defined yyoverflow \
      && (! defined __cplusplus \
@@ -473,17 +491,17 @@ void free (void *); /* INFRINGES ON USER NAME SPACE */
 /* A type that is properly aligned for any stack member.  */
 union yyalloc
 {
-  yytype_int16 yyss_alloc;
+  yy_state_t yyss_alloc;
   YYSTYPE yyvs_alloc;
 };
 
 /* The size of the maximum gap between one aligned stack and the next.  */
-# define YYSTACK_GAP_MAXIMUM (sizeof (union yyalloc) - 1)
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
 
 /* The size of an array large to enough to hold all stacks, each with
    N elements.  */
 # define YYSTACK_BYTES(N) \
-     ((N) * (sizeof (yytype_int16) + sizeof (YYSTYPE)) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
       + YYSTACK_GAP_MAXIMUM)
 
 # define YYCOPY_NEEDED 1
@@ -496,11 +514,11 @@ union yyalloc
 # define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
     do                                                                  \
       {                                                                 \
-        YYSIZE_T yynewbytes;                                            \
+        YYPTRDIFF_T yynewbytes;                                         \
         YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
         Stack = &yyptr->Stack_alloc;                                    \
-        yynewbytes = yystacksize * sizeof (*Stack) + YYSTACK_GAP_MAXIMUM; \
-        yyptr += yynewbytes / sizeof (*yyptr);                          \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
       }                                                                 \
     while (0)
 
@@ -512,12 +530,12 @@ union yyalloc
 # ifndef YYCOPY
 #  if defined __GNUC__ && 1 < __GNUC__
 #   define YYCOPY(Dst, Src, Count) \
-      __builtin_memcpy (Dst, Src, (Count) * sizeof (*(Src)))
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
 #  else
 #   define YYCOPY(Dst, Src, Count)              \
       do                                        \
         {                                       \
-          YYSIZE_T yyi;                         \
+          YYPTRDIFF_T yyi;                      \
           for (yyi = 0; yyi < (Count); yyi++)   \
             (Dst)[yyi] = (Src)[yyi];            \
         }                                       \
@@ -527,30 +545,33 @@ union yyalloc
 #endif /* !YYCOPY_NEEDED */
 
 /* YYFINAL -- State number of the termination state.  */
-#define YYFINAL  65
+#define YYFINAL  3
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   398
+#define YYLAST   416
 
 /* YYNTOKENS -- Number of terminals.  */
 #define YYNTOKENS  70
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  30
+#define YYNNTS  31
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  107
+#define YYNRULES  110
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  208
+#define YYNSTATES  210
 
-/* YYTRANSLATE[YYX] -- Symbol number corresponding to YYX as returned
-   by yylex, with out-of-bounds checking.  */
-#define YYUNDEFTOK  2
+/* YYMAXUTOK -- Last valid token kind.  */
 #define YYMAXUTOK   324
 
-#define YYTRANSLATE(YYX)                                                \
-  ((unsigned int) (YYX) <= YYMAXUTOK ? yytranslate[YYX] : YYUNDEFTOK)
+
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
 
 /* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
-   as returned by yylex, without out-of-bounds checking.  */
-static const yytype_uint8 yytranslate[] =
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
 {
        0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -588,328 +609,335 @@ static const yytype_uint8 yytranslate[] =
 };
 
 #if YYDEBUG
-  /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_uint8 yyrline[] =
 {
-       0,    61,    61,    64,    65,    69,    70,    71,    75,    76,
-      80,    81,    82,    83,    84,    85,    86,    87,    88,    89,
-      90,    91,    92,    93,    94,    95,    96,    97,    98,    99,
-     103,   104,   108,   109,   110,   114,   115,   116,   117,   118,
-     122,   126,   129,   132,   135,   136,   137,   138,   139,   140,
-     141,   144,   148,   149,   150,   154,   155,   159,   160,   163,
-     164,   168,   169,   170,   171,   175,   176,   177,   178,   179,
-     183,   184,   185,   189,   190,   191,   192,   193,   194,   195,
-     196,   197,   198,   199,   203,   204,   208,   209,   210,   211,
-     212,   213,   214,   218,   219,   223,   224,   227,   231,   232,
-     233,   234,   235,   236,   237,   238,   242,   243
+       0,    64,    64,    67,    68,    69,    73,    74,    78,    79,
+      80,    84,    85,    89,    90,    91,    92,    93,    94,    95,
+      96,    97,    98,    99,   100,   101,   102,   103,   104,   105,
+     106,   107,   108,   112,   113,   117,   118,   119,   123,   124,
+     125,   126,   127,   131,   135,   138,   141,   144,   145,   146,
+     147,   148,   149,   150,   153,   157,   158,   159,   163,   164,
+     168,   169,   172,   173,   177,   178,   179,   180,   184,   185,
+     186,   187,   188,   192,   193,   194,   198,   199,   200,   201,
+     202,   203,   204,   205,   206,   207,   208,   212,   213,   217,
+     218,   219,   220,   221,   222,   223,   227,   228,   232,   233,
+     236,   240,   241,   242,   243,   244,   245,   246,   247,   251,
+     252
 };
 #endif
 
-#if YYDEBUG || YYERROR_VERBOSE || 0
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if YYDEBUG || 0
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
 /* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
    First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
 static const char *const yytname[] =
 {
-  "$end", "error", "$undefined", "INTEGER", "REAL", "STRING",
-  "IDENTIFIER", "NEWLINE", "INDENT", "OUTDENT", "DIM", "SDIM", "EXIT",
-  "QUIT", "ELSE", "ELIF", "COMMA", "WHILE", "PASS", "AT", "FOR", "TO",
-  "FROM", "NEXT", "GOTO", "PRINT", "INPUT", "IF", "NATIVE", "ADD", "SUB",
-  "COLON", "DEF", "RET", "NONE", "FILESTART", "IN", "ADDADD", "SUBSUB",
-  "MULMUL", "DIVDIV", "MODMOD", "POWPOW", "FLOORDIVFLOORDIV", "FLOORDIV",
-  "MULT", "DIV", "MOD", "AND", "OR", "NEQ", "LEQ", "GEQ", "LT", "GT", "EQ",
-  "IS", "NOT", "STR", "ID", "SYMBOL", "ALIAS", "LPAREN", "RPAREN",
-  "SLBRACE", "SRBRACE", "TRUE", "FALSE", "ASSGN", "POW", "$accept",
-  "program", "lines", "line", "statements", "statement", "arrayaccessor",
-  "fncallargs", "fndeclarationargs", "fn_entry", "codeblock",
-  "indent_rule", "outdent_rule", "opassgn", "declareident", "elifblock",
-  "expression", "logical_or_expression", "logical_and_expression",
-  "equality_expression", "relational_expression", "additive_expression",
-  "multiplicative_expression", "commaseparray", "value",
-  "identscalararray", "identscalararraylhs", "ident", "constant",
+  "\"end of file\"", "error", "\"invalid token\"", "INTEGER", "REAL",
+  "STRING", "IDENTIFIER", "NEWLINE", "INDENT", "OUTDENT", "DIM", "SDIM",
+  "EXIT", "QUIT", "ELSE", "ELIF", "COMMA", "WHILE", "PASS", "AT", "FOR",
+  "TO", "FROM", "NEXT", "GOTO", "PRINT", "INPUT", "IF", "NATIVE", "ADD",
+  "SUB", "COLON", "DEF", "RET", "NONE", "FILESTART", "IN", "ADDADD",
+  "SUBSUB", "MULMUL", "DIVDIV", "MODMOD", "POWPOW", "FLOORDIVFLOORDIV",
+  "FLOORDIV", "MULT", "DIV", "MOD", "AND", "OR", "NEQ", "LEQ", "GEQ", "LT",
+  "GT", "EQ", "IS", "NOT", "STR", "ID", "SYMBOL", "ALIAS", "LPAREN",
+  "RPAREN", "SLBRACE", "SRBRACE", "TRUE", "FALSE", "ASSGN", "POW",
+  "$accept", "program", "toplevellines", "lines", "line", "statements",
+  "statement", "arrayaccessor", "fncallargs", "fndeclarationargs",
+  "fn_entry", "codeblock", "indent_rule", "outdent_rule", "opassgn",
+  "declareident", "elifblock", "expression", "logical_or_expression",
+  "logical_and_expression", "equality_expression", "relational_expression",
+  "additive_expression", "multiplicative_expression", "commaseparray",
+  "value", "identscalararray", "identscalararraylhs", "ident", "constant",
   "unary_operator", YY_NULLPTR
 };
-#endif
 
-# ifdef YYPRINT
-/* YYTOKNUM[NUM] -- (External) token number corresponding to the
-   (internal) symbol number NUM (which must be that of a token).  */
-static const yytype_uint16 yytoknum[] =
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
 {
-       0,   256,   257,   258,   259,   260,   261,   262,   263,   264,
-     265,   266,   267,   268,   269,   270,   271,   272,   273,   274,
-     275,   276,   277,   278,   279,   280,   281,   282,   283,   284,
-     285,   286,   287,   288,   289,   290,   291,   292,   293,   294,
-     295,   296,   297,   298,   299,   300,   301,   302,   303,   304,
-     305,   306,   307,   308,   309,   310,   311,   312,   313,   314,
-     315,   316,   317,   318,   319,   320,   321,   322,   323,   324
-};
-# endif
+  return yytname[yysymbol];
+}
+#endif
 
-#define YYPACT_NINF -99
+#define YYPACT_NINF (-108)
 
-#define yypact_value_is_default(Yystate) \
-  (!!((Yystate) == (-99)))
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
 
-#define YYTABLE_NINF -97
+#define YYTABLE_NINF (-100)
 
-#define yytable_value_is_error(Yytable_value) \
+#define yytable_value_is_error(Yyn) \
   0
 
-  /* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
-     STATE-NUM.  */
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
 static const yytype_int16 yypact[] =
 {
-     277,   -99,   -99,   -50,   -45,   179,   179,   -99,    36,    36,
-     179,   179,    36,    36,   179,   -15,    61,   277,   -99,    58,
-     337,    19,   111,    -1,   -23,    46,    54,   -99,   -99,   -99,
-      23,    36,   -99,   -99,   -99,   192,    64,    65,    66,   179,
-     179,   -99,   -99,    63,    71,    82,    33,    45,    40,    78,
-     -99,   -99,    22,   -99,    98,   104,   -99,   101,   -99,   -99,
-     112,    79,   -99,   -99,    36,   -99,   -99,   -99,   -99,    36,
-     -99,   -99,   -99,   -99,   -99,   -99,   -99,   179,   179,   179,
-     179,   -32,   -99,   -99,   110,    80,    71,   179,    36,    36,
-      83,   -99,    -8,   138,   192,   192,   192,   192,   192,   192,
-     192,   192,   192,   192,   192,   257,   257,   257,   257,   257,
-     179,    93,   -99,   -99,   138,   179,   314,   179,   140,    -3,
-      94,   -99,   -99,     5,   -99,    95,   179,   -99,   102,   179,
-     103,   108,   117,   -99,   179,   116,   156,   -99,    82,    33,
-      45,    45,    45,    40,    40,    40,    40,    78,    78,   -99,
-     -99,   -99,   -99,   -99,    13,   -99,   155,   -99,    90,    14,
-     179,    36,   157,   179,   179,   -99,   -99,   122,   -99,    15,
-     -99,   -99,   -99,   -99,   257,   -99,   277,   -99,   138,   158,
-     179,   -99,   -99,   127,   124,   138,   -99,   -99,   -99,   -99,
-     -99,    31,   -99,   138,   168,   -99,   179,   -99,   -99,   -99,
-     -99,   138,   -99,    92,   169,   -99,   138,   -99
+    -108,    13,   117,  -108,  -108,  -108,   -59,   -44,   181,   181,
+    -108,    35,    35,   181,   181,    35,    35,   181,    -6,  -108,
+      -3,   179,    19,   -24,    10,    36,  -108,  -108,  -108,    31,
+      35,  -108,  -108,  -108,   246,    39,    41,    60,   181,   181,
+    -108,  -108,   100,    63,    85,    50,    74,    -1,    51,  -108,
+    -108,     8,  -108,    81,   112,  -108,   123,  -108,  -108,   129,
+      99,  -108,  -108,    35,    35,  -108,  -108,  -108,  -108,  -108,
+    -108,  -108,   181,   181,   181,   181,    22,  -108,  -108,   170,
+     101,    63,   181,    35,    35,   102,  -108,    -5,   157,   246,
+     246,   246,   246,   246,   246,   246,   246,   246,   246,   246,
+      48,    48,    48,    48,    48,   181,   103,  -108,  -108,   157,
+     181,   308,   181,   150,    -2,   111,  -108,  -108,     3,  -108,
+     105,   181,  -108,   108,   181,   118,   119,   120,  -108,   181,
+     135,   160,  -108,    85,    50,    74,    74,    74,    -1,    -1,
+      -1,    -1,    51,    51,  -108,  -108,  -108,  -108,  -108,    16,
+    -108,   159,  -108,   355,   132,    17,   181,    35,   161,   181,
+     181,  -108,  -108,   126,  -108,    18,  -108,  -108,  -108,  -108,
+      48,  -108,   331,  -108,   157,  -108,   162,   181,  -108,  -108,
+     134,   127,   157,  -108,  -108,  -108,  -108,  -108,  -108,    30,
+    -108,   194,  -108,   157,   171,  -108,   181,  -108,  -108,  -108,
+    -108,  -108,  -108,   157,  -108,   140,   172,  -108,   157,  -108
 };
 
-  /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
-     Performed when YYTABLE does not specify something else to do.  Zero
-     means the default is an error.  */
-static const yytype_uint8 yydefact[] =
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_int8 yydefact[] =
 {
-       0,    97,     7,     0,     0,     0,     0,    27,     0,     0,
-       0,     0,     0,     0,    23,     0,     0,     2,     3,     6,
-       9,     0,     0,     0,    93,     0,     0,    98,    99,   102,
-       0,     0,   106,   107,   105,     0,     0,     0,     0,     0,
-       0,   103,   104,     0,    55,    57,    59,    61,    65,    70,
-      73,    88,    93,    86,     0,     0,    28,     0,    51,    19,
-       0,     0,    40,    24,     0,     1,     4,     5,     8,    35,
-      44,    45,    46,    47,    48,    49,    50,     0,     0,    32,
-       0,    94,    20,    21,     0,     0,    56,     0,     0,     0,
-       0,    84,     0,     0,     0,     0,     0,     0,     0,     0,
+       3,     0,     2,     1,   100,     5,     0,     0,     0,     0,
+      30,     0,     0,     0,     0,     0,     0,    26,     0,     4,
+       0,     0,     0,    96,     0,     0,   101,   102,   105,     0,
+       0,   109,   110,   108,     0,     0,     0,     0,     0,     0,
+     106,   107,     0,    58,    60,    62,    64,    68,    73,    76,
+      91,    96,    89,     0,     0,    31,     0,    54,    22,     0,
+       0,    43,    27,     0,    38,    47,    48,    49,    50,    51,
+      52,    53,     0,     0,    35,     0,    97,    23,    24,     0,
+       0,    59,     0,     0,     0,     0,    87,     0,     0,     0,
        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-      32,    94,   100,   101,     0,     0,     0,    32,     0,     0,
-      36,    18,    17,     0,    33,     0,     0,    82,     0,    32,
-       0,     0,     0,    87,     0,    80,     0,    16,    58,    60,
-      63,    62,    64,    68,    69,    67,    66,    71,    72,    76,
-      74,    75,    77,    78,     0,    11,     0,    15,    12,     0,
-       0,     0,     0,     0,     0,    25,    30,     0,    83,     0,
-      79,    91,    92,    85,     0,    42,     0,    89,     0,     0,
-       0,    14,    26,     0,    38,     0,    37,    34,    31,    90,
-      81,     0,    10,     0,     0,    29,     0,    22,    43,    41,
-      13,     0,    39,    52,     0,    54,     0,    53
+       0,     0,     0,     0,     0,    35,    97,   103,   104,     0,
+       0,     0,    35,     0,     0,    39,    21,    20,     0,    36,
+       0,     0,    85,     0,    35,     0,     0,     0,    90,     0,
+      83,     0,    19,    61,    63,    66,    65,    67,    71,    72,
+      70,    69,    74,    75,    79,    77,    78,    80,    81,     0,
+      14,     0,    18,    12,    15,     0,     0,     0,     0,     0,
+       0,    28,    33,     0,    86,     0,    82,    94,    95,    88,
+       0,    45,     0,    92,     0,    11,     0,     0,    17,    29,
+       0,    41,     0,    40,    37,    34,    93,    84,    10,     0,
+       6,     9,    13,     0,     0,    32,     0,    25,    46,     7,
+      44,     8,    16,     0,    42,    55,     0,    57,     0,    56
 };
 
-  /* YYPGOTO[NTERM-NUM].  */
+/* YYPGOTO[NTERM-NUM].  */
 static const yytype_int16 yypgoto[] =
 {
-     -99,   -99,    25,   -10,   -16,   -99,   150,   -55,   -99,   -99,
-     -98,   -99,   -99,   -99,   -99,     0,    -5,   171,   118,   109,
-     -44,    32,     8,   -99,   -81,     3,   -99,     2,   -99,   -99
+    -108,  -108,  -108,  -108,    23,  -107,   203,   155,   -97,  -108,
+    -108,   -99,  -108,  -108,  -108,  -108,     9,    -8,   174,   124,
+     133,    26,    44,    58,  -108,   -78,     0,  -108,     5,  -108,
+    -108
 };
 
-  /* YYDEFGOTO[NTERM-NUM].  */
-static const yytype_int16 yydefgoto[] =
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_uint8 yydefgoto[] =
 {
-      -1,    16,    17,    18,    19,    20,    81,   123,   119,    21,
-     137,   176,   199,    77,    57,   181,   124,    44,    45,    46,
-      47,    48,    49,    92,    50,    51,    23,    52,    53,    54
+       0,     1,     2,   189,   190,   191,   153,    76,   118,   114,
+      20,   132,   172,   200,    72,    56,   178,   119,    43,    44,
+      45,    46,    47,    48,    87,    49,    50,    22,    51,    52,
+      53
 };
 
-  /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
-     positive, shift that token.  If negative, reduce the rule whose
-     number is the opposite.  If YYTABLE_NINF, syntax error.  */
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
 static const yytype_int16 yytable[] =
 {
-      43,    55,    24,    22,    68,    59,    60,    66,   134,    63,
-      56,    58,    25,   161,    61,    62,   155,    26,   158,    24,
-      22,   164,    24,    22,   149,   150,   151,   152,   153,   164,
-     164,   164,   126,    85,    90,    91,   -96,     1,     2,    79,
-     198,    80,     1,     3,     4,   -95,     5,    64,     6,     7,
-       8,     9,   140,   141,   142,   154,    10,   135,    11,    12,
-     162,    65,   159,    13,    14,    67,   118,    78,   165,   103,
-     104,   120,   121,   122,   169,   125,   177,   182,   189,   128,
-     192,    69,   130,    96,   110,    84,    80,   197,    97,    98,
-     131,   132,    15,   190,    93,   200,    99,   100,   101,   102,
-     157,   112,   113,   203,   179,   180,   204,   180,   207,    82,
-     156,   147,   148,    27,    28,    29,     1,    83,    24,    22,
-      94,   167,   105,   106,   107,   108,    87,    88,    89,   173,
-      95,   143,   144,   145,   146,   114,    30,   115,    31,    32,
-      33,   117,   129,   116,    34,   136,   133,   109,    70,    71,
-      72,    73,    74,    75,    76,   183,   160,   126,   186,   187,
-     166,   174,   163,   184,   175,   168,   170,    35,    36,    37,
-      38,   171,    39,   127,    40,   194,    41,    42,    24,    22,
-     172,    66,    27,    28,    29,     1,   178,   188,   185,   193,
-     195,   202,   196,    24,    22,    27,    28,    29,     1,   201,
-     206,   191,   111,   205,   139,    30,    86,    31,    32,    33,
-       0,     0,   138,    34,     0,     0,     0,     0,    30,     0,
-      31,    32,    33,     0,     0,     0,    34,     0,     0,     0,
-       0,     0,     0,     0,     0,     0,    35,    36,    37,    38,
-       0,    39,     0,    40,     0,    41,    42,     0,     0,     0,
-      36,    37,    38,     0,    39,     0,    40,     0,    41,    42,
-      27,    28,    29,     1,     0,     0,     0,     0,     0,     0,
+      42,    54,    21,    24,   152,    58,    59,    23,   149,    62,
+     150,   129,   154,     3,   157,   155,    55,    57,    25,   160,
+      60,    61,   144,   145,   146,   147,   148,   165,    98,    99,
+      85,    86,   160,   160,   160,    80,     4,   188,    74,   198,
+      75,     4,     6,     7,   -98,     8,   175,     9,    10,    11,
+      12,    26,    27,    28,     4,    13,    63,    14,    15,    64,
+     130,   158,    16,    17,   116,   117,   161,   120,   113,   115,
+     105,   123,    75,    77,   125,   192,    30,    31,    32,   173,
+     179,   186,    33,   197,   107,   108,   121,    73,   126,   127,
+     -99,    18,   187,    79,   202,   100,   101,   102,   103,    78,
+      91,    82,   151,    83,   205,    92,    93,    36,    37,   209,
+      38,    21,    89,   163,    40,    41,    23,   135,   136,   137,
+     104,   169,    84,     4,     5,    94,    95,    96,    97,     6,
+       7,    88,     8,    90,     9,    10,    11,    12,   138,   139,
+     140,   141,    13,   109,    14,    15,   176,   177,   180,    16,
+      17,   183,   184,    21,   206,   177,   142,   143,    23,   110,
+     111,   112,   181,   124,   131,   128,   156,   121,   171,   194,
+     162,   164,    21,    26,    27,    28,     4,    23,    18,   159,
+     170,   166,   167,   168,    26,    27,    28,     4,   204,    21,
+     174,   185,   182,   193,    23,   196,    29,   195,    30,    31,
+      32,   201,   203,   208,    33,    19,   106,    29,    81,    30,
+      31,    32,   199,   133,   207,    33,    65,    66,    67,    68,
+      69,    70,    71,   134,     0,     0,     0,    34,    35,    36,
+      37,     0,    38,   122,    39,     0,    40,    41,    34,    35,
+      36,    37,     0,    38,     0,    39,     0,    40,    41,    26,
+      27,    28,     4,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,    29,     0,    30,    31,    32,     0,     0,     0,
+      33,     0,     0,     0,     0,     0,     0,     0,     0,     0,
        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-       0,     0,     0,     1,     2,    31,    32,    33,     0,     3,
-       4,    34,     5,     0,     6,     7,     8,     9,     0,     0,
-       0,     0,    10,     0,    11,    12,     0,     0,     0,    13,
-      14,     0,     0,     0,     0,     0,    37,    38,     0,    39,
-       1,   136,     0,    41,    42,     0,     3,     4,     0,     5,
-       0,     6,     7,     8,     9,     0,     0,     0,    15,    10,
-       0,    11,    12,     1,     0,     0,    13,    14,     0,     3,
-       4,     0,     5,     0,     6,     7,     8,     9,     0,     0,
-       0,     0,    10,     0,    11,    12,     0,     0,     0,    13,
-      14,     0,     0,     0,     0,    15,     0,     0,     0,     0,
+       0,     0,     0,     0,    35,    36,    37,     0,    38,     0,
+      39,     0,    40,    41,     4,   131,     0,     0,     0,     0,
+       6,     7,     0,     8,     0,     9,    10,    11,    12,     0,
+       0,     0,     0,    13,     0,    14,    15,     4,   188,     0,
+      16,    17,     0,     6,     7,     0,     8,     0,     9,    10,
+      11,    12,     0,     0,     0,     0,    13,     0,    14,    15,
+       0,     4,     0,    16,    17,     0,     0,     6,     7,    18,
+       8,     0,     9,    10,    11,    12,     0,     0,     0,     0,
+      13,     0,    14,    15,     0,     0,     0,    16,    17,     0,
+       0,     0,    18,     0,     0,     0,     0,     0,     0,     0,
        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-       0,     0,     0,     0,     0,     0,     0,     0,    15
+       0,     0,     0,     0,     0,     0,    18
 };
 
 static const yytype_int16 yycheck[] =
 {
-       5,     6,     0,     0,    20,    10,    11,    17,    16,    14,
-       8,     9,    62,    16,    12,    13,   114,    62,   116,    17,
-      17,    16,    20,    20,   105,   106,   107,   108,   109,    16,
-      16,    16,    64,    31,    39,    40,    68,     6,     7,    62,
-       9,    64,     6,    12,    13,    68,    15,    62,    17,    18,
-      19,    20,    96,    97,    98,   110,    25,    65,    27,    28,
-      63,     0,   117,    32,    33,     7,    64,    68,    63,    29,
-      30,    69,    77,    78,   129,    80,    63,    63,    63,    84,
-     178,    62,    87,    50,    62,    62,    64,   185,    55,    56,
-      88,    89,    61,   174,    31,   193,    51,    52,    53,    54,
-     116,     3,     4,   201,    14,    15,    14,    15,   206,    63,
-     115,   103,   104,     3,     4,     5,     6,    63,   116,   116,
-      49,   126,    44,    45,    46,    47,    62,    62,    62,   134,
-      48,    99,   100,   101,   102,    31,    26,    36,    28,    29,
-      30,    62,    62,    31,    34,     7,    63,    69,    37,    38,
-      39,    40,    41,    42,    43,   160,    16,    64,   163,   164,
-      65,    45,    68,   161,     8,    63,    63,    57,    58,    59,
-      60,    63,    62,    63,    64,   180,    66,    67,   176,   176,
-      63,   191,     3,     4,     5,     6,    31,    65,    31,    31,
-      63,   196,    68,   191,   191,     3,     4,     5,     6,    31,
-      31,   176,    52,   203,    95,    26,    35,    28,    29,    30,
-      -1,    -1,    94,    34,    -1,    -1,    -1,    -1,    26,    -1,
-      28,    29,    30,    -1,    -1,    -1,    34,    -1,    -1,    -1,
-      -1,    -1,    -1,    -1,    -1,    -1,    57,    58,    59,    60,
-      -1,    62,    -1,    64,    -1,    66,    67,    -1,    -1,    -1,
-      58,    59,    60,    -1,    62,    -1,    64,    -1,    66,    67,
-       3,     4,     5,     6,    -1,    -1,    -1,    -1,    -1,    -1,
+       8,     9,     2,    62,   111,    13,    14,     2,   105,    17,
+     109,    16,   111,     0,    16,   112,    11,    12,    62,    16,
+      15,    16,   100,   101,   102,   103,   104,   124,    29,    30,
+      38,    39,    16,    16,    16,    30,     6,     7,    62,     9,
+      64,     6,    12,    13,    68,    15,   153,    17,    18,    19,
+      20,     3,     4,     5,     6,    25,    62,    27,    28,    62,
+      65,    63,    32,    33,    72,    73,    63,    75,    63,    64,
+      62,    79,    64,    63,    82,   174,    28,    29,    30,    63,
+      63,    63,    34,   182,     3,     4,    64,    68,    83,    84,
+      68,    61,   170,    62,   193,    44,    45,    46,    47,    63,
+      50,    62,   110,    62,   203,    55,    56,    59,    60,   208,
+      62,   111,    49,   121,    66,    67,   111,    91,    92,    93,
+      69,   129,    62,     6,     7,    51,    52,    53,    54,    12,
+      13,    31,    15,    48,    17,    18,    19,    20,    94,    95,
+      96,    97,    25,    31,    27,    28,    14,    15,   156,    32,
+      33,   159,   160,   153,    14,    15,    98,    99,   153,    36,
+      31,    62,   157,    62,     7,    63,    16,    64,     8,   177,
+      65,    63,   172,     3,     4,     5,     6,   172,    61,    68,
+      45,    63,    63,    63,     3,     4,     5,     6,   196,   189,
+      31,    65,    31,    31,   189,    68,    26,    63,    28,    29,
+      30,     7,    31,    31,    34,     2,    51,    26,    34,    28,
+      29,    30,   189,    89,   205,    34,    37,    38,    39,    40,
+      41,    42,    43,    90,    -1,    -1,    -1,    57,    58,    59,
+      60,    -1,    62,    63,    64,    -1,    66,    67,    57,    58,
+      59,    60,    -1,    62,    -1,    64,    -1,    66,    67,     3,
+       4,     5,     6,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    26,    -1,    28,    29,    30,    -1,    -1,    -1,
+      34,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
       -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
-      -1,    -1,    -1,     6,     7,    28,    29,    30,    -1,    12,
-      13,    34,    15,    -1,    17,    18,    19,    20,    -1,    -1,
-      -1,    -1,    25,    -1,    27,    28,    -1,    -1,    -1,    32,
-      33,    -1,    -1,    -1,    -1,    -1,    59,    60,    -1,    62,
-       6,     7,    -1,    66,    67,    -1,    12,    13,    -1,    15,
-      -1,    17,    18,    19,    20,    -1,    -1,    -1,    61,    25,
-      -1,    27,    28,     6,    -1,    -1,    32,    33,    -1,    12,
-      13,    -1,    15,    -1,    17,    18,    19,    20,    -1,    -1,
-      -1,    -1,    25,    -1,    27,    28,    -1,    -1,    -1,    32,
-      33,    -1,    -1,    -1,    -1,    61,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    58,    59,    60,    -1,    62,    -1,
+      64,    -1,    66,    67,     6,     7,    -1,    -1,    -1,    -1,
+      12,    13,    -1,    15,    -1,    17,    18,    19,    20,    -1,
+      -1,    -1,    -1,    25,    -1,    27,    28,     6,     7,    -1,
+      32,    33,    -1,    12,    13,    -1,    15,    -1,    17,    18,
+      19,    20,    -1,    -1,    -1,    -1,    25,    -1,    27,    28,
+      -1,     6,    -1,    32,    33,    -1,    -1,    12,    13,    61,
+      15,    -1,    17,    18,    19,    20,    -1,    -1,    -1,    -1,
+      25,    -1,    27,    28,    -1,    -1,    -1,    32,    33,    -1,
+      -1,    -1,    61,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
       -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
-      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    61
+      -1,    -1,    -1,    -1,    -1,    -1,    61
 };
 
-  /* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
-     symbol of state STATE-NUM.  */
-static const yytype_uint8 yystos[] =
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
 {
-       0,     6,     7,    12,    13,    15,    17,    18,    19,    20,
-      25,    27,    28,    32,    33,    61,    71,    72,    73,    74,
-      75,    79,    95,    96,    97,    62,    62,     3,     4,     5,
-      26,    28,    29,    30,    34,    57,    58,    59,    60,    62,
-      64,    66,    67,    86,    87,    88,    89,    90,    91,    92,
-      94,    95,    97,    98,    99,    86,    97,    84,    97,    86,
-      86,    97,    97,    86,    62,     0,    73,     7,    74,    62,
-      37,    38,    39,    40,    41,    42,    43,    83,    68,    62,
-      64,    76,    63,    63,    62,    97,    87,    62,    62,    62,
-      86,    86,    93,    31,    49,    48,    50,    55,    56,    51,
-      52,    53,    54,    29,    30,    44,    45,    46,    47,    69,
-      62,    76,     3,     4,    31,    36,    31,    62,    97,    78,
-      97,    86,    86,    77,    86,    86,    64,    63,    86,    62,
-      86,    97,    97,    63,    16,    65,     7,    80,    88,    89,
-      90,    90,    90,    91,    91,    91,    91,    92,    92,    94,
-      94,    94,    94,    94,    77,    80,    86,    74,    80,    77,
-      16,    16,    63,    68,    16,    63,    65,    86,    63,    77,
-      63,    63,    63,    86,    45,     8,    81,    63,    31,    14,
-      15,    85,    63,    86,    97,    31,    86,    86,    65,    63,
-      94,    72,    80,    31,    86,    63,    68,    80,     9,    82,
-      80,    31,    86,    80,    14,    85,    31,    80
+       0,    71,    72,     0,     6,     7,    12,    13,    15,    17,
+      18,    19,    20,    25,    27,    28,    32,    33,    61,    76,
+      80,    96,    97,    98,    62,    62,     3,     4,     5,    26,
+      28,    29,    30,    34,    57,    58,    59,    60,    62,    64,
+      66,    67,    87,    88,    89,    90,    91,    92,    93,    95,
+      96,    98,    99,   100,    87,    98,    85,    98,    87,    87,
+      98,    98,    87,    62,    62,    37,    38,    39,    40,    41,
+      42,    43,    84,    68,    62,    64,    77,    63,    63,    62,
+      98,    88,    62,    62,    62,    87,    87,    94,    31,    49,
+      48,    50,    55,    56,    51,    52,    53,    54,    29,    30,
+      44,    45,    46,    47,    69,    62,    77,     3,     4,    31,
+      36,    31,    62,    98,    79,    98,    87,    87,    78,    87,
+      87,    64,    63,    87,    62,    87,    98,    98,    63,    16,
+      65,     7,    81,    89,    90,    91,    91,    91,    92,    92,
+      92,    92,    93,    93,    95,    95,    95,    95,    95,    78,
+      81,    87,    75,    76,    81,    78,    16,    16,    63,    68,
+      16,    63,    65,    87,    63,    78,    63,    63,    63,    87,
+      45,     8,    82,    63,    31,    75,    14,    15,    86,    63,
+      87,    98,    31,    87,    87,    65,    63,    95,     7,    73,
+      74,    75,    81,    31,    87,    63,    68,    81,     9,    74,
+      83,     7,    81,    31,    87,    81,    14,    86,    31,    81
 };
 
-  /* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
-static const yytype_uint8 yyr1[] =
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
 {
-       0,    70,    71,    72,    72,    73,    73,    73,    74,    74,
-      75,    75,    75,    75,    75,    75,    75,    75,    75,    75,
-      75,    75,    75,    75,    75,    75,    75,    75,    75,    75,
-      76,    76,    77,    77,    77,    78,    78,    78,    78,    78,
-      79,    80,    81,    82,    83,    83,    83,    83,    83,    83,
-      83,    84,    85,    85,    85,    86,    86,    87,    87,    88,
-      88,    89,    89,    89,    89,    90,    90,    90,    90,    90,
-      91,    91,    91,    92,    92,    92,    92,    92,    92,    92,
-      92,    92,    92,    92,    93,    93,    94,    94,    94,    94,
-      94,    94,    94,    95,    95,    96,    96,    97,    98,    98,
-      98,    98,    98,    98,    98,    98,    99,    99
+       0,    70,    71,    72,    72,    72,    73,    73,    74,    74,
+      74,    75,    75,    76,    76,    76,    76,    76,    76,    76,
+      76,    76,    76,    76,    76,    76,    76,    76,    76,    76,
+      76,    76,    76,    77,    77,    78,    78,    78,    79,    79,
+      79,    79,    79,    80,    81,    82,    83,    84,    84,    84,
+      84,    84,    84,    84,    85,    86,    86,    86,    87,    87,
+      88,    88,    89,    89,    90,    90,    90,    90,    91,    91,
+      91,    91,    91,    92,    92,    92,    93,    93,    93,    93,
+      93,    93,    93,    93,    93,    93,    93,    94,    94,    95,
+      95,    95,    95,    95,    95,    95,    96,    96,    97,    97,
+      98,    99,    99,    99,    99,    99,    99,    99,    99,   100,
+     100
 };
 
-  /* YYR2[YYN] -- Number of symbols on the right hand side of rule YYN.  */
-static const yytype_uint8 yyr2[] =
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
 {
-       0,     2,     1,     1,     2,     2,     1,     1,     2,     1,
-       6,     4,     4,     7,     5,     4,     4,     3,     3,     2,
-       3,     3,     6,     1,     2,     4,     5,     1,     2,     6,
-       3,     4,     0,     1,     3,     0,     1,     3,     3,     5,
-       2,     4,     1,     1,     1,     1,     1,     1,     1,     1,
-       1,     1,     4,     7,     5,     1,     2,     1,     3,     1,
-       3,     1,     3,     3,     3,     1,     3,     3,     3,     3,
-       1,     3,     3,     1,     3,     3,     3,     3,     3,     4,
-       3,     5,     3,     4,     1,     3,     1,     3,     1,     4,
-       5,     4,     4,     1,     2,     1,     2,     1,     1,     1,
-       2,     2,     1,     1,     1,     1,     1,     1
+       0,     2,     1,     0,     2,     2,     1,     2,     2,     1,
+       1,     2,     1,     6,     4,     4,     7,     5,     4,     4,
+       3,     3,     2,     3,     3,     6,     1,     2,     4,     5,
+       1,     2,     6,     3,     4,     0,     1,     3,     0,     1,
+       3,     3,     5,     2,     4,     1,     1,     1,     1,     1,
+       1,     1,     1,     1,     1,     4,     7,     5,     1,     2,
+       1,     3,     1,     3,     1,     3,     3,     3,     1,     3,
+       3,     3,     3,     1,     3,     3,     1,     3,     3,     3,
+       3,     3,     4,     3,     5,     3,     4,     1,     3,     1,
+       3,     1,     4,     5,     4,     4,     1,     2,     1,     2,
+       1,     1,     1,     2,     2,     1,     1,     1,     1,     1,
+       1
 };
 
 
+enum { YYENOMEM = -2 };
+
 #define yyerrok         (yyerrstatus = 0)
 #define yyclearin       (yychar = YYEMPTY)
-#define YYEMPTY         (-2)
-#define YYEOF           0
 
 #define YYACCEPT        goto yyacceptlab
 #define YYABORT         goto yyabortlab
 #define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
 
 
 #define YYRECOVERING()  (!!yyerrstatus)
 
-#define YYBACKUP(Token, Value)                                  \
-do                                                              \
-  if (yychar == YYEMPTY)                                        \
-    {                                                           \
-      yychar = (Token);                                         \
-      yylval = (Value);                                         \
-      YYPOPSTACK (yylen);                                       \
-      yystate = *yyssp;                                         \
-      goto yybackup;                                            \
-    }                                                           \
-  else                                                          \
-    {                                                           \
-      yyerror (YY_("syntax error: cannot back up")); \
-      YYERROR;                                                  \
-    }                                                           \
-while (0)
-
-/* Error token number */
-#define YYTERROR        1
-#define YYERRCODE       256
-
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
 
 
 /* Enable debugging if requested.  */
@@ -926,55 +954,52 @@ do {                                            \
     YYFPRINTF Args;                             \
 } while (0)
 
-/* This macro is provided for backward compatibility. */
-#ifndef YY_LOCATION_PRINT
-# define YY_LOCATION_PRINT(File, Loc) ((void) 0)
-#endif
 
 
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)                    \
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
 do {                                                                      \
   if (yydebug)                                                            \
     {                                                                     \
       YYFPRINTF (stderr, "%s ", Title);                                   \
       yy_symbol_print (stderr,                                            \
-                  Type, Value); \
+                  Kind, Value); \
       YYFPRINTF (stderr, "\n");                                           \
     }                                                                     \
 } while (0)
 
 
-/*----------------------------------------.
-| Print this symbol's value on YYOUTPUT.  |
-`----------------------------------------*/
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
 
 static void
-yy_symbol_value_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep)
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
 {
-  FILE *yyo = yyoutput;
-  YYUSE (yyo);
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
   if (!yyvaluep)
     return;
-# ifdef YYPRINT
-  if (yytype < YYNTOKENS)
-    YYPRINT (yyoutput, yytoknum[yytype], *yyvaluep);
-# endif
-  YYUSE (yytype);
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
-/*--------------------------------.
-| Print this symbol on YYOUTPUT.  |
-`--------------------------------*/
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
 
 static void
-yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep)
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
 {
-  YYFPRINTF (yyoutput, "%s %s (",
-             yytype < YYNTOKENS ? "token" : "nterm", yytname[yytype]);
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
-  yy_symbol_value_print (yyoutput, yytype, yyvaluep);
-  YYFPRINTF (yyoutput, ")");
+  yy_symbol_value_print (yyo, yykind, yyvaluep);
+  YYFPRINTF (yyo, ")");
 }
 
 /*------------------------------------------------------------------.
@@ -983,7 +1008,7 @@ yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep)
 `------------------------------------------------------------------*/
 
 static void
-yy_stack_print (yytype_int16 *yybottom, yytype_int16 *yytop)
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
 {
   YYFPRINTF (stderr, "Stack now");
   for (; yybottom <= yytop; yybottom++)
@@ -1006,21 +1031,21 @@ do {                                                            \
 `------------------------------------------------*/
 
 static void
-yy_reduce_print (yytype_int16 *yyssp, YYSTYPE *yyvsp, int yyrule)
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule)
 {
-  unsigned long int yylno = yyrline[yyrule];
+  int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
   int yyi;
-  YYFPRINTF (stderr, "Reducing stack by rule %d (line %lu):\n",
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
              yyrule - 1, yylno);
   /* The symbols being reduced.  */
   for (yyi = 0; yyi < yynrhs; yyi++)
     {
       YYFPRINTF (stderr, "   $%d = ", yyi + 1);
       yy_symbol_print (stderr,
-                       yystos[yyssp[yyi + 1 - yynrhs]],
-                       &(yyvsp[(yyi + 1) - (yynrhs)])
-                                              );
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)]);
       YYFPRINTF (stderr, "\n");
     }
 }
@@ -1035,8 +1060,8 @@ do {                                    \
    multiple parsers can coexist.  */
 int yydebug;
 #else /* !YYDEBUG */
-# define YYDPRINTF(Args)
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
 # define YY_STACK_PRINT(Bottom, Top)
 # define YY_REDUCE_PRINT(Rule)
 #endif /* !YYDEBUG */
@@ -1059,249 +1084,30 @@ int yydebug;
 #endif
 
 
-#if YYERROR_VERBOSE
-
-# ifndef yystrlen
-#  if defined __GLIBC__ && defined _STRING_H
-#   define yystrlen strlen
-#  else
-/* Return the length of YYSTR.  */
-static YYSIZE_T
-yystrlen (const char *yystr)
-{
-  YYSIZE_T yylen;
-  for (yylen = 0; yystr[yylen]; yylen++)
-    continue;
-  return yylen;
-}
-#  endif
-# endif
-
-# ifndef yystpcpy
-#  if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
-#   define yystpcpy stpcpy
-#  else
-/* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
-   YYDEST.  */
-static char *
-yystpcpy (char *yydest, const char *yysrc)
-{
-  char *yyd = yydest;
-  const char *yys = yysrc;
 
-  while ((*yyd++ = *yys++) != '\0')
-    continue;
 
-  return yyd - 1;
-}
-#  endif
-# endif
 
-# ifndef yytnamerr
-/* Copy to YYRES the contents of YYSTR after stripping away unnecessary
-   quotes and backslashes, so that it's suitable for yyerror.  The
-   heuristic is that double-quoting is unnecessary unless the string
-   contains an apostrophe, a comma, or backslash (other than
-   backslash-backslash).  YYSTR is taken from yytname.  If YYRES is
-   null, do not copy; instead, return the length of what the result
-   would have been.  */
-static YYSIZE_T
-yytnamerr (char *yyres, const char *yystr)
-{
-  if (*yystr == '"')
-    {
-      YYSIZE_T yyn = 0;
-      char const *yyp = yystr;
-
-      for (;;)
-        switch (*++yyp)
-          {
-          case '\'':
-          case ',':
-            goto do_not_strip_quotes;
-
-          case '\\':
-            if (*++yyp != '\\')
-              goto do_not_strip_quotes;
-            /* Fall through.  */
-          default:
-            if (yyres)
-              yyres[yyn] = *yyp;
-            yyn++;
-            break;
-
-          case '"':
-            if (yyres)
-              yyres[yyn] = '\0';
-            return yyn;
-          }
-    do_not_strip_quotes: ;
-    }
-
-  if (! yyres)
-    return yystrlen (yystr);
-
-  return yystpcpy (yyres, yystr) - yyres;
-}
-# endif
-
-/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
-   about the unexpected token YYTOKEN for the state stack whose top is
-   YYSSP.
-
-   Return 0 if *YYMSG was successfully written.  Return 1 if *YYMSG is
-   not large enough to hold the message.  In that case, also set
-   *YYMSG_ALLOC to the required number of bytes.  Return 2 if the
-   required number of bytes is too large to store.  */
-static int
-yysyntax_error (YYSIZE_T *yymsg_alloc, char **yymsg,
-                yytype_int16 *yyssp, int yytoken)
-{
-  YYSIZE_T yysize0 = yytnamerr (YY_NULLPTR, yytname[yytoken]);
-  YYSIZE_T yysize = yysize0;
-  enum { YYERROR_VERBOSE_ARGS_MAXIMUM = 5 };
-  /* Internationalized format string. */
-  const char *yyformat = YY_NULLPTR;
-  /* Arguments of yyformat. */
-  char const *yyarg[YYERROR_VERBOSE_ARGS_MAXIMUM];
-  /* Number of reported tokens (one for the "unexpected", one per
-     "expected"). */
-  int yycount = 0;
-
-  /* There are many possibilities here to consider:
-     - If this state is a consistent state with a default action, then
-       the only way this function was invoked is if the default action
-       is an error action.  In that case, don't check for expected
-       tokens because there are none.
-     - The only way there can be no lookahead present (in yychar) is if
-       this state is a consistent state with a default action.  Thus,
-       detecting the absence of a lookahead is sufficient to determine
-       that there is no unexpected or expected token to report.  In that
-       case, just report a simple "syntax error".
-     - Don't assume there isn't a lookahead just because this state is a
-       consistent state with a default action.  There might have been a
-       previous inconsistent state, consistent state with a non-default
-       action, or user semantic action that manipulated yychar.
-     - Of course, the expected token list depends on states to have
-       correct lookahead information, and it depends on the parser not
-       to perform extra reductions after fetching a lookahead from the
-       scanner and before detecting a syntax error.  Thus, state merging
-       (from LALR or IELR) and default reductions corrupt the expected
-       token list.  However, the list is correct for canonical LR with
-       one exception: it will still contain any token that will not be
-       accepted due to an error action in a later state.
-  */
-  if (yytoken != YYEMPTY)
-    {
-      int yyn = yypact[*yyssp];
-      yyarg[yycount++] = yytname[yytoken];
-      if (!yypact_value_is_default (yyn))
-        {
-          /* Start YYX at -YYN if negative to avoid negative indexes in
-             YYCHECK.  In other words, skip the first -YYN actions for
-             this state because they are default actions.  */
-          int yyxbegin = yyn < 0 ? -yyn : 0;
-          /* Stay within bounds of both yycheck and yytname.  */
-          int yychecklim = YYLAST - yyn + 1;
-          int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
-          int yyx;
-
-          for (yyx = yyxbegin; yyx < yyxend; ++yyx)
-            if (yycheck[yyx + yyn] == yyx && yyx != YYTERROR
-                && !yytable_value_is_error (yytable[yyx + yyn]))
-              {
-                if (yycount == YYERROR_VERBOSE_ARGS_MAXIMUM)
-                  {
-                    yycount = 1;
-                    yysize = yysize0;
-                    break;
-                  }
-                yyarg[yycount++] = yytname[yyx];
-                {
-                  YYSIZE_T yysize1 = yysize + yytnamerr (YY_NULLPTR, yytname[yyx]);
-                  if (! (yysize <= yysize1
-                         && yysize1 <= YYSTACK_ALLOC_MAXIMUM))
-                    return 2;
-                  yysize = yysize1;
-                }
-              }
-        }
-    }
-
-  switch (yycount)
-    {
-# define YYCASE_(N, S)                      \
-      case N:                               \
-        yyformat = S;                       \
-      break
-      YYCASE_(0, YY_("syntax error"));
-      YYCASE_(1, YY_("syntax error, unexpected %s"));
-      YYCASE_(2, YY_("syntax error, unexpected %s, expecting %s"));
-      YYCASE_(3, YY_("syntax error, unexpected %s, expecting %s or %s"));
-      YYCASE_(4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
-      YYCASE_(5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
-# undef YYCASE_
-    }
-
-  {
-    YYSIZE_T yysize1 = yysize + yystrlen (yyformat);
-    if (! (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM))
-      return 2;
-    yysize = yysize1;
-  }
-
-  if (*yymsg_alloc < yysize)
-    {
-      *yymsg_alloc = 2 * yysize;
-      if (! (yysize <= *yymsg_alloc
-             && *yymsg_alloc <= YYSTACK_ALLOC_MAXIMUM))
-        *yymsg_alloc = YYSTACK_ALLOC_MAXIMUM;
-      return 1;
-    }
-
-  /* Avoid sprintf, as that infringes on the user's name space.
-     Don't have undefined behavior even if the translation
-     produced a string with the wrong number of "%s"s.  */
-  {
-    char *yyp = *yymsg;
-    int yyi = 0;
-    while ((*yyp = *yyformat) != '\0')
-      if (*yyp == '%' && yyformat[1] == 's' && yyi < yycount)
-        {
-          yyp += yytnamerr (yyp, yyarg[yyi++]);
-          yyformat += 2;
-        }
-      else
-        {
-          yyp++;
-          yyformat++;
-        }
-  }
-  return 0;
-}
-#endif /* YYERROR_VERBOSE */
 
 /*-----------------------------------------------.
 | Release the memory associated to this symbol.  |
 `-----------------------------------------------*/
 
 static void
-yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep)
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep)
 {
-  YYUSE (yyvaluep);
+  YY_USE (yyvaluep);
   if (!yymsg)
     yymsg = "Deleting";
-  YY_SYMBOL_PRINT (yymsg, yytype, yyvaluep, yylocationp);
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
 
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  YYUSE (yytype);
+  YY_USE (yykind);
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
-
-
-/* The lookahead symbol.  */
+/* Lookahead token kind.  */
 int yychar;
 
 /* The semantic value of the lookahead symbol.  */
@@ -1310,6 +1116,8 @@ YYSTYPE yylval;
 int yynerrs;
 
 
+
+
 /*----------.
 | yyparse.  |
 `----------*/
@@ -1317,43 +1125,36 @@ int yynerrs;
 int
 yyparse (void)
 {
-    int yystate;
+    yy_state_fast_t yystate = 0;
     /* Number of tokens to shift before error messages enabled.  */
-    int yyerrstatus;
+    int yyerrstatus = 0;
 
-    /* The stacks and their tools:
-       'yyss': related to states.
-       'yyvs': related to semantic values.
-
-       Refer to the stacks through separate pointers, to allow yyoverflow
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
        to reallocate them elsewhere.  */
 
-    /* The state stack.  */
-    yytype_int16 yyssa[YYINITDEPTH];
-    yytype_int16 *yyss;
-    yytype_int16 *yyssp;
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
 
-    /* The semantic value stack.  */
-    YYSTYPE yyvsa[YYINITDEPTH];
-    YYSTYPE *yyvs;
-    YYSTYPE *yyvsp;
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
 
-    YYSIZE_T yystacksize;
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
 
   int yyn;
+  /* The return value of yyparse.  */
   int yyresult;
-  /* Lookahead token as an internal (translated) token number.  */
-  int yytoken = 0;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
   /* The variables used to return semantic value and location from the
      action routines.  */
   YYSTYPE yyval;
 
-#if YYERROR_VERBOSE
-  /* Buffer for error messages, and its allocated size.  */
-  char yymsgbuf[128];
-  char *yymsg = yymsgbuf;
-  YYSIZE_T yymsg_alloc = sizeof yymsgbuf;
-#endif
+
 
 #define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
 
@@ -1361,71 +1162,75 @@ yyparse (void)
      Keep to zero when no symbol should be popped.  */
   int yylen = 0;
 
-  yyssp = yyss = yyssa;
-  yyvsp = yyvs = yyvsa;
-  yystacksize = YYINITDEPTH;
-
   YYDPRINTF ((stderr, "Starting parse\n"));
 
-  yystate = 0;
-  yyerrstatus = 0;
-  yynerrs = 0;
   yychar = YYEMPTY; /* Cause a token to be read.  */
+
   goto yysetstate;
 
+
 /*------------------------------------------------------------.
-| yynewstate -- Push a new state, which is found in yystate.  |
+| yynewstate -- push a new state, which is found in yystate.  |
 `------------------------------------------------------------*/
- yynewstate:
+yynewstate:
   /* In all cases, when you get here, the value and location stacks
      have just been pushed.  So pushing a state here evens the stacks.  */
   yyssp++;
 
- yysetstate:
-  *yyssp = yystate;
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
 
   if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
     {
       /* Get the current used size of the three stacks, in elements.  */
-      YYSIZE_T yysize = yyssp - yyss + 1;
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
 
-#ifdef yyoverflow
+# if defined yyoverflow
       {
         /* Give user a chance to reallocate the stack.  Use copies of
            these so that the &'s don't force the real ones into
            memory.  */
+        yy_state_t *yyss1 = yyss;
         YYSTYPE *yyvs1 = yyvs;
-        yytype_int16 *yyss1 = yyss;
 
         /* Each stack pointer address is followed by the size of the
            data in use in that stack, in bytes.  This used to be a
            conditional around just the two extra args, but that might
            be undefined if yyoverflow is a macro.  */
         yyoverflow (YY_("memory exhausted"),
-                    &yyss1, yysize * sizeof (*yyssp),
-                    &yyvs1, yysize * sizeof (*yyvsp),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
                     &yystacksize);
-
         yyss = yyss1;
         yyvs = yyvs1;
       }
-#else /* no yyoverflow */
-# ifndef YYSTACK_RELOCATE
-      goto yyexhaustedlab;
-# else
+# else /* defined YYSTACK_RELOCATE */
       /* Extend the stack our own way.  */
       if (YYMAXDEPTH <= yystacksize)
-        goto yyexhaustedlab;
+        YYNOMEM;
       yystacksize *= 2;
       if (YYMAXDEPTH < yystacksize)
         yystacksize = YYMAXDEPTH;
 
       {
-        yytype_int16 *yyss1 = yyss;
+        yy_state_t *yyss1 = yyss;
         union yyalloc *yyptr =
-          (union yyalloc *) YYSTACK_ALLOC (YYSTACK_BYTES (yystacksize));
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
         if (! yyptr)
-          goto yyexhaustedlab;
+          YYNOMEM;
         YYSTACK_RELOCATE (yyss_alloc, yyss);
         YYSTACK_RELOCATE (yyvs_alloc, yyvs);
 #  undef YYSTACK_RELOCATE
@@ -1433,30 +1238,31 @@ yyparse (void)
           YYSTACK_FREE (yyss1);
       }
 # endif
-#endif /* no yyoverflow */
 
       yyssp = yyss + yysize - 1;
       yyvsp = yyvs + yysize - 1;
 
-      YYDPRINTF ((stderr, "Stack size increased to %lu\n",
-                  (unsigned long int) yystacksize));
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
 
       if (yyss + yystacksize - 1 <= yyssp)
         YYABORT;
     }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
 
-  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
 
   if (yystate == YYFINAL)
     YYACCEPT;
 
   goto yybackup;
 
+
 /*-----------.
 | yybackup.  |
 `-----------*/
 yybackup:
-
   /* Do appropriate processing given the current state.  Read a
      lookahead token if we need one and don't already have one.  */
 
@@ -1467,18 +1273,29 @@ yybackup:
 
   /* Not known => get a lookahead token if don't already have one.  */
 
-  /* YYCHAR is either YYEMPTY or YYEOF or a valid lookahead symbol.  */
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
   if (yychar == YYEMPTY)
     {
-      YYDPRINTF ((stderr, "Reading a token: "));
+      YYDPRINTF ((stderr, "Reading a token\n"));
       yychar = yylex ();
     }
 
   if (yychar <= YYEOF)
     {
-      yychar = yytoken = YYEOF;
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
       YYDPRINTF ((stderr, "Now at end of input.\n"));
     }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
   else
     {
       yytoken = YYTRANSLATE (yychar);
@@ -1506,15 +1323,13 @@ yybackup:
 
   /* Shift the lookahead token.  */
   YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
-
-  /* Discard the shifted token.  */
-  yychar = YYEMPTY;
-
   yystate = yyn;
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
   *++yyvsp = yylval;
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
   goto yynewstate;
 
 
@@ -1529,7 +1344,7 @@ yydefault:
 
 
 /*-----------------------------.
-| yyreduce -- Do a reduction.  |
+| yyreduce -- do a reduction.  |
 `-----------------------------*/
 yyreduce:
   /* yyn is the number of a rule to reduce with.  */
@@ -1549,632 +1364,651 @@ yyreduce:
   YY_REDUCE_PRINT (yyn);
   switch (yyn)
     {
-        case 2:
-#line 61 "epython.y" /* yacc.c:1646  */
-    { compileMemory((yyvsp[0].data)); }
-#line 1556 "parser.c" /* yacc.c:1646  */
+  case 2: /* program: toplevellines  */
+#line 64 "epython.y"
+                        { compileMemory(lowerIr((yyvsp[0].irlist))); }
+#line 1371 "parser.c"
     break;
 
-  case 4:
-#line 65 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=concatenateMemory((yyvsp[-1].data), (yyvsp[0].data)); }
-#line 1562 "parser.c" /* yacc.c:1646  */
+  case 3: /* toplevellines: %empty  */
+#line 67 "epython.y"
+                    { (yyval.irlist)=createIrList(); }
+#line 1377 "parser.c"
     break;
 
-  case 5:
-#line 69 "epython.y" /* yacc.c:1646  */
-    { (yyval.data) = (yyvsp[-1].data); }
-#line 1568 "parser.c" /* yacc.c:1646  */
+  case 4: /* toplevellines: toplevellines statement  */
+#line 68 "epython.y"
+                                  { appendIrStatements((yyvsp[-1].irlist), (yyvsp[0].ir)); (yyval.irlist)=lowerIrBatch((yyvsp[-1].irlist)); }
+#line 1383 "parser.c"
     break;
 
-  case 6:
-#line 70 "epython.y" /* yacc.c:1646  */
-    { (yyval.data) = (yyvsp[0].data); }
-#line 1574 "parser.c" /* yacc.c:1646  */
+  case 5: /* toplevellines: toplevellines NEWLINE  */
+#line 69 "epython.y"
+                                { (yyval.irlist)=(yyvsp[-1].irlist); }
+#line 1389 "parser.c"
     break;
 
-  case 7:
-#line 71 "epython.y" /* yacc.c:1646  */
-    { (yyval.data) = NULL; }
-#line 1580 "parser.c" /* yacc.c:1646  */
+  case 6: /* lines: line  */
+#line 73 "epython.y"
+               { (yyval.irlist)=createIrList(); appendIrStatements((yyval.irlist), (yyvsp[0].ir)); }
+#line 1395 "parser.c"
     break;
 
-  case 8:
-#line 75 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=concatenateMemory((yyvsp[-1].data), (yyvsp[0].data)); }
-#line 1586 "parser.c" /* yacc.c:1646  */
+  case 7: /* lines: lines line  */
+#line 74 "epython.y"
+                     { appendIrStatements((yyvsp[-1].irlist), (yyvsp[0].ir)); (yyval.irlist)=(yyvsp[-1].irlist); }
+#line 1401 "parser.c"
     break;
 
-  case 10:
-#line 80 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=appendForStatement((yyvsp[-4].string), (yyvsp[-2].data), (yyvsp[0].data)); leaveScope(); }
-#line 1592 "parser.c" /* yacc.c:1646  */
+  case 8: /* line: statements NEWLINE  */
+#line 78 "epython.y"
+                             { (yyval.ir) = (yyvsp[-1].ir); }
+#line 1407 "parser.c"
     break;
 
-  case 11:
-#line 81 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=appendWhileStatement((yyvsp[-2].data), (yyvsp[0].data)); }
-#line 1598 "parser.c" /* yacc.c:1646  */
+  case 9: /* line: statements  */
+#line 79 "epython.y"
+                     { (yyval.ir) = (yyvsp[0].ir); }
+#line 1413 "parser.c"
     break;
 
-  case 12:
-#line 82 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=appendIfStatement((yyvsp[-2].data), (yyvsp[0].data)); }
-#line 1604 "parser.c" /* yacc.c:1646  */
+  case 10: /* line: NEWLINE  */
+#line 80 "epython.y"
+                      { (yyval.ir) = NULL; }
+#line 1419 "parser.c"
     break;
 
-  case 13:
-#line 83 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=appendIfElseStatement((yyvsp[-5].data), (yyvsp[-3].data), (yyvsp[0].data)); }
-#line 1610 "parser.c" /* yacc.c:1646  */
+  case 11: /* statements: statement statements  */
+#line 84 "epython.y"
+                               { (yyval.ir)=prependIrStatement((yyvsp[0].ir), (yyvsp[-1].ir)); }
+#line 1425 "parser.c"
     break;
 
-  case 14:
-#line 84 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=appendIfElseStatement((yyvsp[-3].data), (yyvsp[-1].data), (yyvsp[0].data)); }
-#line 1616 "parser.c" /* yacc.c:1646  */
+  case 12: /* statements: statement  */
+#line 85 "epython.y"
+                    { (yyval.ir) = (yyvsp[0].ir); }
+#line 1431 "parser.c"
     break;
 
-  case 15:
-#line 85 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=appendIfStatement((yyvsp[-2].data), (yyvsp[0].data)); }
-#line 1622 "parser.c" /* yacc.c:1646  */
+  case 13: /* statement: FOR declareident IN expression COLON codeblock  */
+#line 89 "epython.y"
+                                                         { (yyval.ir)=createIrFor((yyvsp[-4].string), (yyvsp[-2].ir), (yyvsp[0].ir)); }
+#line 1437 "parser.c"
     break;
 
-  case 16:
-#line 86 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=appendIfStatement((yyvsp[-2].data), (yyvsp[0].data)); }
-#line 1628 "parser.c" /* yacc.c:1646  */
+  case 14: /* statement: WHILE expression COLON codeblock  */
+#line 90 "epython.y"
+                                           { (yyval.ir)=createIrWhile((yyvsp[-2].ir), (yyvsp[0].ir)); }
+#line 1443 "parser.c"
     break;
 
-  case 17:
-#line 87 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=appendLetStatement((yyvsp[-2].data), (yyvsp[0].data)); }
-#line 1634 "parser.c" /* yacc.c:1646  */
+  case 15: /* statement: IF expression COLON codeblock  */
+#line 91 "epython.y"
+                                        { (yyval.ir)=createIrIf((yyvsp[-2].ir), (yyvsp[0].ir), NULL); }
+#line 1449 "parser.c"
     break;
 
-  case 18:
-#line 88 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=appendLetWithOperatorStatement((yyvsp[-2].data), (yyvsp[0].data), (yyvsp[-1].uchar)); }
-#line 1640 "parser.c" /* yacc.c:1646  */
+  case 16: /* statement: IF expression COLON codeblock ELSE COLON codeblock  */
+#line 92 "epython.y"
+                                                             { (yyval.ir)=createIrIf((yyvsp[-5].ir), (yyvsp[-3].ir), (yyvsp[0].ir)); }
+#line 1455 "parser.c"
     break;
 
-  case 19:
-#line 89 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=appendNativeCallFunctionStatement("rtl_print", NULL, (yyvsp[0].data)); }
-#line 1646 "parser.c" /* yacc.c:1646  */
+  case 17: /* statement: IF expression COLON codeblock elifblock  */
+#line 93 "epython.y"
+                                                  { (yyval.ir)=createIrIf((yyvsp[-3].ir), (yyvsp[-1].ir), (yyvsp[0].ir)); }
+#line 1461 "parser.c"
     break;
 
-  case 20:
-#line 90 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=appendStopStatement(); }
-#line 1652 "parser.c" /* yacc.c:1646  */
+  case 18: /* statement: IF expression COLON statements  */
+#line 94 "epython.y"
+                                         { (yyval.ir)=createIrIf((yyvsp[-2].ir), (yyvsp[0].ir), NULL); }
+#line 1467 "parser.c"
     break;
 
-  case 21:
-#line 91 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=appendStopStatement(); }
-#line 1658 "parser.c" /* yacc.c:1646  */
+  case 19: /* statement: ELIF expression COLON codeblock  */
+#line 95 "epython.y"
+                                          { (yyval.ir)=createIrIf((yyvsp[-2].ir), (yyvsp[0].ir), NULL); }
+#line 1473 "parser.c"
     break;
 
-  case 22:
-#line 92 "epython.y" /* yacc.c:1646  */
-    { appendNewFunctionStatement((yyvsp[-5].string), (yyvsp[-3].stack), (yyvsp[0].data)); leaveScope(); (yyval.data) = NULL; }
-#line 1664 "parser.c" /* yacc.c:1646  */
+  case 20: /* statement: identscalararraylhs ASSGN expression  */
+#line 96 "epython.y"
+                                               { (yyval.ir)=createIrLet((yyvsp[-2].ir), (yyvsp[0].ir)); }
+#line 1479 "parser.c"
     break;
 
-  case 23:
-#line 93 "epython.y" /* yacc.c:1646  */
-    { (yyval.data) = appendReturnStatement(); }
-#line 1670 "parser.c" /* yacc.c:1646  */
+  case 21: /* statement: identscalararray opassgn expression  */
+#line 97 "epython.y"
+                                              { (yyval.ir)=createIrLetWithOperator((yyvsp[-2].ir), (yyvsp[0].ir), (yyvsp[-1].uchar)); }
+#line 1485 "parser.c"
     break;
 
-  case 24:
-#line 94 "epython.y" /* yacc.c:1646  */
-    { (yyval.data) = appendReturnStatementWithExpression((yyvsp[0].data)); }
-#line 1676 "parser.c" /* yacc.c:1646  */
+  case 22: /* statement: PRINT expression  */
+#line 98 "epython.y"
+                           { (yyval.ir)=createIrNativeCall("rtl_print", NULL, (yyvsp[0].ir)); }
+#line 1491 "parser.c"
     break;
 
-  case 25:
-#line 95 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=appendCallFunctionStatement((yyvsp[-3].string), (yyvsp[-1].stack)); }
-#line 1682 "parser.c" /* yacc.c:1646  */
+  case 23: /* statement: EXIT LPAREN RPAREN  */
+#line 99 "epython.y"
+                            { (yyval.ir)=createIrStop(); }
+#line 1497 "parser.c"
     break;
 
-  case 26:
-#line 96 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=appendNativeCallFunctionStatement((yyvsp[-3].string), (yyvsp[-1].stack), NULL); }
-#line 1688 "parser.c" /* yacc.c:1646  */
+  case 24: /* statement: QUIT LPAREN RPAREN  */
+#line 100 "epython.y"
+                            { (yyval.ir)=createIrStop(); }
+#line 1503 "parser.c"
     break;
 
-  case 27:
-#line 97 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=appendPassStatement(); }
-#line 1694 "parser.c" /* yacc.c:1646  */
+  case 25: /* statement: fn_entry LPAREN fndeclarationargs RPAREN COLON codeblock  */
+#line 101 "epython.y"
+                                                                   { (yyval.ir)=createIrFunction((yyvsp[-5].string), (yyvsp[-3].irlist), (yyvsp[0].ir)); }
+#line 1509 "parser.c"
     break;
 
-  case 28:
-#line 98 "epython.y" /* yacc.c:1646  */
-    {  fn_decorator=(char*) malloc(strlen((yyvsp[0].string))+1); strcpy(fn_decorator, (yyvsp[0].string)); (yyval.data) = NULL; }
-#line 1700 "parser.c" /* yacc.c:1646  */
+  case 26: /* statement: RET  */
+#line 102 "epython.y"
+              { (yyval.ir) = createIrReturn(NULL); }
+#line 1515 "parser.c"
     break;
 
-  case 29:
-#line 99 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=appendAliasStatement((yyvsp[-3].string), (yyvsp[-1].data)); }
-#line 1706 "parser.c" /* yacc.c:1646  */
+  case 27: /* statement: RET expression  */
+#line 103 "epython.y"
+                         { (yyval.ir) = createIrReturn((yyvsp[0].ir)); }
+#line 1521 "parser.c"
     break;
 
-  case 30:
-#line 103 "epython.y" /* yacc.c:1646  */
-    { (yyval.stack)=getNewStack(); pushExpression((yyval.stack), (yyvsp[-1].data)); }
-#line 1712 "parser.c" /* yacc.c:1646  */
+  case 28: /* statement: ident LPAREN fncallargs RPAREN  */
+#line 104 "epython.y"
+                                         { (yyval.ir)=createIrCall((yyvsp[-3].string), (yyvsp[-1].irlist)); }
+#line 1527 "parser.c"
     break;
 
-  case 31:
-#line 104 "epython.y" /* yacc.c:1646  */
-    { pushExpression((yyvsp[-3].stack), (yyvsp[-1].data)); }
-#line 1718 "parser.c" /* yacc.c:1646  */
+  case 29: /* statement: NATIVE ident LPAREN fncallargs RPAREN  */
+#line 105 "epython.y"
+                                                { (yyval.ir)=createIrNativeCall((yyvsp[-3].string), (yyvsp[-1].irlist), NULL); }
+#line 1533 "parser.c"
     break;
 
-  case 32:
-#line 108 "epython.y" /* yacc.c:1646  */
-    { (yyval.stack)=getNewStack(); }
-#line 1724 "parser.c" /* yacc.c:1646  */
+  case 30: /* statement: PASS  */
+#line 106 "epython.y"
+               { (yyval.ir)=createIrPass(); }
+#line 1539 "parser.c"
     break;
 
-  case 33:
-#line 109 "epython.y" /* yacc.c:1646  */
-    { (yyval.stack)=getNewStack(); pushExpression((yyval.stack), (yyvsp[0].data)); }
-#line 1730 "parser.c" /* yacc.c:1646  */
+  case 31: /* statement: AT ident  */
+#line 107 "epython.y"
+                   { (yyval.ir)=createIrDecorator((yyvsp[0].string)); }
+#line 1545 "parser.c"
     break;
 
-  case 34:
-#line 110 "epython.y" /* yacc.c:1646  */
-    { pushExpression((yyvsp[-2].stack), (yyvsp[0].data)); (yyval.stack)=(yyvsp[-2].stack); }
-#line 1736 "parser.c" /* yacc.c:1646  */
+  case 32: /* statement: ALIAS LPAREN ident COMMA expression RPAREN  */
+#line 108 "epython.y"
+                                                     { (yyval.ir)=createIrAlias((yyvsp[-3].string), (yyvsp[-1].ir)); }
+#line 1551 "parser.c"
     break;
 
-  case 35:
-#line 114 "epython.y" /* yacc.c:1646  */
-    { enterScope(); (yyval.stack)=getNewStack(); }
-#line 1742 "parser.c" /* yacc.c:1646  */
+  case 33: /* arrayaccessor: SLBRACE expression SRBRACE  */
+#line 112 "epython.y"
+                                     { (yyval.irlist)=createIrList(); appendIrNode((yyval.irlist), (yyvsp[-1].ir)); }
+#line 1557 "parser.c"
     break;
 
-  case 36:
-#line 115 "epython.y" /* yacc.c:1646  */
-    { (yyval.stack)=getNewStack(); enterScope(); pushIdentifier((yyval.stack), (yyvsp[0].string)); appendArgument((yyvsp[0].string)); }
-#line 1748 "parser.c" /* yacc.c:1646  */
+  case 34: /* arrayaccessor: arrayaccessor SLBRACE expression SRBRACE  */
+#line 113 "epython.y"
+                                                   { appendIrNode((yyvsp[-3].irlist), (yyvsp[-1].ir)); }
+#line 1563 "parser.c"
     break;
 
-  case 37:
-#line 116 "epython.y" /* yacc.c:1646  */
-    { (yyval.stack)=getNewStack(); enterScope(); pushIdentifierAssgnExpression((yyval.stack), (yyvsp[-2].string), (yyvsp[0].data)); appendArgument((yyvsp[-2].string)); }
-#line 1754 "parser.c" /* yacc.c:1646  */
+  case 35: /* fncallargs: %empty  */
+#line 117 "epython.y"
+                    { (yyval.irlist)=createIrList(); }
+#line 1569 "parser.c"
     break;
 
-  case 38:
-#line 117 "epython.y" /* yacc.c:1646  */
-    { pushIdentifier((yyvsp[-2].stack), (yyvsp[0].string)); (yyval.stack)=(yyvsp[-2].stack); appendArgument((yyvsp[0].string)); }
-#line 1760 "parser.c" /* yacc.c:1646  */
+  case 36: /* fncallargs: expression  */
+#line 118 "epython.y"
+                     { (yyval.irlist)=createIrList(); appendIrNode((yyval.irlist), (yyvsp[0].ir)); }
+#line 1575 "parser.c"
     break;
 
-  case 39:
-#line 118 "epython.y" /* yacc.c:1646  */
-    { pushIdentifierAssgnExpression((yyvsp[-4].stack), (yyvsp[-2].string), (yyvsp[0].data)); (yyval.stack)=(yyvsp[-4].stack); appendArgument((yyvsp[-2].string)); }
-#line 1766 "parser.c" /* yacc.c:1646  */
+  case 37: /* fncallargs: fncallargs COMMA expression  */
+#line 119 "epython.y"
+                                      { appendIrNode((yyvsp[-2].irlist), (yyvsp[0].ir)); (yyval.irlist)=(yyvsp[-2].irlist); }
+#line 1581 "parser.c"
     break;
 
-  case 40:
-#line 122 "epython.y" /* yacc.c:1646  */
-    { enterFunction((yyvsp[0].string)); (yyval.string)=(yyvsp[0].string); }
-#line 1772 "parser.c" /* yacc.c:1646  */
+  case 38: /* fndeclarationargs: %empty  */
+#line 123 "epython.y"
+                    { (yyval.irlist)=createIrList(); }
+#line 1587 "parser.c"
     break;
 
-  case 41:
-#line 126 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=(yyvsp[-1].data); }
-#line 1778 "parser.c" /* yacc.c:1646  */
+  case 39: /* fndeclarationargs: ident  */
+#line 124 "epython.y"
+                { (yyval.irlist)=createIrList(); appendIrNode((yyval.irlist), createIrParameter((yyvsp[0].string), NULL)); }
+#line 1593 "parser.c"
     break;
 
-  case 42:
-#line 129 "epython.y" /* yacc.c:1646  */
-    { enterScope(); }
-#line 1784 "parser.c" /* yacc.c:1646  */
+  case 40: /* fndeclarationargs: ident ASSGN expression  */
+#line 125 "epython.y"
+                                 { (yyval.irlist)=createIrList(); appendIrNode((yyval.irlist), createIrParameter((yyvsp[-2].string), (yyvsp[0].ir))); }
+#line 1599 "parser.c"
     break;
 
-  case 43:
-#line 132 "epython.y" /* yacc.c:1646  */
-    { leaveScope(); }
-#line 1790 "parser.c" /* yacc.c:1646  */
+  case 41: /* fndeclarationargs: fndeclarationargs COMMA ident  */
+#line 126 "epython.y"
+                                        { appendIrNode((yyvsp[-2].irlist), createIrParameter((yyvsp[0].string), NULL)); (yyval.irlist)=(yyvsp[-2].irlist); }
+#line 1605 "parser.c"
     break;
 
-  case 44:
-#line 135 "epython.y" /* yacc.c:1646  */
-    { (yyval.uchar)=0; }
-#line 1796 "parser.c" /* yacc.c:1646  */
+  case 42: /* fndeclarationargs: fndeclarationargs COMMA ident ASSGN expression  */
+#line 127 "epython.y"
+                                                         { appendIrNode((yyvsp[-4].irlist), createIrParameter((yyvsp[-2].string), (yyvsp[0].ir))); (yyval.irlist)=(yyvsp[-4].irlist); }
+#line 1611 "parser.c"
     break;
 
-  case 45:
-#line 136 "epython.y" /* yacc.c:1646  */
-    { (yyval.uchar)=1; }
-#line 1802 "parser.c" /* yacc.c:1646  */
+  case 43: /* fn_entry: DEF ident  */
+#line 131 "epython.y"
+                    { (yyval.string)=(yyvsp[0].string); }
+#line 1617 "parser.c"
     break;
 
-  case 46:
-#line 137 "epython.y" /* yacc.c:1646  */
-    { (yyval.uchar)=2; }
-#line 1808 "parser.c" /* yacc.c:1646  */
+  case 44: /* codeblock: NEWLINE indent_rule lines outdent_rule  */
+#line 135 "epython.y"
+                                                 { (yyval.ir)=createIrBlock((yyvsp[-1].irlist), 1); }
+#line 1623 "parser.c"
     break;
 
-  case 47:
-#line 138 "epython.y" /* yacc.c:1646  */
-    { (yyval.uchar)=3; }
-#line 1814 "parser.c" /* yacc.c:1646  */
+  case 47: /* opassgn: ADDADD  */
+#line 144 "epython.y"
+                 { (yyval.uchar)=0; }
+#line 1629 "parser.c"
     break;
 
-  case 48:
-#line 139 "epython.y" /* yacc.c:1646  */
-    { (yyval.uchar)=4; }
-#line 1820 "parser.c" /* yacc.c:1646  */
+  case 48: /* opassgn: SUBSUB  */
+#line 145 "epython.y"
+                 { (yyval.uchar)=1; }
+#line 1635 "parser.c"
     break;
 
-  case 49:
-#line 140 "epython.y" /* yacc.c:1646  */
-    { (yyval.uchar)=5; }
-#line 1826 "parser.c" /* yacc.c:1646  */
+  case 49: /* opassgn: MULMUL  */
+#line 146 "epython.y"
+                 { (yyval.uchar)=2; }
+#line 1641 "parser.c"
     break;
 
-  case 50:
-#line 141 "epython.y" /* yacc.c:1646  */
-    { (yyval.uchar)=6; }
-#line 1832 "parser.c" /* yacc.c:1646  */
+  case 50: /* opassgn: DIVDIV  */
+#line 147 "epython.y"
+                 { (yyval.uchar)=3; }
+#line 1647 "parser.c"
     break;
 
-  case 51:
-#line 144 "epython.y" /* yacc.c:1646  */
-    { (yyval.string)=(yyvsp[0].string); enterScope(); addVariableIfNeeded((yyvsp[0].string)); }
-#line 1838 "parser.c" /* yacc.c:1646  */
+  case 51: /* opassgn: MODMOD  */
+#line 148 "epython.y"
+                 { (yyval.uchar)=4; }
+#line 1653 "parser.c"
     break;
 
-  case 52:
-#line 148 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=appendIfStatement((yyvsp[-2].data), (yyvsp[0].data)); }
-#line 1844 "parser.c" /* yacc.c:1646  */
+  case 52: /* opassgn: POWPOW  */
+#line 149 "epython.y"
+                 { (yyval.uchar)=5; }
+#line 1659 "parser.c"
     break;
 
-  case 53:
-#line 149 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=appendIfElseStatement((yyvsp[-5].data), (yyvsp[-3].data), (yyvsp[0].data)); }
-#line 1850 "parser.c" /* yacc.c:1646  */
+  case 53: /* opassgn: FLOORDIVFLOORDIV  */
+#line 150 "epython.y"
+                           { (yyval.uchar)=6; }
+#line 1665 "parser.c"
     break;
 
-  case 54:
-#line 150 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=appendIfElseStatement((yyvsp[-3].data), (yyvsp[-1].data), (yyvsp[0].data)); }
-#line 1856 "parser.c" /* yacc.c:1646  */
+  case 54: /* declareident: ident  */
+#line 153 "epython.y"
+                 { (yyval.string)=(yyvsp[0].string); }
+#line 1671 "parser.c"
     break;
 
-  case 55:
-#line 154 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=(yyvsp[0].data); }
-#line 1862 "parser.c" /* yacc.c:1646  */
+  case 55: /* elifblock: ELIF expression COLON codeblock  */
+#line 157 "epython.y"
+                                          { (yyval.ir)=createIrIf((yyvsp[-2].ir), (yyvsp[0].ir), NULL); }
+#line 1677 "parser.c"
     break;
 
-  case 56:
-#line 155 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=createNotExpression((yyvsp[0].data)); }
-#line 1868 "parser.c" /* yacc.c:1646  */
+  case 56: /* elifblock: ELIF expression COLON codeblock ELSE COLON codeblock  */
+#line 158 "epython.y"
+                                                               { (yyval.ir)=createIrIf((yyvsp[-5].ir), (yyvsp[-3].ir), (yyvsp[0].ir)); }
+#line 1683 "parser.c"
     break;
 
-  case 57:
-#line 159 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=(yyvsp[0].data); }
-#line 1874 "parser.c" /* yacc.c:1646  */
+  case 57: /* elifblock: ELIF expression COLON codeblock elifblock  */
+#line 159 "epython.y"
+                                                    { (yyval.ir)=createIrIf((yyvsp[-3].ir), (yyvsp[-1].ir), (yyvsp[0].ir)); }
+#line 1689 "parser.c"
     break;
 
-  case 58:
-#line 160 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=createOrExpression((yyvsp[-2].data), (yyvsp[0].data)); }
-#line 1880 "parser.c" /* yacc.c:1646  */
+  case 58: /* expression: logical_or_expression  */
+#line 163 "epython.y"
+                                { (yyval.ir)=(yyvsp[0].ir); }
+#line 1695 "parser.c"
     break;
 
-  case 59:
-#line 163 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=(yyvsp[0].data); }
-#line 1886 "parser.c" /* yacc.c:1646  */
+  case 59: /* expression: NOT logical_or_expression  */
+#line 164 "epython.y"
+                                    { (yyval.ir)=createIrNot((yyvsp[0].ir)); }
+#line 1701 "parser.c"
     break;
 
-  case 60:
-#line 164 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=createAndExpression((yyvsp[-2].data), (yyvsp[0].data)); }
-#line 1892 "parser.c" /* yacc.c:1646  */
+  case 60: /* logical_or_expression: logical_and_expression  */
+#line 168 "epython.y"
+                                 { (yyval.ir)=(yyvsp[0].ir); }
+#line 1707 "parser.c"
     break;
 
-  case 61:
-#line 168 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=(yyvsp[0].data); }
-#line 1898 "parser.c" /* yacc.c:1646  */
+  case 61: /* logical_or_expression: logical_or_expression OR logical_and_expression  */
+#line 169 "epython.y"
+                                                          { (yyval.ir)=createIrOperator(OR_TOKEN, (yyvsp[-2].ir), (yyvsp[0].ir)); }
+#line 1713 "parser.c"
     break;
 
-  case 62:
-#line 169 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=createEqExpression((yyvsp[-2].data), (yyvsp[0].data)); }
-#line 1904 "parser.c" /* yacc.c:1646  */
+  case 62: /* logical_and_expression: equality_expression  */
+#line 172 "epython.y"
+                              { (yyval.ir)=(yyvsp[0].ir); }
+#line 1719 "parser.c"
     break;
 
-  case 63:
-#line 170 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=createNeqExpression((yyvsp[-2].data), (yyvsp[0].data)); }
-#line 1910 "parser.c" /* yacc.c:1646  */
+  case 63: /* logical_and_expression: logical_and_expression AND equality_expression  */
+#line 173 "epython.y"
+                                                         { (yyval.ir)=createIrOperator(AND_TOKEN, (yyvsp[-2].ir), (yyvsp[0].ir)); }
+#line 1725 "parser.c"
     break;
 
-  case 64:
-#line 171 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=createIsExpression((yyvsp[-2].data), (yyvsp[0].data)); }
-#line 1916 "parser.c" /* yacc.c:1646  */
+  case 64: /* equality_expression: relational_expression  */
+#line 177 "epython.y"
+                                { (yyval.ir)=(yyvsp[0].ir); }
+#line 1731 "parser.c"
     break;
 
-  case 65:
-#line 175 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=(yyvsp[0].data); }
-#line 1922 "parser.c" /* yacc.c:1646  */
+  case 65: /* equality_expression: equality_expression EQ relational_expression  */
+#line 178 "epython.y"
+                                                       { (yyval.ir)=createIrOperator(EQ_TOKEN, (yyvsp[-2].ir), (yyvsp[0].ir)); }
+#line 1737 "parser.c"
     break;
 
-  case 66:
-#line 176 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=createGtExpression((yyvsp[-2].data), (yyvsp[0].data)); }
-#line 1928 "parser.c" /* yacc.c:1646  */
+  case 66: /* equality_expression: equality_expression NEQ relational_expression  */
+#line 179 "epython.y"
+                                                        { (yyval.ir)=createIrOperator(NEQ_TOKEN, (yyvsp[-2].ir), (yyvsp[0].ir)); }
+#line 1743 "parser.c"
     break;
 
-  case 67:
-#line 177 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=createLtExpression((yyvsp[-2].data), (yyvsp[0].data)); }
-#line 1934 "parser.c" /* yacc.c:1646  */
+  case 67: /* equality_expression: equality_expression IS relational_expression  */
+#line 180 "epython.y"
+                                                       { (yyval.ir)=createIrOperator(IS_TOKEN, (yyvsp[-2].ir), (yyvsp[0].ir)); }
+#line 1749 "parser.c"
     break;
 
-  case 68:
-#line 178 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=createLeqExpression((yyvsp[-2].data), (yyvsp[0].data)); }
-#line 1940 "parser.c" /* yacc.c:1646  */
+  case 68: /* relational_expression: additive_expression  */
+#line 184 "epython.y"
+                              { (yyval.ir)=(yyvsp[0].ir); }
+#line 1755 "parser.c"
     break;
 
-  case 69:
-#line 179 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=createGeqExpression((yyvsp[-2].data), (yyvsp[0].data)); }
-#line 1946 "parser.c" /* yacc.c:1646  */
+  case 69: /* relational_expression: relational_expression GT additive_expression  */
+#line 185 "epython.y"
+                                                       { (yyval.ir)=createIrOperator(GT_TOKEN, (yyvsp[-2].ir), (yyvsp[0].ir)); }
+#line 1761 "parser.c"
     break;
 
-  case 70:
-#line 183 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=(yyvsp[0].data); }
-#line 1952 "parser.c" /* yacc.c:1646  */
+  case 70: /* relational_expression: relational_expression LT additive_expression  */
+#line 186 "epython.y"
+                                                       { (yyval.ir)=createIrOperator(LT_TOKEN, (yyvsp[-2].ir), (yyvsp[0].ir)); }
+#line 1767 "parser.c"
     break;
 
-  case 71:
-#line 184 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=createAddExpression((yyvsp[-2].data), (yyvsp[0].data)); }
-#line 1958 "parser.c" /* yacc.c:1646  */
+  case 71: /* relational_expression: relational_expression LEQ additive_expression  */
+#line 187 "epython.y"
+                                                        { (yyval.ir)=createIrOperator(LEQ_TOKEN, (yyvsp[-2].ir), (yyvsp[0].ir)); }
+#line 1773 "parser.c"
     break;
 
-  case 72:
-#line 185 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=createSubExpression((yyvsp[-2].data), (yyvsp[0].data)); }
-#line 1964 "parser.c" /* yacc.c:1646  */
+  case 72: /* relational_expression: relational_expression GEQ additive_expression  */
+#line 188 "epython.y"
+                                                        { (yyval.ir)=createIrOperator(GEQ_TOKEN, (yyvsp[-2].ir), (yyvsp[0].ir)); }
+#line 1779 "parser.c"
     break;
 
-  case 73:
-#line 189 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=(yyvsp[0].data); }
-#line 1970 "parser.c" /* yacc.c:1646  */
+  case 73: /* additive_expression: multiplicative_expression  */
+#line 192 "epython.y"
+                                    { (yyval.ir)=(yyvsp[0].ir); }
+#line 1785 "parser.c"
     break;
 
-  case 74:
-#line 190 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=createMulExpression((yyvsp[-2].data), (yyvsp[0].data)); }
-#line 1976 "parser.c" /* yacc.c:1646  */
+  case 74: /* additive_expression: additive_expression ADD multiplicative_expression  */
+#line 193 "epython.y"
+                                                            { (yyval.ir)=createIrOperator(ADD_TOKEN, (yyvsp[-2].ir), (yyvsp[0].ir)); }
+#line 1791 "parser.c"
     break;
 
-  case 75:
-#line 191 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=createDivExpression((yyvsp[-2].data), (yyvsp[0].data)); }
-#line 1982 "parser.c" /* yacc.c:1646  */
+  case 75: /* additive_expression: additive_expression SUB multiplicative_expression  */
+#line 194 "epython.y"
+                                                            { (yyval.ir)=createIrOperator(SUB_TOKEN, (yyvsp[-2].ir), (yyvsp[0].ir)); }
+#line 1797 "parser.c"
     break;
 
-  case 76:
-#line 192 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=createFloorDivExpression((yyvsp[-2].data), (yyvsp[0].data)); }
-#line 1988 "parser.c" /* yacc.c:1646  */
+  case 76: /* multiplicative_expression: value  */
+#line 198 "epython.y"
+                { (yyval.ir)=(yyvsp[0].ir); }
+#line 1803 "parser.c"
     break;
 
-  case 77:
-#line 193 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=createModExpression((yyvsp[-2].data), (yyvsp[0].data)); }
-#line 1994 "parser.c" /* yacc.c:1646  */
+  case 77: /* multiplicative_expression: multiplicative_expression MULT value  */
+#line 199 "epython.y"
+                                               { (yyval.ir)=createIrOperator(MUL_TOKEN, (yyvsp[-2].ir), (yyvsp[0].ir)); }
+#line 1809 "parser.c"
     break;
 
-  case 78:
-#line 194 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=createPowExpression((yyvsp[-2].data), (yyvsp[0].data)); }
-#line 2000 "parser.c" /* yacc.c:1646  */
+  case 78: /* multiplicative_expression: multiplicative_expression DIV value  */
+#line 200 "epython.y"
+                                              { (yyval.ir)=createIrOperator(DIV_TOKEN, (yyvsp[-2].ir), (yyvsp[0].ir)); }
+#line 1815 "parser.c"
     break;
 
-  case 79:
-#line 195 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=(yyvsp[-1].data); }
-#line 2006 "parser.c" /* yacc.c:1646  */
+  case 79: /* multiplicative_expression: multiplicative_expression FLOORDIV value  */
+#line 201 "epython.y"
+                                                   { (yyval.ir)=createIrFloorDiv((yyvsp[-2].ir), (yyvsp[0].ir)); }
+#line 1821 "parser.c"
     break;
 
-  case 80:
-#line 196 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=createArrayExpression((yyvsp[-1].stack), NULL); }
-#line 2012 "parser.c" /* yacc.c:1646  */
+  case 80: /* multiplicative_expression: multiplicative_expression MOD value  */
+#line 202 "epython.y"
+                                              { (yyval.ir)=createIrOperator(MOD_TOKEN, (yyvsp[-2].ir), (yyvsp[0].ir)); }
+#line 1827 "parser.c"
     break;
 
-  case 81:
-#line 197 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=createArrayExpression((yyvsp[-3].stack), (yyvsp[0].data)); }
-#line 2018 "parser.c" /* yacc.c:1646  */
+  case 81: /* multiplicative_expression: multiplicative_expression POW value  */
+#line 203 "epython.y"
+                                              { (yyval.ir)=createIrOperator(POW_TOKEN, (yyvsp[-2].ir), (yyvsp[0].ir)); }
+#line 1833 "parser.c"
     break;
 
-  case 82:
-#line 198 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=appendNativeCallFunctionStatement("rtl_input", NULL, NULL); }
-#line 2024 "parser.c" /* yacc.c:1646  */
+  case 82: /* multiplicative_expression: STR LPAREN expression RPAREN  */
+#line 204 "epython.y"
+                                       { (yyval.ir)=(yyvsp[-1].ir); }
+#line 1839 "parser.c"
     break;
 
-  case 83:
-#line 199 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=appendNativeCallFunctionStatement("rtl_inputprint", NULL, (yyvsp[-1].data)); }
-#line 2030 "parser.c" /* yacc.c:1646  */
+  case 83: /* multiplicative_expression: SLBRACE commaseparray SRBRACE  */
+#line 205 "epython.y"
+                                        { (yyval.ir)=createIrArray((yyvsp[-1].irlist), NULL); }
+#line 1845 "parser.c"
     break;
 
-  case 84:
-#line 203 "epython.y" /* yacc.c:1646  */
-    { (yyval.stack)=getNewStack(); pushExpression((yyval.stack), (yyvsp[0].data)); }
-#line 2036 "parser.c" /* yacc.c:1646  */
+  case 84: /* multiplicative_expression: SLBRACE commaseparray SRBRACE MULT value  */
+#line 206 "epython.y"
+                                                   { (yyval.ir)=createIrArray((yyvsp[-3].irlist), (yyvsp[0].ir)); }
+#line 1851 "parser.c"
     break;
 
-  case 85:
-#line 204 "epython.y" /* yacc.c:1646  */
-    { pushExpression((yyvsp[-2].stack), (yyvsp[0].data)); }
-#line 2042 "parser.c" /* yacc.c:1646  */
+  case 85: /* multiplicative_expression: INPUT LPAREN RPAREN  */
+#line 207 "epython.y"
+                              { (yyval.ir)=createIrNativeCall("rtl_input", NULL, NULL); }
+#line 1857 "parser.c"
     break;
 
-  case 86:
-#line 208 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=(yyvsp[0].data); }
-#line 2048 "parser.c" /* yacc.c:1646  */
+  case 86: /* multiplicative_expression: INPUT LPAREN expression RPAREN  */
+#line 208 "epython.y"
+                                         { (yyval.ir)=createIrNativeCall("rtl_inputprint", NULL, (yyvsp[-1].ir)); }
+#line 1863 "parser.c"
     break;
 
-  case 87:
-#line 209 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=(yyvsp[-1].data); }
-#line 2054 "parser.c" /* yacc.c:1646  */
+  case 87: /* commaseparray: expression  */
+#line 212 "epython.y"
+                     { (yyval.irlist)=createIrList(); appendIrNode((yyval.irlist), (yyvsp[0].ir)); }
+#line 1869 "parser.c"
     break;
 
-  case 88:
-#line 210 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=(yyvsp[0].data); }
-#line 2060 "parser.c" /* yacc.c:1646  */
+  case 88: /* commaseparray: commaseparray COMMA expression  */
+#line 213 "epython.y"
+                                         { appendIrNode((yyvsp[-2].irlist), (yyvsp[0].ir)); }
+#line 1875 "parser.c"
     break;
 
-  case 89:
-#line 211 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=appendCallFunctionStatement((yyvsp[-3].string), (yyvsp[-1].stack)); }
-#line 2066 "parser.c" /* yacc.c:1646  */
+  case 89: /* value: constant  */
+#line 217 "epython.y"
+                   { (yyval.ir)=(yyvsp[0].ir); }
+#line 1881 "parser.c"
     break;
 
-  case 90:
-#line 212 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=appendNativeCallFunctionStatement((yyvsp[-3].string), (yyvsp[-1].stack), NULL); }
-#line 2072 "parser.c" /* yacc.c:1646  */
+  case 90: /* value: LPAREN expression RPAREN  */
+#line 218 "epython.y"
+                                   { (yyval.ir)=(yyvsp[-1].ir); }
+#line 1887 "parser.c"
     break;
 
-  case 91:
-#line 213 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=appendReferenceStatement((yyvsp[-1].string)); }
-#line 2078 "parser.c" /* yacc.c:1646  */
+  case 91: /* value: identscalararray  */
+#line 219 "epython.y"
+                           { (yyval.ir)=(yyvsp[0].ir); }
+#line 1893 "parser.c"
     break;
 
-  case 92:
-#line 214 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=appendSymbolStatement((yyvsp[-1].string)); }
-#line 2084 "parser.c" /* yacc.c:1646  */
+  case 92: /* value: ident LPAREN fncallargs RPAREN  */
+#line 220 "epython.y"
+                                         { (yyval.ir)=createIrCall((yyvsp[-3].string), (yyvsp[-1].irlist)); }
+#line 1899 "parser.c"
     break;
 
-  case 93:
-#line 218 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=createIdentifierExpression((yyvsp[0].string), 0); }
-#line 2090 "parser.c" /* yacc.c:1646  */
+  case 93: /* value: NATIVE ident LPAREN fncallargs RPAREN  */
+#line 221 "epython.y"
+                                                { (yyval.ir)=createIrNativeCall((yyvsp[-3].string), (yyvsp[-1].irlist), NULL); }
+#line 1905 "parser.c"
     break;
 
-  case 94:
-#line 219 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=createIdentifierArrayAccessExpression((yyvsp[-1].string), (yyvsp[0].stack)); }
-#line 2096 "parser.c" /* yacc.c:1646  */
+  case 94: /* value: ID LPAREN ident RPAREN  */
+#line 222 "epython.y"
+                                 { (yyval.ir)=createIrReference((yyvsp[-1].string)); }
+#line 1911 "parser.c"
     break;
 
-  case 95:
-#line 223 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=createIdentifierExpression((yyvsp[0].string), 1); }
-#line 2102 "parser.c" /* yacc.c:1646  */
+  case 95: /* value: SYMBOL LPAREN ident RPAREN  */
+#line 223 "epython.y"
+                                     { (yyval.ir)=createIrSymbol((yyvsp[-1].string)); }
+#line 1917 "parser.c"
     break;
 
-  case 96:
-#line 224 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=createIdentifierArrayAccessExpression((yyvsp[-1].string), (yyvsp[0].stack)); }
-#line 2108 "parser.c" /* yacc.c:1646  */
+  case 96: /* identscalararray: ident  */
+#line 227 "epython.y"
+                { (yyval.ir)=createIrVariable((yyvsp[0].string), 0); }
+#line 1923 "parser.c"
     break;
 
-  case 97:
-#line 227 "epython.y" /* yacc.c:1646  */
-    { (yyval.string) = malloc(strlen((yyvsp[0].string))+1); strcpy((yyval.string), (yyvsp[0].string)); }
-#line 2114 "parser.c" /* yacc.c:1646  */
+  case 97: /* identscalararray: ident arrayaccessor  */
+#line 228 "epython.y"
+                              { (yyval.ir)=createIrArrayAccess((yyvsp[-1].string), (yyvsp[0].irlist)); }
+#line 1929 "parser.c"
     break;
 
-  case 98:
-#line 231 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=createIntegerExpression((yyvsp[0].integer)); }
-#line 2120 "parser.c" /* yacc.c:1646  */
+  case 98: /* identscalararraylhs: ident  */
+#line 232 "epython.y"
+                { (yyval.ir)=createIrVariable((yyvsp[0].string), 1); }
+#line 1935 "parser.c"
     break;
 
-  case 99:
-#line 232 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=createRealExpression((yyvsp[0].real)); }
-#line 2126 "parser.c" /* yacc.c:1646  */
+  case 99: /* identscalararraylhs: ident arrayaccessor  */
+#line 233 "epython.y"
+                              { (yyval.ir)=createIrArrayAccess((yyvsp[-1].string), (yyvsp[0].irlist)); }
+#line 1941 "parser.c"
     break;
 
-  case 100:
-#line 233 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=createIntegerExpression((yyvsp[-1].integer) * (yyvsp[0].integer)); }
-#line 2132 "parser.c" /* yacc.c:1646  */
+  case 100: /* ident: IDENTIFIER  */
+#line 236 "epython.y"
+                     { (yyval.string) = arenaDuplicateString((yyvsp[0].string)); }
+#line 1947 "parser.c"
     break;
 
-  case 101:
-#line 234 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=createRealExpression((yyvsp[-1].integer) * (yyvsp[0].real)); }
-#line 2138 "parser.c" /* yacc.c:1646  */
+  case 101: /* constant: INTEGER  */
+#line 240 "epython.y"
+                  { (yyval.ir)=createIrInteger((yyvsp[0].integer)); }
+#line 1953 "parser.c"
     break;
 
-  case 102:
-#line 235 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=createStringExpression((yyvsp[0].string)); }
-#line 2144 "parser.c" /* yacc.c:1646  */
+  case 102: /* constant: REAL  */
+#line 241 "epython.y"
+               { (yyval.ir)=createIrReal((yyvsp[0].real)); }
+#line 1959 "parser.c"
     break;
 
-  case 103:
-#line 236 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=createBooleanExpression(1); }
-#line 2150 "parser.c" /* yacc.c:1646  */
+  case 103: /* constant: unary_operator INTEGER  */
+#line 242 "epython.y"
+                                 { (yyval.ir)=createIrInteger((yyvsp[-1].integer) * (yyvsp[0].integer)); }
+#line 1965 "parser.c"
     break;
 
-  case 104:
-#line 237 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=createBooleanExpression(0); }
-#line 2156 "parser.c" /* yacc.c:1646  */
+  case 104: /* constant: unary_operator REAL  */
+#line 243 "epython.y"
+                              { (yyval.ir)=createIrReal((yyvsp[-1].integer) * (yyvsp[0].real)); }
+#line 1971 "parser.c"
     break;
 
-  case 105:
-#line 238 "epython.y" /* yacc.c:1646  */
-    { (yyval.data)=createNoneExpression(); }
-#line 2162 "parser.c" /* yacc.c:1646  */
+  case 105: /* constant: STRING  */
+#line 244 "epython.y"
+                 { (yyval.ir)=createIrString((yyvsp[0].string)); }
+#line 1977 "parser.c"
     break;
 
-  case 106:
-#line 242 "epython.y" /* yacc.c:1646  */
-    { (yyval.integer) = 1; }
-#line 2168 "parser.c" /* yacc.c:1646  */
+  case 106: /* constant: TRUE  */
+#line 245 "epython.y"
+               { (yyval.ir)=createIrBoolean(1); }
+#line 1983 "parser.c"
     break;
 
-  case 107:
-#line 243 "epython.y" /* yacc.c:1646  */
-    { (yyval.integer) = -1; }
-#line 2174 "parser.c" /* yacc.c:1646  */
+  case 107: /* constant: FALSE  */
+#line 246 "epython.y"
+                { (yyval.ir)=createIrBoolean(0); }
+#line 1989 "parser.c"
     break;
 
+  case 108: /* constant: NONE  */
+#line 247 "epython.y"
+               { (yyval.ir)=createIrNone(); }
+#line 1995 "parser.c"
+    break;
+
+  case 109: /* unary_operator: ADD  */
+#line 251 "epython.y"
+              { (yyval.integer) = 1; }
+#line 2001 "parser.c"
+    break;
+
+  case 110: /* unary_operator: SUB  */
+#line 252 "epython.y"
+              { (yyval.integer) = -1; }
+#line 2007 "parser.c"
+    break;
+
+
+#line 2011 "parser.c"
 
-#line 2178 "parser.c" /* yacc.c:1646  */
       default: break;
     }
   /* User semantic actions sometimes alter yychar, and that requires
@@ -2188,25 +2022,23 @@ yyreduce:
      case of YYERROR or YYBACKUP, subsequent parser actions might lead
      to an incorrect destructor call or verbose syntax error message
      before the lookahead is translated.  */
-  YY_SYMBOL_PRINT ("-> $$ =", yyr1[yyn], &yyval, &yyloc);
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
 
   YYPOPSTACK (yylen);
   yylen = 0;
-  YY_STACK_PRINT (yyss, yyssp);
 
   *++yyvsp = yyval;
 
   /* Now 'shift' the result of the reduction.  Determine what state
      that goes to, based on the state we popped back to and the rule
      number reduced by.  */
-
-  yyn = yyr1[yyn];
-
-  yystate = yypgoto[yyn - YYNTOKENS] + *yyssp;
-  if (0 <= yystate && yystate <= YYLAST && yycheck[yystate] == *yyssp)
-    yystate = yytable[yystate];
-  else
-    yystate = yydefgoto[yyn - YYNTOKENS];
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
 
   goto yynewstate;
 
@@ -2217,50 +2049,14 @@ yyreduce:
 yyerrlab:
   /* Make sure we have latest lookahead translation.  See comments at
      user semantic actions for why this is necessary.  */
-  yytoken = yychar == YYEMPTY ? YYEMPTY : YYTRANSLATE (yychar);
-
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
   /* If not already recovering from an error, report this error.  */
   if (!yyerrstatus)
     {
       ++yynerrs;
-#if ! YYERROR_VERBOSE
       yyerror (YY_("syntax error"));
-#else
-# define YYSYNTAX_ERROR yysyntax_error (&yymsg_alloc, &yymsg, \
-                                        yyssp, yytoken)
-      {
-        char const *yymsgp = YY_("syntax error");
-        int yysyntax_error_status;
-        yysyntax_error_status = YYSYNTAX_ERROR;
-        if (yysyntax_error_status == 0)
-          yymsgp = yymsg;
-        else if (yysyntax_error_status == 1)
-          {
-            if (yymsg != yymsgbuf)
-              YYSTACK_FREE (yymsg);
-            yymsg = (char *) YYSTACK_ALLOC (yymsg_alloc);
-            if (!yymsg)
-              {
-                yymsg = yymsgbuf;
-                yymsg_alloc = sizeof yymsgbuf;
-                yysyntax_error_status = 2;
-              }
-            else
-              {
-                yysyntax_error_status = YYSYNTAX_ERROR;
-                yymsgp = yymsg;
-              }
-          }
-        yyerror (yymsgp);
-        if (yysyntax_error_status == 2)
-          goto yyexhaustedlab;
-      }
-# undef YYSYNTAX_ERROR
-#endif
     }
 
-
-
   if (yyerrstatus == 3)
     {
       /* If just tried and failed to reuse lookahead token after an
@@ -2289,12 +2085,11 @@ yyerrlab:
 | yyerrorlab -- error raised explicitly by YYERROR.  |
 `---------------------------------------------------*/
 yyerrorlab:
-
-  /* Pacify compilers like GCC when the user code never invokes
-     YYERROR and the label yyerrorlab therefore never appears in user
-     code.  */
-  if (/*CONSTCOND*/ 0)
-     goto yyerrorlab;
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
 
   /* Do not reclaim the symbols of the rule whose action triggered
      this YYERROR.  */
@@ -2311,13 +2106,14 @@ yyerrorlab:
 yyerrlab1:
   yyerrstatus = 3;      /* Each real token shifted decrements this.  */
 
+  /* Pop stack until we find a state that shifts the error token.  */
   for (;;)
     {
       yyn = yypact[yystate];
       if (!yypact_value_is_default (yyn))
         {
-          yyn += YYTERROR;
-          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYTERROR)
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
             {
               yyn = yytable[yyn];
               if (0 < yyn)
@@ -2331,7 +2127,7 @@ yyerrlab1:
 
 
       yydestruct ("Error: popping",
-                  yystos[yystate], yyvsp);
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
@@ -2343,7 +2139,7 @@ yyerrlab1:
 
 
   /* Shift the error token.  */
-  YY_SYMBOL_PRINT ("Shifting", yystos[yyn], yyvsp, yylsp);
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
 
   yystate = yyn;
   goto yynewstate;
@@ -2354,26 +2150,30 @@ yyerrlab1:
 `-------------------------------------*/
 yyacceptlab:
   yyresult = 0;
-  goto yyreturn;
+  goto yyreturnlab;
+
 
 /*-----------------------------------.
 | yyabortlab -- YYABORT comes here.  |
 `-----------------------------------*/
 yyabortlab:
   yyresult = 1;
-  goto yyreturn;
+  goto yyreturnlab;
 
-#if !defined yyoverflow || YYERROR_VERBOSE
-/*-------------------------------------------------.
-| yyexhaustedlab -- memory exhaustion comes here.  |
-`-------------------------------------------------*/
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
 yyexhaustedlab:
   yyerror (YY_("memory exhausted"));
   yyresult = 2;
-  /* Fall through.  */
-#endif
+  goto yyreturnlab;
+
 
-yyreturn:
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
   if (yychar != YYEMPTY)
     {
       /* Make sure we have latest lookahead translation.  See comments at
@@ -2389,18 +2189,16 @@ yyreturn:
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-                  yystos[*yyssp], yyvsp);
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
   if (yyss != yyssa)
     YYSTACK_FREE (yyss);
 #endif
-#if YYERROR_VERBOSE
-  if (yymsg != yymsgbuf)
-    YYSTACK_FREE (yymsg);
-#endif
+
   return yyresult;
 }
-#line 246 "epython.y" /* yacc.c:1906  */
+
+#line 255 "epython.y"
 
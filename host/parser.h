@@ -1,8 +1,9 @@
-/* A Bison parser, made by GNU Bison 3.0.4.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison interface for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989-1990, 2000-2015 Free Software Foundation, Inc.
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
    This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
@@ -15,7 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -30,6 +31,10 @@
    This special exception was added by the Free Software Foundation in
    version 2.2 of Bison.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 #ifndef YY_YY_PARSER_H_INCLUDED
 # define YY_YY_PARSER_H_INCLUDED
 /* Debug traces.  */
@@ -40,166 +45,102 @@
 extern int yydebug;
 #endif
 
-/* Token type.  */
+/* Token kinds.  */
 #ifndef YYTOKENTYPE
 # define YYTOKENTYPE
   enum yytokentype
   {
-    INTEGER = 258,
-    REAL = 259,
-    STRING = 260,
-    IDENTIFIER = 261,
-    NEWLINE = 262,
-    INDENT = 263,
-    OUTDENT = 264,
-    DIM = 265,
-    SDIM = 266,
-    EXIT = 267,
-    QUIT = 268,
-    ELSE = 269,
-    ELIF = 270,
-    COMMA = 271,
-    WHILE = 272,
-    PASS = 273,
-    AT = 274,
-    FOR = 275,
-    TO = 276,
-    FROM = 277,
-    NEXT = 278,
-    GOTO = 279,
-    PRINT = 280,
-    INPUT = 281,
-    IF = 282,
-    NATIVE = 283,
-    ADD = 284,
-    SUB = 285,
-    COLON = 286,
-    DEF = 287,
-    RET = 288,
-    NONE = 289,
-    FILESTART = 290,
-    IN = 291,
-    ADDADD = 292,
-    SUBSUB = 293,
-    MULMUL = 294,
-    DIVDIV = 295,
-    MODMOD = 296,
-    POWPOW = 297,
-    FLOORDIVFLOORDIV = 298,
-    FLOORDIV = 299,
-    MULT = 300,
-    DIV = 301,
-    MOD = 302,
-    AND = 303,
-    OR = 304,
-    NEQ = 305,
-    LEQ = 306,
-    GEQ = 307,
-    LT = 308,
-    GT = 309,
-    EQ = 310,
-    IS = 311,
-    NOT = 312,
-    STR = 313,
-    ID = 314,
-    SYMBOL = 315,
-    ALIAS = 316,
-    LPAREN = 317,
-    RPAREN = 318,
-    SLBRACE = 319,
-    SRBRACE = 320,
-    TRUE = 321,
-    FALSE = 322,
-    ASSGN = 323,
-    POW = 324
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    INTEGER = 258,                 /* INTEGER  */
+    REAL = 259,                    /* REAL  */
+    STRING = 260,                  /* STRING  */
+    IDENTIFIER = 261,              /* IDENTIFIER  */
+    NEWLINE = 262,                 /* NEWLINE  */
+    INDENT = 263,                  /* INDENT  */
+    OUTDENT = 264,                 /* OUTDENT  */
+    DIM = 265,                     /* DIM  */
+    SDIM = 266,                    /* SDIM  */
+    EXIT = 267,                    /* EXIT  */
+    QUIT = 268,                    /* QUIT  */
+    ELSE = 269,                    /* ELSE  */
+    ELIF = 270,                    /* ELIF  */
+    COMMA = 271,                   /* COMMA  */
+    WHILE = 272,                   /* WHILE  */
+    PASS = 273,                    /* PASS  */
+    AT = 274,                      /* AT  */
+    FOR = 275,                     /* FOR  */
+    TO = 276,                      /* TO  */
+    FROM = 277,                    /* FROM  */
+    NEXT = 278,                    /* NEXT  */
+    GOTO = 279,                    /* GOTO  */
+    PRINT = 280,                   /* PRINT  */
+    INPUT = 281,                   /* INPUT  */
+    IF = 282,                      /* IF  */
+    NATIVE = 283,                  /* NATIVE  */
+    ADD = 284,                     /* ADD  */
+    SUB = 285,                     /* SUB  */
+    COLON = 286,                   /* COLON  */
+    DEF = 287,                     /* DEF  */
+    RET = 288,                     /* RET  */
+    NONE = 289,                    /* NONE  */
+    FILESTART = 290,               /* FILESTART  */
+    IN = 291,                      /* IN  */
+    ADDADD = 292,                  /* ADDADD  */
+    SUBSUB = 293,                  /* SUBSUB  */
+    MULMUL = 294,                  /* MULMUL  */
+    DIVDIV = 295,                  /* DIVDIV  */
+    MODMOD = 296,                  /* MODMOD  */
+    POWPOW = 297,                  /* POWPOW  */
+    FLOORDIVFLOORDIV = 298,        /* FLOORDIVFLOORDIV  */
+    FLOORDIV = 299,                /* FLOORDIV  */
+    MULT = 300,                    /* MULT  */
+    DIV = 301,                     /* DIV  */
+    MOD = 302,                     /* MOD  */
+    AND = 303,                     /* AND  */
+    OR = 304,                      /* OR  */
+    NEQ = 305,                     /* NEQ  */
+    LEQ = 306,                     /* LEQ  */
+    GEQ = 307,                     /* GEQ  */
+    LT = 308,                      /* LT  */
+    GT = 309,                      /* GT  */
+    EQ = 310,                      /* EQ  */
+    IS = 311,                      /* IS  */
+    NOT = 312,                     /* NOT  */
+    STR = 313,                     /* STR  */
+    ID = 314,                      /* ID  */
+    SYMBOL = 315,                  /* SYMBOL  */
+    ALIAS = 316,                   /* ALIAS  */
+    LPAREN = 317,                  /* LPAREN  */
+    RPAREN = 318,                  /* RPAREN  */
+    SLBRACE = 319,                 /* SLBRACE  */
+    SRBRACE = 320,                 /* SRBRACE  */
+    TRUE = 321,                    /* TRUE  */
+    FALSE = 322,                   /* FALSE  */
+    ASSGN = 323,                   /* ASSGN  */
+    POW = 324                      /* POW  */
   };
+  typedef enum yytokentype yytoken_kind_t;
 #endif
-/* Tokens.  */
-#define INTEGER 258
-#define REAL 259
-#define STRING 260
-#define IDENTIFIER 261
-#define NEWLINE 262
-#define INDENT 263
-#define OUTDENT 264
-#define DIM 265
-#define SDIM 266
-#define EXIT 267
-#define QUIT 268
-#define ELSE 269
-#define ELIF 270
-#define COMMA 271
-#define WHILE 272
-#define PASS 273
-#define AT 274
-#define FOR 275
-#define TO 276
-#define FROM 277
-#define NEXT 278
-#define GOTO 279
-#define PRINT 280
-#define INPUT 281
-#define IF 282
-#define NATIVE 283
-#define ADD 284
-#define SUB 285
-#define COLON 286
-#define DEF 287
-#define RET 288
-#define NONE 289
-#define FILESTART 290
-#define IN 291
-#define ADDADD 292
-#define SUBSUB 293
-#define MULMUL 294
-#define DIVDIV 295
-#define MODMOD 296
-#define POWPOW 297
-#define FLOORDIVFLOORDIV 298
-#define FLOORDIV 299
-#define MULT 300
-#define DIV 301
-#define MOD 302
-#define AND 303
-#define OR 304
-#define NEQ 305
-#define LEQ 306
-#define GEQ 307
-#define LT 308
-#define GT 309
-#define EQ 310
-#define IS 311
-#define NOT 312
-#define STR 313
-#define ID 314
-#define SYMBOL 315
-#define ALIAS 316
-#define LPAREN 317
-#define RPAREN 318
-#define SLBRACE 319
-#define SRBRACE 320
-#define TRUE 321
-#define FALSE 322
-#define ASSGN 323
-#define POW 324
 
 /* Value type.  */
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-
 union YYSTYPE
 {
-#line 22 "epython.y" /* yacc.c:1909  */
+#line 25 "epython.y"
 
 	int integer;
 	unsigned char uchar;
 	float real;	
-	struct memorycontainer * data;
+	struct ir_node * ir;
 	char *string;
-	struct stack_t * stack;
+	struct ir_list * irlist;
 
-#line 201 "parser.h" /* yacc.c:1909  */
-};
+#line 142 "parser.h"
 
+};
 typedef union YYSTYPE YYSTYPE;
 # define YYSTYPE_IS_TRIVIAL 1
 # define YYSTYPE_IS_DECLARED 1
@@ -208,6 +149,8 @@ typedef union YYSTYPE YYSTYPE;
 
 extern YYSTYPE yylval;
 
+
 int yyparse (void);
 
+
 #endif /* !YY_YY_PARSER_H_INCLUDED  */
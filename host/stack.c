@@ -8,9 +8,12 @@
 #include <stdlib.h>
 #include <string.h>
 #include "stack.h"
+#include "arena.h"
+
+static void growStack(struct stack_t*);
 
 struct stack_t* getNewStack(void) {
-	struct stack_t* newStack=(struct stack_t*) malloc(sizeof(struct stack_t));
+	struct stack_t* newStack=(struct stack_t*) arenaAllocate(sizeof(struct stack_t));
 	initStack(newStack);
 	return newStack;
 }
@@ -18,8 +21,8 @@ struct stack_t* getNewStack(void) {
 void initStack(struct stack_t* stack) {
     stack->width=INITIAL_STACK_SIZE;
     stack->size=0;
-    stack->data=(void**) malloc(sizeof(void*) * INITIAL_STACK_SIZE);
-    stack->type=(char*) malloc(sizeof(char) * INITIAL_STACK_SIZE);
+    stack->data=(void**) arenaAllocate(sizeof(void*) * INITIAL_STACK_SIZE);
+    stack->type=(char*) arenaAllocate(sizeof(char) * INITIAL_STACK_SIZE);
 }
 
 int getStackSize(struct stack_t* stack) {
@@ -28,18 +31,13 @@ int getStackSize(struct stack_t* stack) {
 
 int pop(struct stack_t* stack) {
    if (stack->size > 0) {
-	   int data=*((int*) stack->data[stack->size-1]);
-	   free(stack->data[--stack->size]);
-       return data;
+       return *((int*) stack->data[--stack->size]);
    }
    return -1;
 }
 
 void clearStack(struct stack_t* stack) {
 	stack->size=0;
-	free(stack->data);
-	free(stack->type);
-	stack->width=INITIAL_STACK_SIZE;
 }
 
 char* popIdentifier(struct stack_t* stack) {
@@ -100,51 +98,33 @@ int getTypeAt(struct stack_t* stack, int index) {
 
 void push(struct stack_t* stack, int val) {
 	stack->size++;
-    if (stack->size >= stack->width) {
-        stack->width*=2;
-        stack->data=(void**) realloc(&stack->data, sizeof(void*) * stack->width);
-        stack->type=(char*) realloc(&stack->type, sizeof(char) * stack->width);
-    }
-    stack->data[stack->size-1]=malloc(sizeof(int));
+    if (stack->size >= stack->width) growStack(stack);
+    stack->data[stack->size-1]=arenaAllocate(sizeof(int));
     stack->type[stack->size-1]=1;
     memcpy(stack->data[stack->size-1], &val, sizeof(int));
 }
 
 void pushIdentifier(struct stack_t* stack, char* val) {
 	stack->size++;
-    if (stack->size >= stack->width) {
-        stack->width*=2;
-        stack->data=(void**) realloc(&stack->data, sizeof(void*) * stack->width);
-        stack->type=(char*) realloc(&stack->type, sizeof(char) * stack->width);
-    }
-    stack->data[stack->size-1]=malloc(strlen(val)+1);
+    if (stack->size >= stack->width) growStack(stack);
+    stack->data[stack->size-1]=arenaDuplicateString(val);
     stack->type[stack->size-1]=2;
-    strcpy(stack->data[stack->size-1], val);
 }
 
 void pushIdentifierAssgnExpression(struct stack_t* stack, char* val, struct memorycontainer* exp) {
 	stack->size++;
-    if (stack->size >= stack->width) {
-        stack->width*=2;
-        stack->data=(void**) realloc(&stack->data, sizeof(void*) * stack->width);
-        stack->type=(char*) realloc(&stack->type, sizeof(char) * stack->width);
-    }
+    if (stack->size >= stack->width) growStack(stack);
     struct identifier_exp atom;
-    atom.identifier=(char*) malloc(strlen(val)+1);
-    strcpy(atom.identifier, val);
+    atom.identifier=arenaDuplicateString(val);
     atom.exp=exp;
-    stack->data[stack->size-1]=malloc(sizeof(struct identifier_exp));
+    stack->data[stack->size-1]=arenaAllocate(sizeof(struct identifier_exp));
     memcpy(stack->data[stack->size-1], &atom, sizeof(struct identifier_exp));
     stack->type[stack->size-1]=4;
 }
 
 void pushExpression(struct stack_t* stack, struct memorycontainer* exp) {
 	stack->size++;
-    if (stack->size >= stack->width) {
-        stack->width*=2;
-        stack->data=(void**) realloc(&stack->data, sizeof(void*) * stack->width);
-        stack->type=(char*) realloc(&stack->type, sizeof(char) * stack->width);
-    }
+    if (stack->size >= stack->width) growStack(stack);
     stack->data[stack->size-1]=exp;
     stack->type[stack->size-1]=3;
 }
@@ -155,3 +135,12 @@ int peek(struct stack_t* stack) {
 	}
 	return -1;
 }
+
+/**
+ * Doubles the capacity of a stack, its memory is allocated from the current arena so the old arrays are released along with it
+ */
+static void growStack(struct stack_t* stack) {
+	stack->data=(void**) arenaReallocate(stack->data, sizeof(void*) * stack->width, sizeof(void*) * stack->width * 2);
+	stack->type=(char*) arenaReallocate(stack->type, sizeof(char) * stack->width, sizeof(char) * stack->width * 2);
+	stack->width*=2;
+}
@@ -68,6 +68,34 @@
 #define REFERENCE_TOKEN 0x26
 #define SYMBOL_TOKEN 0x27
 #define ALIAS_TOKEN 0x28
+// Expressions compiled to the register format, the remaining tokens are instructions which only appear within these
+#define REGISTER_EXPRESSION_TOKEN 0x29
+#define REGISTER_TRUTH_TOKEN 0x2A
+#define REGISTER_BOOLEAN_TRUTH_TOKEN 0x2B
+#define REGISTER_EVAL_TOKEN 0x2C
+// Operand of an arithmetic or comparison instruction held in a register, otherwise operands are constants or variables
+#define REGISTER_OPERAND_TOKEN 0x2D
+#define REGISTER_SHORT_CIRCUIT_TOKEN 0x2E
+// Counted loop over a range of integers, held in loop state rather than iterating over an array
+#define FOR_RANGE_TOKEN 0x2F
+// Superinstructions, fusing common statement patterns (increment by constant, compare and branch, array element load and store)
+#define INCREMENT_TOKEN 0x30
+#define IF_COMPARE_TOKEN 0x31
+#define LET_FROM_ARRAY_TOKEN 0x32
+#define LET_TO_ARRAY_TOKEN 0x33
+#define NUMBER_SUPERINSTRUCTIONS 4
+// Arithmetic and comparison operators typed statically for integer or real operands, which are never checked at runtime
+#define INT_TYPED_TOKEN_BASE 0x60
+#define REAL_TYPED_TOKEN_BASE 0x70
+// Size of the register file, expressions needing more registers than this are evaluated in place instead
+#define MAX_EXPRESSION_REGISTERS 16
+
+// Set on a variable slot in the byte code if it is relative to the current function frame rather than global
+#define LOCAL_VARIABLE_FLAG 0x8000
+// Set in the program header (the number of global variable slots) of byte code which has been specialised to how it is run, whose
+// functions have moved from where they are in the generic byte code. Function addresses are always the generic location, and the
+// code is followed by a map from these to where each function now is, which is the pairs of locations and then the number of pairs
+#define FUNCTION_LOCATION_MAP_FLAG 0x8000
 
 #define ERR_STR_ONLYTEST_EQ 0x00
 #define ERR_NONE_ONLYTEST_EQ 0x01
@@ -92,6 +120,7 @@
 #define ERR_FNCALL_VAR_NOT_CONTAINING_FN_PTR 0x14
 #define ERR_PROBE_NOT_SUPPORTED 0x15
 #define ERR_NBSEND_NOT_SUPPORTED 0x16
+#define ERR_SYMBOL_TABLE_FULL 0x17
 
 #define NATIVE_FN_RTL_ISHOST 0x00
 #define NATIVE_FN_RTL_ISDEVICE 0x01
@@ -121,5 +150,6 @@
 #define NATIVE_FN_RTL_DEREFERENCE 0x1A
 #define NATIVE_FN_RTL_FLATTEN 0x1B
 #define NATIVE_FN_RTL_ARRAYCOPY 0x1C
+#define NATIVE_FN_RTL_SIZE 0x1D
 
 #endif /* BASICTOKENS_H_ */
@@ -29,7 +29,11 @@
 #include "basictokens.h"
 #ifdef HOST_INTERPRETER
 #include <stdlib.h>
+#include <stdio.h>
 #include "../host/host-functions.h"
+#ifdef HOST_STANDALONE
+#include "../host/jit.h"
+#endif
 #endif
 
 #define MAX_CALL_STACK_DEPTH 10
@@ -41,12 +45,24 @@ volatile char * stopInterpreter;
 static struct symbol_node ** symbolTable;
 // Number of entries currently in the symbol table
 static volatile int * currentSymbolEntries;
+// Total number of entries that the symbol table can hold
+static int * symbolTableSize;
+// Start of the current function's frame in the symbol table (local slots are relative to this)
+static int * currentFrameBase;
 // The absolute ID of the local core
 static volatile int * localCoreId;
 // Number of active cores
 static volatile int * numActiveCores;
-// Function call level
-unsigned volatile char * fnLevel;
+// Number of times that each superinstruction has fired
+static unsigned int ** superinstructionCounts;
+static int numberSuperinstructionCounts;
+// Map from the generic location of each function whose address is taken to its location in this byte code, if it has moved
+static char ** functionLocationMap;
+static unsigned short * numberFunctionLocations;
+#ifdef HOST_STANDALONE
+// Code translated ahead of time to C, if set this is run in place of interpreting the byte code
+struct value_defn (*translatedCode)(char*, unsigned int, unsigned int, int)=NULL;
+#endif
 #else
 #define NULL ((void *)0)
 // Whether we should stop the interpreter or not (due to error raised)
@@ -55,12 +71,17 @@ char stopInterpreter;
 static struct symbol_node * symbolTable;
 // Number of entries currently in the symbol table
 static int currentSymbolEntries;
+// Total number of entries that the symbol table can hold
+static int symbolTableSize;
+// Start of the current function's frame in the symbol table (local slots are relative to this)
+static int currentFrameBase;
 // The absolute ID of the local core
 static int localCoreId;
 // Number of active cores
 static int numActiveCores;
-// Function call level
-unsigned char fnLevel;
+// Map from the generic location of each function whose address is taken to its location in this byte code, if it has moved
+static char * functionLocationMap;
+static unsigned short numberFunctionLocations;
 #endif
 
 static int hostCoresBasePid;
@@ -68,36 +89,69 @@ static int hostCoresBasePid;
 #ifdef HOST_INTERPRETER
 struct value_defn processAssembledCode(char*, unsigned int, unsigned int, int);
 static unsigned int handleGoto(char*, unsigned int, unsigned int, int);
-static unsigned int handleFnCall(char*, unsigned int, unsigned int*, unsigned int, char, int);
+static struct value_defn callFunction(char*, unsigned int*, unsigned int, char, int);
+static unsigned int handleFnCall(char*, unsigned int, unsigned int*, int*, unsigned int, char, int);
 static unsigned int handleLet(char*, unsigned int, unsigned int, char, int);
 static unsigned int handleIf(char*, unsigned int, unsigned int, int);
 static unsigned int handleFor(char*, unsigned int, unsigned int, int);
+static unsigned int handleForRange(char*, unsigned int, int);
+static unsigned int handleIfCompare(char*, unsigned int, int);
+static unsigned int handleIncrement(char*, unsigned int, int);
+static unsigned int handleLetFromArray(char*, unsigned int, int);
+static unsigned int handleLetToArray(char*, unsigned int, unsigned int, int);
 static unsigned int handleNative(char *, unsigned int, unsigned int, struct value_defn*, int);
 static unsigned int handleAlias(char *, unsigned int, unsigned int, int);
 static int getArrayAccessorIndex(struct symbol_node*, char*, unsigned int*, unsigned int, int);
-static struct symbol_node* getVariableSymbol(unsigned short, unsigned char, int, int);
-static int getSymbolTableEntryId(int);
-static void clearVariablesToLevel(unsigned char, int);
+static int computeArrayAccessorIndex(struct symbol_node*, unsigned char, int*, int);
+static struct symbol_node* getVariableSymbol(unsigned short, int, int);
+static void initialiseSymbolTableEntries(int, int, int);
 static struct value_defn getExpressionValue(char*, unsigned int*, unsigned int, int);
 static int determine_logical_expression(char*, unsigned int*,  unsigned int, int);
-static struct value_defn computeExpressionResult(unsigned char, char*, unsigned int*, unsigned int, int);
+static struct value_defn computeExpressionResult(char*, unsigned int*, unsigned int, int);
+static struct value_defn performTypedArithmetic(char*, unsigned int, struct value_defn, struct value_defn, int);
+static struct value_defn performArithmetic(unsigned char, struct value_defn, struct value_defn, int);
+static struct value_defn executeRegisterExpression(char*, unsigned int*, unsigned int, int);
+static struct value_defn getRegisterOperand(char*, unsigned int*, struct value_defn*, int);
+static unsigned int readFunctionLocationMap(char*, unsigned int, int);
+static unsigned short getFunctionLocation(unsigned short, int);
 #else
 struct value_defn processAssembledCode(char*, unsigned int, unsigned int);
 static unsigned int handleGoto(char*, unsigned int, unsigned int);
-static unsigned int handleFnCall(char*, unsigned int, unsigned int*, unsigned int, char);
+static struct value_defn callFunction(char*, unsigned int*, unsigned int, char);
+static unsigned int handleFnCall(char*, unsigned int, unsigned int*, int*, unsigned int, char);
 static unsigned int handleLet(char*, unsigned int, unsigned int, char);
 static unsigned int handleIf(char*, unsigned int, unsigned int);
 static unsigned int handleFor(char*, unsigned int, unsigned int);
+static unsigned int handleForRange(char*, unsigned int);
+static unsigned int handleIfCompare(char*, unsigned int);
+static unsigned int handleIncrement(char*, unsigned int);
+static unsigned int handleLetFromArray(char*, unsigned int);
+static unsigned int handleLetToArray(char*, unsigned int, unsigned int);
 static unsigned int handleNative(char *, unsigned int, unsigned int, struct value_defn*);
 static unsigned int handleAlias(char *, unsigned int, unsigned int);
 static int getArrayAccessorIndex(struct symbol_node*, char*, unsigned int*, unsigned int);
-static struct symbol_node* getVariableSymbol(unsigned short, unsigned char, int);
-static int getSymbolTableEntryId(void);
-static void clearVariablesToLevel(unsigned char);
+static int computeArrayAccessorIndex(struct symbol_node*, unsigned char, int*);
+static struct symbol_node* getVariableSymbol(unsigned short, int);
+static void initialiseSymbolTableEntries(int, int);
 static struct value_defn getExpressionValue(char*, unsigned int*, unsigned int);
 static int determine_logical_expression(char*, unsigned int*, unsigned int);
-static struct value_defn computeExpressionResult(unsigned char, char*, unsigned int*, unsigned int);
+static struct value_defn computeExpressionResult(char*, unsigned int*, unsigned int);
+static struct value_defn performTypedArithmetic(char*, unsigned int, struct value_defn, struct value_defn);
+static struct value_defn performArithmetic(unsigned char, struct value_defn, struct value_defn);
+static struct value_defn getRegisterOperand(char*, unsigned int*, struct value_defn*);
+static unsigned int readFunctionLocationMap(char*, unsigned int);
+static unsigned short getFunctionLocation(unsigned short);
 #endif
+static int compareValues(unsigned char, struct value_defn, struct value_defn);
+static int compareTypedValues(char*, unsigned int, struct value_defn, struct value_defn);
+static int compareIntegers(unsigned char, int, int);
+static int compareReals(unsigned char, float, float);
+static struct value_defn performIntegerArithmetic(unsigned char, int, int);
+static struct value_defn performRealArithmetic(unsigned char, float, float);
+static unsigned char getGenericOperator(unsigned char);
+static struct value_defn getIdentifierValue(struct symbol_node*);
+static int getLoopBound(struct symbol_node*);
+static void assignVariableValue(struct symbol_node*, struct value_defn, char, int);
 void setVariableValue(struct symbol_node*, struct value_defn, int);
 struct value_defn getVariableValue(struct symbol_node*, int);
 static unsigned short getUShort(void*);
@@ -112,35 +166,123 @@ void initThreadedAspectsForInterpreter(int total_number_threads, int baseHostPid
 	currentSymbolEntries=(int*) malloc(sizeof(int) * total_number_threads);
 	localCoreId=(int*) malloc(sizeof(int) * total_number_threads);
 	numActiveCores=(int*) malloc(sizeof(int) * total_number_threads);
-	fnLevel=(unsigned char*) malloc(sizeof(unsigned char) * total_number_threads);
+	symbolTableSize=(int*) malloc(sizeof(int) * total_number_threads);
+	currentFrameBase=(int*) malloc(sizeof(int) * total_number_threads);
+	functionLocationMap=(char**) malloc(sizeof(char*) * total_number_threads);
+	numberFunctionLocations=(unsigned short*) malloc(sizeof(unsigned short) * total_number_threads);
+	superinstructionCounts=(unsigned int**) malloc(sizeof(unsigned int*) * total_number_threads);
+	int i;
+	for (i=0;i<total_number_threads;i++) {
+		superinstructionCounts[i]=(unsigned int*) calloc(NUMBER_SUPERINSTRUCTIONS, sizeof(unsigned int));
+	}
+	numberSuperinstructionCounts=total_number_threads;
 	initHostCommunicationData(total_number_threads, basicState, baseHostPid);
 	hostCoresBasePid=baseHostPid;
 }
+
+/**
+ * Displays the number of times that each superinstruction fired, summed over the host threads
+ */
+void displaySuperinstructionCounts(void) {
+	static const char * superinstructionNames[NUMBER_SUPERINSTRUCTIONS]={"increment by constant", "compare and branch",
+			"load array element", "store array element"};
+	unsigned int total;
+	int i, j;
+	printf("Superinstructions fired on the host:\n");
+	for (i=0;i<NUMBER_SUPERINSTRUCTIONS;i++) {
+		total=0;
+		for (j=0;j<numberSuperinstructionCounts;j++) total+=superinstructionCounts[j][i];
+		printf("  %-22s %u\n", superinstructionNames[i], total);
+	}
+}
 #endif
 
 #ifdef HOST_INTERPRETER
 void runIntepreter(char * assembled, unsigned int length, unsigned short numberSymbols,
 		int coreId, int numberActiveCores, int threadId) {
+	// The byte code starts with the number of global variable slots, these occupy the bottom of the symbol table
+	unsigned short numberGlobals=getUShort(assembled) & ~FUNCTION_LOCATION_MAP_FLAG;
+	length=readFunctionLocationMap(assembled, length, threadId);
 	stopInterpreter[threadId]=0;
-	currentSymbolEntries[threadId]=-1;
-	fnLevel[threadId]=0;
+	currentSymbolEntries[threadId]=numberGlobals-1;
+	symbolTableSize[threadId]=numberSymbols;
+	currentFrameBase[threadId]=numberGlobals;
 	localCoreId[threadId]=coreId;
 	numActiveCores[threadId]=numberActiveCores;
 	symbolTable[threadId]=initialiseSymbolTable(numberSymbols);
-	processAssembledCode(assembled, 0, length, threadId);
+	initialiseSymbolTableEntries(0, numberGlobals, threadId);
+	processAssembledCode(assembled, sizeof(unsigned short), length, threadId);
 }
 
 #else
 void runIntepreter(char * assembled, unsigned int length, unsigned short numberSymbols,
 		int coreId, int numberActiveCores, int baseHostPid) {
+	// The byte code starts with the number of global variable slots, these occupy the bottom of the symbol table
+	unsigned short numberGlobals=getUShort(assembled) & ~FUNCTION_LOCATION_MAP_FLAG;
+	length=readFunctionLocationMap(assembled, length);
 	stopInterpreter=0;
-	currentSymbolEntries=-1;
-	fnLevel=0;
+	currentSymbolEntries=numberGlobals-1;
+	symbolTableSize=numberSymbols;
+	currentFrameBase=numberGlobals;
 	localCoreId=coreId;
 	numActiveCores=numberActiveCores;
 	symbolTable=initialiseSymbolTable(numberSymbols);
+	initialiseSymbolTableEntries(0, numberGlobals);
 	hostCoresBasePid=baseHostPid;
-	processAssembledCode(assembled, 0, length);
+	processAssembledCode(assembled, sizeof(unsigned short), length);
+}
+#endif
+
+/**
+ * Byte code specialised to how it is run may be followed by a map of where functions have moved to from their locations in the
+ * generic byte code, which function addresses refer to. This notes the map if there is one and returns the length of the code
+ */
+#ifdef HOST_INTERPRETER
+static unsigned int readFunctionLocationMap(char * assembled, unsigned int length, int threadId) {
+	if (getUShort(assembled) & FUNCTION_LOCATION_MAP_FLAG) {
+		numberFunctionLocations[threadId]=getUShort(&assembled[length-sizeof(unsigned short)]);
+		length-=sizeof(unsigned short) * (numberFunctionLocations[threadId] * 2 + 1);
+		functionLocationMap[threadId]=&assembled[length];
+	} else {
+		numberFunctionLocations[threadId]=0;
+	}
+	return length;
+}
+#else
+static unsigned int readFunctionLocationMap(char * assembled, unsigned int length) {
+	if (getUShort(assembled) & FUNCTION_LOCATION_MAP_FLAG) {
+		numberFunctionLocations=getUShort(&assembled[length-sizeof(unsigned short)]);
+		length-=sizeof(unsigned short) * (numberFunctionLocations * 2 + 1);
+		functionLocationMap=&assembled[length];
+	} else {
+		numberFunctionLocations=0;
+	}
+	return length;
+}
+#endif
+
+/**
+ * Looks up where the function at some location in the generic byte code, which a function address refers to, is in this byte code
+ */
+#ifdef HOST_INTERPRETER
+static unsigned short getFunctionLocation(unsigned short genericLocation, int threadId) {
+	unsigned short i;
+	for (i=0;i<numberFunctionLocations[threadId];i++) {
+		if (getUShort(&functionLocationMap[threadId][i*2*sizeof(unsigned short)]) == genericLocation) {
+			return getUShort(&functionLocationMap[threadId][(i*2+1)*sizeof(unsigned short)]);
+		}
+	}
+	return genericLocation;
+}
+#else
+static unsigned short getFunctionLocation(unsigned short genericLocation) {
+	unsigned short i;
+	for (i=0;i<numberFunctionLocations;i++) {
+		if (getUShort(&functionLocationMap[i*2*sizeof(unsigned short)]) == genericLocation) {
+			return getUShort(&functionLocationMap[(i*2+1)*sizeof(unsigned short)]);
+		}
+	}
+	return genericLocation;
 }
 #endif
 
@@ -149,37 +291,154 @@ void runIntepreter(char * assembled, unsigned int length, unsigned short numberS
  * Entry function which will process the assembled code and perform the required actions
  */
 struct value_defn processAssembledCode(char * assembled, unsigned int currentPoint, unsigned int length, int threadId) {
+#ifdef HOST_STANDALONE
+	if (translatedCode != NULL) return translatedCode(assembled, currentPoint, length, threadId);
+#endif
 	struct value_defn empty;
 	empty.type=NONE_TYPE;
 	empty.dtype=SCALAR;
-	unsigned int i, fnAddr;
+	unsigned int i;
 	for (i=currentPoint;i<length;) {
 		unsigned char command=getUChar(&assembled[i]);
 		i+=sizeof(unsigned char);
-		if (command == LET_TOKEN) i=handleLet(assembled, i, length, 0, threadId);
-		if (command == LETNOALIAS_TOKEN) i=handleLet(assembled, i, length, 1, threadId);
-		if (command == STOP_TOKEN) return empty;
-		if (command == IF_TOKEN) i=handleIf(assembled, i, length, threadId);
-		if (command == IFELSE_TOKEN) i=handleIf(assembled, i, length, threadId);
-		if (command == FOR_TOKEN) i=handleFor(assembled, i, length, threadId);
-		if (command == GOTO_TOKEN) i=handleGoto(assembled, i, length, threadId);
-		if (command == FNCALL_TOKEN || command == FNCALL_BY_VAR_TOKEN) {
-			i=handleFnCall(assembled, i, &fnAddr, length, command == FNCALL_BY_VAR_TOKEN ? 1:0, threadId);
-			fnLevel[threadId]++;
-			processAssembledCode(assembled, fnAddr, length, threadId);
-			clearVariablesToLevel(fnLevel[threadId], threadId);
-			fnLevel[threadId]--;
+		// Dense switch over the statement tokens, compiled to a jump table rather than a chain of tests
+		switch (command) {
+		case LET_TOKEN:
+			i=handleLet(assembled, i, length, 0, threadId);
+			break;
+		case LETNOALIAS_TOKEN:
+			i=handleLet(assembled, i, length, 1, threadId);
+			break;
+		case IF_TOKEN:
+		case IFELSE_TOKEN:
+			i=handleIf(assembled, i, length, threadId);
+			break;
+		case FOR_TOKEN:
+			i=handleFor(assembled, i, length, threadId);
+			break;
+		case FOR_RANGE_TOKEN:
+			i=handleForRange(assembled, i, threadId);
+			break;
+		case IF_COMPARE_TOKEN:
+			i=handleIfCompare(assembled, i, threadId);
+			break;
+		case INCREMENT_TOKEN:
+			i=handleIncrement(assembled, i, threadId);
+			break;
+		case LET_FROM_ARRAY_TOKEN:
+			i=handleLetFromArray(assembled, i, threadId);
+			break;
+		case LET_TO_ARRAY_TOKEN:
+			i=handleLetToArray(assembled, i, length, threadId);
+			break;
+		case GOTO_TOKEN: {
+			unsigned int gotoPoint=i;
+			i=handleGoto(assembled, i, length, threadId);
+#ifdef HOST_STANDALONE
+			// Jumping backwards goes round a loop, which is run as native code once it is hot
+			if (jitEnabled && i < gotoPoint) i=runCompiledLoop(assembled, i, symbolTable[threadId],
+					&symbolTable[threadId][currentFrameBase[threadId]], &stopInterpreter[threadId], threadId);
+#endif
+			break;
 		}
-		if (command == NATIVE_TOKEN) i=handleNative(assembled, i, length, NULL, threadId);
-		if (command == ALIAS_TOKEN) i=handleAlias(assembled, i, length, threadId);
-		if (command == RETURN_TOKEN) return empty;
-		if (command == RETURN_EXP_TOKEN) {
+		case FNCALL_TOKEN:
+		case FNCALL_BY_VAR_TOKEN:
+			callFunction(assembled, &i, length, command == FNCALL_BY_VAR_TOKEN ? 1:0, threadId);
+			break;
+		case NATIVE_TOKEN:
+			i=handleNative(assembled, i, length, NULL, threadId);
+			break;
+		case ALIAS_TOKEN:
+			i=handleAlias(assembled, i, length, threadId);
+			break;
+		case RETURN_EXP_TOKEN:
 			return getExpressionValue(assembled, &i, length, threadId);
+		case STOP_TOKEN:
+		case RETURN_TOKEN:
+			return empty;
 		}
 		if (stopInterpreter[threadId]) return empty;
 	}
 	return empty;
 }
+
+#ifdef HOST_STANDALONE
+/**
+ * Runs the single statement at some point for code translated ahead of time to C, returning the point of the statement that
+ * follows. The value of a return statement is placed in returnValue, whereas stopping and returning without a value are left
+ * to the translated code
+ */
+unsigned int runTranslatedStatement(char * assembled, unsigned int currentPoint, unsigned int length, struct value_defn * returnValue,
+		int threadId) {
+	unsigned char command=getUChar(&assembled[currentPoint]);
+	currentPoint+=sizeof(unsigned char);
+	switch (command) {
+	case LET_TOKEN:
+		return handleLet(assembled, currentPoint, length, 0, threadId);
+	case LETNOALIAS_TOKEN:
+		return handleLet(assembled, currentPoint, length, 1, threadId);
+	case IF_TOKEN:
+	case IFELSE_TOKEN:
+		return handleIf(assembled, currentPoint, length, threadId);
+	case FOR_TOKEN:
+		return handleFor(assembled, currentPoint, length, threadId);
+	case FOR_RANGE_TOKEN:
+		return handleForRange(assembled, currentPoint, threadId);
+	case IF_COMPARE_TOKEN:
+		return handleIfCompare(assembled, currentPoint, threadId);
+	case INCREMENT_TOKEN:
+		return handleIncrement(assembled, currentPoint, threadId);
+	case LET_FROM_ARRAY_TOKEN:
+		return handleLetFromArray(assembled, currentPoint, threadId);
+	case LET_TO_ARRAY_TOKEN:
+		return handleLetToArray(assembled, currentPoint, length, threadId);
+	case GOTO_TOKEN:
+		return handleGoto(assembled, currentPoint, length, threadId);
+	case FNCALL_TOKEN:
+	case FNCALL_BY_VAR_TOKEN:
+		callFunction(assembled, &currentPoint, length, command == FNCALL_BY_VAR_TOKEN ? 1:0, threadId);
+		return currentPoint;
+	case NATIVE_TOKEN:
+		return handleNative(assembled, currentPoint, length, NULL, threadId);
+	case ALIAS_TOKEN:
+		return handleAlias(assembled, currentPoint, length, threadId);
+	case RETURN_EXP_TOKEN:
+		*returnValue=getExpressionValue(assembled, &currentPoint, length, threadId);
+		return currentPoint;
+	}
+	return currentPoint;
+}
+
+/**
+ * Retrieves the symbol of a variable for code translated ahead of time to C, following aliases in the same way as the interpreter
+ */
+struct symbol_node* getTranslatedVariableSymbol(unsigned short id, int threadId) {
+	return getVariableSymbol(id, threadId, 1);
+}
+
+/**
+ * Retrieves the value of a variable for code translated ahead of time to C, which is passed on as it is to the runtime
+ */
+struct value_defn getTranslatedIdentifierValue(struct symbol_node* variableSymbol) {
+	return getIdentifierValue(variableSymbol);
+}
+
+/**
+ * Assigns a value to a variable, or to an element of a one dimensional array if the index is not negative, for code translated
+ * ahead of time to C. This follows the same rules as assignment in the interpreter
+ */
+void setTranslatedVariableValue(struct symbol_node* variableSymbol, struct value_defn value, int index) {
+	assignVariableValue(variableSymbol, value, index >= 0, index);
+}
+
+/**
+ * Calls a native function with arguments evaluated by code translated ahead of time to C
+ */
+void callTranslatedNative(struct value_defn * returnValue, unsigned char fnCode, int numArgs, struct value_defn * args, int threadId) {
+	callNativeFunction(returnValue, fnCode, numArgs, args, numActiveCores[threadId], localCoreId[threadId], currentSymbolEntries[threadId],
+			symbolTable[threadId], threadId);
+}
+#endif
 #else
 /**
  * Entry function which will process the assembled code and perform the required actions
@@ -188,29 +447,58 @@ struct value_defn processAssembledCode(char * assembled, unsigned int currentPoi
 	struct value_defn empty;
 	empty.type=NONE_TYPE;
 	empty.dtype=SCALAR;
-	unsigned int i, fnAddr;
+	unsigned int i;
 	for (i=currentPoint;i<length;) {
 		unsigned char command=getUChar(&assembled[i]);
 		i+=sizeof(unsigned char);
-		if (command == LET_TOKEN) i=handleLet(assembled, i, length, 0);
-		if (command == LETNOALIAS_TOKEN) i=handleLet(assembled, i, length, 1);
-		if (command == STOP_TOKEN) return empty;
-		if (command == IF_TOKEN) i=handleIf(assembled, i, length);
-		if (command == IFELSE_TOKEN) i=handleIf(assembled, i, length);
-		if (command == FOR_TOKEN) i=handleFor(assembled, i, length);
-		if (command == GOTO_TOKEN) i=handleGoto(assembled, i, length);
-		if (command == FNCALL_TOKEN || command == FNCALL_BY_VAR_TOKEN) {
-			i=handleFnCall(assembled, i, &fnAddr, length, command == FNCALL_BY_VAR_TOKEN ? 1:0);
-			fnLevel++;
-			processAssembledCode(assembled, fnAddr, length);
-			clearVariablesToLevel(fnLevel);
-			fnLevel--;
-		}
-		if (command == NATIVE_TOKEN) i=handleNative(assembled, i, length, NULL);
-		if (command == ALIAS_TOKEN) i=handleAlias(assembled, i, length);
-		if (command == RETURN_TOKEN) return empty;
-		if (command == RETURN_EXP_TOKEN) {
+		// Dense switch over the statement tokens, compiled to a jump table rather than a chain of tests
+		switch (command) {
+		case LET_TOKEN:
+			i=handleLet(assembled, i, length, 0);
+			break;
+		case LETNOALIAS_TOKEN:
+			i=handleLet(assembled, i, length, 1);
+			break;
+		case IF_TOKEN:
+		case IFELSE_TOKEN:
+			i=handleIf(assembled, i, length);
+			break;
+		case FOR_TOKEN:
+			i=handleFor(assembled, i, length);
+			break;
+		case FOR_RANGE_TOKEN:
+			i=handleForRange(assembled, i);
+			break;
+		case IF_COMPARE_TOKEN:
+			i=handleIfCompare(assembled, i);
+			break;
+		case INCREMENT_TOKEN:
+			i=handleIncrement(assembled, i);
+			break;
+		case LET_FROM_ARRAY_TOKEN:
+			i=handleLetFromArray(assembled, i);
+			break;
+		case LET_TO_ARRAY_TOKEN:
+			i=handleLetToArray(assembled, i, length);
+			break;
+		case GOTO_TOKEN:
+			i=handleGoto(assembled, i, length);
+			break;
+		case FNCALL_TOKEN:
+		case FNCALL_BY_VAR_TOKEN:
+			callFunction(assembled, &i, length, command == FNCALL_BY_VAR_TOKEN ? 1:0);
+			break;
+		case NATIVE_TOKEN:
+			i=handleNative(assembled, i, length, NULL);
+			break;
+		case ALIAS_TOKEN:
+			i=handleAlias(assembled, i, length);
+			break;
+		case RETURN_EXP_TOKEN:
 			return getExpressionValue(assembled, &i, length);
+		case STOP_TOKEN:
+		case RETURN_TOKEN:
+			return empty;
 		}
 		if (stopInterpreter) return empty;
 	}
@@ -266,24 +554,58 @@ static unsigned int handleNative(char * assembled, unsigned int currentPoint, un
 }
 
 /**
- * Calls some function and stores the call point in the function call stack for returning from this function
+ * Calls a function by pushing its activation frame, running its body and then popping the frame again. As scalars are held
+ * directly in the symbol table there is no other memory to release, so popping the frame is constant cost
+ */
+#ifdef HOST_INTERPRETER
+static struct value_defn callFunction(char * assembled, unsigned int * currentPoint, unsigned int length, char calledByVar, int threadId) {
+	unsigned int fnAddr;
+	int frameBase, callerFrameBase=currentFrameBase[threadId];
+	*currentPoint=handleFnCall(assembled, *currentPoint, &fnAddr, &frameBase, length, calledByVar, threadId);
+	currentFrameBase[threadId]=frameBase;
+	struct value_defn returnValue=processAssembledCode(assembled, fnAddr, length, threadId);
+	currentSymbolEntries[threadId]=frameBase-1;
+	currentFrameBase[threadId]=callerFrameBase;
+	return returnValue;
+}
+#else
+static struct value_defn callFunction(char * assembled, unsigned int * currentPoint, unsigned int length, char calledByVar) {
+	unsigned int fnAddr;
+	int frameBase, callerFrameBase=currentFrameBase;
+	*currentPoint=handleFnCall(assembled, *currentPoint, &fnAddr, &frameBase, length, calledByVar);
+	currentFrameBase=frameBase;
+	struct value_defn returnValue=processAssembledCode(assembled, fnAddr, length);
+	currentSymbolEntries=frameBase-1;
+	currentFrameBase=callerFrameBase;
+	return returnValue;
+}
+#endif
+
+/**
+ * Calls some function, this pushes a new frame for the function's local variables onto the symbol table (the start of which
+ * is returned in frameBase) and aliases the arguments of the function to the variables provided by the caller
  */
 #ifdef HOST_INTERPRETER
-static unsigned int handleFnCall(char * assembled, unsigned int currentPoint, unsigned int * functionAddress, unsigned int length, char calledByVar, int threadId) {
+static unsigned int handleFnCall(char * assembled, unsigned int currentPoint, unsigned int * functionAddress, int * frameBase,
+		unsigned int length, char calledByVar, int threadId) {
 #else
-static unsigned int handleFnCall(char * assembled, unsigned int currentPoint, unsigned int * functionAddress, unsigned int length, char calledByVar) {
+static unsigned int handleFnCall(char * assembled, unsigned int currentPoint, unsigned int * functionAddress, int * frameBase,
+		unsigned int length, char calledByVar) {
 #endif
 	unsigned short fnAddress;
 	if (calledByVar) {
 #ifdef HOST_INTERPRETER
-        struct symbol_node* callVar=getVariableSymbol(getUShort(&assembled[currentPoint]), fnLevel[threadId], threadId, 1);
+        struct symbol_node* callVar=getVariableSymbol(getUShort(&assembled[currentPoint]), threadId, 1);
 #else
-        struct symbol_node* callVar=getVariableSymbol(getUShort(&assembled[currentPoint]), fnLevel, 1);
+        struct symbol_node* callVar=getVariableSymbol(getUShort(&assembled[currentPoint]), 1);
 #endif
         if (callVar->value.type != FN_ADDR_TYPE) raiseError(ERR_FNCALL_VAR_NOT_CONTAINING_FN_PTR);
-        char *ptr;
-        cpy(&ptr, callVar->value.data, sizeof(char*));
-        fnAddress=getUShort(ptr);
+        struct value_defn fnPtr=getVariableValue(callVar, -1);
+#ifdef HOST_INTERPRETER
+        fnAddress=getFunctionLocation(getUShort(fnPtr.data), threadId);
+#else
+        fnAddress=getFunctionLocation(getUShort(fnPtr.data));
+#endif
 	} else {
         fnAddress=getUShort(&assembled[currentPoint]);
 	}
@@ -291,33 +613,57 @@ static unsigned int handleFnCall(char * assembled, unsigned int currentPoint, un
 
 	unsigned short fnNumArgs=getUShort(&assembled[fnAddress]);
 	fnAddress+=sizeof(unsigned short);
+	unsigned short fnFrameSize=getUShort(&assembled[fnAddress]);
+	fnAddress+=sizeof(unsigned short);
+
+#ifdef HOST_INTERPRETER
+	*frameBase=currentSymbolEntries[threadId]+1;
+	if (*frameBase + fnFrameSize > symbolTableSize[threadId]) raiseError(ERR_SYMBOL_TABLE_FULL);
+	initialiseSymbolTableEntries(*frameBase, fnFrameSize, threadId);
+#else
+	*frameBase=currentSymbolEntries+1;
+	if (*frameBase + fnFrameSize > symbolTableSize) raiseError(ERR_SYMBOL_TABLE_FULL);
+	initialiseSymbolTableEntries(*frameBase, fnFrameSize);
+#endif
 
 	unsigned short callerNumArgs=getUShort(&assembled[currentPoint]);
 	currentPoint+=sizeof(unsigned short);
 	struct symbol_node* srcSymbol, *targetSymbol;
+	char* zero=0;
 	int i, numArgs;
 	numArgs=fnNumArgs > callerNumArgs ? fnNumArgs : callerNumArgs;
 	for (i=0;i<numArgs;i++) {
 		if (i<callerNumArgs && i<fnNumArgs) {
+			// The source is looked up in the caller's frame with any alias chain collapsed, so the parameter refers directly to
+			// the caller's storage and is a single hop on access. The target is always a local slot in the new frame
 #ifdef HOST_INTERPRETER
-			srcSymbol=getVariableSymbol(getUShort(&assembled[currentPoint]), fnLevel[threadId], threadId, 0);
-			targetSymbol=getVariableSymbol(getUShort(&assembled[fnAddress]), fnLevel[threadId]+1, threadId, 0);
+			srcSymbol=getVariableSymbol(getUShort(&assembled[currentPoint]), threadId, 1);
+			targetSymbol=&symbolTable[threadId][*frameBase + (getUShort(&assembled[fnAddress]) & ~LOCAL_VARIABLE_FLAG)];
+			targetSymbol->alias=(unsigned short) (srcSymbol - symbolTable[threadId]);
 #else
-			srcSymbol=getVariableSymbol(getUShort(&assembled[currentPoint]), fnLevel, 0);
-			targetSymbol=getVariableSymbol(getUShort(&assembled[fnAddress]), fnLevel+1, 0);
+			srcSymbol=getVariableSymbol(getUShort(&assembled[currentPoint]), 1);
+			targetSymbol=&symbolTable[*frameBase + (getUShort(&assembled[fnAddress]) & ~LOCAL_VARIABLE_FLAG)];
+			targetSymbol->alias=(unsigned short) (srcSymbol - symbolTable);
 #endif
 			targetSymbol->state=ALIAS;
-			targetSymbol->alias=srcSymbol->id;
+			targetSymbol->value.dtype=SCALAR;
+			cpy(targetSymbol->value.data, &zero, sizeof(char*));
 		}
 		if (i<callerNumArgs) currentPoint+=sizeof(unsigned short);
 		if (i<fnNumArgs) fnAddress+=sizeof(unsigned short);
 	}
 	*functionAddress=fnAddress;
+#ifdef HOST_INTERPRETER
+	currentSymbolEntries[threadId]=*frameBase + fnFrameSize - 1;
+#else
+	currentSymbolEntries=*frameBase + fnFrameSize - 1;
+#endif
 	return currentPoint;
 }
 
 /**
- * Loop iteration
+ * Loop iteration over an array, which was evaluated on entry to the loop. The trip count is computed on the first iteration and
+ * held in loop state, with the loop counter being advanced as each element is assigned to the loop variable
  */
 #ifdef HOST_INTERPRETER
 static unsigned int handleFor(char * assembled, unsigned int currentPoint, unsigned int length, int threadId) {
@@ -325,45 +671,101 @@ static unsigned int handleFor(char * assembled, unsigned int currentPoint, unsig
 static unsigned int handleFor(char * assembled, unsigned int currentPoint, unsigned int length) {
 #endif
 	unsigned short loopIncrementerId=getUShort(&assembled[currentPoint]);
-	currentPoint+=sizeof(unsigned short);
-	unsigned short loopVariantId=getUShort(&assembled[currentPoint]);
-	currentPoint+=sizeof(unsigned short);
+	unsigned short loopVariantId=getUShort(&assembled[currentPoint+sizeof(unsigned short)]);
+	unsigned short loopArrayId=getUShort(&assembled[currentPoint+sizeof(unsigned short)*2]);
+	unsigned short loopTripCountId=getUShort(&assembled[currentPoint+sizeof(unsigned short)*3]);
+	currentPoint+=sizeof(unsigned short)*4;
 #ifdef HOST_INTERPRETER
-	struct symbol_node* incrementVarSymbol=getVariableSymbol(loopIncrementerId, fnLevel[threadId], threadId, 1);
-	struct symbol_node* variantVarSymbol=getVariableSymbol(loopVariantId, fnLevel[threadId], threadId, 1);
-	struct value_defn expressionVal=getExpressionValue(assembled, &currentPoint, length, threadId);
+	struct symbol_node* incrementVarSymbol=getVariableSymbol(loopIncrementerId, threadId, 1);
+	struct symbol_node* arrayVarSymbol=getVariableSymbol(loopArrayId, threadId, 1);
+	struct symbol_node* tripCountVarSymbol=getVariableSymbol(loopTripCountId, threadId, 1);
 #else
-	struct symbol_node* incrementVarSymbol=getVariableSymbol(loopIncrementerId, fnLevel, 1);
-	struct symbol_node* variantVarSymbol=getVariableSymbol(loopVariantId, fnLevel, 1);
-	struct value_defn expressionVal=getExpressionValue(assembled, &currentPoint, length);
+	struct symbol_node* incrementVarSymbol=getVariableSymbol(loopIncrementerId, 1);
+	struct symbol_node* arrayVarSymbol=getVariableSymbol(loopArrayId, 1);
+	struct symbol_node* tripCountVarSymbol=getVariableSymbol(loopTripCountId, 1);
 #endif
 	unsigned short blockLen=getUShort(&assembled[currentPoint]);
 	currentPoint+=sizeof(unsigned short);
 
 	char * ptr;
-	int singleSize, arrSize=1, i, headersize;
+	int singleSize, arrSize=1, i;
 	unsigned char numDims;
-	cpy(&ptr, expressionVal.data, sizeof(char*));
+	cpy(&ptr, arrayVarSymbol->value.data, sizeof(char*));
 	cpy(&numDims, ptr, sizeof(unsigned char));
 	numDims=numDims & 0xF;
-	for (i=0;i<numDims;i++) {
-        cpy(&singleSize, &ptr[1+(i*sizeof(unsigned int))], sizeof(unsigned int));
-        arrSize*=singleSize;
-	}
-	headersize=sizeof(unsigned char) + (sizeof(unsigned int) * numDims);
 	struct value_defn varVal=getVariableValue(incrementVarSymbol, -1);
 	int incrementVal=getInt(varVal.data);
+	if (incrementVal == 0) {
+		for (i=0;i<numDims;i++) {
+			cpy(&singleSize, &ptr[1+(i*sizeof(unsigned int))], sizeof(unsigned int));
+			arrSize*=singleSize;
+		}
+		tripCountVarSymbol->value.type=INT_TYPE;
+		tripCountVarSymbol->value.dtype=SCALAR;
+		cpy(tripCountVarSymbol->value.data, &arrSize, sizeof(int));
+	} else {
+		arrSize=getInt(tripCountVarSymbol->value.data);
+	}
 	if (incrementVal < arrSize) {
 		struct value_defn nextElement;
-		nextElement.type=expressionVal.type;
-		cpy(&nextElement.data, ptr+((incrementVal*sizeof(int)) + headersize), sizeof(int));
-		setVariableValue(variantVarSymbol, nextElement, -1);
+		nextElement.type=arrayVarSymbol->value.type;
+		nextElement.dtype=SCALAR;
+		cpy(&nextElement.data, ptr+((incrementVal+numDims)*sizeof(int)) + sizeof(unsigned char), sizeof(int));
+#ifdef HOST_INTERPRETER
+		setVariableValue(getVariableSymbol(loopVariantId, threadId, 1), nextElement, -1);
+#else
+		setVariableValue(getVariableSymbol(loopVariantId, 1), nextElement, -1);
+#endif
+		incrementVal++;
+		cpy(incrementVarSymbol->value.data, &incrementVal, sizeof(int));
 		return currentPoint;
 	}
 	currentPoint+=(blockLen+sizeof(unsigned short)+sizeof(unsigned char));
 	return currentPoint;
 }
 
+/**
+ * Counted loop iteration, the loop variable takes the current value if this has not passed the (inclusive) stop value in the
+ * direction of the step, and the current value is then advanced by the step
+ */
+#ifdef HOST_INTERPRETER
+static unsigned int handleForRange(char * assembled, unsigned int currentPoint, int threadId) {
+	struct symbol_node* currentVarSymbol=getVariableSymbol(getUShort(&assembled[currentPoint]), threadId, 1);
+	struct symbol_node* variantVarSymbol=getVariableSymbol(getUShort(&assembled[currentPoint+sizeof(unsigned short)]), threadId, 1);
+	int stop=getLoopBound(getVariableSymbol(getUShort(&assembled[currentPoint+sizeof(unsigned short)*2]), threadId, 1));
+	int step=getLoopBound(getVariableSymbol(getUShort(&assembled[currentPoint+sizeof(unsigned short)*3]), threadId, 1));
+#else
+static unsigned int handleForRange(char * assembled, unsigned int currentPoint) {
+	struct symbol_node* currentVarSymbol=getVariableSymbol(getUShort(&assembled[currentPoint]), 1);
+	struct symbol_node* variantVarSymbol=getVariableSymbol(getUShort(&assembled[currentPoint+sizeof(unsigned short)]), 1);
+	int stop=getLoopBound(getVariableSymbol(getUShort(&assembled[currentPoint+sizeof(unsigned short)*2]), 1));
+	int step=getLoopBound(getVariableSymbol(getUShort(&assembled[currentPoint+sizeof(unsigned short)*3]), 1));
+#endif
+	int current=getLoopBound(currentVarSymbol);
+	currentPoint+=sizeof(unsigned short)*4;
+	if ((step > 0 && current <= stop) || (step < 0 && current >= stop)) {
+		struct value_defn nextValue;
+		nextValue.type=INT_TYPE;
+		nextValue.dtype=SCALAR;
+		cpy(nextValue.data, &current, sizeof(int));
+		setVariableValue(variantVarSymbol, nextValue, -1);
+		current+=step;
+		currentVarSymbol->value.type=INT_TYPE;
+		cpy(currentVarSymbol->value.data, &current, sizeof(int));
+		return currentPoint+sizeof(unsigned short);
+	}
+	return currentPoint+sizeof(unsigned short)+getUShort(&assembled[currentPoint])+sizeof(unsigned short)+sizeof(unsigned char);
+}
+
+/**
+ * Retrieves the integer value of a counted loop's current, stop or step value, real values are truncated
+ */
+static int getLoopBound(struct symbol_node* variableSymbol) {
+	struct value_defn value=getVariableValue(variableSymbol, -1);
+	if (value.type == REAL_TYPE) return (int) getFloat(value.data);
+	return getInt(value.data);
+}
+
 /**
  * Conditional, with or without else block
  */
@@ -379,6 +781,111 @@ static unsigned int handleIf(char * assembled, unsigned int currentPoint, unsign
 	return currentPoint+sizeof(unsigned short)+blockLen;
 }
 
+/**
+ * Compare and branch superinstruction, a conditional (with or without else block or as the test of a loop) whose condition is the
+ * comparison of two constants or variables
+ */
+#ifdef HOST_INTERPRETER
+static unsigned int handleIfCompare(char * assembled, unsigned int currentPoint, int threadId) {
+#else
+static unsigned int handleIfCompare(char * assembled, unsigned int currentPoint) {
+#endif
+	unsigned int comparisonPoint=currentPoint;
+	currentPoint+=sizeof(unsigned char);
+#ifdef HOST_INTERPRETER
+	superinstructionCounts[threadId][IF_COMPARE_TOKEN-INCREMENT_TOKEN]++;
+	struct value_defn operand1=getRegisterOperand(assembled, &currentPoint, NULL, threadId);
+	struct value_defn operand2=getRegisterOperand(assembled, &currentPoint, NULL, threadId);
+#else
+	struct value_defn operand1=getRegisterOperand(assembled, &currentPoint, NULL);
+	struct value_defn operand2=getRegisterOperand(assembled, &currentPoint, NULL);
+#endif
+	if (compareTypedValues(assembled, comparisonPoint, operand1, operand2)) return currentPoint+sizeof(unsigned short);
+	return currentPoint+sizeof(unsigned short)+getUShort(&assembled[currentPoint]);
+}
+
+/**
+ * Increment (or decrement) by constant superinstruction, integer scalars are updated in place and otherwise this follows the
+ * same rules as the equivalent addition or subtraction
+ */
+#ifdef HOST_INTERPRETER
+static unsigned int handleIncrement(char * assembled, unsigned int currentPoint, int threadId) {
+	struct symbol_node* variableSymbol=getVariableSymbol(getUShort(&assembled[currentPoint]), threadId, 1);
+	superinstructionCounts[threadId][INCREMENT_TOKEN-INCREMENT_TOKEN]++;
+#else
+static unsigned int handleIncrement(char * assembled, unsigned int currentPoint) {
+	struct symbol_node* variableSymbol=getVariableSymbol(getUShort(&assembled[currentPoint]), 1);
+#endif
+	unsigned char operator=getUChar(&assembled[currentPoint+sizeof(unsigned short)]);
+	currentPoint+=sizeof(unsigned short)+sizeof(unsigned char);
+	if (variableSymbol->value.dtype == SCALAR && variableSymbol->value.type == INT_TYPE) {
+		int value=getInt(variableSymbol->value.data), constant=getInt(&assembled[currentPoint]);
+		value=operator == ADD_TOKEN ? value+constant : value-constant;
+		cpy(variableSymbol->value.data, &value, sizeof(int));
+	} else {
+		struct value_defn constant;
+		constant.type=INT_TYPE;
+		constant.dtype=SCALAR;
+		cpy(constant.data, &assembled[currentPoint], sizeof(int));
+#ifdef HOST_INTERPRETER
+		assignVariableValue(variableSymbol, performArithmetic(operator, getIdentifierValue(variableSymbol), constant, threadId), 0, -1);
+#else
+		assignVariableValue(variableSymbol, performArithmetic(operator, getIdentifierValue(variableSymbol), constant), 0, -1);
+#endif
+	}
+	return currentPoint+sizeof(int);
+}
+
+/**
+ * Load array element superinstruction, which sets a variable to an element of a one dimensional array
+ */
+#ifdef HOST_INTERPRETER
+static unsigned int handleLetFromArray(char * assembled, unsigned int currentPoint, int threadId) {
+	struct symbol_node* variableSymbol=getVariableSymbol(getUShort(&assembled[currentPoint]), threadId, 1);
+	struct symbol_node* arraySymbol=getVariableSymbol(getUShort(&assembled[currentPoint+sizeof(unsigned short)]), threadId, 1);
+	currentPoint+=sizeof(unsigned short)*2;
+	superinstructionCounts[threadId][LET_FROM_ARRAY_TOKEN-INCREMENT_TOKEN]++;
+	struct value_defn index=getRegisterOperand(assembled, &currentPoint, NULL, threadId);
+	int arrayIndex=getInt(index.data);
+	struct value_defn value=getVariableValue(arraySymbol, computeArrayAccessorIndex(arraySymbol, 1, &arrayIndex, threadId));
+#else
+static unsigned int handleLetFromArray(char * assembled, unsigned int currentPoint) {
+	struct symbol_node* variableSymbol=getVariableSymbol(getUShort(&assembled[currentPoint]), 1);
+	struct symbol_node* arraySymbol=getVariableSymbol(getUShort(&assembled[currentPoint+sizeof(unsigned short)]), 1);
+	currentPoint+=sizeof(unsigned short)*2;
+	struct value_defn index=getRegisterOperand(assembled, &currentPoint, NULL);
+	int arrayIndex=getInt(index.data);
+	struct value_defn value=getVariableValue(arraySymbol, computeArrayAccessorIndex(arraySymbol, 1, &arrayIndex));
+#endif
+	assignVariableValue(variableSymbol, value, 0, -1);
+	return currentPoint;
+}
+
+/**
+ * Store array element superinstruction, which sets an element of a one dimensional array to the value of an expression
+ */
+#ifdef HOST_INTERPRETER
+static unsigned int handleLetToArray(char * assembled, unsigned int currentPoint, unsigned int length, int threadId) {
+	struct symbol_node* arraySymbol=getVariableSymbol(getUShort(&assembled[currentPoint]), threadId, 1);
+	currentPoint+=sizeof(unsigned short);
+	superinstructionCounts[threadId][LET_TO_ARRAY_TOKEN-INCREMENT_TOKEN]++;
+	struct value_defn index=getRegisterOperand(assembled, &currentPoint, NULL, threadId);
+	int arrayIndex=getInt(index.data);
+	int targetIndex=computeArrayAccessorIndex(arraySymbol, 1, &arrayIndex, threadId);
+	struct value_defn value=getExpressionValue(assembled, &currentPoint, length, threadId);
+#else
+static unsigned int handleLetToArray(char * assembled, unsigned int currentPoint, unsigned int length) {
+	struct symbol_node* arraySymbol=getVariableSymbol(getUShort(&assembled[currentPoint]), 1);
+	currentPoint+=sizeof(unsigned short);
+	struct value_defn index=getRegisterOperand(assembled, &currentPoint, NULL);
+	int arrayIndex=getInt(index.data);
+	int targetIndex=computeArrayAccessorIndex(arraySymbol, 1, &arrayIndex);
+	struct value_defn value=getExpressionValue(assembled, &currentPoint, length);
+#endif
+	assignVariableValue(arraySymbol, value, 1, targetIndex);
+	return currentPoint;
+}
+
 #ifdef HOST_INTERPRETER
 static unsigned int handleAlias(char * assembled, unsigned int currentPoint, unsigned int length, int threadId) {
 #else
@@ -387,15 +894,15 @@ static unsigned int handleAlias(char * assembled, unsigned int currentPoint, uns
 	unsigned short tgtVarId=getUShort(&assembled[currentPoint]);
 	currentPoint+=sizeof(unsigned short);
 #ifdef HOST_INTERPRETER
-	struct symbol_node* tgtVariableSymbol=getVariableSymbol(tgtVarId, fnLevel[threadId], threadId, 1);
+	struct symbol_node* tgtVariableSymbol=getVariableSymbol(tgtVarId, threadId, 1);
 	struct value_defn value=getExpressionValue(assembled, &currentPoint, length, threadId);
 #else
-	struct symbol_node* tgtVariableSymbol=getVariableSymbol(tgtVarId, fnLevel, 1);
+	struct symbol_node* tgtVariableSymbol=getVariableSymbol(tgtVarId, 1);
 	struct value_defn value=getExpressionValue(assembled, &currentPoint, length);
 #endif
 	int symbolVal=getInt(value.data);
 	tgtVariableSymbol->state=ALIAS;
-	tgtVariableSymbol->alias=(unsigned char) symbolVal;
+	tgtVariableSymbol->alias=(unsigned short) symbolVal;
 	return currentPoint;
 }
 
@@ -412,42 +919,48 @@ static unsigned int handleLet(char * assembled, unsigned int currentPoint, unsig
 	unsigned short varId=getUShort(&assembled[currentPoint]);
 	currentPoint+=sizeof(unsigned short);
 #ifdef HOST_INTERPRETER
-	struct symbol_node* variableSymbol=getVariableSymbol(varId, fnLevel[threadId], threadId, 1);
+	struct symbol_node* variableSymbol=getVariableSymbol(varId, threadId, 1);
 	int targetIndex=-1;
 	if (identifierType==ARRAYACCESS_TOKEN) {
 		targetIndex=getArrayAccessorIndex(variableSymbol, assembled, &currentPoint, length, threadId);
 	}
 	struct value_defn value=getExpressionValue(assembled, &currentPoint, length, threadId);
-	if (restrictNoAlias && getVariableSymbol(varId, fnLevel[threadId], threadId, 0)->state==ALIAS) return currentPoint;
+	if (restrictNoAlias && getVariableSymbol(varId, threadId, 0)->state==ALIAS) return currentPoint;
 #else
-	struct symbol_node* variableSymbol=getVariableSymbol(varId, fnLevel, 1);
+	struct symbol_node* variableSymbol=getVariableSymbol(varId, 1);
 	int targetIndex=-1;
 	if (identifierType==ARRAYACCESS_TOKEN) {
 		targetIndex=getArrayAccessorIndex(variableSymbol, assembled, &currentPoint, length);
 	}
 	struct value_defn value=getExpressionValue(assembled, &currentPoint, length);
-	if (restrictNoAlias && getVariableSymbol(varId, fnLevel, 0)->state==ALIAS) return currentPoint;
+	if (restrictNoAlias && getVariableSymbol(varId, 0)->state==ALIAS) return currentPoint;
 #endif
+	assignVariableValue(variableSymbol, value, identifierType==ARRAYACCESS_TOKEN, targetIndex);
+	return currentPoint;
+}
+
+/**
+ * Assigns a value to a variable, or to an element of it for an array access, this is common to all the forms of assignment
+ */
+static void assignVariableValue(struct symbol_node* variableSymbol, struct value_defn value, char isArrayAccess, int targetIndex) {
 	variableSymbol->value.type=value.type;
 	// Set the dtype if this is not an array (otherwise it can overwrite an array type with scalar, and array access will always be predefined so should be fine
-	if (identifierType!=ARRAYACCESS_TOKEN) variableSymbol->value.dtype=value.dtype;
+	if (!isArrayAccess) {
+		if (value.dtype > 1) {
+			// A dereferenced pointer, held as an array or as a scalar reference to the memory pointed to
+			variableSymbol->value.dtype=value.dtype-2 == ARRAY ? ARRAY : SCALAR_REFERENCE;
+		} else if (variableSymbol->value.dtype != SCALAR_REFERENCE || value.dtype != SCALAR || value.type == STRING_TYPE) {
+			// Scalar references keep their dtype when assigned a scalar, so that this is written through to the memory pointed to
+			variableSymbol->value.dtype=value.dtype;
+		}
+	}
 	if (value.dtype == ARRAY || value.dtype > 1) {
 		cpy(variableSymbol->value.data, value.data, sizeof(char*));
 	} else if (value.type == STRING_TYPE) {
 		cpy(&variableSymbol->value.data, &value.data, sizeof(char*));
 	} else {
-		char * ptr;
-		cpy(&ptr, variableSymbol->value.data, sizeof(char*));
-		if (ptr == 0) {
-			ptr=getStackMemory(sizeof(int), 0);
-			cpy(variableSymbol->value.data, &ptr, sizeof(char*));
-			cpy(ptr, value.data, sizeof(char*));
-		} else {
-			setVariableValue(variableSymbol, value, targetIndex);
-		}
+		setVariableValue(variableSymbol, value, targetIndex);
 	}
-	if (variableSymbol->value.dtype > 1) variableSymbol->value.dtype-=2;
-	return currentPoint;
 }
 
 /**
@@ -458,18 +971,27 @@ static int determine_logical_expression(char * assembled, unsigned int * current
 #else
 static int determine_logical_expression(char * assembled, unsigned int * currentPoint, unsigned int length) {
 #endif
-	unsigned char expressionId=getUChar(&assembled[*currentPoint]);
+	unsigned int operatorPoint=*currentPoint;
+	unsigned char expressionId=getGenericOperator(getUChar(&assembled[*currentPoint]));
 	*currentPoint+=sizeof(unsigned char);
 	if (expressionId == AND_TOKEN || expressionId == OR_TOKEN) {
+		// The second expression is skipped over if the first alone determines the result
+		unsigned short skipLength=getUShort(&assembled[*currentPoint]);
+		*currentPoint+=sizeof(unsigned short);
 #ifdef HOST_INTERPRETER
 		int s1=determine_logical_expression(assembled, currentPoint, length, threadId);
-		int s2=determine_logical_expression(assembled, currentPoint, length, threadId);
 #else
 		int s1=determine_logical_expression(assembled, currentPoint, length);
-		int s2=determine_logical_expression(assembled, currentPoint, length);
 #endif
-		if (expressionId == AND_TOKEN) return s1 && s2;
-		if (expressionId == OR_TOKEN) return s1 || s2;
+		if ((expressionId == AND_TOKEN && !s1) || (expressionId == OR_TOKEN && s1)) {
+			*currentPoint+=skipLength;
+			return s1;
+		}
+#ifdef HOST_INTERPRETER
+		return determine_logical_expression(assembled, currentPoint, length, threadId);
+#else
+		return determine_logical_expression(assembled, currentPoint, length);
+#endif
 	} else if (expressionId == NOT_TOKEN) {
 #ifdef HOST_INTERPRETER
 		struct value_defn expression=getExpressionValue(assembled, currentPoint, length, threadId);
@@ -488,52 +1010,7 @@ static int determine_logical_expression(char * assembled, unsigned int * current
 		struct value_defn expression1=getExpressionValue(assembled, currentPoint, length);
 		struct value_defn expression2=getExpressionValue(assembled, currentPoint, length);
 #endif
-		if (expressionId == IS_TOKEN) {
-			if (expression1.type == NONE_TYPE && expression2.type == NONE_TYPE) return 1;
-			if (expression1.type != expression2.type) return 0;
-			char *ptr1, *ptr2;
-			cpy(&ptr1, expression1.data, sizeof(char*));
-			cpy(&ptr2, expression2.data, sizeof(char*));
-			return ptr1 == ptr2;
-		}
-		if (expression1.type == expression2.type && expression1.type == INT_TYPE) {
-			int value1=getInt(expression1.data);
-			int value2=getInt(expression2.data);
-			if (expressionId == EQ_TOKEN) return value1 == value2;
-			if (expressionId == NEQ_TOKEN) return value1 != value2;
-			if (expressionId == GT_TOKEN) return value1 > value2;
-			if (expressionId == GEQ_TOKEN) return value1 >= value2;
-			if (expressionId == LT_TOKEN) return value1 < value2;
-			if (expressionId == LEQ_TOKEN) return value1 <= value2;
-		} else if ((expression1.type == REAL_TYPE || expression1.type == INT_TYPE) &&
-				(expression2.type == REAL_TYPE || expression2.type == INT_TYPE)) {
-			float value1=getFloat(expression1.data);
-			float value2=getFloat(expression2.data);
-			if (expression1.type==INT_TYPE) value1=(float) getInt(expression1.data);
-			if (expression2.type==INT_TYPE) value2=(float) getInt(expression2.data);
-			if (expressionId == EQ_TOKEN) return value1 == value2;
-			if (expressionId == NEQ_TOKEN) return value1 != value2;
-			if (expressionId == GT_TOKEN) return value1 > value2;
-			if (expressionId == GEQ_TOKEN) return value1 >= value2;
-			if (expressionId == LT_TOKEN) return value1 < value2;
-			if (expressionId == LEQ_TOKEN) return value1 <= value2;
-		} else if (expression1.type == expression2.type && expression1.type == STRING_TYPE) {
-			if (expressionId == EQ_TOKEN) {
-				return checkStringEquality(expression1, expression2);
-			} else if (expressionId == NEQ_TOKEN) {
-				return !checkStringEquality(expression1, expression2);
-			} else {
-				raiseError(ERR_STR_ONLYTEST_EQ);
-			}
-		} else if (expression1.type == expression2.type && expression1.type == NONE_TYPE) {
-			if (expressionId == EQ_TOKEN || expressionId == IS_TOKEN) {
-				return 1;
-			} else if (expressionId == NEQ_TOKEN) {
-				return 0;
-			} else {
-				raiseError(ERR_NONE_ONLYTEST_EQ);
-			}
-		}
+		return compareTypedValues(assembled, operatorPoint, expression1, expression2);
 	} else if (expressionId == BOOLEAN_TOKEN) {
 		struct value_defn value;
 		cpy(value.data, &assembled[*currentPoint], sizeof(int));
@@ -544,9 +1021,9 @@ static int determine_logical_expression(char * assembled, unsigned int * current
 		unsigned short variable_id=getUShort(&assembled[*currentPoint]);
 		*currentPoint+=sizeof(unsigned short);
 #ifdef HOST_INTERPRETER
-		struct symbol_node* variableSymbol=getVariableSymbol(variable_id, fnLevel[threadId], threadId, 1);
+		struct symbol_node* variableSymbol=getVariableSymbol(variable_id, threadId, 1);
 #else
-		struct symbol_node* variableSymbol=getVariableSymbol(variable_id, fnLevel, 1);
+		struct symbol_node* variableSymbol=getVariableSymbol(variable_id, 1);
 #endif
 		value=getVariableValue(variableSymbol, -1);
 		if (expressionId == ARRAYACCESS_TOKEN) {
@@ -588,36 +1065,45 @@ static struct value_defn getExpressionValue(char * assembled, unsigned int * cur
 
 	unsigned char expressionId=getUChar(&assembled[*currentPoint]);
 	*currentPoint+=sizeof(unsigned char);
-	if (expressionId == INTEGER_TOKEN) {
+	// Typed operators are dispatched in the same way as the generic operator that they specialise
+	switch (getGenericOperator(expressionId)) {
+	case INTEGER_TOKEN:
 		value.type=INT_TYPE;
 		value.dtype=SCALAR;
 		cpy(value.data, &assembled[*currentPoint], sizeof(int));
 		*currentPoint+=sizeof(int);
-	} else if (expressionId == REAL_TOKEN) {
+		break;
+	case REAL_TOKEN:
 		value.type=REAL_TYPE;
 		value.dtype=SCALAR;
 		cpy(value.data, &assembled[*currentPoint], sizeof(float));
 		*currentPoint+=sizeof(float);
-	} else if (expressionId == BOOLEAN_TOKEN) {
+		break;
+	case BOOLEAN_TOKEN:
 		value.type=BOOLEAN_TYPE;
 		value.dtype=SCALAR;
 		cpy(value.data, &assembled[*currentPoint], sizeof(int));
 		*currentPoint+=sizeof(int);
-	} else if (expressionId == STRING_TOKEN) {
+		break;
+	case STRING_TOKEN: {
 		value.type=STRING_TYPE;
 		char * strPtr=assembled + *currentPoint;
 		cpy(&value.data, &strPtr, sizeof(char*));
 		*currentPoint+=(slength(strPtr)+1);
 		value.dtype=SCALAR;
-	} else if (expressionId == NONE_TOKEN) {
+		break;
+	}
+	case NONE_TOKEN:
 		value.type=NONE_TYPE;
 		value.dtype=SCALAR;
-	} else if (expressionId ==FN_ADDR_TOKEN) {
+		break;
+	case FN_ADDR_TOKEN:
         value.type=FN_ADDR_TYPE;
 		value.dtype=SCALAR;
 		cpy(value.data, &assembled[*currentPoint], sizeof(unsigned short));
 		*currentPoint+=sizeof(unsigned short);
-	} else if (expressionId == LET_TOKEN) {
+		break;
+	case LET_TOKEN:
 #ifdef HOST_INTERPRETER
 		*currentPoint=handleLet(assembled, *currentPoint, length, 0, threadId);
 		value=getExpressionValue(assembled, currentPoint, length, threadId);
@@ -625,7 +1111,8 @@ static struct value_defn getExpressionValue(char * assembled, unsigned int * cur
 		*currentPoint=handleLet(assembled, *currentPoint, length, 0);
 		value=getExpressionValue(assembled, currentPoint, length);
 #endif
-	} else if (expressionId == ARRAY_TOKEN) {
+		break;
+	case ARRAY_TOKEN: {
 		int i, j, repetitionMultiplier=1, numItems=getInt(&assembled[*currentPoint]), totalSize=numItems;
 		*currentPoint+=sizeof(int);
 		unsigned char hasRepetition=getUChar(&assembled[*currentPoint]), ndims=1;
@@ -663,69 +1150,73 @@ static struct value_defn getExpressionValue(char * assembled, unsigned int * cur
             }
 		}
 		value.dtype=ARRAY;
-	} else if (expressionId == FNCALL_TOKEN || expressionId == FNCALL_BY_VAR_TOKEN) {
+		break;
+	}
+	case FNCALL_TOKEN:
+	case FNCALL_BY_VAR_TOKEN:
 #ifdef HOST_INTERPRETER
-		unsigned int fnAddr;
-		*currentPoint=handleFnCall(assembled, *currentPoint, &fnAddr, length, expressionId == FNCALL_BY_VAR_TOKEN ? 1:0, threadId);
-		fnLevel[threadId]++;
-		value=processAssembledCode(assembled, fnAddr, length, threadId);
-		clearVariablesToLevel(fnLevel[threadId], threadId);
-		fnLevel[threadId]--;
+		value=callFunction(assembled, currentPoint, length, expressionId == FNCALL_BY_VAR_TOKEN ? 1:0, threadId);
 #else
-		unsigned int fnAddr;
-		*currentPoint=handleFnCall(assembled, *currentPoint, &fnAddr, length, expressionId == FNCALL_BY_VAR_TOKEN ? 1:0);
-		fnLevel++;
-		value=processAssembledCode(assembled, fnAddr, length);
-		clearVariablesToLevel(fnLevel);
-		fnLevel--;
+		value=callFunction(assembled, currentPoint, length, expressionId == FNCALL_BY_VAR_TOKEN ? 1:0);
 #endif
-    } else if (expressionId == NATIVE_TOKEN) {
+		break;
+	case NATIVE_TOKEN:
 #ifdef HOST_INTERPRETER
         *currentPoint=handleNative(assembled, *currentPoint, length, &value, threadId);
 #else
         *currentPoint=handleNative(assembled, *currentPoint, length, &value);
 #endif
-	} else if (expressionId == SYMBOL_TOKEN) {
+		break;
+	case SYMBOL_TOKEN: {
 		unsigned short variable_id=getUShort(&assembled[*currentPoint]);
 		*currentPoint+=sizeof(unsigned short);
 #ifdef HOST_INTERPRETER
-		struct symbol_node* variableSymbol=getVariableSymbol(variable_id, fnLevel[threadId], threadId, 1);
+		struct symbol_node* variableSymbol=getVariableSymbol(variable_id, threadId, 1);
 #else
-		struct symbol_node* variableSymbol=getVariableSymbol(variable_id, fnLevel, 1);
+		struct symbol_node* variableSymbol=getVariableSymbol(variable_id, 1);
 #endif
 		value.dtype=SCALAR;
 		value.type=INT_TYPE;
-		cpy(value.data, &variableSymbol->id, sizeof(int));
-	} else if (expressionId == REFERENCE_TOKEN) {
+#ifdef HOST_INTERPRETER
+		int symbolIndex=variableSymbol - symbolTable[threadId];
+#else
+		int symbolIndex=variableSymbol - symbolTable;
+#endif
+		cpy(value.data, &symbolIndex, sizeof(int));
+		break;
+	}
+	case REFERENCE_TOKEN: {
 		unsigned short variable_id=getUShort(&assembled[*currentPoint]);
 		*currentPoint+=sizeof(unsigned short);
 #ifdef HOST_INTERPRETER
-		struct symbol_node* variableSymbol=getVariableSymbol(variable_id, fnLevel[threadId], threadId, 1);
+		struct symbol_node* variableSymbol=getVariableSymbol(variable_id, threadId, 1);
 #else
-		struct symbol_node* variableSymbol=getVariableSymbol(variable_id, fnLevel, 1);
+		struct symbol_node* variableSymbol=getVariableSymbol(variable_id, 1);
 #endif
 		value.dtype=SCALAR;
 		value.type=variableSymbol->value.type;
 		value.type|=1 << 7;
-		value.type|=(variableSymbol->value.dtype & 1)<<5;
-		value.type|=(variableSymbol->value.dtype >> 1 & 1)<<6;
-		cpy(value.data, variableSymbol->value.data, sizeof(char*));
-	} else if (expressionId == IDENTIFIER_TOKEN || expressionId == ARRAYACCESS_TOKEN) {
+		value.type|=(variableSymbol->value.dtype == ARRAY)<<5;
+		if (variableSymbol->value.dtype == SCALAR && variableSymbol->value.type != STRING_TYPE) {
+			// Scalars are held directly in the symbol table, so the reference is to the value in the table entry
+			char * ptr=variableSymbol->value.data;
+			cpy(value.data, &ptr, sizeof(char*));
+		} else {
+			cpy(value.data, variableSymbol->value.data, sizeof(char*));
+		}
+		break;
+	}
+	case IDENTIFIER_TOKEN:
+	case ARRAYACCESS_TOKEN: {
 		unsigned short variable_id=getUShort(&assembled[*currentPoint]);
 		*currentPoint+=sizeof(unsigned short);
 #ifdef HOST_INTERPRETER
-		struct symbol_node* variableSymbol=getVariableSymbol(variable_id, fnLevel[threadId], threadId, 1);
+		struct symbol_node* variableSymbol=getVariableSymbol(variable_id, threadId, 1);
 #else
-		struct symbol_node* variableSymbol=getVariableSymbol(variable_id, fnLevel, 1);
+		struct symbol_node* variableSymbol=getVariableSymbol(variable_id, 1);
 #endif
 		if (expressionId == IDENTIFIER_TOKEN) {
-			if (variableSymbol->value.dtype==SCALAR) {
-				value=getVariableValue(variableSymbol, -1);
-			} else if (variableSymbol->value.dtype==ARRAY) {
-				value.dtype=ARRAY;
-				value.type=variableSymbol->value.type;
-				cpy(value.data, variableSymbol->value.data, sizeof(char*));
-			}
+			value=getIdentifierValue(variableSymbol);
 		} else if (expressionId == ARRAYACCESS_TOKEN) {
 #ifdef HOST_INTERPRETER
 			int targetIndex=getArrayAccessorIndex(variableSymbol, assembled, currentPoint, length, threadId);
@@ -734,15 +1225,30 @@ static struct value_defn getExpressionValue(char * assembled, unsigned int * cur
 #endif
 			value=getVariableValue(variableSymbol, targetIndex);
 		}
-	} else if (expressionId == ADD_TOKEN || expressionId == SUB_TOKEN || expressionId == MUL_TOKEN ||
-			expressionId == DIV_TOKEN || expressionId == MOD_TOKEN || expressionId == POW_TOKEN) {
+		break;
+	}
+	case ADD_TOKEN:
+	case SUB_TOKEN:
+	case MUL_TOKEN:
+	case DIV_TOKEN:
+	case MOD_TOKEN:
+	case POW_TOKEN:
 #ifdef HOST_INTERPRETER
-		value=computeExpressionResult(expressionId, assembled, currentPoint, length, threadId);
+		value=computeExpressionResult(assembled, currentPoint, length, threadId);
 #else
-		value=computeExpressionResult(expressionId, assembled, currentPoint, length);
+		value=computeExpressionResult(assembled, currentPoint, length);
 #endif
-	} else if (expressionId == EQ_TOKEN || expressionId == NEQ_TOKEN || expressionId == GT_TOKEN || expressionId == GEQ_TOKEN ||
-			expressionId == LT_TOKEN || expressionId == LEQ_TOKEN || expressionId == IS_TOKEN) {
+		break;
+	case EQ_TOKEN:
+	case NEQ_TOKEN:
+	case GT_TOKEN:
+	case GEQ_TOKEN:
+	case LT_TOKEN:
+	case LEQ_TOKEN:
+	case IS_TOKEN:
+	case AND_TOKEN:
+	case OR_TOKEN:
+	case NOT_TOKEN: {
 		*currentPoint-=sizeof(unsigned char);
 #ifdef HOST_INTERPRETER
 		int retVal=determine_logical_expression(assembled, currentPoint, length, threadId);
@@ -752,29 +1258,368 @@ static struct value_defn getExpressionValue(char * assembled, unsigned int * cur
 		value.type=BOOLEAN_TYPE;
 		value.dtype=SCALAR;
 		cpy(value.data, &retVal, sizeof(int));
+		break;
+	}
+#ifdef HOST_INTERPRETER
+	case REGISTER_EXPRESSION_TOKEN:
+		value=executeRegisterExpression(assembled, currentPoint, length, threadId);
+		break;
+#endif
+	}
+	return value;
+}
+
+/**
+ * Executes an expression held in the register format. This is a flat sequence of instructions, each of which reads its operands
+ * from and writes its result to virtual registers, so it is evaluated in a single loop rather than recursively. The header is the
+ * length of the instructions, with the value of the expression being left in the first register. This is
+ * kept out of line as otherwise the register file would enlarge the stack frame of every recursive getExpressionValue call. It
+ * is only built into the host interpreter, as the register format is slower than the prefix one and space on a core is short
+ */
+#ifdef HOST_INTERPRETER
+__attribute__((noinline))
+static struct value_defn executeRegisterExpression(char * assembled, unsigned int * currentPoint, unsigned int length, int threadId) {
+	unsigned int i=*currentPoint;
+	unsigned int end=i+sizeof(unsigned short)+getUShort(&assembled[i]);
+	struct value_defn registers[MAX_EXPRESSION_REGISTERS];
+	int truth;
+	i+=sizeof(unsigned short);
+	while (i<end) {
+		unsigned char instruction=getUChar(&assembled[i]);
+		struct value_defn * target=&registers[getUChar(&assembled[i+1])];
+		i+=sizeof(unsigned char) * 2;
+		switch (instruction) {
+		case INTEGER_TOKEN:
+		case BOOLEAN_TOKEN:
+			target->type=instruction == INTEGER_TOKEN ? INT_TYPE : BOOLEAN_TYPE;
+			target->dtype=SCALAR;
+			cpy(target->data, &assembled[i], sizeof(int));
+			i+=sizeof(int);
+			break;
+		case REAL_TOKEN:
+			target->type=REAL_TYPE;
+			target->dtype=SCALAR;
+			cpy(target->data, &assembled[i], sizeof(float));
+			i+=sizeof(float);
+			break;
+		case STRING_TOKEN: {
+			char * strPtr=assembled + i;
+			target->type=STRING_TYPE;
+			target->dtype=SCALAR;
+			cpy(&target->data, &strPtr, sizeof(char*));
+			i+=(slength(strPtr)+1);
+			break;
+		}
+		case NONE_TOKEN:
+			target->type=NONE_TYPE;
+			target->dtype=SCALAR;
+			break;
+		case IDENTIFIER_TOKEN:
+			*target=getIdentifierValue(getVariableSymbol(getUShort(&assembled[i]), threadId, 1));
+			i+=sizeof(unsigned short);
+			break;
+		case ARRAYACCESS_TOKEN: {
+			// The index in each dimension has already been placed in the registers following the target
+			unsigned char j, numDims=getUChar(&assembled[i+sizeof(unsigned short)]);
+			int indexes[numDims];
+			for (j=0;j<numDims;j++) indexes[j]=getInt(target[j+1].data);
+			struct symbol_node* variableSymbol=getVariableSymbol(getUShort(&assembled[i]), threadId, 1);
+			*target=getVariableValue(variableSymbol, computeArrayAccessorIndex(variableSymbol, numDims, indexes, threadId));
+			i+=sizeof(unsigned short) + sizeof(unsigned char);
+			break;
+		}
+		case ADD_TOKEN:
+		case SUB_TOKEN:
+		case MUL_TOKEN:
+		case DIV_TOKEN:
+		case MOD_TOKEN:
+		case POW_TOKEN: {
+			struct value_defn operand1=getRegisterOperand(assembled, &i, registers, threadId);
+			*target=performArithmetic(instruction, operand1, getRegisterOperand(assembled, &i, registers, threadId), threadId);
+			break;
+		}
+		case EQ_TOKEN:
+		case NEQ_TOKEN:
+		case GT_TOKEN:
+		case GEQ_TOKEN:
+		case LT_TOKEN:
+		case LEQ_TOKEN:
+		case IS_TOKEN: {
+			struct value_defn operand1=getRegisterOperand(assembled, &i, registers, threadId);
+			truth=compareValues(instruction, operand1, getRegisterOperand(assembled, &i, registers, threadId));
+			target->type=BOOLEAN_TYPE;
+			target->dtype=SCALAR;
+			cpy(target->data, &truth, sizeof(int));
+			break;
+		}
+		case REGISTER_SHORT_CIRCUIT_TOKEN:
+			// The first operand of and or or has been reduced to a truth value, if this determines the result then the
+			// instructions for the second operand are skipped, otherwise they overwrite the register with its truth value
+			truth=getInt(target->data) > 0;
+			if ((getUChar(&assembled[i]) == AND_TOKEN && !truth) || (getUChar(&assembled[i]) == OR_TOKEN && truth)) {
+				i+=getUShort(&assembled[i+sizeof(unsigned char)]);
+			}
+			i+=sizeof(unsigned char) + sizeof(unsigned short);
+			break;
+		case NOT_TOKEN:
+			truth=getInt(registers[getUChar(&assembled[i])].data) > 0 ? 0 : 1;
+			i+=sizeof(unsigned char);
+			target->type=BOOLEAN_TYPE;
+			target->dtype=SCALAR;
+			cpy(target->data, &truth, sizeof(int));
+			break;
+		case REGISTER_TRUTH_TOKEN:
+		case REGISTER_BOOLEAN_TRUTH_TOKEN:
+			// Conditions on identifiers only hold for booleans, whereas for other values integers are also tested
+			truth=(target->type == BOOLEAN_TYPE || (instruction == REGISTER_TRUTH_TOKEN && target->type == INT_TYPE)) &&
+					getInt(target->data) > 0;
+			target->type=BOOLEAN_TYPE;
+			target->dtype=SCALAR;
+			cpy(target->data, &truth, sizeof(int));
+			break;
+		case REGISTER_EVAL_TOKEN:
+			// Some expression which is not held in the register format, such as a function call, that is evaluated in place
+			*target=getExpressionValue(assembled, &i, length, threadId);
+			break;
+		}
+	}
+	*currentPoint=end;
+	return registers[0];
+}
+#endif
+
+/**
+ * Retrieves an operand of an arithmetic or comparison register instruction, which is either held in a register or is a constant or
+ * variable encoded directly in the instruction. Superinstructions also use this for their operands, without any registers
+ */
+#ifdef HOST_INTERPRETER
+static struct value_defn getRegisterOperand(char * assembled, unsigned int * currentPoint, struct value_defn * registers, int threadId) {
+#else
+static struct value_defn getRegisterOperand(char * assembled, unsigned int * currentPoint, struct value_defn * registers) {
+#endif
+	struct value_defn value;
+	unsigned char operandType=getUChar(&assembled[*currentPoint]);
+	*currentPoint+=sizeof(unsigned char);
+	switch (operandType) {
+#ifdef HOST_INTERPRETER
+	case REGISTER_OPERAND_TOKEN:
+		value=registers[getUChar(&assembled[*currentPoint])];
+		*currentPoint+=sizeof(unsigned char);
+		break;
+#endif
+	case IDENTIFIER_TOKEN:
+#ifdef HOST_INTERPRETER
+		value=getIdentifierValue(getVariableSymbol(getUShort(&assembled[*currentPoint]), threadId, 1));
+#else
+		value=getIdentifierValue(getVariableSymbol(getUShort(&assembled[*currentPoint]), 1));
+#endif
+		*currentPoint+=sizeof(unsigned short);
+		break;
+	default:
+		// Integer, real or boolean constant
+		value.type=operandType == INTEGER_TOKEN ? INT_TYPE : operandType == REAL_TOKEN ? REAL_TYPE : BOOLEAN_TYPE;
+		value.dtype=SCALAR;
+		cpy(value.data, &assembled[*currentPoint], sizeof(int));
+		*currentPoint+=sizeof(int);
+		break;
 	}
 	return value;
 }
 
+/**
+ * Compares two values with some comparison operator (or tests their identity), returning one if this holds and zero otherwise
+ */
+static int compareValues(unsigned char operator, struct value_defn expression1, struct value_defn expression2) {
+	if (operator == IS_TOKEN) {
+		if (expression1.type == NONE_TYPE && expression2.type == NONE_TYPE) return 1;
+		if (expression1.type != expression2.type) return 0;
+		char *ptr1, *ptr2;
+		cpy(&ptr1, expression1.data, sizeof(char*));
+		cpy(&ptr2, expression2.data, sizeof(char*));
+		return ptr1 == ptr2;
+	}
+	if (expression1.type == expression2.type && expression1.type == INT_TYPE) {
+		int value1=getInt(expression1.data);
+		int value2=getInt(expression2.data);
+		if (operator == EQ_TOKEN) return value1 == value2;
+		if (operator == NEQ_TOKEN) return value1 != value2;
+		if (operator == GT_TOKEN) return value1 > value2;
+		if (operator == GEQ_TOKEN) return value1 >= value2;
+		if (operator == LT_TOKEN) return value1 < value2;
+		if (operator == LEQ_TOKEN) return value1 <= value2;
+	} else if ((expression1.type == REAL_TYPE || expression1.type == INT_TYPE) &&
+			(expression2.type == REAL_TYPE || expression2.type == INT_TYPE)) {
+		float value1=getFloat(expression1.data);
+		float value2=getFloat(expression2.data);
+		if (expression1.type==INT_TYPE) value1=(float) getInt(expression1.data);
+		if (expression2.type==INT_TYPE) value2=(float) getInt(expression2.data);
+		if (operator == EQ_TOKEN) return value1 == value2;
+		if (operator == NEQ_TOKEN) return value1 != value2;
+		if (operator == GT_TOKEN) return value1 > value2;
+		if (operator == GEQ_TOKEN) return value1 >= value2;
+		if (operator == LT_TOKEN) return value1 < value2;
+		if (operator == LEQ_TOKEN) return value1 <= value2;
+	} else if (expression1.type == expression2.type && expression1.type == STRING_TYPE) {
+		if (operator == EQ_TOKEN) {
+			return checkStringEquality(expression1, expression2);
+		} else if (operator == NEQ_TOKEN) {
+			return !checkStringEquality(expression1, expression2);
+		} else {
+			raiseError(ERR_STR_ONLYTEST_EQ);
+		}
+	} else if (expression1.type == expression2.type && expression1.type == NONE_TYPE) {
+		if (operator == EQ_TOKEN || operator == IS_TOKEN) {
+			return 1;
+		} else if (operator == NEQ_TOKEN) {
+			return 0;
+		} else {
+			raiseError(ERR_NONE_ONLYTEST_EQ);
+		}
+	}
+	return 0;
+}
+
+/**
+ * Compares two values with the comparison operator at some point in the byte code. Operators typed statically are run directly
+ * without checking the type of the values, otherwise the generic operator is applied
+ */
+static int compareTypedValues(char * assembled, unsigned int operatorPoint, struct value_defn expression1, struct value_defn expression2) {
+	unsigned char operator=getUChar(&assembled[operatorPoint]);
+	if (operator >= REAL_TYPED_TOKEN_BASE) {
+		return compareReals(operator-REAL_TYPED_TOKEN_BASE+EQ_TOKEN, getFloat(expression1.data), getFloat(expression2.data));
+	} else if (operator >= INT_TYPED_TOKEN_BASE) {
+		return compareIntegers(operator-INT_TYPED_TOKEN_BASE+EQ_TOKEN, getInt(expression1.data), getInt(expression2.data));
+	}
+	return compareValues(operator, expression1, expression2);
+}
+
+/**
+ * Compares two integers with a (generic) comparison operator
+ */
+static int compareIntegers(unsigned char operator, int value1, int value2) {
+	switch (operator) {
+	case EQ_TOKEN: return value1 == value2;
+	case NEQ_TOKEN: return value1 != value2;
+	case LT_TOKEN: return value1 < value2;
+	case GT_TOKEN: return value1 > value2;
+	case LEQ_TOKEN: return value1 <= value2;
+	default: return value1 >= value2;
+	}
+}
+
+/**
+ * Compares two reals with a (generic) comparison operator
+ */
+static int compareReals(unsigned char operator, float value1, float value2) {
+	switch (operator) {
+	case EQ_TOKEN: return value1 == value2;
+	case NEQ_TOKEN: return value1 != value2;
+	case LT_TOKEN: return value1 < value2;
+	case GT_TOKEN: return value1 > value2;
+	case LEQ_TOKEN: return value1 <= value2;
+	default: return value1 >= value2;
+	}
+}
+
+/**
+ * Retrieves the generic operator that a typed operator specialises, other tokens are returned unchanged. Each of the typed
+ * ranges holds sixteen tokens, offset from EQ
+ */
+static unsigned char getGenericOperator(unsigned char token) {
+	if (token >= INT_TYPED_TOKEN_BASE) return ((token-INT_TYPED_TOKEN_BASE) & 0xF)+EQ_TOKEN;
+	return token;
+}
+
 /**
  * Computes the result of a simple mathematical expression, if one is a real and the other an integer
  * then raises to be a real
  */
 #ifdef HOST_INTERPRETER
-static struct value_defn computeExpressionResult(unsigned char operator, char * assembled, unsigned int * currentPoint,
-		unsigned int length, int threadId) {
+static struct value_defn computeExpressionResult(char * assembled, unsigned int * currentPoint, unsigned int length, int threadId) {
 #else
-static struct value_defn computeExpressionResult(unsigned char operator, char * assembled, unsigned int * currentPoint,
-		unsigned int length) {
+static struct value_defn computeExpressionResult(char * assembled, unsigned int * currentPoint, unsigned int length) {
 #endif
-	struct value_defn value;
+	unsigned int operatorPoint=*currentPoint-sizeof(unsigned char);
 #ifdef HOST_INTERPRETER
 	struct value_defn v1=getExpressionValue(assembled, currentPoint, length, threadId);
 	struct value_defn v2=getExpressionValue(assembled, currentPoint, length, threadId);
+	return performTypedArithmetic(assembled, operatorPoint, v1, v2, threadId);
 #else
 	struct value_defn v1=getExpressionValue(assembled, currentPoint, length);
 	struct value_defn v2=getExpressionValue(assembled, currentPoint, length);
+	return performTypedArithmetic(assembled, operatorPoint, v1, v2);
+#endif
+}
+
+/**
+ * Performs the arithmetic operator at some point in the byte code. Operators typed statically are run directly without checking
+ * the type of the values, otherwise the generic operator is applied
+ */
+#ifdef HOST_INTERPRETER
+static struct value_defn performTypedArithmetic(char * assembled, unsigned int operatorPoint, struct value_defn v1, struct value_defn v2,
+		int threadId) {
+#else
+static struct value_defn performTypedArithmetic(char * assembled, unsigned int operatorPoint, struct value_defn v1, struct value_defn v2) {
+#endif
+	unsigned char operator=getUChar(&assembled[operatorPoint]);
+	if (operator >= REAL_TYPED_TOKEN_BASE) {
+		return performRealArithmetic(operator-REAL_TYPED_TOKEN_BASE+EQ_TOKEN, getFloat(v1.data), getFloat(v2.data));
+	} else if (operator >= INT_TYPED_TOKEN_BASE) {
+		return performIntegerArithmetic(operator-INT_TYPED_TOKEN_BASE+EQ_TOKEN, getInt(v1.data), getInt(v2.data));
+	}
+#ifdef HOST_INTERPRETER
+	return performArithmetic(operator, v1, v2, threadId);
+#else
+	return performArithmetic(operator, v1, v2);
+#endif
+}
+
+/**
+ * Performs a (generic) arithmetic operator, other than power, on two integers
+ */
+static struct value_defn performIntegerArithmetic(unsigned char operator, int value1, int value2) {
+	struct value_defn value;
+	int result;
+	switch (operator) {
+	case ADD_TOKEN: result=value1+value2; break;
+	case SUB_TOKEN: result=value1-value2; break;
+	case MUL_TOKEN: result=value1*value2; break;
+	case DIV_TOKEN: result=value1/value2; break;
+	default: result=value1%value2; break;
+	}
+	value.type=INT_TYPE;
+	value.dtype=SCALAR;
+	cpy(value.data, &result, sizeof(int));
+	return value;
+}
+
+/**
+ * Performs a (generic) arithmetic operator, other than power or modulo, on two reals
+ */
+static struct value_defn performRealArithmetic(unsigned char operator, float value1, float value2) {
+	struct value_defn value;
+	float result;
+	switch (operator) {
+	case ADD_TOKEN: result=value1+value2; break;
+	case SUB_TOKEN: result=value1-value2; break;
+	case MUL_TOKEN: result=value1*value2; break;
+	default: result=value1/value2; break;
+	}
+	value.type=REAL_TYPE;
+	value.dtype=SCALAR;
+	cpy(value.data, &result, sizeof(float));
+	return value;
+}
+
+/**
+ * Performs a mathematical operation on two values, if one is a real and the other an integer then raises to be a real
+ */
+#ifdef HOST_INTERPRETER
+static struct value_defn performArithmetic(unsigned char operator, struct value_defn v1, struct value_defn v2, int threadId) {
+#else
+static struct value_defn performArithmetic(unsigned char operator, struct value_defn v1, struct value_defn v2) {
 #endif
+	struct value_defn value;
 	value.type=v1.type==INT_TYPE && v2.type==INT_TYPE ? INT_TYPE : v1.type==STRING_TYPE || v2.type==STRING_TYPE ? STRING_TYPE : REAL_TYPE;
 	value.dtype=SCALAR;
 	if (value.type==INT_TYPE) {
@@ -822,19 +1667,43 @@ static struct value_defn computeExpressionResult(unsigned char operator, char *
 }
 
 /**
- * Retrieves the absolute array target index based upon the provided index expression(s) and dimensions of the array itself. Does some error checking
- * to ensure that the configured values do not exceed the size
+ * Retrieves the absolute array target index based upon the provided index expression(s) and dimensions of the array itself
  */
 #ifdef HOST_INTERPRETER
 static int getArrayAccessorIndex(struct symbol_node* variableSymbol, char * assembled, unsigned int * currentPoint, unsigned int length, int threadId) {
 #else
 static int getArrayAccessorIndex(struct symbol_node* variableSymbol, char * assembled, unsigned int * currentPoint, unsigned int length) {
 #endif
-    struct value_defn index;
+    unsigned char num_dims=getUChar(&assembled[*currentPoint]);
+    *currentPoint+=sizeof(unsigned char);
+    int i, indexes[num_dims];
+    for (i=0;i<num_dims;i++) {
+#ifdef HOST_INTERPRETER
+        struct value_defn index=getExpressionValue(assembled, currentPoint, length, threadId);
+#else
+        struct value_defn index=getExpressionValue(assembled, currentPoint, length);
+#endif
+        indexes[i]=getInt(index.data);
+    }
+#ifdef HOST_INTERPRETER
+    return computeArrayAccessorIndex(variableSymbol, num_dims, indexes, threadId);
+#else
+    return computeArrayAccessorIndex(variableSymbol, num_dims, indexes);
+#endif
+}
+
+/**
+ * Computes the absolute array target index from the index in each dimension and dimensions of the array itself. Does some error checking
+ * to ensure that the configured values do not exceed the size
+ */
+#ifdef HOST_INTERPRETER
+static int computeArrayAccessorIndex(struct symbol_node* variableSymbol, unsigned char num_dims, int * indexes, int threadId) {
+#else
+static int computeArrayAccessorIndex(struct symbol_node* variableSymbol, unsigned char num_dims, int * indexes) {
+#endif
     int i, j, runningWeight, spec_weight, num_weights, specificIndex=0, provIdx;
     unsigned int totSize=1;
-    unsigned char num_dims=getUChar(&assembled[*currentPoint]), array_dims, needsExtension=0, allowedExtension;
-    *currentPoint+=sizeof(unsigned char);
+    unsigned char array_dims, needsExtension=0, allowedExtension;
 
     char * arraymemory;
     cpy(&arraymemory, variableSymbol->value.data, sizeof(char*));
@@ -852,14 +1721,9 @@ static int getArrayAccessorIndex(struct symbol_node* variableSymbol, char * asse
             cpy(&spec_weight, &arraymemory[sizeof(int) * (array_dims-j)], sizeof(int));
             runningWeight*=spec_weight;
         }
-#ifdef HOST_INTERPRETER
-        index=getExpressionValue(assembled, currentPoint, length, threadId);
-#else
-        index=getExpressionValue(assembled, currentPoint, length);
-#endif
         cpy(&spec_weight, &arraymemory[sizeof(int) * i], sizeof(int));
         totSize*=spec_weight;
-        provIdx=getInt(index.data);
+        provIdx=indexes[i];
         if (provIdx < 0) {
             raiseError(ERR_NEG_ARR_INDEX);
         } else if (provIdx >= spec_weight) {
@@ -894,135 +1758,95 @@ static int getArrayAccessorIndex(struct symbol_node* variableSymbol, char * asse
 }
 
 /**
- * Retrieves the symbol entry of a variable based upon its id
+ * Retrieves the symbol entry of a variable based upon its slot, global slots index the symbol table directly and local slots
+ * are relative to the current function's frame. An entry is allocated on first use and aliases are followed if requested
  */
 #ifdef HOST_INTERPRETER
-static struct symbol_node* getVariableSymbol(unsigned short id, unsigned char lvl, int threadId, int followAlias) {
+static struct symbol_node* getVariableSymbol(unsigned short slot, int threadId, int followAlias) {
+	struct symbol_node* variableSymbol=&symbolTable[threadId][slot & LOCAL_VARIABLE_FLAG ? currentFrameBase[threadId] + (slot & ~LOCAL_VARIABLE_FLAG) : slot];
 #else
-static struct symbol_node* getVariableSymbol(unsigned short id, unsigned char lvl, int followAlias) {
+static struct symbol_node* getVariableSymbol(unsigned short slot, int followAlias) {
+	struct symbol_node* variableSymbol=&symbolTable[slot & LOCAL_VARIABLE_FLAG ? currentFrameBase + (slot & ~LOCAL_VARIABLE_FLAG) : slot];
 #endif
-	int i;
+	if (variableSymbol->state == UNALLOCATED) {
+		char* zero=0;
+		variableSymbol->state=ALLOCATED;
+		variableSymbol->value.type=INT_TYPE;
+		variableSymbol->value.dtype=SCALAR;
+		cpy(variableSymbol->value.data, &zero, sizeof(char*));
+	} else if (followAlias) {
+		while (variableSymbol->state == ALIAS) {
 #ifdef HOST_INTERPRETER
-	for (i=0;i<=currentSymbolEntries[threadId];i++) {
-		if (symbolTable[threadId][i].id == id && symbolTable[threadId][i].state != UNALLOCATED && (symbolTable[threadId][i].level == 0 || symbolTable[threadId][i].level==lvl)) {
-			if (followAlias && symbolTable[threadId][i].state == ALIAS) {
-				return getVariableSymbol(symbolTable[threadId][i].alias, lvl-1, threadId, 1);
-			} else {
-				return &(symbolTable[threadId])[i];
-			}
-		}
+			variableSymbol=&symbolTable[threadId][variableSymbol->alias];
 #else
-	for (i=0;i<=currentSymbolEntries;i++) {
-		if (symbolTable[i].id == id && symbolTable[i].state != UNALLOCATED && (symbolTable[i].level == 0 || symbolTable[i].level==lvl)) {
-			if (followAlias && symbolTable[i].state == ALIAS) {
-				return getVariableSymbol(symbolTable[i].alias, lvl-1, 1);
-			} else {
-				return &symbolTable[i];
-			}
-		}
+			variableSymbol=&symbolTable[variableSymbol->alias];
 #endif
+		}
 	}
-	char* zero=0;
-#ifdef HOST_INTERPRETER
-	int newEntryLocation=getSymbolTableEntryId(threadId);
-	symbolTable[threadId][newEntryLocation].id=id;
-	symbolTable[threadId][newEntryLocation].state=ALLOCATED;
-	symbolTable[threadId][newEntryLocation].level=lvl;
-	symbolTable[threadId][newEntryLocation].value.type=INT_TYPE;
-	cpy(symbolTable[threadId][newEntryLocation].value.data, &zero, sizeof(char*));
-	return &symbolTable[threadId][newEntryLocation];
-#else
-	int newEntryLocation=getSymbolTableEntryId();
-	symbolTable[newEntryLocation].id=id;
-	symbolTable[newEntryLocation].level=lvl;
-	symbolTable[newEntryLocation].state=ALLOCATED;
-	symbolTable[newEntryLocation].value.type=INT_TYPE;
-	symbolTable[newEntryLocation].value.dtype=SCALAR;
-	cpy(symbolTable[newEntryLocation].value.data, &zero, sizeof(char*));
-	return &symbolTable[newEntryLocation];
-#endif
+	return variableSymbol;
 }
+
+/**
+ * Marks a range of symbol table entries as unallocated, done for the globals on startup and for each new function frame
+ */
 #ifdef HOST_INTERPRETER
-static int getSymbolTableEntryId(int threadId) {
+static void initialiseSymbolTableEntries(int start, int number, int threadId) {
 #else
-static int getSymbolTableEntryId(void) {
+static void initialiseSymbolTableEntries(int start, int number) {
 #endif
 	int i;
+	for (i=start;i<start+number;i++) {
 #ifdef HOST_INTERPRETER
-	for (i=0;i<=currentSymbolEntries[threadId];i++) {
-			if (symbolTable[threadId][i].state == UNALLOCATED) return i;
-	}
-	return ++currentSymbolEntries[threadId];
+		symbolTable[threadId][i].state=UNALLOCATED;
 #else
-	for (i=0;i<=currentSymbolEntries;i++) {
-		if (symbolTable[i].state == UNALLOCATED) return i;
-	}
-	return ++currentSymbolEntries;
+		symbolTable[i].state=UNALLOCATED;
 #endif
+	}
 }
 
-#ifdef HOST_INTERPRETER
-static void clearVariablesToLevel(unsigned char clearLevel, int threadId) {
-#else
-static void clearVariablesToLevel(unsigned char clearLevel) {
-#endif
-	int i;
-	char * smallestMemoryAddress=0, *ptr;
-#ifdef HOST_INTERPRETER
-	for (i=0;i<=currentSymbolEntries[threadId];i++) {
-		if (symbolTable[threadId][i].level >= clearLevel && symbolTable[threadId][i].state != UNALLOCATED) {
-			symbolTable[threadId][i].state=UNALLOCATED;
-			if (symbolTable[threadId][i].value.dtype==SCALAR && symbolTable[threadId][i].value.type != STRING_TYPE) {
-				cpy(&ptr, symbolTable[threadId][i].value.data, sizeof(int*));
-				if (ptr != 0 && (smallestMemoryAddress == 0 || smallestMemoryAddress > ptr)) smallestMemoryAddress=ptr;
-			}
-		}
-	}
-#else
-	for (i=0;i<=currentSymbolEntries;i++) {
-		if (symbolTable[i].level >= clearLevel && symbolTable[i].state != UNALLOCATED) {
-			symbolTable[i].state=UNALLOCATED;
-			if (symbolTable[i].value.dtype==SCALAR && symbolTable[i].value.type != STRING_TYPE) {
-				cpy(&ptr, symbolTable[i].value.data, sizeof(char*));
-				if (ptr != 0 && (smallestMemoryAddress == 0 || smallestMemoryAddress > ptr)) smallestMemoryAddress=ptr;
-			}
-		}
+/**
+ * Retrieves the value of a variable referenced by its identifier, which for arrays is the array itself
+ */
+static struct value_defn getIdentifierValue(struct symbol_node* variableSymbol) {
+	struct value_defn value;
+	if (variableSymbol->value.dtype==SCALAR || variableSymbol->value.dtype==SCALAR_REFERENCE) {
+		value=getVariableValue(variableSymbol, -1);
+	} else if (variableSymbol->value.dtype==ARRAY) {
+		value.dtype=ARRAY;
+		value.type=variableSymbol->value.type;
+		cpy(value.data, variableSymbol->value.data, sizeof(char*));
 	}
-#endif
-	if (smallestMemoryAddress != 0) clearFreedStackFrames(smallestMemoryAddress);
+	return value;
 }
 
 /**
- * Sets a variables value in memory as pointed to by symbol table
+ * Sets a variables value, scalars are held directly in the symbol table whereas arrays and scalar references are written
+ * to the memory that the symbol table points to
  */
 void setVariableValue(struct symbol_node* variableSymbol, struct value_defn value, int index) {
 	variableSymbol->value.type=value.type;
 	if (value.type == STRING_TYPE) {
 		cpy(&variableSymbol->value.data, &value.data, sizeof(char*));
+	} else if (variableSymbol->value.dtype == SCALAR) {
+		cpy(variableSymbol->value.data, value.data, sizeof(char*));
 	} else {
 		char * ptr;
 		cpy(&ptr, variableSymbol->value.data, sizeof(char*));
-		if (ptr == 0) {
-			ptr=getStackMemory(sizeof(int) * index, 0);
-			cpy(variableSymbol->value.data, &ptr, sizeof(char*));
-			cpy(ptr+((index+1) *4), value.data, sizeof(int));
-		} else {
-			cpy(&ptr, variableSymbol->value.data, sizeof(char*));
-			if (variableSymbol->value.dtype == ARRAY) {
-                unsigned char num_dims;
-                cpy(&num_dims, ptr, sizeof(unsigned char));
-                num_dims=num_dims & 0xF;
-                ptr+=((index+num_dims)*sizeof(int)) + sizeof(unsigned char);
-            } else {
-                ptr+=(index+1)*sizeof(int);
-            }
-			cpy(ptr, value.data, sizeof(int));
-		}
+		if (variableSymbol->value.dtype == ARRAY) {
+            unsigned char num_dims;
+            cpy(&num_dims, ptr, sizeof(unsigned char));
+            num_dims=num_dims & 0xF;
+            ptr+=((index+num_dims)*sizeof(int)) + sizeof(unsigned char);
+        } else {
+            ptr+=(index+1)*sizeof(int);
+        }
+		cpy(ptr, value.data, sizeof(int));
 	}
 }
 
 /**
- * Retrieves a variable value from memory, which the symbol table points to
+ * Retrieves a variable value, scalars are held directly in the symbol table whereas arrays and scalar references are read
+ * from the memory that the symbol table points to
  */
 struct value_defn getVariableValue(struct symbol_node* variableSymbol, int index) {
 	struct value_defn val;
@@ -1030,6 +1854,8 @@ struct value_defn getVariableValue(struct symbol_node* variableSymbol, int index
 	val.dtype=SCALAR;
 	if (variableSymbol->value.type == STRING_TYPE) {
 		cpy(&val.data, &variableSymbol->value.data, sizeof(int*));
+	} else if (variableSymbol->value.dtype == SCALAR) {
+		cpy(val.data, variableSymbol->value.data, sizeof(char*));
 	} else {
 		char * ptr;
 		cpy(&ptr, variableSymbol->value.data, sizeof(char*));
@@ -1041,7 +1867,7 @@ struct value_defn getVariableValue(struct symbol_node* variableSymbol, int index
 		} else {
 		    ptr+=(index+1)*sizeof(int);
 		}
-		cpy(val.data, ptr, sizeof(char*));
+		cpy(val.data, ptr, sizeof(int));
 	}
 	return val;
 }
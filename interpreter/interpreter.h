@@ -45,6 +45,8 @@
 
 #define SCALAR 0
 #define ARRAY 1
+// A scalar held indirectly, its data is a pointer to the value (i.e. obtained by dereferencing a reference) rather than the value itself
+#define SCALAR_REFERENCE 2
 
 #define UNALLOCATED 1
 #define ALLOCATED 2
@@ -61,10 +63,11 @@ struct value_defn {
 #endif
 };
 
-// A node in the symbol table - its id and value
+// A node in the symbol table - its state, the entry it aliases (if applicable) and value. Variables are mapped to
+// entries by their slot, which is resolved at compile time to be either global or relative to the current function frame
 struct symbol_node {
-	unsigned short id, alias;
-	unsigned char state, level;
+	unsigned short alias;
+	unsigned char state;
 	struct value_defn value __attribute__((aligned(8)));
 };
 
@@ -72,6 +75,16 @@ struct symbol_node {
 extern volatile char * stopInterpreter;
 void runIntepreter(char*, unsigned int, unsigned short, int, int, int);
 void initThreadedAspectsForInterpreter(int, int, struct shared_basic*);
+void displaySuperinstructionCounts(void);
+#ifdef HOST_STANDALONE
+// Code translated ahead of time to C, which is run in place of the interpreter when set
+extern struct value_defn (*translatedCode)(char*, unsigned int, unsigned int, int);
+unsigned int runTranslatedStatement(char*, unsigned int, unsigned int, struct value_defn*, int);
+struct symbol_node* getTranslatedVariableSymbol(unsigned short, int);
+struct value_defn getTranslatedIdentifierValue(struct symbol_node*);
+void setTranslatedVariableValue(struct symbol_node*, struct value_defn, int);
+void callTranslatedNative(struct value_defn*, unsigned char, int, struct value_defn*, int);
+#endif
 #else
 extern char stopInterpreter;
 void runIntepreter(char*, unsigned int, unsigned short, int, int, int);
@@ -42,23 +42,13 @@ def arraycopy(target, source):
         native rtl_arraycopy(target, source, ndim(target), ndim(source), len(target))
 
 def size(arr):
-    dims=ndim(arr)
-    if dims > 0:
-        s=shape(arr)
-        arraylength=1
-        i=0
-        while i<dims:
-            arraylength*=s[i]
-            i+=1
-        return arraylength
-    else:
-        return 0
+    return native rtl_size(arr)
 
 def freearray(arr):
     native rtl_free(arr)
 
 def len(arr):
-    return size(arr)
+    return native rtl_size(arr)
 
 def ndim(arr):
     return native rtl_numdims(arr)
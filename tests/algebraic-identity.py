@@ -0,0 +1,6 @@
+b=3
+print b*1
+print b-0
+print 1*b
+a="x"
+print a*1
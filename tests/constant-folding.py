@@ -0,0 +1,13 @@
+a=3
+b=a+4
+c=b*2
+print c
+print 7/2
+print -7%3
+print 2**10
+print 3/2.0
+print 1.5**3
+print 2.0 >= 3
+print 7//2
+i=2147483647
+print i+1
@@ -0,0 +1,18 @@
+from parallel import *
+
+def square(x):
+    return x * x
+
+def cube(x):
+    return x * x * x
+
+if coreid() == 1:
+    send(cube, 0)
+    f=recv(0)
+    send(f(4), 0)
+else:
+    print "core zero"
+    f=recv(1)
+    print f(3)
+    send(square, 1)
+    print recv(1)
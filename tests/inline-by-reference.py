@@ -0,0 +1,21 @@
+def setfirst(a, v):
+	a[0]=v
+
+def bump(x):
+	x=x+1
+	return x
+
+def twice(x):
+	return x+x
+
+def ident(x):
+	return x
+
+arr=[0,0,0]
+setfirst(arr, 7)
+print arr[0]
+n=5
+print bump(n)
+print n
+print twice(n)
+print ident(arr[0])
@@ -0,0 +1,16 @@
+counter=0
+
+def tick():
+	counter=counter+1
+	return counter
+
+def twice(x):
+	return x+x
+
+def square(x):
+	return x*x
+
+print twice(tick())
+print counter
+print square(tick())
+print counter
@@ -0,0 +1,4 @@
+mv=10
+print "before"
+import linkedorder
+print mf()
@@ -0,0 +1,13 @@
+from util import range
+import linkedconstants
+import linkedglobals
+a=1
+b=2
+print count
+print item
+print values[1]
+print scaled(a+b)
+print total()
+for i in range(1,3):
+	print i*scale+b
+print offset+limit
@@ -0,0 +1,2 @@
+offset=100
+limit=7
@@ -0,0 +1,17 @@
+count=0
+scale=3
+values=[5, 6, 7, 8]
+index=1
+count=count+1
+count=count+2
+item=values[index]
+values[index]=item*scale
+if count < scale:
+	count=count+10
+def scaled(x):
+	return x*scale
+def total():
+	t=0
+	for v in values:
+		t=t+v
+	return t
@@ -0,0 +1,4 @@
+print "in mod"
+mv=mv+1
+def mf():
+	return mv
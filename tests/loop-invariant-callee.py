@@ -0,0 +1,34 @@
+from util import range
+limit=3
+scale=2
+
+def grow():
+	scale=scale+1
+
+total=0
+i=0
+while i < limit:
+	total=total+scale*10
+	grow()
+	i=i+1
+print total
+print scale
+
+data=[1,2,3,4]
+sum=0
+for j in range(4):
+	sum=sum+data[0]*j
+	data[0]=data[0]+1
+print sum
+
+def bumpfirst(a):
+	a[0]=a[0]+1
+
+values=[5,0]
+k=0
+acc=0
+while k < 3:
+	acc=acc+values[0]*2
+	bumpfirst(values)
+	k=k+1
+print acc
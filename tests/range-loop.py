@@ -0,0 +1,9 @@
+from util import range
+for i in range(1,3):
+	print i
+total=0
+for i in range(10):
+	total+=i
+print total
+for i in xrange(2,4):
+	print i
@@ -0,0 +1,45 @@
+#!/bin/bash
+
+# Runs each test against the host built standalone (make standalone) and compares what it outputs with what is expected. A test is
+# a Python source file or a byte code file, which is loaded with -l, named the same as the .expected file holding its output. Any
+# further command line arguments for a test are held in a .flags file of the same name, and the imported modules which are linked
+# in as objects are compiled into a cache directory which is removed afterwards
+
+cd "$(dirname "$0")"
+
+EPYTHON=${EPYTHON:-../epython-host}
+export EPYTHONPATH=../modules
+export EPYTHONCACHE=$(mktemp -d)
+trap 'rm -rf "$EPYTHONCACHE"' EXIT
+
+if [ ! -x $EPYTHON ]
+then
+echo "ePython host '$EPYTHON' not found, build this first with make standalone"
+exit 1
+fi
+
+PASSED=0
+FAILED=0
+
+for EXPECTED in *.expected
+do
+TEST=${EXPECTED%.expected}
+FLAGS=$(cat $TEST.flags 2>/dev/null)
+if [ -f $TEST.py ]
+then
+OUTPUT=$($EPYTHON -nocache -h 1 $FLAGS $TEST.py 2>&1 < /dev/null)
+else
+OUTPUT=$($EPYTHON -nocache -h 1 $FLAGS -l $TEST.epyb 2>&1 < /dev/null)
+fi
+if [ "$OUTPUT" == "$(cat $EXPECTED)" ]
+then
+PASSED=$((PASSED+1))
+else
+FAILED=$((FAILED+1))
+echo "FAILED $TEST"
+diff <(echo "$OUTPUT") $EXPECTED
+fi
+done
+
+echo "$PASSED passed, $FAILED failed"
+[ $FAILED -eq 0 ]
@@ -0,0 +1,19 @@
+from util import range
+a=7
+b=2
+print a/b
+c=a
+c=2.5
+print c*b
+d=a
+if b > 1:
+	d="text"
+print d
+e=1
+for k in range(3):
+	e=e*2.5
+print e
+print 7%3
+f=a
+f=f+0.5
+print f
@@ -0,0 +1,5 @@
+def range(a,b):
+	return [a*10,b*10]
+
+for i in range(1,2):
+	print i